@@ -6,6 +6,7 @@ enable_language(CXX)
 # Build option(s)
 #-----------------------------------------------------------------------------
 option(BUILD_TESTING "tests" ON)
+option(BUILD_BENCHMARKS "timings of the main operations on synthetic populations" OFF)
 
 set(PRIMARY_PROJECT_NAME ${LOCAL_PROJECT_NAME})
 
@@ -168,6 +168,7 @@ endif()
 list(APPEND ${CMAKE_PROJECT_NAME}_SUPERBUILD_EP_VARS
   BUILD_EXAMPLES:BOOL
   BUILD_TESTING:BOOL
+  BUILD_BENCHMARKS:BOOL
   ITK_VERSION_MAJOR:STRING
   ITK_DIR:PATH
   VTK_DIR:PATH
@@ -0,0 +1,359 @@
+//***************************************************************************//
+//     Timings of the ShapePopulationBase operations on synthetic meshes     //
+//***************************************************************************//
+//
+// ShapePopulationBenchmarks [--scale NxM]... [--repetitions R] [--directory DIR] [--output FILE] [--no-render]
+//
+// Every scale is a population of N meshes of about M points, with one scalar and one vector
+// attribute. The meshes only depend on (N, M, index), so two runs time the same data.
+// The results (minimum, median and mean over R repetitions) are written as JSON.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <cstdio>
+
+#include "ShapePopulationBase.h"
+#include "ShapePopulationParallel.h"
+
+#include <vtkSphereSource.h>
+#include <vtkPolyDataWriter.h>
+#include <vtkTimerLog.h>
+
+static const char * s_scalarName = "Benchmark_Scalar";
+static const char * s_vectorName = "Benchmark_Vector";
+
+struct BenchmarkScale
+{
+    int numberOfMeshes;
+    int numberOfPoints;
+};
+
+struct BenchmarkResult
+{
+    int numberOfMeshes;
+    vtkIdType numberOfPoints;
+    std::string operation;
+    std::vector<double> times;          // milliseconds, one per repetition
+};
+
+// Population driven directly through the ShapePopulationBase API, without the Qt widgets
+class BenchmarkPopulation : public ShapePopulationBase
+{
+    public :
+
+    ~BenchmarkPopulation()
+    {
+        for(unsigned int i = 0; i < m_meshList.size(); i++) delete m_meshList[i];
+        for(unsigned int i = 0; i < m_magnitude.size(); i++) delete m_magnitude[i];
+        for(unsigned int i = 0; i < m_axisColor.size(); i++) delete m_axisColor[i];
+    }
+
+    // Same per-mesh state as ShapePopulationQT::CreateWidgets
+    void Load(std::vector<std::string> a_files, bool a_offScreen)
+    {
+        for(unsigned int i = 0; i < a_files.size(); i++)
+        {
+            this->CreateNewWindow(a_files[i]);
+            m_windowsList.back()->SetSize(300, 300);
+            if(a_offScreen) m_windowsList.back()->SetOffScreenRendering(1);
+
+            m_selectedIndex.push_back(i);
+            m_displayColorMapByMagnitude.push_back(true);
+            m_displayColorMapByDirection.push_back(false);
+            m_displayVectors.push_back(true);
+            m_displayVectorsByMagnitude.push_back(true);
+            m_displayVectorsByDirection.push_back(false);
+            m_meshOpacity.push_back(100);
+            m_vectorScale.push_back(100);
+            m_vectorDensity.push_back(1);
+
+            axisColorStruct * axisColor = new axisColorStruct;
+            axisColor->XAxiscolor[0] = 255; axisColor->XAxiscolor[1] = 0;   axisColor->XAxiscolor[2] = 0;
+            axisColor->YAxiscolor[0] = 0;   axisColor->YAxiscolor[1] = 255; axisColor->YAxiscolor[2] = 0;
+            axisColor->ZAxiscolor[0] = 0;   axisColor->ZAxiscolor[1] = 0;   axisColor->ZAxiscolor[2] = 255;
+            axisColor->sameColor = false;
+            axisColor->complementaryColor = true;
+            m_axisColor.push_back(axisColor);
+        }
+        this->computeCommonAttributes();
+
+        std::string vectorMagnitude = std::string(s_vectorName) + "_mag\n";
+        double * range = this->computeCommonRange(vectorMagnitude.c_str(), m_selectedIndex);
+        magnitudStruct * magnitude = new magnitudStruct;
+        magnitude->min = range[0];
+        magnitude->max = range[1];
+        m_magnitude.push_back(magnitude);
+    }
+
+    void ComputeCommonAttributes() {this->computeCommonAttributes();}
+    void ComputeCommonRange(const char * a_attribute) {this->computeCommonRange(a_attribute, m_selectedIndex);}
+    void UpdateAttribute(const char * a_attribute) {ShapePopulationBase::UpdateAttribute(a_attribute, m_selectedIndex);}
+    void UpdateColorMapByDirection(const char * a_attribute) {ShapePopulationBase::UpdateColorMapByDirection(a_attribute, 0);}
+    void SetVectorDensity(double a_density) {this->setVectorDensity(a_density);}
+    void RenderAll() {ShapePopulationBase::RenderAll();}
+    vtkIdType GetNumberOfPoints() {return m_meshList.empty() ? 0 : m_meshList[0]->GetPolyData()->GetNumberOfPoints();}
+};
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                        SYNTHETIC DATA                                         * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// Deformed sphere of about a_numberOfPoints points, the deformation depending on a_index
+static vtkSmartPointer<vtkPolyData> createMesh(int a_numberOfPoints, int a_index)
+{
+    int resolution = std::max(3, (int)sqrt(a_numberOfPoints/2.0));
+    vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(10.0);
+    sphere->SetThetaResolution(2*resolution);
+    sphere->SetPhiResolution(resolution + 2);
+    sphere->Update();
+
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->DeepCopy(sphere->GetOutput());
+    polyData->GetPointData()->Initialize();
+
+    vtkIdType numPts = polyData->GetNumberOfPoints();
+    vtkSmartPointer<vtkDoubleArray> scalars = vtkSmartPointer<vtkDoubleArray>::New();
+    scalars->SetName(s_scalarName);
+    scalars->SetNumberOfTuples(numPts);
+    vtkSmartPointer<vtkDoubleArray> vectors = vtkSmartPointer<vtkDoubleArray>::New();
+    vectors->SetName(s_vectorName);
+    vectors->SetNumberOfComponents(3);
+    vectors->SetNumberOfTuples(numPts);
+
+    double frequency = 1.0 + a_index%5;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        double point[3];
+        polyData->GetPoint(v, point);
+        double direction[3] = {point[0], point[1], point[2]};
+        vtkMath::Normalize(direction);
+
+        double amplitude = 0.5*sin(frequency*direction[0]*3.0)*cos(frequency*direction[1]*2.0) + 0.02*a_index;
+        for(int k = 0; k < 3; k++) point[k] += amplitude*direction[k];
+        polyData->GetPoints()->SetPoint(v, point);
+
+        scalars->SetValue(v, amplitude + 0.1*direction[2]);
+        vectors->SetTuple3(v, amplitude*direction[0], amplitude*direction[1], amplitude*direction[2]);
+    }
+    polyData->GetPointData()->AddArray(scalars);
+    polyData->GetPointData()->AddArray(vectors);
+    return polyData;
+}
+
+static std::vector<std::string> writePopulation(BenchmarkScale a_scale, std::string a_directory)
+{
+    std::vector<std::string> files;
+    for(int i = 0; i < a_scale.numberOfMeshes; i++)
+    {
+        std::ostringstream filePath;
+        filePath << a_directory << "/spvBenchmark_" << a_scale.numberOfMeshes << "x" << a_scale.numberOfPoints << "_" << i << ".vtk";
+
+        vtkSmartPointer<vtkPolyDataWriter> writer = vtkSmartPointer<vtkPolyDataWriter>::New();
+        writer->SetFileName(filePath.str().c_str());
+#if (VTK_MAJOR_VERSION < 6)
+        writer->SetInput(createMesh(a_scale.numberOfPoints, i));
+#else
+        writer->SetInputData(createMesh(a_scale.numberOfPoints, i));
+#endif
+        writer->SetFileTypeToBinary();
+        writer->Write();
+        files.push_back(filePath.str());
+    }
+    return files;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          BENCHMARKS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+static double elapsedMilliseconds(double a_start)
+{
+    return 1000.0*(vtkTimerLog::GetUniversalTime() - a_start);
+}
+
+static void runScale(BenchmarkScale a_scale, int a_repetitions, std::string a_directory, bool a_render, std::vector<BenchmarkResult> &a_results)
+{
+    std::vector<std::string> files = writePopulation(a_scale, a_directory);
+
+    const char * operations[] = {"ReadMesh", "ScanHeaders", "computeCommonAttributes", "computeCommonRange", "UpdateAttribute(scalar)",
+                                 "UpdateAttribute(vector)", "UpdateColorMapByDirection", "setVectorDensity", "RenderAll"};
+    int numberOfOperations = a_render ? 9 : 8;
+    std::vector<BenchmarkResult> results(numberOfOperations);
+
+    BenchmarkPopulation population;
+    population.Load(files, a_render);
+    for(int k = 0; k < numberOfOperations; k++)
+    {
+        results[k].numberOfMeshes = a_scale.numberOfMeshes;
+        results[k].numberOfPoints = population.GetNumberOfPoints();
+        results[k].operation = operations[k];
+    }
+
+    std::string vectorMagnitude = std::string(s_vectorName) + "_mag\n";
+    if(a_render) population.RenderAll();          // first render creates the OpenGL resources
+
+    for(int r = 0; r < a_repetitions; r++)
+    {
+        double start = vtkTimerLog::GetUniversalTime();
+        for(unsigned int i = 0; i < files.size(); i++)
+        {
+            ShapePopulationData mesh;
+            mesh.ReadMesh(files[i]);
+        }
+        results[0].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        ShapePopulationHeader::ScanFiles(files);
+        results[1].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        population.ComputeCommonAttributes();
+        results[2].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        population.ComputeCommonRange(vectorMagnitude.c_str());
+        results[3].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        population.UpdateAttribute(s_scalarName);
+        results[4].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        population.UpdateAttribute(s_vectorName);
+        results[5].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        population.UpdateColorMapByDirection(s_vectorName);
+        results[6].times.push_back(elapsedMilliseconds(start));
+
+        start = vtkTimerLog::GetUniversalTime();
+        population.SetVectorDensity(r%2 ? 50 : 100);
+        results[7].times.push_back(elapsedMilliseconds(start));
+
+        if(a_render)
+        {
+            start = vtkTimerLog::GetUniversalTime();
+            population.RenderAll();
+            results[8].times.push_back(elapsedMilliseconds(start));
+        }
+    }
+
+    for(unsigned int i = 0; i < files.size(); i++) remove(files[i].c_str());
+    a_results.insert(a_results.end(), results.begin(), results.end());
+}
+
+static void writeJSON(std::ostream &a_stream, std::vector<BenchmarkResult> a_results, int a_repetitions)
+{
+    a_stream << "{" << std::endl;
+    a_stream << "  \"benchmark\": \"ShapePopulationBenchmarks\"," << std::endl;
+    a_stream << "  \"vtkVersion\": \"" << vtkVersion::GetVTKVersion() << "\"," << std::endl;
+    a_stream << "  \"threads\": " << ShapePopulationParallel::GetNumberOfThreads() << "," << std::endl;
+    a_stream << "  \"repetitions\": " << a_repetitions << "," << std::endl;
+    a_stream << "  \"results\": [" << std::endl;
+    for(unsigned int i = 0; i < a_results.size(); i++)
+    {
+        std::vector<double> times = a_results[i].times;
+        std::sort(times.begin(), times.end());
+        double mean = 0.0;
+        for(unsigned int r = 0; r < times.size(); r++) mean += times[r];
+        mean /= times.size();
+        double median = (times.size()%2) ? times[times.size()/2] : 0.5*(times[times.size()/2 - 1] + times[times.size()/2]);
+
+        a_stream << "    {\"meshes\": " << a_results[i].numberOfMeshes
+                 << ", \"points\": " << a_results[i].numberOfPoints
+                 << ", \"operation\": \"" << a_results[i].operation << "\""
+                 << ", \"min_ms\": " << times.front()
+                 << ", \"median_ms\": " << median
+                 << ", \"mean_ms\": " << mean << "}"
+                 << ((i + 1 < a_results.size()) ? "," : "") << std::endl;
+    }
+    a_stream << "  ]" << std::endl;
+    a_stream << "}" << std::endl;
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: ShapePopulationBenchmarks [--scale NxM]... [--repetitions R] [--directory DIR] [--output FILE] [--no-render]" << std::endl;
+    std::cout << "  --scale NxM      population of N meshes of about M points (default 4x10000 16x10000 16x100000 64x10000)" << std::endl;
+    std::cout << "  --repetitions R  number of timings of each operation (default 5)" << std::endl;
+    std::cout << "  --directory DIR  where the synthetic meshes are written (default .)" << std::endl;
+    std::cout << "  --output FILE    JSON results (default standard output)" << std::endl;
+    std::cout << "  --no-render      skip the offscreen RenderAll timing" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<BenchmarkScale> scales;
+    int repetitions = 5;
+    std::string directory = ".";
+    std::string output = "";
+    bool render = true;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if(argument == "--scale" && i + 1 < argc)
+        {
+            BenchmarkScale scale;
+            if(sscanf(argv[++i], "%dx%d", &scale.numberOfMeshes, &scale.numberOfPoints) != 2 || scale.numberOfMeshes < 1 || scale.numberOfPoints < 1)
+            {
+                std::cerr << "Invalid scale: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+            scales.push_back(scale);
+        }
+        else if(argument == "--repetitions" && i + 1 < argc) repetitions = std::max(1, atoi(argv[++i]));
+        else if(argument == "--directory" && i + 1 < argc) directory = argv[++i];
+        else if(argument == "--output" && i + 1 < argc) output = argv[++i];
+        else if(argument == "--no-render") render = false;
+        else
+        {
+            printUsage();
+            return (argument == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if(scales.empty())
+    {
+        int defaults[4][2] = {{4, 10000}, {16, 10000}, {16, 100000}, {64, 10000}};
+        for(int k = 0; k < 4; k++)
+        {
+            BenchmarkScale scale;
+            scale.numberOfMeshes = defaults[k][0];
+            scale.numberOfPoints = defaults[k][1];
+            scales.push_back(scale);
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    for(unsigned int s = 0; s < scales.size(); s++)
+    {
+        std::cerr << "Population " << scales[s].numberOfMeshes << " x " << scales[s].numberOfPoints << " points" << std::endl;
+        runScale(scales[s], repetitions, directory, render, results);
+    }
+
+    if(output.empty())
+    {
+        writeJSON(std::cout, results, repetitions);
+    }
+    else
+    {
+        std::ofstream file(output.c_str());
+        if(!file)
+        {
+            std::cerr << "Cannot write " << output << std::endl;
+            return EXIT_FAILURE;
+        }
+        writeJSON(file, results, repetitions);
+    }
+    return EXIT_SUCCESS;
+}
@@ -15,6 +15,60 @@ CSVloaderQT::~CSVloaderQT()
     delete m_layout;
 }
 
+vtkSmartPointer<vtkTable> CSVloaderQT::readTable(std::string filePath)
+{
+    //Read .CSV with VTK
+    vtkSmartPointer<vtkDelimitedTextReader> CSVreader = vtkSmartPointer<vtkDelimitedTextReader>::New();
+    CSVreader->SetFieldDelimiterCharacters(",");
+    CSVreader->SetFileName(filePath.c_str());
+    CSVreader->SetHaveHeaders(true);
+    CSVreader->Update();
+    return CSVreader->GetOutput();
+}
+
+int CSVloaderQT::checkFile(const QFileInfo &file)
+{
+    QString QFilePath = file.absoluteFilePath();
+    if (!ShapePopulationReaders::IsSupported(QFilePath.toStdString())) return FILE_WRONG_FORMAT;
+    if (!QFileInfo(QFilePath).exists()) return FILE_NOT_FOUND;          // not the cached information of the copy
+    return FILE_OK;
+}
+
+void CSVloaderQT::waitForFuture(QFutureWatcherBase * watcher)
+{
+    // The GUI keeps repainting while the worker threads run
+    QEventLoop loop;
+    connect(watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+    if(!watcher->isFinished()) loop.exec();
+}
+
+void CSVloaderQT::loadCSVFile(QFileInfo file)
+{
+    // The CSV is read in a worker thread, a large one on a network share would freeze the GUI
+    QProgressDialog progress("Reading " + file.fileName() + "...", QString(), 0, 0, this->parentWidget());
+    progress.setWindowTitle("Load CSV");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    QFutureWatcher< vtkSmartPointer<vtkTable> > watcher;
+    watcher.setFuture(QtConcurrent::run(CSVloaderQT::readTable, std::string(file.absoluteFilePath().toLocal8Bit().data())));
+    this->waitForFuture(&watcher);
+    progress.reset();
+
+    vtkSmartPointer<vtkTable> table = watcher.result();
+    if(table == NULL || table->GetNumberOfRows() == 0)
+    {
+        std::ostringstream strs;
+        strs << file.absoluteFilePath().toStdString() << std::endl
+             << "This file has no rows to load."<< std::endl;
+        QMessageBox::critical(this->parentWidget(),"Load CSV",QString(strs.str().c_str()), QMessageBox::Ok);
+        return;
+    }
+
+    //Display in CSVloaderQT
+    this->displayTable(table,file.absoluteDir());
+}
+
 
 void CSVloaderQT::displayTable(vtkSmartPointer<vtkTable> table, QDir directory)
 {
@@ -43,38 +97,70 @@ void CSVloaderQT::on_buttonBox_accepted()
 
     //Get selected Items
     QFileInfoList fileList;
+    std::vector<vtkIdType> rows;
     for(int i = 0 ; i < items->GetNumberOfTuples(); i++)
     {
         double* cell = items->GetTuple(i);
         vtkVariant test = m_table->GetValue(cell[0],cell[1]);
         QString relativePath = test.ToString().c_str();
         fileList.append(QFileInfo(m_directory,relativePath));
+        rows.push_back((vtkIdType)cell[0]);
     }
 
-    // Control the files format
+    // Control the files in parallel, the paths may be on a network share
+    QProgressDialog progress("Checking the files...", "Cancel", 0, fileList.size(), this->parentWidget());
+    progress.setWindowTitle("Load CSV");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    QFutureWatcher<int> watcher;
+    connect(&watcher, SIGNAL(progressValueChanged(int)), &progress, SLOT(setValue(int)));
+    connect(&progress, SIGNAL(canceled()), &watcher, SLOT(cancel()));
+    watcher.setFuture(QtConcurrent::mapped(fileList, CSVloaderQT::checkFile));
+    this->waitForFuture(&watcher);
+    progress.reset();
+    if(watcher.isCanceled()) return;
+
+    // One report of all the files which can not be loaded
+    QFileInfoList validFileList;
+    std::vector<vtkIdType> validRows;
+    std::ostringstream strs;
+    int numberOfErrors = 0;
     for (int i = 0; i < fileList.size(); i++)
     {
-        QString QFilePath = fileList[i].absoluteFilePath();
-        if (!QFilePath.endsWith(".vtk") && !QFilePath.endsWith(".vtp"))
+        int status = watcher.resultAt(i);
+        if(status == FILE_OK)
         {
-            fileList.removeAt(i);
-            i--;
-            std::ostringstream strs;
-            strs << QFilePath.toStdString() << std::endl
-                 << "This is not a vtk/vtp file."<< std::endl;
-            QMessageBox::critical(this,"Wrong file format",QString(strs.str().c_str()), QMessageBox::Ok);
-        }
-        else if(!fileList[i].exists())
-        {
-            fileList.removeAt(i);
-            i--;
-            std::ostringstream strs;
-            strs << QFilePath.toStdString() << std::endl
-                 << "This file does not exist."<< std::endl;
-            QMessageBox::critical(this,"File not found",QString(strs.str().c_str()), QMessageBox::Ok);
+            validFileList.append(fileList[i]);
+            validRows.push_back(rows[i]);
+            continue;
         }
+        if(numberOfErrors++ >= 20) continue;
+        strs << fileList[i].absoluteFilePath().toStdString() << " : "
+             << (status == FILE_WRONG_FORMAT ? "This is not a " + ShapePopulationReaders::GetFormatList() + " file." : "This file does not exist.") << std::endl;
+    }
+    if(numberOfErrors > 0)
+    {
+        if(numberOfErrors > 20) strs << "... and " << numberOfErrors - 20 << " more." << std::endl;
+        std::ostringstream title;
+        title << numberOfErrors << " of the " << fileList.size() << " files can not be loaded :" << std::endl;
+        QMessageBox::critical(this->parentWidget(),"Load CSV",QString((title.str() + strs.str()).c_str()), QMessageBox::Ok);
     }
 
-    emit sig_itemsSelected(fileList);
+    if(validFileList.isEmpty()) return;
+
+    // The other columns of the rows are the covariates of the meshes : file path first, then the values
+    QStringList columns;
+    for(vtkIdType j = 0; j < m_table->GetNumberOfColumns(); j++) columns.append(QString(m_table->GetColumnName(j)));
+    QList<QStringList> covariates;
+    for (int i = 0; i < validFileList.size(); i++)
+    {
+        QStringList values;
+        values.append(validFileList[i].absoluteFilePath());
+        for(vtkIdType j = 0; j < m_table->GetNumberOfColumns(); j++) values.append(QString(m_table->GetValue(validRows[i],j).ToString().c_str()));
+        covariates.append(values);
+    }
+    emit sig_covariatesLoaded(columns, covariates);
 
+    emit sig_itemsSelected(validFileList);
 }
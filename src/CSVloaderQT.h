@@ -5,12 +5,22 @@
 #include <QBoxLayout>
 #include <QFileInfo>
 #include <QDir>
+#include <QStringList>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include <QtConcurrentRun>
+#include <QtConcurrentMap>
+#include <QFutureWatcher>
+#include <QEventLoop>
 #include <sstream>
+#include <vector>
 
 #include <vtkQtTableView.h>
 #include <vtkIdTypeArray.h>
 #include <vtkTable.h>
+#include <vtkDelimitedTextReader.h>
+
+#include "ShapePopulationReaders.h"
 
 namespace Ui {
 class CSVloaderQT;
@@ -24,6 +34,7 @@ public:
     explicit CSVloaderQT(QWidget *Qparent = 0);
     ~CSVloaderQT();
 
+    void loadCSVFile(QFileInfo file);
     void displayTable(vtkSmartPointer<vtkTable> table, QDir directory);
     
 private slots:
@@ -31,8 +42,16 @@ private slots:
 
 signals:
     void sig_itemsSelected(QFileInfoList fileList);
+    void sig_covariatesLoaded(QStringList columns, QList<QStringList> covariates);
 
 private:
+    // Problems of the files of the CSV
+    enum fileStatus {FILE_OK, FILE_WRONG_FORMAT, FILE_NOT_FOUND};
+
+    static vtkSmartPointer<vtkTable> readTable(std::string filePath);
+    static int checkFile(const QFileInfo &file);
+    void waitForFuture(QFutureWatcherBase * watcher);
+
     vtkSmartPointer<vtkQtTableView> m_tableView;
     vtkSmartPointer<vtkTable> m_table;
     QDir m_directory;
@@ -0,0 +1,409 @@
+#include "ShapePopulationAnimation.h"
+#include "ShapePopulationExport.h"
+
+#include <vtkMath.h>
+
+#include <cmath>
+#include <algorithm>
+
+struct AnimationFrames
+{
+    ShapePopulationAnimation * animation;
+    std::vector<vtkImageData *> * images;
+    std::vector<std::string> * filePaths;
+    std::vector<int> * written;
+    int format;
+};
+
+// Orientation of the camera : rows right, up and direction of projection reversed (focal point to position)
+static double spvCameraFrame(const cameraConfigStruct &a_camera, double a_frame[3][3])
+{
+    double back[3] = {a_camera.pos_x - a_camera.foc_x, a_camera.pos_y - a_camera.foc_y, a_camera.pos_z - a_camera.foc_z};
+    double up[3] = {a_camera.view_vx, a_camera.view_vy, a_camera.view_vz};
+    double distance = vtkMath::Normalize(back);
+    double dot = vtkMath::Dot(up, back);
+    for(int k = 0; k < 3; k++) up[k] -= dot*back[k];
+    vtkMath::Normalize(up);
+    vtkMath::Cross(up, back, a_frame[0]);
+    for(int k = 0; k < 3; k++)
+    {
+        a_frame[1][k] = up[k];
+        a_frame[2][k] = back[k];
+    }
+    return distance;
+}
+
+ShapePopulationAnimation::ShapePopulationAnimation()
+{
+    m_Output = PNG_SEQUENCE;
+    m_Video = NULL;
+    m_VideoSize[0] = m_VideoSize[1] = 0;
+    m_QueueSize = 8;
+    m_NumberOfPushedFrames = 0;
+    m_NumberOfWrittenFrames = 0;
+    m_Closed = true;
+    m_Aborted = false;
+    m_Lock = vtkSmartPointer<vtkMutexLock>::New();
+    m_Condition = vtkSmartPointer<vtkConditionVariable>::New();
+}
+
+ShapePopulationAnimation::~ShapePopulationAnimation()
+{
+    for(unsigned int i = 0; i < m_Queue.size(); i++) m_Queue[i].image->UnRegister(NULL);
+    if(m_Video != NULL) fclose(m_Video);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          CAMERA PATH                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationAnimation::ClearKeyframes()
+{
+    m_Keyframes.clear();
+}
+
+void ShapePopulationAnimation::AddKeyframe(double a_time, cameraConfigStruct a_camera)
+{
+    Keyframe keyframe;
+    keyframe.time = a_time;
+    keyframe.camera = a_camera;
+    unsigned int position = m_Keyframes.size();
+    while(position > 0 && m_Keyframes[position - 1].time > a_time) position--;
+    m_Keyframes.insert(m_Keyframes.begin() + position, keyframe);
+}
+
+double ShapePopulationAnimation::GetDuration()
+{
+    if(m_Keyframes.empty()) return 0.0;
+    return m_Keyframes.back().time - m_Keyframes.front().time;
+}
+
+void ShapePopulationAnimation::CreateOrbit(cameraConfigStruct a_camera, double a_degrees, double a_duration)
+{
+    // Keyframes at most a quarter of turn apart : the interpolation between them is the rotation around the view up
+    this->ClearKeyframes();
+    int steps = std::max(1, (int)ceil(fabs(a_degrees)/90.0 - 1e-9));
+    for(int i = 0; i <= steps; i++) this->AddKeyframe(a_duration*i/steps, Orbit(a_camera, a_degrees*i/steps));
+}
+
+void ShapePopulationAnimation::CreateViewTour(cameraConfigStruct a_camera, double a_duration)
+{
+    // Around the mesh (A, L, P, R), then above and below it (S, I)
+    int views[8][6] = {{0, 1, 0, 0, 0, 1}, {-1, 0, 0, 0, 0, 1}, {0, -1, 0, 0, 0, 1}, {1, 0, 0, 0, 0, 1},
+                       {0, 1, 0, 0, 0, 1}, {0, 0, 1, 0, 1, 0}, {0, 0, -1, 0, 1, 0}, {0, 1, 0, 0, 0, 1}};
+    this->ClearKeyframes();
+    for(int i = 0; i < 8; i++)
+    {
+        int * v = views[i];
+        this->AddKeyframe(a_duration*i/7.0, PresetView(a_camera, v[0], v[1], v[2], v[3], v[4], v[5]));
+    }
+}
+
+cameraConfigStruct ShapePopulationAnimation::GetCamera(double a_time)
+{
+    if(m_Keyframes.empty())
+    {
+        cameraConfigStruct camera = {0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0};
+        return camera;
+    }
+    if(a_time <= m_Keyframes.front().time) return m_Keyframes.front().camera;
+    if(a_time >= m_Keyframes.back().time) return m_Keyframes.back().camera;
+
+    unsigned int next = 1;
+    while(m_Keyframes[next].time < a_time) next++;
+    const Keyframe &first = m_Keyframes[next - 1];
+    const Keyframe &second = m_Keyframes[next];
+    double length = second.time - first.time;
+    if(length <= 0.0) return second.camera;
+    return Interpolate(first.camera, second.camera, (a_time - first.time)/length);
+}
+
+cameraConfigStruct ShapePopulationAnimation::Interpolate(const cameraConfigStruct &a_first, const cameraConfigStruct &a_second, double a_t)
+{
+    // The orientation is interpolated as a rotation (quaternions), the distance to the focal point linearly
+    double firstFrame[3][3], secondFrame[3][3];
+    double firstDistance = spvCameraFrame(a_first, firstFrame);
+    double secondDistance = spvCameraFrame(a_second, secondFrame);
+    double q0[4], q1[4], q[4];
+    vtkMath::Matrix3x3ToQuaternion(firstFrame, q0);
+    vtkMath::Matrix3x3ToQuaternion(secondFrame, q1);
+
+    double dot = q0[0]*q1[0] + q0[1]*q1[1] + q0[2]*q1[2] + q0[3]*q1[3];
+    if(dot < 0.0)
+    {
+        dot = -dot;
+        for(int k = 0; k < 4; k++) q1[k] = -q1[k];
+    }
+    double w0 = 1.0 - a_t;
+    double w1 = a_t;
+    if(dot < 0.9995)
+    {
+        double theta = acos(dot);
+        w0 = sin((1.0 - a_t)*theta)/sin(theta);
+        w1 = sin(a_t*theta)/sin(theta);
+    }
+    double norm = 0.0;
+    for(int k = 0; k < 4; k++)
+    {
+        q[k] = w0*q0[k] + w1*q1[k];
+        norm += q[k]*q[k];
+    }
+    norm = sqrt(norm);
+    for(int k = 0; k < 4; k++) q[k] /= norm;
+
+    double frame[3][3];
+    vtkMath::QuaternionToMatrix3x3(q, frame);
+    double distance = (1.0 - a_t)*firstDistance + a_t*secondDistance;
+
+    cameraConfigStruct camera;
+    camera.foc_x = (1.0 - a_t)*a_first.foc_x + a_t*a_second.foc_x;
+    camera.foc_y = (1.0 - a_t)*a_first.foc_y + a_t*a_second.foc_y;
+    camera.foc_z = (1.0 - a_t)*a_first.foc_z + a_t*a_second.foc_z;
+    camera.pos_x = camera.foc_x + distance*frame[2][0];
+    camera.pos_y = camera.foc_y + distance*frame[2][1];
+    camera.pos_z = camera.foc_z + distance*frame[2][2];
+    camera.view_vx = frame[1][0];
+    camera.view_vy = frame[1][1];
+    camera.view_vz = frame[1][2];
+    camera.scale = (1.0 - a_t)*a_first.scale + a_t*a_second.scale;
+    return camera;
+}
+
+cameraConfigStruct ShapePopulationAnimation::Orbit(const cameraConfigStruct &a_camera, double a_degrees)
+{
+    // Rotation of the position around the view up going through the focal point (Rodrigues)
+    double axis[3] = {a_camera.view_vx, a_camera.view_vy, a_camera.view_vz};
+    double vector[3] = {a_camera.pos_x - a_camera.foc_x, a_camera.pos_y - a_camera.foc_y, a_camera.pos_z - a_camera.foc_z};
+    vtkMath::Normalize(axis);
+    double angle = vtkMath::RadiansFromDegrees(a_degrees);
+    double cross[3];
+    vtkMath::Cross(axis, vector, cross);
+    double dot = vtkMath::Dot(axis, vector);
+
+    cameraConfigStruct camera = a_camera;
+    double rotated[3];
+    for(int k = 0; k < 3; k++) rotated[k] = vector[k]*cos(angle) + cross[k]*sin(angle) + axis[k]*dot*(1.0 - cos(angle));
+    camera.pos_x = a_camera.foc_x + rotated[0];
+    camera.pos_y = a_camera.foc_y + rotated[1];
+    camera.pos_z = a_camera.foc_z + rotated[2];
+    return camera;
+}
+
+cameraConfigStruct ShapePopulationAnimation::PresetView(const cameraConfigStruct &a_camera, int R, int A, int S, int x_ViewUp, int y_ViewUp, int z_ViewUp)
+{
+    double vector[3] = {a_camera.pos_x - a_camera.foc_x, a_camera.pos_y - a_camera.foc_y, a_camera.pos_z - a_camera.foc_z};
+    double distance = vtkMath::Norm(vector);
+
+    cameraConfigStruct camera = a_camera;
+    camera.pos_x = a_camera.foc_x + R*distance;
+    camera.pos_y = a_camera.foc_y + A*distance;
+    camera.pos_z = a_camera.foc_z + S*distance;
+    camera.view_vx = x_ViewUp;
+    camera.view_vy = y_ViewUp;
+    camera.view_vz = z_ViewUp;
+    return camera;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             FRAMES                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationAnimation::Open(std::string a_filePath, int a_output, unsigned int a_queueSize, std::string &a_errorMessage)
+{
+    m_FilePath = a_filePath;
+    m_Output = a_output;
+    m_QueueSize = std::max(1u, a_queueSize);
+    m_NumberOfPushedFrames = 0;
+    m_NumberOfWrittenFrames = 0;
+    m_VideoSize[0] = m_VideoSize[1] = 0;
+    m_ErrorMessage = "";
+    m_Closed = false;
+    m_Aborted = false;
+
+    if(m_Output == RAW_VIDEO)
+    {
+        m_Video = fopen(a_filePath.c_str(), "wb");
+        if(m_Video == NULL)
+        {
+            a_errorMessage = "Couldn't write " + a_filePath;
+            m_Closed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string ShapePopulationAnimation::GetFramePath(int a_frame)
+{
+    // prefix_00000.png
+    std::string prefix = m_FilePath;
+    std::string::size_type extension = prefix.find_last_of('.');
+    std::string::size_type directory = prefix.find_last_of("/\\");
+    if(extension != std::string::npos && (directory == std::string::npos || extension > directory)) prefix = prefix.substr(0, extension);
+
+    char number[16];
+    sprintf(number, "_%05d", a_frame);
+    return prefix + number + ShapePopulationExport::GetExtension(m_Output == TIFF_SEQUENCE ? ShapePopulationExport::TIFF : ShapePopulationExport::PNG);
+}
+
+bool ShapePopulationAnimation::PushFrame(vtkImageData * a_frame)
+{
+    m_Lock->Lock();
+    while(m_Queue.size() >= m_QueueSize && !m_Aborted) m_Condition->Wait(m_Lock);
+    if(m_Aborted || m_Closed)
+    {
+        m_Lock->Unlock();
+        return false;
+    }
+    Frame frame;
+    frame.image = a_frame;
+    frame.index = m_NumberOfPushedFrames++;
+    a_frame->Register(NULL);
+    m_Queue.push_back(frame);
+    m_Condition->Broadcast();
+    m_Lock->Unlock();
+    return true;
+}
+
+void ShapePopulationAnimation::Close()
+{
+    m_Lock->Lock();
+    m_Closed = true;
+    m_Condition->Broadcast();
+    m_Lock->Unlock();
+}
+
+void ShapePopulationAnimation::Abort()
+{
+    m_Lock->Lock();
+    m_Aborted = true;
+    for(unsigned int i = 0; i < m_Queue.size(); i++) m_Queue[i].image->UnRegister(NULL);
+    m_Queue.clear();
+    m_Condition->Broadcast();
+    m_Lock->Unlock();
+}
+
+unsigned int ShapePopulationAnimation::GetNumberOfQueuedFrames()
+{
+    m_Lock->Lock();
+    unsigned int size = m_Queue.size();
+    m_Lock->Unlock();
+    return size;
+}
+
+bool ShapePopulationAnimation::WriteVideoFrame(vtkImageData * a_frame)
+{
+    int dims[3];
+    a_frame->GetDimensions(dims);
+    if(a_frame->GetScalarType() != VTK_UNSIGNED_CHAR || a_frame->GetNumberOfScalarComponents() != 3)
+    {
+        m_ErrorMessage = "The frames of a raw video must be RGB images";
+        return false;
+    }
+    if(m_VideoSize[0] == 0)
+    {
+        m_VideoSize[0] = dims[0];
+        m_VideoSize[1] = dims[1];
+    }
+    if(dims[0] != m_VideoSize[0] || dims[1] != m_VideoSize[1])
+    {
+        m_ErrorMessage = "The frames of a raw video must have the same size";
+        return false;
+    }
+
+    // rgb24 rows from the top, the images start at their bottom row
+    unsigned char * pixels = static_cast<unsigned char *>(a_frame->GetScalarPointer());
+    for(int y = dims[1] - 1; y >= 0; y--)
+    {
+        if(fwrite(pixels + 3*(vtkIdType)y*dims[0], 3, dims[0], m_Video) != (size_t)dims[0])
+        {
+            m_ErrorMessage = "Couldn't write " + m_FilePath;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShapePopulationAnimation::WriteImageBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    AnimationFrames * data = static_cast<AnimationFrames *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        (*data->written)[i] = ShapePopulationExport::WriteImage((*data->images)[i], (*data->filePaths)[i], data->format);
+    }
+}
+
+bool ShapePopulationAnimation::WriteFrames()
+{
+    SPV_PROFILE_SCOPE("WriteAnimationFrames");
+    bool success = true;
+    unsigned int batchSize = std::max(1, ShapePopulationParallel::GetNumberOfThreads());
+    while(true)
+    {
+        // The frames are taken in their order, a batch at a time
+        std::vector<Frame> frames;
+        m_Lock->Lock();
+        while(m_Queue.empty() && !m_Closed && !m_Aborted) m_Condition->Wait(m_Lock);
+        while(!m_Queue.empty() && frames.size() < batchSize)
+        {
+            frames.push_back(m_Queue.front());
+            m_Queue.pop_front();
+        }
+        bool aborted = m_Aborted;
+        m_Condition->Broadcast();
+        m_Lock->Unlock();
+        if(frames.empty()) break;
+
+        if(!aborted && m_Output == RAW_VIDEO)
+        {
+            for(unsigned int i = 0; i < frames.size() && success; i++) success = this->WriteVideoFrame(frames[i].image);
+        }
+        else if(!aborted)
+        {
+            std::vector<vtkImageData *> images;
+            std::vector<std::string> filePaths;
+            for(unsigned int i = 0; i < frames.size(); i++)
+            {
+                images.push_back(frames[i].image);
+                filePaths.push_back(this->GetFramePath(frames[i].index));
+            }
+            std::vector<int> written(frames.size(), 0);
+            AnimationFrames data;
+            data.animation = this;
+            data.images = &images;
+            data.filePaths = &filePaths;
+            data.written = &written;
+            data.format = (m_Output == TIFF_SEQUENCE) ? ShapePopulationExport::TIFF : ShapePopulationExport::PNG;
+            ShapePopulationParallel::For(frames.size(), 1, WriteImageBlock, &data);
+            for(unsigned int i = 0; i < written.size() && success; i++)
+            {
+                if(written[i]) continue;
+                m_ErrorMessage = "Couldn't write " + filePaths[i];
+                success = false;
+            }
+        }
+        for(unsigned int i = 0; i < frames.size(); i++) frames[i].image->UnRegister(NULL);
+
+        m_Lock->Lock();
+        if(success && !aborted) m_NumberOfWrittenFrames += frames.size();
+        m_Lock->Unlock();
+        if(!success)
+        {
+            this->Abort();                                              // the GUI stops rendering frames
+            break;
+        }
+    }
+
+    if(m_Video != NULL)
+    {
+        if(fclose(m_Video) != 0 && success)
+        {
+            m_ErrorMessage = "Couldn't write " + m_FilePath;
+            success = false;
+        }
+        m_Video = NULL;
+    }
+    return success;
+}
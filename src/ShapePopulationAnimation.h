@@ -0,0 +1,92 @@
+#ifndef SHAPEPOPULATIONANIMATION_H
+#define SHAPEPOPULATIONANIMATION_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+#include "cameraConfigStruct.h"
+
+#include <vtkImageData.h>
+#include <vtkConditionVariable.h>
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdio>
+
+// Camera animation of the population : a path of camera keyframes (turntable orbit, tour of the
+// anatomical views or keyframes of the user) is sampled over time, the GUI thread renders every frame
+// and pushes it in a queue of a fixed size, and a worker writes the frames as an image sequence
+// (encoded in parallel) or as a raw RGB video, in the order of the animation.
+class ShapePopulationAnimation
+{
+    public :
+
+    enum Output {PNG_SEQUENCE = 0, TIFF_SEQUENCE = 1, RAW_VIDEO = 2};
+
+    ShapePopulationAnimation();
+    ~ShapePopulationAnimation();
+
+    // CAMERA PATH
+    void ClearKeyframes();
+    void AddKeyframe(double a_time, cameraConfigStruct a_camera);     // in the order of the times
+    unsigned int GetNumberOfKeyframes() {return m_Keyframes.size();}
+    double GetDuration();
+    void CreateOrbit(cameraConfigStruct a_camera, double a_degrees, double a_duration);
+    void CreateViewTour(cameraConfigStruct a_camera, double a_duration);
+    cameraConfigStruct GetCamera(double a_time);
+
+    static cameraConfigStruct Interpolate(const cameraConfigStruct &a_first, const cameraConfigStruct &a_second, double a_t);
+    static cameraConfigStruct Orbit(const cameraConfigStruct &a_camera, double a_degrees);
+    // Same directions as ShapePopulationBase::ChangeView, around the focal point of the camera
+    static cameraConfigStruct PresetView(const cameraConfigStruct &a_camera, int R, int A, int S, int x_ViewUp, int y_ViewUp, int z_ViewUp);
+
+    // FRAMES
+    bool Open(std::string a_filePath, int a_output, unsigned int a_queueSize, std::string &a_errorMessage);
+    bool PushFrame(vtkImageData * a_frame);                             // waits while the queue is full
+    void Close();                                                       // no more frames
+    void Abort();
+    bool WriteFrames();                                                 // worker, until the queue is closed
+    unsigned int GetNumberOfQueuedFrames();
+    unsigned int GetQueueSize() {return m_QueueSize;}
+    int GetNumberOfWrittenFrames() {return m_NumberOfWrittenFrames;}
+    std::string GetFramePath(int a_frame);
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+
+    protected :
+
+    struct Keyframe
+    {
+        double time;
+        cameraConfigStruct camera;
+    };
+
+    struct Frame
+    {
+        vtkImageData * image;
+        int index;
+    };
+
+    std::vector<Keyframe> m_Keyframes;
+
+    std::string m_FilePath;                                             // video, or prefix of the images
+    int m_Output;
+    FILE * m_Video;
+    int m_VideoSize[2];
+    std::deque<Frame> m_Queue;
+    unsigned int m_QueueSize;
+    int m_NumberOfPushedFrames;
+    int m_NumberOfWrittenFrames;
+    bool m_Closed;
+    bool m_Aborted;
+    std::string m_ErrorMessage;
+    vtkSmartPointer<vtkMutexLock> m_Lock;
+    vtkSmartPointer<vtkConditionVariable> m_Condition;
+
+    bool WriteVideoFrame(vtkImageData * a_frame);
+    static void WriteImageBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
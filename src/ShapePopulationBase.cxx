@@ -23,6 +23,15 @@ namespace spv_math
     }
 }
 
+// Adaptive quality : meshes smaller than this are not decimated
+static const vtkIdType s_lodMinimumNumberOfPoints = 10000;
+static const double s_lodTargetReduction = 0.9;
+static const unsigned int s_numberOfFrameTimes = 64;
+static const int s_lowestQualityLevel = 4;
+
+// Vertex picking : radius of the marker, relative to the diagonal of the mesh
+static const double s_vertexMarkerRadius = 0.015;
+
 
 ShapePopulationBase::ShapePopulationBase()
 {
@@ -45,6 +54,15 @@ ShapePopulationBase::ShapePopulationBase()
     m_displaySphere = true;
     m_noUpdateVectorsByDirection = false;
     m_createSphere.push_back(false);
+    m_adaptiveQuality = true;
+    m_targetFrameRate = 15.0;
+    m_qualityLevel = 0;
+    m_interacting = false;
+    m_frameCount = 0;
+    m_memoryBudget = 0;
+    m_pickedVertex = -1;
+    m_displayLabels = false;
+    m_displayTensors = false;
 }
 
 void ShapePopulationBase::setBackgroundSelectedColor(double a_selectedColor[])
@@ -127,6 +145,12 @@ void ShapePopulationBase::CreateNewWindow(std::string a_filePath)
     //DATA
     ShapePopulationData * Mesh = new ShapePopulationData;
     Mesh->ReadMesh(a_filePath);
+    this->CreateNewWindow(Mesh);
+}
+
+void ShapePopulationBase::CreateNewWindow(ShapePopulationData * Mesh)
+{
+    SPV_PROFILE_SCOPE("CreateNewWindow");
     m_meshList.push_back(Mesh);
     
     //MAPPER
@@ -160,8 +184,22 @@ void ShapePopulationBase::CreateNewWindow(std::string a_filePath)
     glyph->SetColorModeToColorByVector();
     glyph->SetScaleModeToScaleByVector();
     glyph->SetVectorModeToUseVector();
+    glyph->AddObserver(vtkCommand::StartEvent, this, &ShapePopulationBase::ProfileStartEventVTK);
+    glyph->AddObserver(vtkCommand::EndEvent, this, &ShapePopulationBase::ProfileEndEventVTK);
     glyph->Update();
     m_glyphList.push_back(glyph);
+
+    //Ellipsoids, fed by updateTensorGlyphs
+    vtkSmartPointer<vtkSphereSource> ellipsoid = vtkSmartPointer<vtkSphereSource>::New();
+    ellipsoid->SetThetaResolution(12);
+    ellipsoid->SetPhiResolution(8);
+    vtkSmartPointer<vtkTensorGlyph> tensorGlyph = vtkSmartPointer<vtkTensorGlyph>::New();
+    tensorGlyph->SetSourceConnection(ellipsoid->GetOutputPort());
+    tensorGlyph->ExtractEigenvaluesOn();
+    tensorGlyph->ColorGlyphsOn();
+    tensorGlyph->SetColorModeToScalars();
+    tensorGlyph->ScalingOn();
+    m_tensorGlyphList.push_back(tensorGlyph);
     
     //Mapper & Actor
     vtkSmartPointer<vtkPolyDataMapper> glyphMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -306,20 +344,21 @@ void ShapePopulationBase::ClickEvent(vtkObject* a_selectedObject, unsigned long,
     }
     selectedWindow->GetRenderers()->GetFirstRenderer()->SetActiveCamera(m_headcam);                 //Set renderWindow to headcam
     m_selectedIndex.push_back(index);                                               //Add to the selectedWindows List
+    this->restoreMeshData(index);                                                   //Rebuild what the memory budget released
     
     // IF MULTIPLE SELECTION
     if(m_selectedIndex.size() > 1)
     {
         // Update colormap to the first selected window position
-        const char * cmap = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
-        const char * cmap_newSelected = m_meshList[index]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+        const char * cmap = m_meshList[m_selectedIndex[0]]->GetActiveScalarsName();
+        const char * cmap_newSelected = m_meshList[index]->GetActiveScalarsName();
 
         if(strcmp(cmap,cmap_newSelected))
         {
             m_noUpdateVectorsByDirection = true;
         }
         this->UpdateAttribute(cmap, m_selectedIndex);
-        int dim = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(cmap)->GetNumberOfComponents();
+        int dim = m_meshList[m_selectedIndex[0]]->GetAttribute(cmap)->GetNumberOfComponents();
         if(dim == 1) this->UpdateColorMapByMagnitude(m_selectedIndex);
     }
     
@@ -342,6 +381,7 @@ void ShapePopulationBase::SelectAll()
     for(unsigned int i = 0; i < m_windowsList.size(); i++)
     {
         m_selectedIndex.push_back(i);
+        this->restoreMeshData(i);
         m_windowsList[i]->GetRenderers()->GetFirstRenderer()->SetActiveCamera(m_headcam); //connect to headcam for synchro
         m_windowsList[i]->GetRenderers()->GetFirstRenderer()->SetBackground(m_selectedColor);
         m_windowsList[i]->Render();
@@ -394,11 +434,35 @@ void ShapePopulationBase::CameraChangedEventVTK(vtkObject*, unsigned long, void*
 void ShapePopulationBase::StartEventVTK(vtkObject*, unsigned long, void*)
 {
     m_renderAllSelection = true;
+    m_interacting = true;
 }
 
 void ShapePopulationBase::EndEventVTK(vtkObject*, unsigned long, void*)
 {
     m_renderAllSelection = false;
+    m_interacting = false;
+
+    // Back to full quality (RenderSelection is not called again while m_renderAllSelection is false)
+    if(m_qualityLevel == 0) return;
+    this->setQualityLevel(0);
+    for (unsigned int i = 0; i < m_selectedIndex.size();i++)
+    {
+        m_windowsList[m_selectedIndex[i]]->Render();
+    }
+}
+
+void ShapePopulationBase::ProfileStartEventVTK(vtkObject* a_object, unsigned long, void*)
+{
+    ShapePopulationProfiler::BeginObject(a_object);
+}
+
+void ShapePopulationBase::ProfileEndEventVTK(vtkObject* a_object, unsigned long, void*)
+{
+    if(!ShapePopulationProfiler::IsEnabled()) return;
+    ShapePopulationProfiler::EndObject(a_object, "vtkGlyph3D");
+    ShapePopulationProfiler::AddCount("GlyphExecutions", 1);
+    vtkGlyph3D * glyph = vtkGlyph3D::SafeDownCast(a_object);
+    if(glyph != NULL) ShapePopulationProfiler::AddCount("MemoryAllocatedKB", glyph->GetOutput()->GetActualMemorySize());
 }
 
 
@@ -408,14 +472,17 @@ void ShapePopulationBase::EndEventVTK(vtkObject*, unsigned long, void*)
 
 void ShapePopulationBase::RenderAll()
 {
+    SPV_PROFILE_SCOPE("RenderAll");
     for (unsigned int i = 0; i < m_windowsList.size();i++)
     {
         m_windowsList[i]->Render();
     }
+    ShapePopulationProfiler::AddCount("WindowsRendered", m_windowsList.size());
 }
 void ShapePopulationBase::RenderSelection()
 {
     if(m_selectedIndex.size()==0 || m_renderAllSelection == false) return;
+    SPV_PROFILE_SCOPE("RenderSelection");
     
     int test_realtime = m_windowsList[m_selectedIndex[0]]->HasObserver(vtkCommand::RenderEvent);
     int test_delayed = m_windowsList[m_selectedIndex[0]]->HasObserver(vtkCommand::ModifiedEvent);
@@ -425,9 +492,24 @@ void ShapePopulationBase::RenderSelection()
         m_windowsList[m_selectedIndex[i]]->RemoveAllObservers();
     }
     
+    double frameStart = vtkTimerLog::GetUniversalTime();
+    unsigned int numberOfRenderedWindows = 0;
     for (unsigned int i = 0; i < m_selectedIndex.size();i++) //render all windows selected (one of them will be the event window)
     {
+        if(m_qualityLevel >= s_lowestQualityLevel && (i + m_frameCount) % 2 != 0) continue;        //lowest quality : every other tile on each pass
         m_windowsList[m_selectedIndex[i]]->Render();
+        numberOfRenderedWindows++;
+    }
+    ShapePopulationProfiler::AddCount("WindowsRendered", numberOfRenderedWindows);
+
+    //frame timing, the quality is lowered while the pass exceeds the frame budget
+    double frameTime = vtkTimerLog::GetUniversalTime() - frameStart;
+    if(m_frameTimes.size() < s_numberOfFrameTimes) m_frameTimes.push_back(frameTime);
+    else m_frameTimes[m_frameCount % s_numberOfFrameTimes] = frameTime;
+    m_frameCount++;
+    if(m_adaptiveQuality && m_interacting && m_targetFrameRate > 0 && frameTime > 1.0/m_targetFrameRate && m_qualityLevel < s_lowestQualityLevel)
+    {
+        this->setQualityLevel(m_qualityLevel + 1);
     }
     
     for (unsigned int i = 0; i < m_selectedIndex.size();i++) //attribuate the observers back to the windows the way it used to be
@@ -468,6 +550,131 @@ void ShapePopulationBase::RealTimeRenderSynchro(bool realtime)
 }
 
 
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       ADAPTIVE QUALITY                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationBase::setAdaptiveQuality(bool adaptive)
+{
+    m_adaptiveQuality = adaptive;
+    if(!adaptive && !m_interacting) this->setQualityLevel(0);
+}
+
+void ShapePopulationBase::setTargetFrameRate(double frameRate)
+{
+    m_targetFrameRate = frameRate;
+}
+
+void ShapePopulationBase::setQualityLevel(int level)
+{
+    if(level < 0) level = 0;
+    if(level > s_lowestQualityLevel) level = s_lowestQualityLevel;
+    if(level == m_qualityLevel) return;
+
+    // Visibilities the user chose, saved when the quality is first lowered
+    if(m_qualityLevel == 0) m_qualityVisibility.assign(4*m_windowsList.size(), 1);
+
+    for (unsigned int i = 0; i < m_windowsList.size() && i < m_meshList.size(); i++)
+    {
+        vtkRenderer * renderer = m_windowsList[i]->GetRenderers()->GetFirstRenderer();
+        vtkActorCollection * actors = renderer->GetActors();
+        vtkSmartPointer<vtkPropCollection> propCollection = renderer->GetViewProps();
+
+        // 1 : glyphs
+        vtkActor * glyphActor = actors->GetLastActor();
+        if(m_qualityLevel < 1 && level >= 1)
+        {
+            m_qualityVisibility[4*i] = glyphActor->GetVisibility();
+            glyphActor->SetVisibility(0);
+        }
+        else if(m_qualityLevel >= 1 && level < 1) glyphActor->SetVisibility(m_qualityVisibility[4*i]);
+
+        // 2 : decimated meshes
+        if((m_qualityLevel < 2) != (level < 2))
+        {
+            actors->InitTraversal();
+            vtkPolyDataMapper * mapper = vtkPolyDataMapper::SafeDownCast(actors->GetNextActor()->GetMapper());
+            vtkSmartPointer<vtkPolyData> polyData = (level >= 2) ? this->getLODMesh(m_meshList[i]) : m_meshList[i]->GetPolyData();
+#if (VTK_MAJOR_VERSION < 6)
+            mapper->SetInputConnection(polyData->GetProducerPort());
+#else
+            mapper->SetInputData(polyData);
+#endif
+        }
+
+        // 3 : annotations and scalar bar
+        for (int j = 0; j < 3; j++)
+        {
+            vtkProp * prop = (vtkProp*)propCollection->GetItemAsObject(2 + j);
+            if(prop == NULL) continue;
+            if(m_qualityLevel < 3 && level >= 3)
+            {
+                m_qualityVisibility[4*i + 1 + j] = prop->GetVisibility();
+                prop->SetVisibility(0);
+            }
+            else if(m_qualityLevel >= 3 && level < 3) prop->SetVisibility(m_qualityVisibility[4*i + 1 + j]);
+        }
+    }
+
+    // 4 : handled by RenderSelection
+    m_qualityLevel = level;
+    ShapePopulationProfiler::AddCount("QualityChanges", 1);
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationBase::getLODMesh(ShapePopulationData * a_mesh)
+{
+    SPV_PROFILE_SCOPE("getLODMesh");
+    vtkSmartPointer<vtkPolyData> polyData = a_mesh->GetPolyData();
+    if(polyData->GetNumberOfPoints() < s_lodMinimumNumberOfPoints) return polyData;
+
+    // The decimated triangles have no cell values to colour
+    if(polyData->GetPointData()->GetScalars() == NULL && polyData->GetCellData()->GetScalars() != NULL) return polyData;
+
+    // Forget the meshes which were deleted
+    std::map< ShapePopulationData *, vtkSmartPointer<vtkPolyData> >::iterator it = m_lodMeshes.begin();
+    while(it != m_lodMeshes.end())
+    {
+        if(std::find(m_meshList.begin(), m_meshList.end(), it->first) == m_meshList.end()) m_lodMeshes.erase(it++);
+        else ++it;
+    }
+
+    // Decimated again when the mesh or its attributes changed, DecimatePro keeps the point data of the kept points
+    it = m_lodMeshes.find(a_mesh);
+    if(it != m_lodMeshes.end() && it->second->GetMTime() > polyData->GetMTime()) return it->second;
+
+    vtkSmartPointer<vtkDecimatePro> decimate = vtkSmartPointer<vtkDecimatePro>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    decimate->SetInput(polyData);
+#else
+    decimate->SetInputData(polyData);
+#endif
+    decimate->SetTargetReduction(s_lodTargetReduction);
+    decimate->PreserveTopologyOn();
+    decimate->Update();
+
+    vtkSmartPointer<vtkPolyData> lodMesh = vtkSmartPointer<vtkPolyData>::New();
+    lodMesh->ShallowCopy(decimate->GetOutput());
+    m_lodMeshes[a_mesh] = lodMesh;
+    return lodMesh;
+}
+
+void ShapePopulationBase::getFrameStatistics(double &a_last, double &a_mean, double &a_maximum)
+{
+    a_last = 0.0;
+    a_mean = 0.0;
+    a_maximum = 0.0;
+    if(m_frameTimes.empty()) return;
+
+    a_last = m_frameTimes[(m_frameCount - 1) % m_frameTimes.size()];
+    for(unsigned int i = 0; i < m_frameTimes.size(); i++)
+    {
+        a_mean += m_frameTimes[i];
+        a_maximum = std::max(a_maximum, m_frameTimes[i]);
+    }
+    a_mean /= m_frameTimes.size();
+}
+
+
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
 // *                                           COLORMAP                                            * //
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
@@ -506,12 +713,39 @@ void ShapePopulationBase::computeCommonAttributes()
     }
 }
 
+void ShapePopulationBase::computeCommonAttributes(std::vector<ShapePopulationHeader> &a_headers)
+{
+    this->computeCommonAttributes();
+
+    // The headers of a population can only remove attributes : the loaded meshes must have them. The attributes
+    // no file has (distances, statistics maps, shape modes) are computed in memory, the headers don't know them
+    std::set<std::string> fileAttributes;
+    for (unsigned int i = 0; i < a_headers.size(); i++)
+    {
+        if(!a_headers[i].IsValid()) continue;
+        std::vector<std::string> attributes = a_headers[i].GetAttributeList();
+        fileAttributes.insert(attributes.begin(), attributes.end());
+    }
+    if(fileAttributes.empty()) return;
+
+    std::vector<std::string> headerAttributes = ShapePopulationHeader::ComputeCommonAttributes(a_headers);
+    std::vector<std::string> commonAttributes;
+    for (unsigned int i = 0; i < m_commonAttributes.size(); i++)
+    {
+        const std::string &attribute = m_commonAttributes[i];
+        if(fileAttributes.find(attribute) == fileAttributes.end() ||
+           std::binary_search(headerAttributes.begin(), headerAttributes.end(), attribute)) commonAttributes.push_back(attribute);
+    }
+    m_commonAttributes = commonAttributes;
+}
+
 double * ShapePopulationBase::computeCommonRange(const char * a_cmap, std::vector< unsigned int > a_windowIndex)
 {
     double * commonRange = NULL; //to avoid warning for not being initialized
     for (unsigned int i = 0; i < a_windowIndex.size(); i++)
     {
-        double * newRange = m_meshList[a_windowIndex[i]]->GetPolyData()->GetPointData()->GetScalars(a_cmap)->GetRange();
+        m_meshList[a_windowIndex[i]]->RestoreMagnitudes();                          //released by the memory budget
+        double * newRange = m_meshList[a_windowIndex[i]]->GetAttribute(a_cmap)->GetRange();
         
         if(i==0) commonRange = newRange;
         else
@@ -526,6 +760,7 @@ double * ShapePopulationBase::computeCommonRange(const char * a_cmap, std::vecto
 
 void ShapePopulationBase::UpdateColorMapByDirection(const char * cmap,int index)
 {
+    SPV_PROFILE_SCOPE("UpdateColorMapByDirection");
     for (unsigned int i = 0; i < m_selectedIndex.size(); i++)
     {
         ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
@@ -622,14 +857,21 @@ void ShapePopulationBase::UpdateColorMapByDirection(const char * cmap,int index)
 
         }
         mesh->GetPolyData()->GetPointData()->AddArray(scalars);
+        ShapePopulationProfiler::AddCount("MemoryAllocatedKB", scalars->GetActualMemorySize());
     }
 
 }
 
 void ShapePopulationBase::UpdateAttribute(const char * a_cmap, std::vector< unsigned int > a_windowIndex)
 {
+    SPV_PROFILE_SCOPE("UpdateAttribute");
+    for (unsigned int i = 0; i < a_windowIndex.size(); i++)
+    {
+        m_meshList[a_windowIndex[i]]->RestoreMagnitudes();                          //released by the memory budget
+        m_meshList[a_windowIndex[i]]->ConvertCellVectors(a_cmap);                   //glyphs at the points, cell scalars stay on the cells
+    }
     /* FIND DIMENSION OF ATTRIBUTE */
-    int dim = m_meshList[a_windowIndex[0]]->GetPolyData()->GetPointData()->GetScalars(a_cmap)->GetNumberOfComponents();
+    int dim = m_meshList[a_windowIndex[0]]->GetAttribute(a_cmap)->GetNumberOfComponents();
 
     //test if _mag => in that case, we will take the cmap without _mag for the vectors
     std::string cmap = std::string(a_cmap);
@@ -666,10 +908,10 @@ void ShapePopulationBase::UpdateAttribute(const char * a_cmap, std::vector< unsi
             vtkSmartPointer<vtkActor> glyphActor = window->GetRenderers()->GetFirstRenderer()->GetActors()->GetLastActor();
             
             // Set Active Scalars
-            mesh->GetPolyData()->GetPointData()->SetActiveScalars(a_cmap);
+            mesh->SetActiveScalars(a_cmap);
             
-            // Glyph visibility
-            glyphActor->SetVisibility(0);
+            // Glyph visibility : the ellipsoids of a tensor attribute
+            glyphActor->SetVisibility(this->updateTensorGlyphs(a_windowIndex[i]) ? 1 : 0);
         }
 
         // Compute the largest range
@@ -704,13 +946,13 @@ void ShapePopulationBase::UpdateAttribute(const char * a_cmap, std::vector< unsi
             // display colormap by direction
             if(m_displayColorMapByDirection[a_windowIndex[i]])
             {
-                mesh->GetPolyData()->GetPointData()->SetActiveScalars(strs_dir.str().c_str());
+                mesh->SetActiveScalars(strs_dir.str().c_str());
             }
             
             // display colormap by magnitude
             else
             {
-                mesh->GetPolyData()->GetPointData()->SetActiveScalars(strs_mag.str().c_str());
+                mesh->SetActiveScalars(strs_mag.str().c_str());
             }
 
 
@@ -719,6 +961,7 @@ void ShapePopulationBase::UpdateAttribute(const char * a_cmap, std::vector< unsi
             vtkSmartPointer<vtkGlyph3D> glyph = m_glyphList[a_windowIndex[i]];
             glyph->SetSourceConnection(arrow->GetOutputPort());
             glyph->Update();
+            this->updateTensorGlyphs(a_windowIndex[i]);                             //back to the arrows
             
             // Vectors
             if(!m_noUpdateVectorsByDirection)
@@ -762,6 +1005,7 @@ void ShapePopulationBase::UpdateAttribute(const char * a_cmap, std::vector< unsi
 
 void ShapePopulationBase::displayColorMapByMagnitude(bool display)
 {
+    SPV_PROFILE_SCOPE("displayColorMapByMagnitude");
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
         if(display) m_displayColorMapByMagnitude[m_selectedIndex[i]] = true ;
@@ -771,7 +1015,7 @@ void ShapePopulationBase::displayColorMapByMagnitude(bool display)
         {
             // display of the color map by magnitude
             ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
-            const char * a_cmap = mesh->GetPolyData()->GetPointData()->GetScalars()->GetName();
+            const char * a_cmap = mesh->GetActiveScalarsName();
             std::string cmap = std::string(a_cmap);
             std::string key1 ("_ColorByDirection");
             size_t found = cmap.rfind(key1);
@@ -782,7 +1026,7 @@ void ShapePopulationBase::displayColorMapByMagnitude(bool display)
             strs << cmap;
 
             // Set Active Scalars
-            mesh->GetPolyData()->GetPointData()->SetActiveScalars(strs.str().c_str());
+            mesh->SetActiveScalars(strs.str().c_str());
 
             // Hide or show the scalar bar
             vtkSmartPointer<vtkPropCollection> propCollection =  m_windowsList[m_selectedIndex[i]]->GetRenderers()->GetFirstRenderer()->GetViewProps();
@@ -810,6 +1054,7 @@ void ShapePopulationBase::displayColorMapByMagnitude(bool display)
 
 void ShapePopulationBase::displayColorMapByDirection(bool display)
 {
+    SPV_PROFILE_SCOPE("displayColorMapByDirection");
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
         if(display) m_displayColorMapByDirection[m_selectedIndex[i]] = true ;
@@ -819,7 +1064,7 @@ void ShapePopulationBase::displayColorMapByDirection(bool display)
         {
             // display of the color map by direction
             ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
-            const char * a_cmap = mesh->GetPolyData()->GetPointData()->GetScalars()->GetName();
+            const char * a_cmap = mesh->GetActiveScalarsName();
             std::string cmap = std::string(a_cmap);
             std::string key1 ("_mag");
             size_t found = cmap.rfind(key1);
@@ -827,7 +1072,7 @@ void ShapePopulationBase::displayColorMapByDirection(bool display)
                 cmap.replace (found,key1.length(),"_ColorByDirection");
 
             // Set Active Scalars for the ColorMap
-            mesh->GetPolyData()->GetPointData()->SetActiveScalars(cmap.c_str());
+            mesh->SetActiveScalars(cmap.c_str());
 
             // Hide or show the scalar bar
             vtkSmartPointer<vtkPropCollection> propCollection =  m_windowsList[m_selectedIndex[i]]->GetRenderers()->GetFirstRenderer()->GetViewProps();
@@ -847,8 +1092,24 @@ void ShapePopulationBase::displayColorMapByDirection(bool display)
 
 void ShapePopulationBase::UpdateColorMapByMagnitude(std::vector< unsigned int > a_windowIndex)
 {
+    SPV_PROFILE_SCOPE("UpdateColorMapByMagnitude");
     for (unsigned int i = 0; i < a_windowIndex.size(); i++)
     {
+        //Label Mode : the same indexed colors in every window, shared by the mappers and the scalar bar
+        if(m_displayLabels && this->updateLabels(m_meshList[a_windowIndex[i]]->GetActiveScalarsName()))
+        {
+            vtkRenderer * renderer = m_windowsList[a_windowIndex[i]]->GetRenderers()->GetFirstRenderer();
+            vtkActorCollection * actors = renderer->GetActors();
+            actors->InitTraversal();
+            vtkMapper * mapper = actors->GetNextActor()->GetMapper();
+            mapper->SetLookupTable(m_labels.GetLookupTable());
+            mapper->ScalarVisibilityOn();
+            actors->GetLastActor()->GetMapper()->SetLookupTable(m_labels.GetLookupTable());
+            vtkScalarBarActor * scalarBar = (vtkScalarBarActor*)renderer->GetViewProps()->GetItemAsObject(4);
+            scalarBar->SetLookupTable(m_labels.GetLookupTable());
+            continue;
+        }
+
         //Look Up table
         vtkSmartPointer<vtkColorTransferFunction> DistanceMapTFunc = vtkSmartPointer<vtkColorTransferFunction>::New();
         double range = fabs(m_usedColorBar->range[1] - m_usedColorBar->range[0]);
@@ -897,6 +1158,104 @@ void ShapePopulationBase::UpdateColorMapByMagnitude(std::vector< unsigned int >
 }
 
 
+bool ShapePopulationBase::updateLabels(std::string a_attribute)
+{
+    if(a_attribute.empty()) return false;
+
+    // Scanned again when the attribute or the meshes loaded changed
+    if(!m_labels.IsComputed(m_meshList, a_attribute)) m_labels.Compute(m_meshList, a_attribute);
+    return m_labels.IsCategorical();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            TENSORS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationBase::displayTensors(bool display)
+{
+    m_displayTensors = display;
+    for (unsigned int i = 0; i < m_selectedIndex.size(); i++)
+    {
+        vtkActor * glyphActor = m_windowsList[m_selectedIndex[i]]->GetRenderers()->GetFirstRenderer()->GetActors()->GetLastActor();
+        if(this->updateTensorGlyphs(m_selectedIndex[i])) glyphActor->SetVisibility(1);
+        else if(m_meshList[m_selectedIndex[i]]->IsDerivedAttribute(m_meshList[m_selectedIndex[i]]->GetActiveScalarsName())) glyphActor->SetVisibility(0);
+    }
+}
+
+bool ShapePopulationBase::updateTensorGlyphs(unsigned int a_index)
+{
+    SPV_PROFILE_SCOPE("updateTensorGlyphs");
+    ShapePopulationData * mesh = m_meshList[a_index];
+    vtkActor * glyphActor = m_windowsList[a_index]->GetRenderers()->GetFirstRenderer()->GetActors()->GetLastActor();
+    vtkPolyDataMapper * glyphMapper = vtkPolyDataMapper::SafeDownCast(glyphActor->GetMapper());
+    vtkTensorGlyph * tensorGlyph = m_tensorGlyphList[a_index];
+
+    std::string attribute = mesh->GetActiveScalarsName();
+    vtkDataArray * tensors = NULL;
+    vtkDataArray * scalars = NULL;
+    if(m_displayTensors && mesh->GetTensorSource(attribute) != "")
+    {
+        tensors = mesh->GetTensors(attribute);
+        scalars = mesh->GetPointAttribute(attribute);
+    }
+
+    // Arrows of the vector attributes
+    if(tensors == NULL || scalars == NULL)
+    {
+        if(glyphMapper->GetInput() == tensorGlyph->GetOutput())
+        {
+#if (VTK_MAJOR_VERSION < 6)
+            glyphMapper->SetInputConnection(m_glyphList[a_index]->GetOutputPort());
+#else
+            glyphMapper->SetInputData(m_glyphList[a_index]->GetOutput());
+#endif
+            tensorGlyph->GetOutput()->ReleaseData();
+        }
+        return false;
+    }
+
+    // Tensors and colors at the points, at most 5000 ellipsoids
+    vtkSmartPointer<vtkPolyData> points = vtkSmartPointer<vtkPolyData>::New();
+    points->SetPoints(mesh->GetPolyData()->GetPoints());
+    points->GetPointData()->SetTensors(tensors);
+    points->GetPointData()->SetScalars(scalars);
+    vtkSmartPointer<vtkMaskPoints> mask = vtkSmartPointer<vtkMaskPoints>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    mask->SetInputConnection(points->GetProducerPort());
+#else
+    mask->SetInputData(points);
+#endif
+    vtkIdType numberOfPoints = points->GetNumberOfPoints();
+    mask->SetOnRatio(std::max((vtkIdType)1, numberOfPoints/5000));
+    mask->GenerateVerticesOff();
+
+    // The largest ellipsoid a few percent of the mesh : the norm of a tensor bounds its eigenvalues
+    double maximum = 0.0;
+    for(vtkIdType j = 0; j < tensors->GetNumberOfTuples(); j++)
+    {
+        double * t = tensors->GetTuple9(j);
+        double norm = 0.0;
+        for(int k = 0; k < 9; k++) norm += t[k]*t[k];
+        maximum = std::max(maximum, norm);
+    }
+    maximum = sqrt(maximum);
+    double scale = (maximum > 0.0) ? 0.05*mesh->GetPolyData()->GetLength()/maximum : 1.0;
+
+    tensorGlyph->SetInputConnection(mask->GetOutputPort());
+    tensorGlyph->SetScaleFactor(scale);
+    tensorGlyph->Update();
+#if (VTK_MAJOR_VERSION < 6)
+    glyphMapper->SetInputConnection(tensorGlyph->GetOutputPort());
+#else
+    glyphMapper->SetInputData(tensorGlyph->GetOutput());
+#endif
+    glyphMapper->ScalarVisibilityOn();
+    ShapePopulationProfiler::AddCount("TensorGlyphs", mask->GetOutput()->GetNumberOfPoints());
+    return true;
+}
+
+
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
 // *                                            VECTORS                                            * //
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
@@ -932,6 +1291,7 @@ void ShapePopulationBase::setVectorScale(double value)
 
 void ShapePopulationBase::setVectorDensity(double value)
 {
+    SPV_PROFILE_SCOPE("setVectorDensity");
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
         m_vectorDensity[m_selectedIndex[i]] = value;
@@ -958,6 +1318,7 @@ void ShapePopulationBase::setVectorDensity(double value)
 
 void ShapePopulationBase::displayVectors(bool display)
 {
+    SPV_PROFILE_SCOPE("displayVectors");
 
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
@@ -965,7 +1326,7 @@ void ShapePopulationBase::displayVectors(bool display)
         else m_displayVectors[m_selectedIndex[i]] = false;
 
         // display of vectors
-        const char * a_cmap = m_meshList[m_selectedIndex[i]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+        const char * a_cmap = m_meshList[m_selectedIndex[i]]->GetActiveScalarsName();
         std::string cmap = std::string(a_cmap);
         std::string key1 ("_mag");
         size_t found = cmap.rfind(key1);
@@ -1031,6 +1392,7 @@ void ShapePopulationBase::displayVectors(bool display)
 
 void ShapePopulationBase::displayVectorsByMagnitude(bool display)
 {
+    SPV_PROFILE_SCOPE("displayVectorsByMagnitude");
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
         if(display) m_displayVectorsByMagnitude[m_selectedIndex[i]] = true ;
@@ -1039,7 +1401,7 @@ void ShapePopulationBase::displayVectorsByMagnitude(bool display)
         if(display)
         {
             // diplay of the color of vectors by magnitude
-            const char * a_cmap = m_meshList[m_selectedIndex[i]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+            const char * a_cmap = m_meshList[m_selectedIndex[i]]->GetActiveScalarsName();
             std::string cmap = std::string(a_cmap);
             size_t found = cmap.rfind("_mag");
             std::string new_cmap = cmap.substr(0,found);
@@ -1082,6 +1444,7 @@ void ShapePopulationBase::displayVectorsByMagnitude(bool display)
 
 void ShapePopulationBase::displayVectorsByDirection(bool display)
 {
+    SPV_PROFILE_SCOPE("displayVectorsByDirection");
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
         if(display) m_displayVectorsByDirection[m_selectedIndex[i]] =  true;
@@ -1091,7 +1454,7 @@ void ShapePopulationBase::displayVectorsByDirection(bool display)
         {
             //display of the color of vectors by direction
             ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
-            const char * a_cmap = mesh->GetPolyData()->GetPointData()->GetScalars()->GetName();
+            const char * a_cmap = mesh->GetActiveScalarsName();
             std::string cmap = std::string(a_cmap);
             size_t found = cmap.rfind("_mag");
             std::string new_cmap = cmap.substr(0,found);
@@ -1144,10 +1507,11 @@ void ShapePopulationBase::displayVectorsByDirection(bool display)
 
 void ShapePopulationBase::UpdateVectorsByDirection()
 {
+    SPV_PROFILE_SCOPE("UpdateVectorsByDirection");
     for(unsigned int i = 0; i < m_selectedIndex.size() ; i++)
     {
         ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
-        const char * a_cmap = mesh->GetPolyData()->GetPointData()->GetScalars()->GetName();
+        const char * a_cmap = mesh->GetActiveScalarsName();
         
         std::string cmap = std::string(a_cmap);
         size_t found = cmap.rfind("_mag");
@@ -1166,7 +1530,7 @@ void ShapePopulationBase::UpdateVectorsByDirection()
         strs_dir << new_cmap << "_ColorByDirection" << std::endl;
         
         // Set Active Scalars to color vectors
-        if(m_displayVectorsByDirection[m_selectedIndex[i]]) mesh->GetPolyData()->GetPointData()->SetActiveScalars(strs_dir.str().c_str());
+        if(m_displayVectorsByDirection[m_selectedIndex[i]]) mesh->SetActiveScalars(strs_dir.str().c_str());
 
         // Set Active Vectors
         mesh->GetPolyData()->GetPointData()->SetActiveVectors(strs.str().c_str());
@@ -1178,8 +1542,8 @@ void ShapePopulationBase::UpdateVectorsByDirection()
         glyph->Update();
         
         // Set Active Scalars to re-color the colormap
-        if(m_displayColorMapByMagnitude[m_selectedIndex[i]]) mesh->GetPolyData()->GetPointData()->SetActiveScalars(strs_mag.str().c_str());
-        else if (m_displayColorMapByDirection[m_selectedIndex[i]]) mesh->GetPolyData()->GetPointData()->SetActiveScalars(strs_dir.str().c_str());
+        if(m_displayColorMapByMagnitude[m_selectedIndex[i]]) mesh->SetActiveScalars(strs_mag.str().c_str());
+        else if (m_displayColorMapByDirection[m_selectedIndex[i]]) mesh->SetActiveScalars(strs_dir.str().c_str());
     }
     
 }
@@ -1191,6 +1555,7 @@ void ShapePopulationBase::UpdateVectorsByDirection()
 
 void ShapePopulationBase::displayColorbar(bool display)
 {
+    SPV_PROFILE_SCOPE("displayColorbar");
     for(unsigned int i = 0; i < m_windowsList.size() ; i++)
     {
         vtkSmartPointer<vtkPropCollection> propCollection =  m_windowsList[i]->GetRenderers()->GetFirstRenderer()->GetViewProps();
@@ -1215,6 +1580,7 @@ void ShapePopulationBase::displayColorbar(bool display)
 
 void ShapePopulationBase::displayAttribute(bool display)
 {
+    SPV_PROFILE_SCOPE("displayAttribute");
     for(unsigned int i = 0; i < m_windowsList.size() ; i++)
     {
         vtkSmartPointer<vtkPropCollection> propCollection =  m_windowsList[i]->GetRenderers()->GetFirstRenderer()->GetViewProps();
@@ -1239,6 +1605,7 @@ void ShapePopulationBase::displayAttribute(bool display)
 
 void ShapePopulationBase::displayMeshName(bool display)
 {
+    SPV_PROFILE_SCOPE("displayMeshName");
     for(unsigned int i = 0; i < m_windowsList.size() ; i++)
     {
         vtkSmartPointer<vtkPropCollection> propCollection =  m_windowsList[i]->GetRenderers()->GetFirstRenderer()->GetViewProps();
@@ -1263,6 +1630,7 @@ void ShapePopulationBase::displayMeshName(bool display)
 
 void ShapePopulationBase::displaySphere(bool display)
 {
+    SPV_PROFILE_SCOPE("displaySphere");
     for(unsigned int i = 0; i < m_windowsList.size() ; i++)
     {
         if(display)
@@ -1500,6 +1868,949 @@ void ShapePopulationBase::initializationAllWidgets()
     }
 }
 
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          HISTOGRAMS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationBase::updateHistograms()
+{
+    // Only the new or modified attributes are binned again
+    m_histograms.Update(m_meshList, m_commonAttributes);
+}
+
+bool ShapePopulationBase::computePercentileRange(std::string a_attribute, double a_lowPercentile, double a_highPercentile, double a_range[2])
+{
+    this->updateHistograms();
+    if(!m_histograms.HasAttribute(a_attribute) || m_selectedIndex.empty()) return false;
+
+    double range[2];
+    m_histograms.GetRange(a_attribute, range);
+    std::vector<double> histogram = m_histograms.GetMergedHistogram(a_attribute, m_selectedIndex);
+    a_range[0] = ShapePopulationHistogram::ComputePercentile(histogram, range, a_lowPercentile);
+    a_range[1] = ShapePopulationHistogram::ComputePercentile(histogram, range, a_highPercentile);
+    return true;
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          STATISTICS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationBase::getGroupMeshes(std::vector<ShapePopulationData *> &a_groupA, std::vector<ShapePopulationData *> &a_groupB)
+{
+    a_groupA.clear();
+    a_groupB.clear();
+    for (unsigned int i = 0; i < m_groupA.size(); i++)
+    {
+        if(m_groupA[i] < m_meshList.size()) a_groupA.push_back(m_meshList[m_groupA[i]]);
+    }
+    for (unsigned int i = 0; i < m_groupB.size(); i++)
+    {
+        if(m_groupB[i] < m_meshList.size()) a_groupB.push_back(m_meshList[m_groupB[i]]);
+    }
+
+    // The vectors are compared by their magnitude, released by the memory budget on the meshes not displayed
+    for (unsigned int i = 0; i < a_groupA.size(); i++) a_groupA[i]->RestoreMagnitudes();
+    for (unsigned int i = 0; i < a_groupB.size(); i++) a_groupB[i]->RestoreMagnitudes();
+}
+
+ShapePopulationData * ShapePopulationBase::createStatisticsMesh(ShapePopulationStatistics * a_statistics, std::string a_attribute, bool a_permutationTest)
+{
+    std::vector<ShapePopulationData *> groupA;
+    std::vector<ShapePopulationData *> groupB;
+    this->getGroupMeshes(groupA, groupB);
+
+    // New mesh : mean shape of both groups
+    std::string label = a_attribute.empty() ? std::string("Displacement") : a_attribute;
+    std::string prefix = a_permutationTest ? std::string("/PermutationTest_") : std::string("/GroupComparison_");
+    ShapePopulationData * Mesh = new ShapePopulationData;
+    Mesh->LoadPolyData(a_statistics->GetMeanShape(), groupA[0]->GetFileDir() + prefix + label + ".vtk");
+
+    std::vector< vtkSmartPointer<vtkDoubleArray> > maps;
+    std::vector<std::string> mapNames;
+    if(a_permutationTest)
+    {
+        maps.push_back(a_statistics->GetWelchT());          mapNames.push_back("_WelchT");
+        maps.push_back(a_statistics->GetUncorrectedP());    mapNames.push_back("_pUncorrected");
+        maps.push_back(a_statistics->GetMaxTCorrectedP());  mapNames.push_back("_pMaxT");
+        maps.push_back(a_statistics->GetFDRCorrectedP());   mapNames.push_back("_qFDR");
+    }
+    else
+    {
+        maps.push_back(a_statistics->GetMeanDifference());  mapNames.push_back("_GroupDifference");
+        maps.push_back(a_statistics->GetWelchT());          mapNames.push_back("_WelchT");
+        maps.push_back(a_statistics->GetCohenD());          mapNames.push_back("_CohenD");
+    }
+
+    // The maps are shared by the meshes of the same number of points so that they become common attributes
+    // with their own colorbar ; the meshes of another topology don't get them
+    for (unsigned int k = 0; k < maps.size(); k++)
+    {
+        maps[k]->SetName((label + mapNames[k]).c_str());
+        Mesh->AddAttribute(maps[k]);
+        for (unsigned int i = 0; i < m_meshList.size(); i++)
+        {
+            if(m_meshList[i]->GetPolyData()->GetNumberOfPoints() != maps[k]->GetNumberOfTuples()) continue;
+            m_meshList[i]->AddAttribute(maps[k]);
+        }
+    }
+
+    return Mesh;
+}
+
+ShapePopulationData * ShapePopulationBase::computeGroupComparison(std::string a_attribute, std::string &a_errorMessage)
+{
+    std::vector<ShapePopulationData *> groupA;
+    std::vector<ShapePopulationData *> groupB;
+    this->getGroupMeshes(groupA, groupB);
+
+    ShapePopulationStatistics statistics;
+    if(!statistics.ComputeGroupComparison(groupA, groupB, a_attribute))
+    {
+        a_errorMessage = statistics.GetErrorMessage();
+        return NULL;
+    }
+    return this->createStatisticsMesh(&statistics, a_attribute, false);
+}
+
+ShapePopulationData * ShapePopulationBase::computePermutationTest(std::string a_attribute, int a_numberOfPermutations, unsigned int a_seed, std::string &a_errorMessage)
+{
+    std::vector<ShapePopulationData *> groupA;
+    std::vector<ShapePopulationData *> groupB;
+    this->getGroupMeshes(groupA, groupB);
+
+    ShapePopulationStatistics statistics;
+    if(!statistics.ComputePermutationTest(groupA, groupB, a_attribute, a_numberOfPermutations, a_seed))
+    {
+        a_errorMessage = statistics.GetErrorMessage();
+        return NULL;
+    }
+    return this->createStatisticsMesh(&statistics, a_attribute, true);
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          SHAPE MODES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationData * ShapePopulationBase::computeShapeModes(int a_numberOfModes, std::string &a_errorMessage)
+{
+    // Modes of the selected meshes, without a previous shape modes mesh
+    ShapePopulationData * previousMesh = this->getShapeModesMesh();
+    std::vector<ShapePopulationData *> meshes;
+    for (unsigned int i = 0; i < m_selectedIndex.size(); i++)
+    {
+        if(m_meshList[m_selectedIndex[i]] != previousMesh) meshes.push_back(m_meshList[m_selectedIndex[i]]);
+    }
+
+    if(!m_shapeModes.ComputeModes(meshes, a_numberOfModes))
+    {
+        a_errorMessage = m_shapeModes.GetErrorMessage();
+        return NULL;
+    }
+
+    // New mesh : mean shape, moved along the modes by setShapeMode
+    ShapePopulationData * Mesh = new ShapePopulationData;
+    Mesh->LoadPolyData(m_shapeModes.GetMeanShape(), meshes[0]->GetFileDir() + "/ShapeModes.vtk");
+    m_shapeModesFilePath = Mesh->GetFilePath();
+
+    // Distance to the mean shape, updated by setShapeMode on the new mesh only. The meshes of the same number
+    // of points get their own array of zeros so that it becomes a common attribute
+    vtkIdType numPts = Mesh->GetPolyData()->GetNumberOfPoints();
+    for (int i = -1; i < (int)m_meshList.size(); i++)
+    {
+        ShapePopulationData * mesh = (i < 0) ? Mesh : m_meshList[i];
+        if(mesh->GetPolyData()->GetNumberOfPoints() != numPts) continue;
+
+        vtkSmartPointer<vtkDoubleArray> displacement = vtkSmartPointer<vtkDoubleArray>::New();
+        displacement->SetName("ShapeMode_Displacement");
+        displacement->SetNumberOfTuples(numPts);
+        displacement->FillComponent(0, 0.0);
+        mesh->AddAttribute(displacement);
+    }
+
+    return Mesh;
+}
+
+ShapePopulationData * ShapePopulationBase::getShapeModesMesh()
+{
+    if(m_shapeModesFilePath.empty()) return NULL;
+    for (int i = (int)m_meshList.size() - 1; i >= 0; i--)
+    {
+        if(m_meshList[i]->GetFilePath() == m_shapeModesFilePath) return m_meshList[i];
+    }
+    return NULL;
+}
+
+void ShapePopulationBase::setShapeMode(int a_mode, double a_standardDeviations)
+{
+    ShapePopulationData * mesh = this->getShapeModesMesh();
+    if(mesh == NULL || a_mode < 0 || a_mode >= m_shapeModes.GetNumberOfModes()) return;
+
+    vtkPolyData * polyData = mesh->GetPolyData();
+    vtkIdType numPts = polyData->GetNumberOfPoints();
+    vtkDoubleArray * displacement = vtkDoubleArray::SafeDownCast(polyData->GetPointData()->GetArray("ShapeMode_Displacement"));
+    if(displacement == NULL || displacement->GetNumberOfTuples() != numPts) return;
+
+    std::vector<double> coefficients(a_mode + 1, 0.0);
+    coefficients[a_mode] = a_standardDeviations;
+    std::vector<double> points(3*numPts);
+    m_shapeModes.GenerateShape(coefficients, &points[0], displacement->GetPointer(0));
+    displacement->Modified();
+
+    for (vtkIdType v = 0; v < numPts; v++)
+    {
+        polyData->GetPoints()->SetPoint(v, &points[3*v]);
+    }
+    polyData->GetPoints()->Modified();
+
+    // Shading of the new shape
+    vtkSmartPointer<vtkPolyDataNormals> normalGenerator = vtkSmartPointer<vtkPolyDataNormals>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    normalGenerator->SetInput(polyData);
+#else
+    normalGenerator->SetInputData(polyData);
+#endif
+    normalGenerator->SplittingOff();
+    normalGenerator->ComputePointNormalsOn();
+    normalGenerator->ComputeCellNormalsOff();
+    normalGenerator->Update();
+    polyData->GetPointData()->SetNormals(normalGenerator->GetOutput()->GetPointData()->GetNormals());
+    polyData->Modified();
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             MORPH                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationBase::updateMeshDisplay(unsigned int a_index)
+{
+    if(a_index >= m_meshList.size() || a_index >= m_windowsList.size()) return;
+    vtkPolyData * polyData = m_meshList[a_index]->GetPolyData();
+
+    // Colors by direction of the new vectors, with the axis colors of the mesh
+    std::vector<unsigned int> selection = m_selectedIndex;
+    m_selectedIndex = std::vector<unsigned int>(1, a_index);
+    for (unsigned int i = 0; i < m_commonAttributes.size() && i < m_magnitude.size(); i++)
+    {
+        std::ostringstream strs;
+        strs << m_commonAttributes[i] << "_ColorByDirection" << std::endl;
+        if(polyData->GetPointData()->GetArray(strs.str().c_str()) == NULL) continue;
+        if(polyData->GetPointData()->GetArray(m_commonAttributes[i].c_str()) == NULL) continue;
+        this->UpdateColorMapByDirection(m_commonAttributes[i].c_str(), i);
+    }
+    m_selectedIndex = selection;
+    polyData->Modified();
+
+    // Glyphs, unless the memory budget released them. The derived attribute displayed is computed again
+    // from the new arrays, and its ellipsoids
+    if(m_releasedGraphics.find(m_meshList[a_index]) == m_releasedGraphics.end()) m_glyphList[a_index]->Update();
+    std::string attribute = m_meshList[a_index]->GetActiveScalarsName();
+    if(m_meshList[a_index]->IsDerivedAttribute(attribute))
+    {
+        m_meshList[a_index]->SetActiveScalars(attribute.c_str());
+        this->updateTensorGlyphs(a_index);
+    }
+
+    // Decimated mesh displayed while the quality is lowered
+    if(m_qualityLevel >= 2)
+    {
+        vtkActorCollection * actors = m_windowsList[a_index]->GetRenderers()->GetFirstRenderer()->GetActors();
+        actors->InitTraversal();
+        vtkPolyDataMapper * mapper = vtkPolyDataMapper::SafeDownCast(actors->GetNextActor()->GetMapper());
+#if (VTK_MAJOR_VERSION < 6)
+        mapper->SetInputConnection(this->getLODMesh(m_meshList[a_index])->GetProducerPort());
+#else
+        mapper->SetInputData(this->getLODMesh(m_meshList[a_index]));
+#endif
+    }
+
+    // The picked vertex and the region moved with the points
+    this->updateVertexMarker(a_index);
+    this->updateRegionDisplay(a_index);
+}
+
+ShapePopulationData * ShapePopulationBase::computeMorph(std::string &a_errorMessage)
+{
+    // Shapes of the selection, without a previous morph
+    ShapePopulationData * previousMesh = this->getMorphMesh();
+    std::vector<ShapePopulationData *> meshes;
+    for (unsigned int i = 0; i < m_selectedIndex.size(); i++)
+    {
+        if(m_meshList[m_selectedIndex[i]] != previousMesh) meshes.push_back(m_meshList[m_selectedIndex[i]]);
+    }
+
+    if(!m_morph.SetShapes(meshes))
+    {
+        a_errorMessage = m_morph.GetErrorMessage();
+        return NULL;
+    }
+
+    // New mesh : the first shape, blended in place by setMorphPosition
+    ShapePopulationData * Mesh = new ShapePopulationData;
+    Mesh->LoadProcessedPolyData(m_morph.GetMorph(), meshes[0]->GetFileDir() + "/Morph.vtk");
+    m_morphFilePath = Mesh->GetFilePath();
+    return Mesh;
+}
+
+ShapePopulationData * ShapePopulationBase::getMorphMesh()
+{
+    if(m_morphFilePath.empty()) return NULL;
+    for (int i = (int)m_meshList.size() - 1; i >= 0; i--)
+    {
+        if(m_meshList[i]->GetFilePath() == m_morphFilePath) return m_meshList[i];
+    }
+    return NULL;
+}
+
+void ShapePopulationBase::setMorphPosition(double a_position, int a_interpolation)
+{
+    ShapePopulationData * mesh = this->getMorphMesh();
+    if(mesh == NULL || mesh->GetPolyData() != m_morph.GetMorph()) return;
+
+    m_morph.Blend(a_position, a_interpolation);
+    for (unsigned int i = 0; i < m_meshList.size(); i++)
+    {
+        if(m_meshList[i] == mesh) this->updateMeshDisplay(i);
+    }
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          TIME SERIES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationBase::setMeshFrame(unsigned int a_index, ShapePopulationData * a_frame)
+{
+    SPV_PROFILE_SCOPE("setMeshFrame");
+    if(a_frame == NULL || a_index >= m_meshList.size() || a_index >= m_windowsList.size()) return false;
+
+    vtkPolyData * polyData = m_meshList[a_index]->GetPolyData();
+    vtkPolyData * framePolyData = a_frame->GetPolyData();
+    if(framePolyData->GetNumberOfPoints() != polyData->GetNumberOfPoints()) return false;
+
+    // The arrays of the frame are shared, the ones with the same name are replaced and stay active
+    polyData->GetPoints()->SetData(framePolyData->GetPoints()->GetData());
+    polyData->GetPoints()->Modified();
+    vtkPointData * framePointData = framePolyData->GetPointData();
+    for (int j = 0; j < framePointData->GetNumberOfArrays(); j++)
+    {
+        polyData->GetPointData()->AddArray(framePointData->GetArray(j));
+    }
+    polyData->GetPointData()->SetNormals(framePointData->GetNormals());
+
+    this->updateMeshDisplay(a_index);
+
+    // Name of the timepoint
+    vtkPropCollection * propCollection = m_windowsList[a_index]->GetRenderers()->GetFirstRenderer()->GetViewProps();
+    vtkCornerAnnotation * fileName = vtkCornerAnnotation::SafeDownCast(propCollection->GetItemAsObject(2));
+    if(fileName != NULL) fileName->SetText(2, a_frame->GetFileName().c_str());
+    return true;
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                         VERTEX PICKING                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// Mesh actor of a window, first actor of its first renderer
+static vtkActor * spvMeshActor(vtkRenderWindow * a_window)
+{
+    vtkActorCollection * actors = a_window->GetRenderers()->GetFirstRenderer()->GetActors();
+    actors->InitTraversal();
+    return actors->GetNextActor();
+}
+
+// Actor of an overlay renderer : 0 marker of the picked vertex, 1 region of interest
+static vtkActor * spvOverlayActor(vtkRenderer * a_overlay, int a_actor)
+{
+    vtkActorCollection * actors = a_overlay->GetActors();
+    actors->InitTraversal();
+    vtkActor * actor = actors->GetNextActor();
+    for(int k = 0; k < a_actor && actor != NULL; k++) actor = actors->GetNextActor();
+    return actor;
+}
+
+bool ShapePopulationBase::pickSurfacePoint(unsigned int a_index, int a_x, int a_y, double a_point[3])
+{
+    if(a_index >= m_windowsList.size()) return false;
+    vtkRenderer * renderer = m_windowsList[a_index]->GetRenderers()->GetFirstRenderer();
+
+    // Depth of the last render under the cursor : no traversal of the geometry
+    double z = renderer->GetZ(a_x, a_y);
+    if(z >= 1.0) return false;
+
+    double worldPoint[4];
+    renderer->SetDisplayPoint(a_x, a_y, z);
+    renderer->DisplayToWorld();
+    renderer->GetWorldPoint(worldPoint);
+    if(worldPoint[3] == 0.0) return false;
+
+    // Coordinates of the mesh : without the translation of the alignment
+    double * position = spvMeshActor(m_windowsList[a_index])->GetPosition();
+    for(int k = 0; k < 3; k++) a_point[k] = worldPoint[k]/worldPoint[3] - position[k];
+    return true;
+}
+
+vtkIdType ShapePopulationBase::pickVertex(unsigned int a_index, int a_x, int a_y)
+{
+    SPV_PROFILE_SCOPE("PickVertex");
+    double point[3];
+    if(a_index >= m_meshList.size() || !this->pickSurfacePoint(a_index, a_x, a_y, point)) return -1;
+    return m_picking.FindClosestPoint(m_meshList[a_index], point);
+}
+
+void ShapePopulationBase::highlightVertex(vtkIdType a_vertex)
+{
+    m_pickedVertex = a_vertex;
+    for (unsigned int i = 0; i < m_meshList.size() && i < m_windowsList.size(); i++)
+    {
+        this->updateVertexMarker(i);
+    }
+}
+
+void ShapePopulationBase::updateVertexMarker(unsigned int a_index)
+{
+    if(a_index >= m_meshList.size() || a_index >= m_windowsList.size()) return;
+    vtkPolyData * polyData = m_meshList[a_index]->GetPolyData();
+
+    // No vertex picked, or a mesh with less points : the marker is hidden, the overlay is not created
+    if(m_pickedVertex < 0 || m_pickedVertex >= polyData->GetNumberOfPoints())
+    {
+        vtkRenderer * overlay = this->getOverlay(a_index, false);
+        if(overlay != NULL) spvOverlayActor(overlay, 0)->VisibilityOff();
+        return;
+    }
+
+    double point[3];
+    polyData->GetPoint(m_pickedVertex, point);
+    double * position = spvMeshActor(m_windowsList[a_index])->GetPosition();
+    for(int k = 0; k < 3; k++) point[k] += position[k];
+
+    vtkActor * marker = spvOverlayActor(this->getOverlay(a_index, true), 0);
+    marker->SetPosition(point);
+    marker->SetScale(s_vertexMarkerRadius*polyData->GetLength());
+    marker->VisibilityOn();
+}
+
+vtkRenderer * ShapePopulationBase::getOverlay(unsigned int a_index, bool a_create)
+{
+    vtkRenderWindow * window = m_windowsList[a_index];
+    std::map< vtkRenderWindow *, vtkSmartPointer<vtkRenderer> >::iterator it = m_overlays.find(window);
+    if(it != m_overlays.end() && it->second->GetRenderWindow() == window) return it->second;
+    if(!a_create) return NULL;
+
+    // Overlays of the deleted windows
+    it = m_overlays.begin();
+    while(it != m_overlays.end())
+    {
+        if(it->second->GetRenderWindow() != it->first) m_overlays.erase(it++);
+        else ++it;
+    }
+
+    // Actor 0 : marker of the picked vertex
+    vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetCenter(0.0, 0.0, 0.0);
+    sphereSource->SetRadius(1.0);
+    sphereSource->SetThetaResolution(16);
+    sphereSource->SetPhiResolution(16);
+    vtkSmartPointer<vtkPolyDataMapper> markerMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    markerMapper->SetInputConnection(sphereSource->GetOutputPort());
+    vtkSmartPointer<vtkActor> marker = vtkSmartPointer<vtkActor>::New();
+    marker->SetMapper(markerMapper);
+    marker->GetProperty()->SetColor(1.0, 1.0, 0.0);
+    marker->PickableOff();
+    marker->VisibilityOff();
+
+    // Actor 1 : vertices of the region of interest
+    vtkSmartPointer<vtkPolyData> regionPolyData = vtkSmartPointer<vtkPolyData>::New();
+    vtkSmartPointer<vtkPolyDataMapper> regionMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    regionMapper->SetInput(regionPolyData);
+#else
+    regionMapper->SetInputData(regionPolyData);
+#endif
+    regionMapper->ScalarVisibilityOff();
+    vtkSmartPointer<vtkActor> region = vtkSmartPointer<vtkActor>::New();
+    region->SetMapper(regionMapper);
+    region->GetProperty()->SetColor(1.0, 0.5, 0.0);
+    region->GetProperty()->SetPointSize(4);
+    region->PickableOff();
+    region->VisibilityOff();
+
+    // 2D actor : lasso being drawn, in display coordinates
+    vtkSmartPointer<vtkPolyData> lassoPolyData = vtkSmartPointer<vtkPolyData>::New();
+    vtkSmartPointer<vtkPolyDataMapper2D> lassoMapper = vtkSmartPointer<vtkPolyDataMapper2D>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    lassoMapper->SetInput(lassoPolyData);
+#else
+    lassoMapper->SetInputData(lassoPolyData);
+#endif
+    vtkSmartPointer<vtkActor2D> lasso = vtkSmartPointer<vtkActor2D>::New();
+    lasso->SetMapper(lassoMapper);
+    lasso->GetProperty()->SetColor(1.0, 0.5, 0.0);
+    lasso->VisibilityOff();
+
+    // The actors of the mesh renderer stay the mesh and the glyphs
+    vtkRenderer * renderer = window->GetRenderers()->GetFirstRenderer();
+    vtkSmartPointer<vtkRenderer> overlay = vtkSmartPointer<vtkRenderer>::New();
+    overlay->SetLayer(1);
+    overlay->InteractiveOff();
+    overlay->PreserveDepthBufferOn();
+    overlay->SetActiveCamera(renderer->GetActiveCamera());
+    overlay->AddActor(marker);
+    overlay->AddActor(region);
+    overlay->AddActor2D(lasso);
+    if(window->GetNumberOfLayers() < 2) window->SetNumberOfLayers(2);
+    window->AddRenderer(overlay);
+    renderer->AddObserver(vtkCommand::StartEvent, this, &ShapePopulationBase::OverlayCameraEventVTK);
+    m_overlays[window] = overlay;
+    return overlay;
+}
+
+void ShapePopulationBase::OverlayCameraEventVTK(vtkObject* a_renderer, unsigned long, void*)
+{
+    // The synchronization may have given another camera to the mesh renderer
+    vtkRenderer * renderer = vtkRenderer::SafeDownCast(a_renderer);
+    if(renderer == NULL) return;
+    std::map< vtkRenderWindow *, vtkSmartPointer<vtkRenderer> >::iterator it = m_overlays.find(renderer->GetRenderWindow());
+    if(it == m_overlays.end()) return;
+    if(it->second->GetActiveCamera() != renderer->GetActiveCamera()) it->second->SetActiveCamera(renderer->GetActiveCamera());
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       REGION OF INTEREST                                      * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationBase::drawLasso(unsigned int a_index, const std::vector<double> &a_lasso)
+{
+    if(a_index >= m_windowsList.size()) return;
+    vtkRenderer * overlay = this->getOverlay(a_index, !a_lasso.empty());
+    if(overlay == NULL) return;
+    vtkActor2D * lasso = overlay->GetActors2D()->GetLastActor2D();
+    if(a_lasso.size() < 4)
+    {
+        lasso->VisibilityOff();
+        return;
+    }
+
+    // Closed polyline through the positions of the cursor
+    vtkIdType numberOfPositions = a_lasso.size()/2;
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+    lines->InsertNextCell(numberOfPositions + 1);
+    for(vtkIdType i = 0; i < numberOfPositions; i++)
+    {
+        points->InsertNextPoint(a_lasso[2*i], a_lasso[2*i + 1], 0.0);
+        lines->InsertCellPoint(i);
+    }
+    lines->InsertCellPoint(0);
+    vtkPolyData * lassoPolyData = vtkPolyData::SafeDownCast(vtkPolyDataMapper2D::SafeDownCast(lasso->GetMapper())->GetInput());
+    lassoPolyData->SetPoints(points);
+    lassoPolyData->SetLines(lines);
+    lassoPolyData->Modified();
+    lasso->VisibilityOn();
+}
+
+void ShapePopulationBase::selectRegion(unsigned int a_index, const std::vector<double> &a_lasso, bool a_add)
+{
+    if(a_index >= m_meshList.size() || a_index >= m_windowsList.size() || a_lasso.size() < 6) return;
+    vtkRenderer * renderer = m_windowsList[a_index]->GetRenderers()->GetFirstRenderer();
+
+    // Lasso in normalized device coordinates
+    std::vector<double> polygon;
+    for(unsigned int i = 0; i + 1 < a_lasso.size(); i += 2)
+    {
+        double viewPoint[3];
+        renderer->SetDisplayPoint(a_lasso[i], a_lasso[i + 1], 0.0);
+        renderer->DisplayToView();
+        renderer->GetViewPoint(viewPoint);
+        polygon.push_back(viewPoint[0]);
+        polygon.push_back(viewPoint[1]);
+    }
+
+    // Mesh coordinates to normalized device coordinates : projection of the camera, after the translation of the alignment
+    vtkMatrix4x4 * matrix = renderer->GetActiveCamera()->GetCompositeProjectionTransformMatrix(renderer->GetTiledAspectRatio(), -1, 1);
+    double * position = spvMeshActor(m_windowsList[a_index])->GetPosition();
+    double projection[16];
+    for(int r = 0; r < 4; r++)
+    {
+        for(int c = 0; c < 3; c++) projection[4*r + c] = matrix->GetElement(r, c);
+        projection[4*r + 3] = matrix->GetElement(r, 0)*position[0] + matrix->GetElement(r, 1)*position[1] + matrix->GetElement(r, 2)*position[2] + matrix->GetElement(r, 3);
+    }
+
+    // Z-buffer of the mesh renderer, rendered without the lasso : the vertices hidden by the surface are not selected
+    m_windowsList[a_index]->Render();
+    int origin[2] = {renderer->GetOrigin()[0], renderer->GetOrigin()[1]};
+    int size[2] = {renderer->GetSize()[0], renderer->GetSize()[1]};
+    float * depth = m_windowsList[a_index]->GetZbufferData(origin[0], origin[1], origin[0] + size[0] - 1, origin[1] + size[1] - 1);
+    m_region.SelectInPolygon(m_meshList[a_index]->GetPolyData(), projection, polygon, a_add, depth, size[0], size[1]);
+    delete [] depth;
+
+    for (unsigned int i = 0; i < m_meshList.size() && i < m_windowsList.size(); i++)
+    {
+        this->updateRegionDisplay(i);
+    }
+}
+
+void ShapePopulationBase::clearRegion()
+{
+    m_region.Clear();
+    for (unsigned int i = 0; i < m_meshList.size() && i < m_windowsList.size(); i++)
+    {
+        this->updateRegionDisplay(i);
+    }
+}
+
+void ShapePopulationBase::updateRegionDisplay(unsigned int a_index)
+{
+    if(a_index >= m_meshList.size() || a_index >= m_windowsList.size()) return;
+    vtkPolyData * polyData = m_meshList[a_index]->GetPolyData();
+
+    // The vertices of the region which the mesh has, on its points
+    vtkSmartPointer<vtkCellArray> vertices = m_region.GetVertexCells(polyData->GetNumberOfPoints());
+    vtkRenderer * overlay = this->getOverlay(a_index, vertices->GetNumberOfCells() > 0);
+    if(overlay == NULL) return;
+    vtkActor * region = spvOverlayActor(overlay, 1);
+    if(vertices->GetNumberOfCells() == 0)
+    {
+        region->VisibilityOff();
+        return;
+    }
+
+    vtkPolyData * regionPolyData = vtkPolyData::SafeDownCast(region->GetMapper()->GetInput());
+    regionPolyData->SetPoints(polyData->GetPoints());
+    regionPolyData->SetVerts(vertices);
+    regionPolyData->Modified();
+    region->SetPosition(spvMeshActor(m_windowsList[a_index])->GetPosition());
+    region->VisibilityOn();
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            MEMORY                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// GPU buffers of a drawn polydata : float positions and normals, RGBA colors and the connectivity
+static unsigned long spvGraphicsMemory(vtkPolyData * a_polyData)
+{
+    unsigned long bytes = (unsigned long)a_polyData->GetNumberOfPoints()*(3*4 + 3*4 + 4);
+    bytes += (unsigned long)a_polyData->GetPolys()->GetNumberOfConnectivityEntries()*4;
+    bytes += (unsigned long)a_polyData->GetStrips()->GetNumberOfConnectivityEntries()*4;
+    return bytes/1024;
+}
+
+memoryUsageStruct ShapePopulationBase::computeMemoryUsage(unsigned int a_index)
+{
+    memoryUsageStruct usage;
+    m_meshList[a_index]->GetMemoryUsage(usage.geometry, usage.attributes, usage.derived);
+
+    vtkPolyData * glyphOutput = m_glyphList[a_index]->GetOutput();
+    usage.glyphs = glyphOutput->GetDataReleased() ? 0 : glyphOutput->GetActualMemorySize();
+    vtkPolyData * tensorOutput = m_tensorGlyphList[a_index]->GetOutput();
+    if(!tensorOutput->GetDataReleased()) usage.glyphs += tensorOutput->GetActualMemorySize();
+
+    usage.graphics = 0;
+    if(m_releasedGraphics.find(m_meshList[a_index]) == m_releasedGraphics.end())
+    {
+        vtkActorCollection * actors = m_windowsList[a_index]->GetRenderers()->GetFirstRenderer()->GetActors();
+        actors->InitTraversal();
+        if(actors->GetNextActor()->GetVisibility()) usage.graphics += spvGraphicsMemory(m_meshList[a_index]->GetPolyData());
+        if(actors->GetLastActor()->GetVisibility() && usage.glyphs > 0) usage.graphics += spvGraphicsMemory(glyphOutput);
+    }
+    return usage;
+}
+
+memoryUsageStruct ShapePopulationBase::computePopulationMemoryUsage()
+{
+    memoryUsageStruct total = {0, 0, 0, 0, 0};
+    for(unsigned int i = 0; i < m_meshList.size() && i < m_windowsList.size(); i++)
+    {
+        memoryUsageStruct usage = this->computeMemoryUsage(i);
+        total.geometry += usage.geometry;
+        total.attributes += usage.attributes;
+        total.derived += usage.derived;
+        total.glyphs += usage.glyphs;
+        total.graphics += usage.graphics;
+    }
+    return total;
+}
+
+unsigned long ShapePopulationBase::totalMemory(const memoryUsageStruct &a_usage)
+{
+    return a_usage.geometry + a_usage.attributes + a_usage.derived + a_usage.glyphs + a_usage.graphics;
+}
+
+void ShapePopulationBase::restoreMeshData(unsigned int a_index)
+{
+    if(a_index >= m_meshList.size() || a_index >= m_glyphList.size()) return;
+    m_meshList[a_index]->RestoreMagnitudes();
+    if(m_glyphList[a_index]->GetOutput()->GetDataReleased()) m_glyphList[a_index]->Update();
+    if(m_tensorGlyphList[a_index]->GetOutput()->GetDataReleased()) this->updateTensorGlyphs(a_index);
+    m_releasedGraphics.erase(m_meshList[a_index]);
+}
+
+unsigned long ShapePopulationBase::enforceMemoryBudget()
+{
+    SPV_PROFILE_SCOPE("enforceMemoryBudget");
+    unsigned int numberOfMeshes = std::min(m_meshList.size(), m_windowsList.size());
+
+    // Forget the meshes which were deleted
+    std::set<ShapePopulationData *>::iterator it = m_releasedGraphics.begin();
+    while(it != m_releasedGraphics.end())
+    {
+        if(std::find(m_meshList.begin(), m_meshList.end(), *it) == m_meshList.end()) m_releasedGraphics.erase(it++);
+        else ++it;
+    }
+
+    // The meshes which are seen again get back what was released
+    std::vector<bool> visible(numberOfMeshes);
+    for(unsigned int i = 0; i < numberOfMeshes; i++)
+    {
+        visible[i] = this->isWindowVisible(i);
+        if(visible[i]) this->restoreMeshData(i);
+    }
+    if(m_memoryBudget == 0) return 0;
+
+    unsigned long total = totalMemory(this->computePopulationMemoryUsage());
+    if(total <= m_memoryBudget) return 0;
+
+    // Unselected meshes, off-screen first, the largest first
+    std::vector< std::pair<unsigned long, unsigned int> > offScreen;
+    std::vector< std::pair<unsigned long, unsigned int> > onScreen;
+    for(unsigned int i = 0; i < numberOfMeshes; i++)
+    {
+        if(std::find(m_selectedIndex.begin(), m_selectedIndex.end(), i) != m_selectedIndex.end()) continue;
+        memoryUsageStruct usage = this->computeMemoryUsage(i);
+        if(visible[i]) onScreen.push_back(std::make_pair(usage.derived, i));
+        else offScreen.push_back(std::make_pair(usage.derived + usage.glyphs + usage.graphics, i));
+    }
+    std::sort(offScreen.rbegin(), offScreen.rend());
+    std::sort(onScreen.rbegin(), onScreen.rend());
+
+    unsigned long released = 0;
+    for(unsigned int j = 0; j < offScreen.size() && total > m_memoryBudget + released; j++)
+    {
+        unsigned int i = offScreen[j].second;
+        memoryUsageStruct usage = this->computeMemoryUsage(i);
+        released += m_meshList[i]->ReleaseMagnitudes();
+
+        m_glyphList[i]->GetOutput()->ReleaseData();
+        m_tensorGlyphList[i]->GetOutput()->ReleaseData();
+        released += usage.glyphs;
+
+        vtkActorCollection * actors = m_windowsList[i]->GetRenderers()->GetFirstRenderer()->GetActors();
+        actors->InitTraversal();
+        for(vtkActor * actor = actors->GetNextActor(); actor != NULL; actor = actors->GetNextActor())
+        {
+            actor->ReleaseGraphicsResources(m_windowsList[i]);
+        }
+        m_releasedGraphics.insert(m_meshList[i]);
+        released += usage.graphics;
+    }
+    for(unsigned int j = 0; j < onScreen.size() && total > m_memoryBudget + released; j++)
+    {
+        released += m_meshList[onScreen[j].second]->ReleaseMagnitudes();
+    }
+
+    ShapePopulationProfiler::AddCount("MemoryReleasedKB", released);
+    return released;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       SURFACE DISTANCE                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationBase::computeSurfaceDistance(unsigned int a_reference, std::string &a_attribute, std::string &a_errorMessage)
+{
+    if(a_reference >= m_meshList.size() || m_selectedIndex.empty())
+    {
+        a_errorMessage = "No reference or no mesh selected.";
+        return false;
+    }
+
+    ShapePopulationDistance distance;
+    if(!distance.SetReference(m_meshList[a_reference]->GetPolyData()))
+    {
+        a_errorMessage = distance.GetErrorMessage();
+        return false;
+    }
+
+    std::string referenceName = m_meshList[a_reference]->GetFileName();
+    size_t extension = referenceName.find_last_of(".");
+    if(extension != std::string::npos) referenceName = referenceName.substr(0, extension);
+    a_attribute = "Distance_" + referenceName;
+
+    // One map per selected mesh, under the same name so that it becomes a common attribute
+    for (unsigned int i = 0; i < m_selectedIndex.size(); i++)
+    {
+        vtkSmartPointer<vtkDoubleArray> map = distance.ComputeSignedDistance(m_meshList[m_selectedIndex[i]]->GetPolyData());
+        map->SetName(a_attribute.c_str());
+        m_meshList[m_selectedIndex[i]]->AddAttribute(map);
+    }
+    return true;
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            SESSION                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+static bool spvSameAxisColor(const axisColorStruct &a_first, const axisColorStruct &a_second)
+{
+    for(int k = 0; k < 3; k++)
+    {
+        if(a_first.XAxiscolor[k] != a_second.XAxiscolor[k] || a_first.YAxiscolor[k] != a_second.YAxiscolor[k]
+           || a_first.ZAxiscolor[k] != a_second.ZAxiscolor[k]) return false;
+    }
+    return a_first.sameColor == a_second.sameColor && a_first.complementaryColor == a_second.complementaryColor;
+}
+
+void ShapePopulationBase::captureSession(ShapePopulationSession &a_session)
+{
+    ShapePopulationBase::UpdateCameraConfig();                      // the GUI only updates it while the camera dialog is open
+
+    ShapePopulationSession::ViewState &view = a_session.GetView();
+    view.displayColorbar = m_displayColorbar;
+    view.displayAttribute = m_displayAttribute;
+    view.displayMeshName = m_displayMeshName;
+    view.displaySphere = m_displaySphere;
+    for(int k = 0; k < 3; k++)
+    {
+        view.selectedColor[k] = m_selectedColor[k];
+        view.unselectedColor[k] = m_unselectedColor[k];
+        view.labelColor[k] = m_labelColor[k];
+    }
+    view.camera = m_headcamConfig;
+
+    // m_colorBarList and m_magnitude follow m_commonAttributes
+    std::vector<ShapePopulationSession::AttributeState> &attributes = a_session.GetAttributes();
+    attributes.clear();
+    for(unsigned int i = 0; i < m_commonAttributes.size() && i < m_colorBarList.size() && i < m_magnitude.size(); i++)
+    {
+        ShapePopulationSession::AttributeState attribute;
+        attribute.name = m_commonAttributes[i];
+        attribute.colorBar = *m_colorBarList[i];
+        attribute.magnitude = *m_magnitude[i];
+        attributes.push_back(attribute);
+    }
+
+    std::vector<ShapePopulationSession::MeshState> &meshes = a_session.GetMeshes();
+    meshes.clear();
+    for(unsigned int i = 0; i < m_meshList.size(); i++)
+    {
+        ShapePopulationSession::MeshState state = ShapePopulationSession::DefaultMeshState(m_meshList[i]->GetFilePath());
+        if(i < m_meshOpacity.size()) state.opacity = m_meshOpacity[i];
+        if(i < m_vectorScale.size()) state.vectorScale = m_vectorScale[i];
+        if(i < m_vectorDensity.size()) state.vectorDensity = m_vectorDensity[i];
+        if(i < m_displayColorMapByDirection.size()) state.colorMapByDirection = m_displayColorMapByDirection[i];
+        if(i < m_displayVectors.size()) state.displayVectors = m_displayVectors[i];
+        if(i < m_displayVectorsByDirection.size()) state.vectorsByDirection = m_displayVectorsByDirection[i];
+        if(i < m_axisColor.size()) state.axisColor = *m_axisColor[i];
+        meshes.push_back(state);
+    }
+}
+
+void ShapePopulationBase::restoreSession(ShapePopulationSession &a_session)
+{
+    SPV_PROFILE_SCOPE("restoreSession");
+
+    // Colorbars of the attributes which are still common
+    std::vector<ShapePopulationSession::AttributeState> &attributes = a_session.GetAttributes();
+    for(unsigned int i = 0; i < attributes.size(); i++)
+    {
+        std::vector<std::string>::iterator it = std::find(m_commonAttributes.begin(), m_commonAttributes.end(), attributes[i].name);
+        unsigned int index = it - m_commonAttributes.begin();
+        if(it == m_commonAttributes.end() || index >= m_colorBarList.size() || index >= m_magnitude.size()) continue;
+        if(!attributes[i].colorBar.colorPointList.empty()) *m_colorBarList[index] = attributes[i].colorBar;
+        *m_magnitude[index] = attributes[i].magnitude;
+    }
+
+    // Meshes, a file loaded twice takes the states in their order
+    std::vector<ShapePopulationSession::MeshState> &meshes = a_session.GetMeshes();
+    std::vector<bool> restored(m_meshList.size(), false);
+    for(unsigned int i = 0; i < meshes.size(); i++)
+    {
+        for(unsigned int j = 0; j < m_meshList.size(); j++)
+        {
+            if(restored[j] || m_meshList[j]->GetFilePath() != meshes[i].filePath) continue;
+            this->restoreMeshState(j, meshes[i]);
+            restored[j] = true;
+            break;
+        }
+    }
+
+    // Colors, the labels after the meshes as they recreate the spheres
+    ShapePopulationSession::ViewState &view = a_session.GetView();
+    this->setBackgroundSelectedColor(view.selectedColor);
+    this->setBackgroundUnselectedColor(view.unselectedColor);
+    this->setLabelColor(view.labelColor);
+
+    // Camera
+    cameraConfigStruct &cam = view.camera;
+    m_headcam->SetPosition(cam.pos_x,cam.pos_y,cam.pos_z);
+    m_headcam->SetFocalPoint(cam.foc_x,cam.foc_y,cam.foc_z);
+    m_headcam->SetViewUp(cam.view_vx,cam.view_vy,cam.view_vz);
+    m_headcam->SetParallelScale(cam.scale);
+    this->UpdateCameraConfig();
+}
+
+void ShapePopulationBase::restoreMeshState(unsigned int a_index, const ShapePopulationSession::MeshState &a_state)
+{
+    if(a_index >= m_meshList.size() || a_index >= m_axisColor.size() || a_index >= m_displayVectors.size()) return;
+
+    // The functions of the VECTORS and COLORMAP sections work on the selection
+    std::vector<unsigned int> selection = m_selectedIndex;
+    m_selectedIndex = std::vector<unsigned int>(1, a_index);
+
+    // Colors by direction, computed with the default axis colors when the mesh was loaded
+    if(!spvSameAxisColor(*m_axisColor[a_index], a_state.axisColor))
+    {
+        *m_axisColor[a_index] = a_state.axisColor;
+        for(unsigned int i = 0; i < m_commonAttributes.size() && i < m_magnitude.size(); i++)
+        {
+            vtkDataArray * array = m_meshList[a_index]->GetPolyData()->GetPointData()->GetArray(m_commonAttributes[i].c_str());
+            if(array != NULL && array->GetNumberOfComponents() == 3) this->UpdateColorMapByDirection(m_commonAttributes[i].c_str(), i);
+        }
+    }
+
+    // Vectors are only displayed for the vector attributes
+    vtkDataArray * scalars = m_meshList[a_index]->GetActiveScalars();
+    std::string cmap = (scalars != NULL && scalars->GetName() != NULL) ? scalars->GetName() : "";
+    bool vectorAttribute = cmap.rfind("_mag") != std::string::npos || cmap.rfind("_ColorByDirection") != std::string::npos;
+
+    // COLOR MAP
+    if(a_state.colorMapByDirection && vectorAttribute)
+    {
+        m_displayColorMapByMagnitude[a_index] = false;
+        this->displayColorMapByDirection(true);
+    }
+    else
+    {
+        m_displayColorMapByDirection[a_index] = false;
+        this->displayColorMapByMagnitude(true);
+    }
+
+    // VECTORS
+    this->setMeshOpacity((double)a_state.opacity/100.0);
+    this->setVectorDensity(a_state.vectorDensity);
+    this->setVectorScale((double)a_state.vectorScale/100.0);
+    if(a_state.displayVectors && vectorAttribute)
+    {
+        // the radio buttons of the GUI : the other mode is turned off first
+        this->displayVectorsByMagnitude(false);
+        this->displayVectorsByDirection(false);
+        if(a_state.vectorsByDirection) this->displayVectorsByDirection(true);
+        else this->displayVectorsByMagnitude(true);
+        this->displayVectors(true);
+    }
+    else
+    {
+        this->displayVectorsByMagnitude(false);
+        this->displayVectorsByDirection(false);
+        this->displayVectors(false);
+    }
+
+    m_selectedIndex = selection;
+}
+
+
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
 // *                                            CAMERA                                             * //
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
@@ -1542,6 +2853,7 @@ void ShapePopulationBase::ResetHeadcam()
 
 void ShapePopulationBase::UpdateCameraConfig()
 {
+    SPV_PROFILE_SCOPE("UpdateCameraConfig");
     double * position = m_headcam->GetPosition();
     m_headcamConfig.pos_x = position[0];
     m_headcamConfig.pos_y = position[1];
@@ -1598,6 +2910,13 @@ void ShapePopulationBase::AlignMesh(bool alignment)
             glyphActor->SetPosition(newposition);
         }
     }
+
+    // The markers and the region follow the meshes
+    if(m_pickedVertex >= 0) this->highlightVertex(m_pickedVertex);
+    for (unsigned int i = 0; i < m_meshList.size() && i < m_windowsList.size(); i++)
+    {
+        this->updateRegionDisplay(i);
+    }
     
     this->ResetHeadcam();
     
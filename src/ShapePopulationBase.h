@@ -4,10 +4,22 @@
 #include <vtkVersion.h>
 
 #include "ShapePopulationData.h"
+#include "ShapePopulationStatistics.h"
+#include "ShapePopulationPCA.h"
+#include "ShapePopulationMorph.h"
+#include "ShapePopulationPicking.h"
+#include "ShapePopulationRegion.h"
+#include "ShapePopulationLabels.h"
+#include "ShapePopulationDistance.h"
+#include "ShapePopulationHistogram.h"
+#include "ShapePopulationHeader.h"
+#include "ShapePopulationProfiler.h"
+#include "ShapePopulationSession.h"
 #include "colorBarStruct.h"
 #include "cameraConfigStruct.h"
 #include "magnitudStruct.h"
 #include "axisColorStruct.h"
+#include "memoryUsageStruct.h"
 
 #include <vtkCamera.h>                      //Camera
 #include <vtkPolyDataMapper.h>              //Mapper
@@ -23,6 +35,9 @@
 #include <vtkCommand.h>                     //Event
 #include <vtkRendererCollection.h>          //GetRenderers
 #include <vtkActor2DCollection.h>           //GetActors2D
+#include <vtkPolyDataMapper2D.h>            //Lasso
+#include <vtkProperty2D.h>
+#include <vtkMatrix4x4.h>
 #include <vtkAxesActor.h>                   //Axes Actor
 #include <vtkTextActor.h>                   //Text Actor
 #include <vtkOrientationMarkerWidget.h>     //Widgets
@@ -33,10 +48,14 @@
 #include <vtkDoubleArray.h>
 
 #include "vtkGlyph3D.h"
+#include "vtkTensorGlyph.h"
 #include "vtkArrowSource.h"
 #include "vtkMaskPoints.h"
+#include "vtkDecimatePro.h"
+#include "vtkTimerLog.h"
 
 #include <set>
+#include <map>
 
 class ShapePopulationBase
 {
@@ -52,11 +71,15 @@ class ShapePopulationBase
     void CameraChangedEventVTK(vtkObject*, unsigned long, void*);
     void StartEventVTK(vtkObject*, unsigned long, void*);
     void EndEventVTK(vtkObject*, unsigned long, void*);
+    void ProfileStartEventVTK(vtkObject* a_object, unsigned long, void*);
+    void ProfileEndEventVTK(vtkObject* a_object, unsigned long, void*);
+    void OverlayCameraEventVTK(vtkObject* a_renderer, unsigned long, void*);
     
     protected :
     
     std::vector<ShapePopulationData *> m_meshList;
     std::vector< vtkSmartPointer<vtkGlyph3D> > m_glyphList;
+    std::vector< vtkSmartPointer<vtkTensorGlyph> > m_tensorGlyphList;
     std::vector< vtkSmartPointer<vtkRenderWindow> > m_windowsList;
     std::vector< unsigned int > m_selectedIndex;
     vtkSmartPointer<vtkCamera> m_headcam;
@@ -86,6 +109,7 @@ class ShapePopulationBase
     std::vector< axisColorStruct* > m_axisColor;
 
     void CreateNewWindow(std::string a_filePath);
+    void CreateNewWindow(ShapePopulationData * a_mesh);
     
     //SELECTION
     unsigned int getSelectedIndex(vtkSmartPointer<vtkRenderWindow> a_selectedWindow);
@@ -97,17 +121,55 @@ class ShapePopulationBase
     void RenderAll();
     void RenderSelection();
     void RealTimeRenderSynchro(bool realtime);
+
+    //ADAPTIVE QUALITY
+    // During an interaction, the quality of the windows is lowered one level at a time while the
+    // synchronized render passes of the selection exceed the frame budget :
+    // 1 hide glyphs, 2 decimated meshes, 3 hide annotations, 4 render half of the tiles per frame
+    bool m_adaptiveQuality;
+    double m_targetFrameRate;
+    int m_qualityLevel;
+    bool m_interacting;
+    unsigned int m_frameCount;
+    std::vector<double> m_frameTimes;                                       // last render passes, in seconds
+    std::vector<int> m_qualityVisibility;                                   // glyph and annotations visibility before level 1 and 3
+    std::map< ShapePopulationData *, vtkSmartPointer<vtkPolyData> > m_lodMeshes;
+    void setAdaptiveQuality(bool adaptive);
+    void setTargetFrameRate(double frameRate);
+    void setQualityLevel(int level);
+    void getFrameStatistics(double &a_last, double &a_mean, double &a_maximum);
+    vtkSmartPointer<vtkPolyData> getLODMesh(ShapePopulationData * a_mesh);
     
     //COLORMAP
     double m_commonRange[2];
     double m_commonMagnitud[2];
     void computeCommonAttributes();
+    void computeCommonAttributes(std::vector<ShapePopulationHeader> &a_headers);    // also common to the files scanned, loaded or not
     double* computeCommonRange(const char * a_cmap, std::vector<unsigned int> a_windowIndex);
     void UpdateColorMapByDirection(const char *cmap, int index);
     void UpdateAttribute(const char *a_cmap, std::vector<unsigned int> a_windowIndex);
     void displayColorMapByMagnitude(bool display);
     void displayColorMapByDirection(bool display);
     void UpdateColorMapByMagnitude(std::vector<unsigned int> a_windowIndex);
+
+    //LABELS
+    // Label mode : a categorical attribute is colored by the lookup table of its labels over the meshes
+    // loaded, instead of the color bar
+    ShapePopulationLabels m_labels;
+    bool m_displayLabels;
+    bool updateLabels(std::string a_attribute);                         // false : not a label attribute
+
+    //TENSORS
+    // Ellipsoids of the tensor array of the attribute displayed (one of its components, trace, FA...) in
+    // place of the arrows, colored by the attribute
+    bool m_displayTensors;
+    void displayTensors(bool display);
+    bool updateTensorGlyphs(unsigned int a_index);                      // false : arrows, no tensor attribute displayed
+
+    //HISTOGRAMS
+    ShapePopulationHistogram m_histograms;
+    void updateHistograms();
+    bool computePercentileRange(std::string a_attribute, double a_lowPercentile, double a_highPercentile, double a_range[2]);
     
     //VECTORS
     void setMeshOpacity(double value);
@@ -133,6 +195,78 @@ class ShapePopulationBase
         // Initialization of all the widgets
     void initializationAllWidgets();
 
+    //STATISTICS
+    std::vector< unsigned int > m_groupA;
+    std::vector< unsigned int > m_groupB;
+    void getGroupMeshes(std::vector<ShapePopulationData *> &a_groupA, std::vector<ShapePopulationData *> &a_groupB);
+    ShapePopulationData * createStatisticsMesh(ShapePopulationStatistics * a_statistics, std::string a_attribute, bool a_permutationTest);
+    ShapePopulationData * computeGroupComparison(std::string a_attribute, std::string &a_errorMessage);
+    ShapePopulationData * computePermutationTest(std::string a_attribute, int a_numberOfPermutations, unsigned int a_seed, std::string &a_errorMessage);
+
+    //SHAPE MODES
+    ShapePopulationPCA m_shapeModes;
+    std::string m_shapeModesFilePath;
+    ShapePopulationData * computeShapeModes(int a_numberOfModes, std::string &a_errorMessage);
+    ShapePopulationData * getShapeModesMesh();
+    void setShapeMode(int a_mode, double a_standardDeviations);
+
+    //MORPH
+    ShapePopulationMorph m_morph;
+    std::string m_morphFilePath;
+    ShapePopulationData * computeMorph(std::string &a_errorMessage);       // between the selected meshes, in the order of the selection
+    ShapePopulationData * getMorphMesh();
+    void setMorphPosition(double a_position, int a_interpolation);
+
+    //MESH UPDATES
+    // The points or the attributes of a mesh changed in place : colors by direction, glyphs and decimated mesh
+    void updateMeshDisplay(unsigned int a_index);
+
+    //TIME SERIES
+    // Points, normals and attributes of a timepoint swapped into the mesh of a window (same number of points),
+    // the mapper input stays the same and the window is not rebuilt
+    bool setMeshFrame(unsigned int a_index, ShapePopulationData * a_frame);
+
+    //VERTEX PICKING
+    // The vertex picked is marked at the same id in every window which has it, by a sphere drawn in an
+    // overlay renderer of the window, with the camera and the depth buffer of the mesh renderer
+    ShapePopulationPicking m_picking;
+    vtkIdType m_pickedVertex;                                           // -1 : none
+    std::map< vtkRenderWindow *, vtkSmartPointer<vtkRenderer> > m_overlays;
+    bool pickSurfacePoint(unsigned int a_index, int a_x, int a_y, double a_point[3]);  // false on the background
+    vtkIdType pickVertex(unsigned int a_index, int a_x, int a_y);
+    void highlightVertex(vtkIdType a_vertex);                           // -1 : hides the markers
+    void updateVertexMarker(unsigned int a_index);
+    vtkRenderer * getOverlay(unsigned int a_index, bool a_create);
+
+    //REGION OF INTEREST
+    // Vertex ids drawn with a lasso in one window, shown as points in the overlay of every window
+    ShapePopulationRegion m_region;
+    void drawLasso(unsigned int a_index, const std::vector<double> &a_lasso);  // display coordinates, empty : hidden
+    void selectRegion(unsigned int a_index, const std::vector<double> &a_lasso, bool a_add);
+    void clearRegion();
+    void updateRegionDisplay(unsigned int a_index);
+
+    //MEMORY
+    // Over the budget, the "_mag" arrays of the unselected meshes, then the glyph outputs and GPU buffers
+    // of the unselected off-screen meshes are released. They are rebuilt when the mesh is selected or visible.
+    unsigned long m_memoryBudget;                                       // KB, 0 : no budget
+    std::set<ShapePopulationData *> m_releasedGraphics;
+    virtual bool isWindowVisible(unsigned int) {return true;}
+    memoryUsageStruct computeMemoryUsage(unsigned int a_index);
+    memoryUsageStruct computePopulationMemoryUsage();
+    static unsigned long totalMemory(const memoryUsageStruct &a_usage);
+    unsigned long enforceMemoryBudget();
+    void restoreMeshData(unsigned int a_index);
+
+    //SURFACE DISTANCE
+    bool computeSurfaceDistance(unsigned int a_reference, std::string &a_attribute, std::string &a_errorMessage);
+
+    //SESSION
+    // The states of the meshes are matched by file path, the meshes of the session which are not loaded are ignored
+    void captureSession(ShapePopulationSession &a_session);
+    void restoreSession(ShapePopulationSession &a_session);
+    void restoreMeshState(unsigned int a_index, const ShapePopulationSession::MeshState &a_state);
+
     //CAMERA/VIEW
     void AlignMesh(bool alignment);
     void ChangeView(int R, int A, int S,int x_ViewUp,int y_ViewUp,int z_ViewUp);
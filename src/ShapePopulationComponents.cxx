@@ -0,0 +1,235 @@
+#include "ShapePopulationComponents.h"
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+// Tuples per block of the parallel loop, and per block laid out for the kernels
+static const vtkIdType s_computeGrain = 16384;
+static const vtkIdType s_blockSize = 256;
+
+struct ComponentsCompute
+{
+    vtkDataArray * source;
+    const ShapePopulationComponents::DerivedAttribute * derived;       // NULL : the 9 components of the tensors
+    double * output;
+};
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            KERNELS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+template <class T>
+static void spvGatherTuples(const T * a_data, int a_numComp, vtkIdType a_begin, vtkIdType a_count, double * a_tuples)
+{
+    const T * data = a_data + a_begin*a_numComp;
+    for(vtkIdType i = 0; i < a_count*a_numComp; i++) a_tuples[i] = static_cast<double>(data[i]);
+}
+
+// XX, YY, ZZ, XY, YZ, XZ of tensors of 6 or 9 components, the full ones made symmetric
+static void spvSymmetricTensors(const double * a_tuples, int a_numComp, vtkIdType a_count, double * a_tensors)
+{
+    for(vtkIdType i = 0; i < a_count; i++)
+    {
+        const double * t = a_tuples + i*a_numComp;
+        double * s = a_tensors + 6*i;
+        if(a_numComp == 6)
+        {
+            for(int k = 0; k < 6; k++) s[k] = t[k];
+            continue;
+        }
+        s[0] = t[0];
+        s[1] = t[4];
+        s[2] = t[8];
+        s[3] = 0.5*(t[1] + t[3]);
+        s[4] = 0.5*(t[5] + t[7]);
+        s[5] = 0.5*(t[2] + t[6]);
+    }
+}
+
+void ShapePopulationComponents::ComputeEigenvalues(const double * a_tensors, vtkIdType a_numberOfTensors, double * a_eigenvalues)
+{
+    // Trigonometric solution of the characteristic polynomial of A : with q the mean of the diagonal and
+    // B = (A - qI)/p, the eigenvalues are q + 2p cos(acos(det(B)/2)/3 + 2k pi/3). A multiple of the identity
+    // has p = 0, B is then taken null and the three eigenvalues are q
+    const double third = 2.0*vtkMath::Pi()/3.0;
+    for(vtkIdType i = 0; i < a_numberOfTensors; i++)
+    {
+        const double * t = a_tensors + 6*i;
+        double q = (t[0] + t[1] + t[2])/3.0;
+        double a = t[0] - q;
+        double b = t[1] - q;
+        double c = t[2] - q;
+        double p = sqrt((a*a + b*b + c*c + 2.0*(t[3]*t[3] + t[4]*t[4] + t[5]*t[5]))/6.0);
+        double inverse = (p > 0.0) ? 1.0/p : 0.0;
+        double determinant = a*(b*c - t[4]*t[4]) - t[3]*(t[3]*c - t[4]*t[5]) + t[5]*(t[3]*t[4] - b*t[5]);
+        double r = 0.5*determinant*inverse*inverse*inverse;
+        r = std::min(1.0, std::max(-1.0, r));
+        double phi = acos(r)/3.0;
+
+        double * e = a_eigenvalues + 3*i;
+        e[0] = q + 2.0*p*cos(phi);
+        e[2] = q + 2.0*p*cos(phi + third);
+        e[1] = 3.0*q - e[0] - e[2];
+    }
+}
+
+void ShapePopulationComponents::ComputeBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    ComponentsCompute * compute = static_cast<ComponentsCompute *>(a_data);
+    vtkDataArray * source = compute->source;
+    int numComp = source->GetNumberOfComponents();
+    const DerivedAttribute * derived = compute->derived;
+    std::vector<double> tuples(s_blockSize*numComp);
+    std::vector<double> tensors(s_blockSize*6);
+    std::vector<double> eigenvalues(s_blockSize*3);
+
+    for(vtkIdType begin = a_begin; begin < a_end; begin += s_blockSize)
+    {
+        vtkIdType count = std::min(s_blockSize, a_end - begin);
+        switch(source->GetDataType())
+        {
+            vtkTemplateMacro(spvGatherTuples(static_cast<VTK_TT *>(source->GetVoidPointer(0)), numComp, begin, count, &tuples[0]));
+        }
+
+        // 9 components of the tensors, for the glyphs
+        if(derived == NULL)
+        {
+            spvSymmetricTensors(&tuples[0], numComp, count, &tensors[0]);
+            for(vtkIdType i = 0; i < count; i++)
+            {
+                const double * s = &tensors[6*i];
+                double * out = compute->output + 9*(begin + i);
+                out[0] = s[0]; out[1] = s[3]; out[2] = s[5];
+                out[3] = s[3]; out[4] = s[1]; out[5] = s[4];
+                out[6] = s[5]; out[7] = s[4]; out[8] = s[2];
+            }
+            continue;
+        }
+
+        double * out = compute->output + begin;
+        switch(derived->mode)
+        {
+            case COMPONENT:
+                for(vtkIdType i = 0; i < count; i++) out[i] = tuples[i*numComp + derived->index];
+                break;
+
+            case MAGNITUDE:
+                // The components out of the diagonal of a symmetric tensor count twice
+                for(vtkIdType i = 0; i < count; i++)
+                {
+                    const double * t = &tuples[i*numComp];
+                    double sum = 0.0;
+                    for(int k = 0; k < numComp; k++) sum += ((numComp == 6 && k >= 3) ? 2.0 : 1.0)*t[k]*t[k];
+                    out[i] = sqrt(sum);
+                }
+                break;
+
+            case TRACE:
+                spvSymmetricTensors(&tuples[0], numComp, count, &tensors[0]);
+                for(vtkIdType i = 0; i < count; i++) out[i] = tensors[6*i] + tensors[6*i + 1] + tensors[6*i + 2];
+                break;
+
+            case FRACTIONAL_ANISOTROPY:
+                spvSymmetricTensors(&tuples[0], numComp, count, &tensors[0]);
+                ComputeEigenvalues(&tensors[0], count, &eigenvalues[0]);
+                for(vtkIdType i = 0; i < count; i++)
+                {
+                    const double * e = &eigenvalues[3*i];
+                    double mean = (e[0] + e[1] + e[2])/3.0;
+                    double deviation = (e[0] - mean)*(e[0] - mean) + (e[1] - mean)*(e[1] - mean) + (e[2] - mean)*(e[2] - mean);
+                    double norm = e[0]*e[0] + e[1]*e[1] + e[2]*e[2];
+                    out[i] = (norm > 0.0) ? sqrt(1.5*deviation/norm) : 0.0;
+                }
+                break;
+
+            case EIGENVALUE:
+                spvSymmetricTensors(&tuples[0], numComp, count, &tensors[0]);
+                ComputeEigenvalues(&tensors[0], count, &eigenvalues[0]);
+                for(vtkIdType i = 0; i < count; i++) out[i] = eigenvalues[3*i + derived->index];
+                break;
+        }
+    }
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       DERIVED ATTRIBUTES                                      * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+std::vector<ShapePopulationComponents::DerivedAttribute> ShapePopulationComponents::GetDerivedAttributes(std::string a_source, int a_numberOfComponents)
+{
+    std::vector<DerivedAttribute> attributes;
+    if(!HasDerivedAttributes(a_numberOfComponents)) return attributes;
+
+    DerivedAttribute attribute;
+    attribute.source = a_source;
+    for(int k = 0; k < a_numberOfComponents; k++)
+    {
+        attribute.name = a_source + "_" + vtkPVPostFilter::DefaultComponentName(k, a_numberOfComponents);
+        attribute.mode = COMPONENT;
+        attribute.index = k;
+        attributes.push_back(attribute);
+    }
+    attribute.name = a_source + "_Magnitude";
+    attribute.mode = MAGNITUDE;
+    attribute.index = -1;
+    attributes.push_back(attribute);
+    if(!IsTensor(a_numberOfComponents)) return attributes;
+
+    attribute.name = a_source + "_Trace";
+    attribute.mode = TRACE;
+    attributes.push_back(attribute);
+    attribute.name = a_source + "_FA";
+    attribute.mode = FRACTIONAL_ANISOTROPY;
+    attributes.push_back(attribute);
+    for(int k = 0; k < 3; k++)
+    {
+        std::ostringstream strs;
+        strs << a_source << "_Eigenvalue" << k + 1;
+        attribute.name = strs.str();
+        attribute.mode = EIGENVALUE;
+        attribute.index = k;
+        attributes.push_back(attribute);
+    }
+    return attributes;
+}
+
+vtkSmartPointer<vtkDoubleArray> ShapePopulationComponents::Compute(vtkDataArray * a_source, const DerivedAttribute &a_derived)
+{
+    SPV_PROFILE_SCOPE("ComputeDerivedAttribute");
+    vtkIdType numberOfTuples = a_source->GetNumberOfTuples();
+    vtkSmartPointer<vtkDoubleArray> array = vtkSmartPointer<vtkDoubleArray>::New();
+    array->SetName(a_derived.name.c_str());
+    array->SetNumberOfComponents(1);
+    array->SetNumberOfTuples(numberOfTuples);
+    if(numberOfTuples == 0) return array;
+
+    ComponentsCompute compute;
+    compute.source = a_source;
+    compute.derived = &a_derived;
+    compute.output = array->GetPointer(0);
+    ShapePopulationParallel::For(numberOfTuples, s_computeGrain, ComputeBlock, &compute);
+    ShapePopulationProfiler::AddCount("DerivedAttributes", 1);
+    return array;
+}
+
+vtkSmartPointer<vtkDoubleArray> ShapePopulationComponents::ComputeTensors(vtkDataArray * a_source)
+{
+    SPV_PROFILE_SCOPE("ComputeTensors");
+    vtkIdType numberOfTuples = a_source->GetNumberOfTuples();
+    vtkSmartPointer<vtkDoubleArray> array = vtkSmartPointer<vtkDoubleArray>::New();
+    std::string name = std::string(a_source->GetName() ? a_source->GetName() : "") + "_Tensors\n";
+    array->SetName(name.c_str());
+    array->SetNumberOfComponents(9);
+    array->SetNumberOfTuples(numberOfTuples);
+    if(numberOfTuples == 0 || !IsTensor(a_source->GetNumberOfComponents())) return array;
+
+    ComponentsCompute compute;
+    compute.source = a_source;
+    compute.derived = NULL;
+    compute.output = array->GetPointer(0);
+    ShapePopulationParallel::For(numberOfTuples, s_computeGrain, ComputeBlock, &compute);
+    return array;
+}
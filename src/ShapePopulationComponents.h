@@ -0,0 +1,54 @@
+#ifndef SHAPEPOPULATIONCOMPONENTS_H
+#define SHAPEPOPULATIONCOMPONENTS_H
+
+#include <vtkVersion.h>
+#include <vtkSmartPointer.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkMath.h>
+
+#include "vtkPVPostFilter.h"
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+
+// Arrays of 2 or more than 3 components (per-vertex tensors, multi-channel features) are displayed through
+// scalar attributes derived from them, each one computed the first time it is needed : every component,
+// named as vtkPVPostFilter names them (XX, YY, ZZ, XY, YZ, XZ for a symmetric tensor), and the magnitude
+// (Frobenius norm of a tensor). The tensors, of 6 (symmetric) or 9 components, also have their trace, their
+// fractional anisotropy and their eigenvalues. The eigenvalues are solved in closed form, block by block, by
+// a loop without branches over the tuples of the block which the compiler can vectorize.
+class ShapePopulationComponents
+{
+    public :
+
+    enum Mode {COMPONENT, MAGNITUDE, TRACE, FRACTIONAL_ANISOTROPY, EIGENVALUE};
+
+    struct DerivedAttribute
+    {
+        std::string name;
+        std::string source;                                             // array of several components
+        Mode mode;
+        int index;                                                      // component, or eigenvalue from the largest
+    };
+
+    static bool HasDerivedAttributes(int a_numberOfComponents) {return (a_numberOfComponents == 2 || a_numberOfComponents > 3);}
+    static bool IsTensor(int a_numberOfComponents) {return (a_numberOfComponents == 6 || a_numberOfComponents == 9);}
+    static std::vector<DerivedAttribute> GetDerivedAttributes(std::string a_source, int a_numberOfComponents);
+
+    // In parallel over the tuples of a_source
+    static vtkSmartPointer<vtkDoubleArray> Compute(vtkDataArray * a_source, const DerivedAttribute &a_derived);
+    static vtkSmartPointer<vtkDoubleArray> ComputeTensors(vtkDataArray * a_source);   // 9 components, symmetric, for vtkTensorGlyph
+
+    // Symmetric tensors of 6 components (XX, YY, ZZ, XY, YZ, XZ) : 3 eigenvalues each, from the largest
+    static void ComputeEigenvalues(const double * a_tensors, vtkIdType a_numberOfTensors, double * a_eigenvalues);
+
+    protected :
+
+    static void ComputeBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
@@ -0,0 +1,211 @@
+#include "ShapePopulationCovariates.h"
+
+#include <vtkPointData.h>
+
+#include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <algorithm>
+
+struct MeshSummary
+{
+    vtkDataArray * array;
+    vtkIdType count;
+    double sum;
+    double minimum;
+    double maximum;
+};
+
+// Display order : groups first, then the sort key, then the current order (stable sort)
+struct CovariateOrder
+{
+    const std::vector<std::string> * groups;
+    const std::vector<std::string> * keys;
+    bool descending;
+
+    bool operator()(unsigned int a_first, unsigned int a_second) const
+    {
+        int group = ShapePopulationCovariates::Compare((*groups)[a_first], (*groups)[a_second]);
+        if(group != 0) return group < 0;
+        if((*keys)[a_first].empty() != (*keys)[a_second].empty()) return (*keys)[a_second].empty();     // empty values last in both orders
+        int key = ShapePopulationCovariates::Compare((*keys)[a_first], (*keys)[a_second]);
+        return descending ? key > 0 : key < 0;
+    }
+};
+
+static bool spvToNumber(const std::string &a_value, double &a_number)
+{
+    if(a_value.empty()) return false;
+    char * end = NULL;
+    a_number = strtod(a_value.c_str(), &end);
+    while(end != NULL && (*end == ' ' || *end == '\t')) end++;
+    if(end == NULL || *end != '\0') return false;
+
+    // "nan" and "inf" are text : a NaN compares to nothing, the sort would not be ordered
+    return (a_number == a_number && fabs(a_number) <= DBL_MAX);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           COVARIATES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationCovariates::AddTable(std::vector<std::string> a_columns, std::vector<std::string> a_filePaths, std::vector< std::vector<std::string> > a_rows)
+{
+    // Columns of several CSV files are merged by name
+    std::vector<unsigned int> columnIndex;
+    for(unsigned int c = 0; c < a_columns.size(); c++)
+    {
+        std::vector<std::string>::iterator it = std::find(m_Columns.begin(), m_Columns.end(), a_columns[c]);
+        if(it == m_Columns.end())
+        {
+            m_Columns.push_back(a_columns[c]);
+            it = m_Columns.end() - 1;
+        }
+        columnIndex.push_back(it - m_Columns.begin());
+    }
+
+    for(unsigned int i = 0; i < a_filePaths.size() && i < a_rows.size(); i++)
+    {
+        std::vector<std::string> &values = m_Values[a_filePaths[i]];
+        values.resize(m_Columns.size());
+        for(unsigned int c = 0; c < a_rows[i].size() && c < columnIndex.size(); c++) values[columnIndex[c]] = a_rows[i][c];
+    }
+}
+
+void ShapePopulationCovariates::Clear()
+{
+    m_Columns.clear();
+    m_Values.clear();
+}
+
+std::string ShapePopulationCovariates::GetValue(std::string a_filePath, std::string a_column)
+{
+    std::vector<std::string>::iterator column = std::find(m_Columns.begin(), m_Columns.end(), a_column);
+    std::map<std::string, std::vector<std::string> >::iterator it = m_Values.find(a_filePath);
+    if(column == m_Columns.end() || it == m_Values.end()) return "";
+
+    unsigned int index = column - m_Columns.begin();
+    if(index >= it->second.size()) return "";
+    return it->second[index];
+}
+
+int ShapePopulationCovariates::Compare(const std::string &a_first, const std::string &a_second)
+{
+    if(a_first.empty() || a_second.empty()) return (int)a_first.empty() - (int)a_second.empty();
+
+    double first, second;
+    bool firstNumber = spvToNumber(a_first, first);
+    bool secondNumber = spvToNumber(a_second, second);
+    if(firstNumber && secondNumber) return (first < second) ? -1 : (first > second) ? 1 : 0;
+    if(firstNumber != secondNumber) return firstNumber ? -1 : 1;
+    return a_first.compare(a_second);
+}
+
+std::vector<unsigned int> ShapePopulationCovariates::ComputeOrder(std::vector<std::string> a_filePaths, std::string a_groupColumn, std::string a_sortColumn,
+                                                                  bool a_descending, std::string a_filterColumn, std::string a_filterText)
+{
+    std::vector<std::string> groups(a_filePaths.size());
+    std::vector<std::string> keys(a_filePaths.size());
+    std::vector<unsigned int> order;
+    for(unsigned int i = 0; i < a_filePaths.size(); i++)
+    {
+        if(!a_filterColumn.empty() && !a_filterText.empty()
+           && this->GetValue(a_filePaths[i], a_filterColumn).find(a_filterText) == std::string::npos) continue;
+
+        if(!a_groupColumn.empty()) groups[i] = this->GetValue(a_filePaths[i], a_groupColumn);
+        if(!a_sortColumn.empty()) keys[i] = this->GetValue(a_filePaths[i], a_sortColumn);
+        order.push_back(i);
+    }
+
+    CovariateOrder compare;
+    compare.groups = &groups;
+    compare.keys = &keys;
+    compare.descending = a_descending;
+    std::stable_sort(order.begin(), order.end(), compare);
+    return order;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                        GROUP STATISTICS                                       * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+template <class T>
+static void spvSummarizeValues(const T * a_data, int a_numComp, vtkIdType a_size, MeshSummary &a_summary)
+{
+    const T * data = a_data;
+    for(vtkIdType v = 0; v < a_size; v++, data += a_numComp)
+    {
+        double value = static_cast<double>(data[0]);
+        if(a_numComp == 3)
+        {
+            double y = static_cast<double>(data[1]);
+            double z = static_cast<double>(data[2]);
+            value = sqrt(value*value + y*y + z*z);
+        }
+        if(value != value) continue;                // NaN
+
+        if(a_summary.count == 0 || value < a_summary.minimum) a_summary.minimum = value;
+        if(a_summary.count == 0 || value > a_summary.maximum) a_summary.maximum = value;
+        a_summary.sum += value;
+        a_summary.count++;
+    }
+}
+
+void ShapePopulationCovariates::StatisticsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    std::vector<MeshSummary> * summaries = static_cast<std::vector<MeshSummary> *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        MeshSummary &summary = (*summaries)[i];
+        vtkDataArray * array = summary.array;
+        if(array == NULL) continue;
+        switch(array->GetDataType())
+        {
+            vtkTemplateMacro(spvSummarizeValues(static_cast<VTK_TT *>(array->GetVoidPointer(0)), array->GetNumberOfComponents(),
+                                                array->GetNumberOfTuples(), summary));
+        }
+    }
+}
+
+std::vector<ShapePopulationCovariates::GroupStatistics> ShapePopulationCovariates::ComputeGroupStatistics(std::vector<ShapePopulationData *> a_meshes, std::vector<int> a_groups,
+                                                                                                           int a_numberOfGroups, std::string a_attribute)
+{
+    // One summary per mesh, every block writing its own summaries
+    std::vector<MeshSummary> summaries(a_meshes.size());
+    for(unsigned int i = 0; i < a_meshes.size(); i++)
+    {
+        summaries[i].array = NULL;
+        summaries[i].count = 0;
+        summaries[i].sum = 0.0;
+        summaries[i].minimum = summaries[i].maximum = 0.0;
+        if(i < a_groups.size() && a_groups[i] >= 0) summaries[i].array = a_meshes[i]->GetAttribute(a_attribute);
+    }
+    if(!summaries.empty()) ShapePopulationParallel::For(summaries.size(), 1, StatisticsBlock, &summaries);
+
+    std::vector<GroupStatistics> statistics(std::max(0, a_numberOfGroups));
+    for(unsigned int g = 0; g < statistics.size(); g++)
+    {
+        statistics[g].numberOfMeshes = 0;
+        statistics[g].numberOfValues = 0;
+        statistics[g].mean = statistics[g].minimum = statistics[g].maximum = 0.0;
+    }
+    for(unsigned int i = 0; i < summaries.size(); i++)
+    {
+        if(summaries[i].array == NULL || a_groups[i] >= a_numberOfGroups) continue;
+        GroupStatistics &group = statistics[a_groups[i]];
+        group.numberOfMeshes++;
+        if(summaries[i].count == 0) continue;
+
+        if(group.numberOfValues == 0 || summaries[i].minimum < group.minimum) group.minimum = summaries[i].minimum;
+        if(group.numberOfValues == 0 || summaries[i].maximum > group.maximum) group.maximum = summaries[i].maximum;
+        group.mean += summaries[i].sum;
+        group.numberOfValues += summaries[i].count;
+    }
+    for(unsigned int g = 0; g < statistics.size(); g++)
+    {
+        if(statistics[g].numberOfValues > 0) statistics[g].mean /= statistics[g].numberOfValues;
+    }
+    return statistics;
+}
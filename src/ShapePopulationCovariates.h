@@ -0,0 +1,62 @@
+#ifndef SHAPEPOPULATIONCOVARIATES_H
+#define SHAPEPOPULATIONCOVARIATES_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+
+#include <vtkDataArray.h>
+
+#include <vector>
+#include <string>
+#include <map>
+
+// Covariates of the meshes (the columns of a CSV besides the file paths), kept by file path.
+// They give the display order of the grid : grouped by one column, sorted by another one inside
+// the groups (numerically when both values are numbers), and filtered on the value of a column.
+// Only indices are computed, the meshes themselves are never touched.
+class ShapePopulationCovariates
+{
+    public :
+
+    struct GroupStatistics
+    {
+        int numberOfMeshes;
+        vtkIdType numberOfValues;
+        double mean;
+        double minimum;
+        double maximum;
+    };
+
+    ShapePopulationCovariates(){}
+    ~ShapePopulationCovariates(){}
+
+    // a_rows[i] are the values of a_filePaths[i], in the order of a_columns
+    void AddTable(std::vector<std::string> a_columns, std::vector<std::string> a_filePaths, std::vector< std::vector<std::string> > a_rows);
+    void Clear();
+
+    bool IsEmpty() {return m_Columns.empty();}
+    std::vector<std::string> GetColumns() {return m_Columns;}
+    std::string GetValue(std::string a_filePath, std::string a_column);                 // "" if unknown
+
+    // Indices of the displayed meshes, in their display order ("" for no grouping, sorting or filtering)
+    std::vector<unsigned int> ComputeOrder(std::vector<std::string> a_filePaths, std::string a_groupColumn, std::string a_sortColumn,
+                                           bool a_descending, std::string a_filterColumn, std::string a_filterText);
+    static int Compare(const std::string &a_first, const std::string &a_second);       // numbers first, then text, empty values last
+
+    // Statistics of the attribute (magnitude for the vectors) over the points or cells of each group, a_groups[i] being the group of
+    // a_meshes[i] (negative for none). The meshes are summarized in parallel.
+    static std::vector<GroupStatistics> ComputeGroupStatistics(std::vector<ShapePopulationData *> a_meshes, std::vector<int> a_groups,
+                                                               int a_numberOfGroups, std::string a_attribute);
+
+    protected :
+
+    std::vector<std::string> m_Columns;
+    std::map<std::string, std::vector<std::string> > m_Values;         // one value per column
+
+    static void StatisticsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
@@ -1,52 +1,34 @@
 #include "ShapePopulationData.h"
 
-static bool endswith(std::string file, std::string ext)
-{
-    int epos = file.length() - ext.length();
-    if (epos < 0)
-    {
-        return false;
-    }
-    return file.rfind(ext) == (unsigned int)epos;
-}
-
 ShapePopulationData::ShapePopulationData()
 {
     m_PolyData = vtkSmartPointer<vtkPolyData>::New();
+    m_TensorsSource = NULL;
+    m_TensorsTime = 0;
 }
 
 vtkSmartPointer<vtkPolyData> ShapePopulationData::ReadPolyData(std::string a_filePath)
 {
-    if (endswith(a_filePath, ".vtp"))
-    {
-        vtkSmartPointer<vtkXMLPolyDataReader> meshReader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
-        meshReader->SetFileName(a_filePath.c_str());
-        meshReader->Update();
-        return meshReader->GetOutput();
-    }
-    else if (endswith(a_filePath, ".vtk"))
-    {
-        vtkSmartPointer<vtkPolyDataReader> meshReader = vtkSmartPointer<vtkPolyDataReader>::New();
-        meshReader->SetFileName(a_filePath.c_str());
-        meshReader->Update();
-        return meshReader->GetOutput();
-    }
-    else
-    {
-        return NULL;
-    }
+    return ShapePopulationReaders::Read(a_filePath);
 }
 
 void ShapePopulationData::ReadMesh(std::string a_filePath)
 {
+    SPV_PROFILE_SCOPE("ReadMesh");
     vtkSmartPointer<vtkPolyData> polyData = ReadPolyData(a_filePath);
     if(polyData == NULL) return;
     
+    this->LoadPolyData(polyData, a_filePath);
+    ShapePopulationProfiler::AddCount("MemoryAllocatedKB", m_PolyData->GetActualMemorySize());
+}
+
+void ShapePopulationData::LoadPolyData(vtkSmartPointer<vtkPolyData> a_polyData, std::string a_filePath)
+{
     vtkSmartPointer<vtkPolyDataNormals> normalGenerator = vtkSmartPointer<vtkPolyDataNormals>::New();
 #if (VTK_MAJOR_VERSION < 6)
-    normalGenerator->SetInput(polyData);
+    normalGenerator->SetInput(a_polyData);
 #else
-    normalGenerator->SetInputData(polyData);
+    normalGenerator->SetInputData(a_polyData);
 #endif
     normalGenerator->SplittingOff();
     normalGenerator->ComputePointNormalsOn();
@@ -55,11 +37,38 @@ void ShapePopulationData::ReadMesh(std::string a_filePath)
     
     //Update the class members
     m_PolyData = normalGenerator->GetOutput();
+    this->SetFilePath(a_filePath);
+    this->UpdateAttributeList();
+}
+
+void ShapePopulationData::LoadProcessedPolyData(vtkSmartPointer<vtkPolyData> a_polyData, std::string a_filePath)
+{
+    // Meshes saved with a session keep their normals, only the magnitudes of the vectors are computed again
+    if(a_polyData->GetPointData()->GetNormals() == NULL)
+    {
+        this->LoadPolyData(a_polyData, a_filePath);
+        return;
+    }
+    m_PolyData = a_polyData;
+    this->SetFilePath(a_filePath);
+    this->UpdateAttributeList();
+}
+
+void ShapePopulationData::SetFilePath(std::string a_filePath)
+{
     m_FilePath = a_filePath;
     size_t found = m_FilePath.find_last_of("/\\");
     m_FileDir = m_FilePath.substr(0,found);
     m_FileName = m_FilePath.substr(found+1);
-    
+}
+
+void ShapePopulationData::UpdateAttributeList()
+{
+    m_AttributeList.clear();
+    m_PointAttributes.clear();
+    m_DerivedAttributes.clear();
+    m_Tensors = NULL;
+    m_TensorsSource = NULL;
     int numAttributes = m_PolyData->GetPointData()->GetNumberOfArrays();
     for (int j = 0; j < numAttributes; j++)
     {
@@ -74,16 +83,353 @@ void ShapePopulationData::ReadMesh(std::string a_filePath)
         if( dim == 3)
         {
             //Vectors
-            vtkPVPostFilter *  getVectors = vtkPVPostFilter::New();
-            std::ostringstream strs;
-            strs.str("");
-            strs.clear();
-            strs << AttributeName << "_mag" << std::endl;
-            getVectors->DoAnyNeededConversions(m_PolyData,strs.str().c_str(),vtkDataObject::FIELD_ASSOCIATION_POINTS, AttributeName, "Magnitude");
-            getVectors->Delete();
+            this->ComputeMagnitude(AttributeName);
         }
+        if(ShapePopulationComponents::HasDerivedAttributes(dim))
+        {
+            //Tensors, several channels
+            this->AddDerivedAttributes(m_PolyData->GetPointData()->GetArray(j), false);
+        }
+    }
+
+    // Cell arrays, hidden by the point arrays of the same name
+    vtkCellData * cellData = m_PolyData->GetCellData();
+    for (int j = 0; j < cellData->GetNumberOfArrays(); j++)
+    {
+        vtkDataArray * array = cellData->GetArray(j);
+        if(array == NULL || array->GetName() == NULL) continue;
+        int dim = array->GetNumberOfComponents();
+        std::string AttributeString = array->GetName();
+        if(IsDerivedArray(AttributeString) || m_PolyData->GetPointData()->GetArray(AttributeString.c_str()) != NULL) continue;
+        if(ShapePopulationComponents::HasDerivedAttributes(dim)) this->AddDerivedAttributes(array, true);
+        if(dim != 1 && dim != 3) continue;
+        m_AttributeList.push_back(AttributeString);
     }
     std::sort(m_AttributeList.begin(),m_AttributeList.end());
 }
 
+bool ShapePopulationData::AddAttribute(vtkDataArray * a_attribute)
+{
+    if(a_attribute == NULL || a_attribute->GetName() == NULL) return false;
+    if(a_attribute->GetNumberOfTuples() != m_PolyData->GetNumberOfPoints()) return false;
+    int dim = a_attribute->GetNumberOfComponents();
+    if(dim != 1 && dim != 3) return false;
+    
+    m_PolyData->GetPointData()->AddArray(a_attribute);
+    
+    std::string AttributeString = a_attribute->GetName();
+    if(std::find(m_AttributeList.begin(),m_AttributeList.end(),AttributeString) == m_AttributeList.end())
+    {
+        m_AttributeList.push_back(AttributeString);
+        std::sort(m_AttributeList.begin(),m_AttributeList.end());
+    }
+    
+    if( dim == 3)
+    {
+        //Vectors
+        this->ComputeMagnitude(AttributeString);
+    }
+    return true;
+}
+
+void ShapePopulationData::AddDerivedAttributes(vtkDataArray * a_array, bool a_cells)
+{
+    if(a_array == NULL || a_array->GetName() == NULL) return;
+
+    // Listed now, computed when they are displayed. An array of the mesh hides the attribute of the same name
+    std::vector<ShapePopulationComponents::DerivedAttribute> attributes = ShapePopulationComponents::GetDerivedAttributes(a_array->GetName(), a_array->GetNumberOfComponents());
+    for(unsigned int k = 0; k < attributes.size(); k++)
+    {
+        const char * name = attributes[k].name.c_str();
+        if(m_PolyData->GetPointData()->GetArray(name) != NULL || m_PolyData->GetCellData()->GetArray(name) != NULL) continue;
+        if(m_DerivedAttributes.find(attributes[k].name) != m_DerivedAttributes.end()) continue;
+
+        DerivedAttribute derived;
+        derived.attribute = attributes[k];
+        derived.cells = a_cells;
+        derived.source = NULL;
+        derived.sourceTime = 0;
+        m_DerivedAttributes[attributes[k].name] = derived;
+        m_AttributeList.push_back(attributes[k].name);
+    }
+}
+
+void ShapePopulationData::ComputeMagnitude(std::string a_attribute)
+{
+    vtkPVPostFilter *  getVectors = vtkPVPostFilter::New();
+    std::ostringstream strs;
+    strs.str("");
+    strs.clear();
+    strs << a_attribute << "_mag" << std::endl;
+    getVectors->DoAnyNeededConversions(m_PolyData,strs.str().c_str(),vtkDataObject::FIELD_ASSOCIATION_POINTS, a_attribute.c_str(), "Magnitude");
+    getVectors->Delete();
+}
+
 
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                        CELL ATTRIBUTES                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationData::IsCellAttribute(std::string a_attribute)
+{
+    std::map<std::string, DerivedAttribute>::iterator it = m_DerivedAttributes.find(a_attribute);
+    if(it != m_DerivedAttributes.end()) return it->second.cells;
+    if(m_PolyData->GetPointData()->GetArray(a_attribute.c_str()) != NULL) return false;
+    return (m_PolyData->GetCellData()->GetArray(a_attribute.c_str()) != NULL);
+}
+
+vtkDataArray * ShapePopulationData::GetAttribute(std::string a_attribute)
+{
+    std::map<std::string, DerivedAttribute>::iterator it = m_DerivedAttributes.find(a_attribute);
+    if(it != m_DerivedAttributes.end()) return this->UpdateDerivedAttribute(it->second);
+
+    vtkDataArray * array = m_PolyData->GetPointData()->GetArray(a_attribute.c_str());
+    if(array != NULL) return array;
+    return m_PolyData->GetCellData()->GetArray(a_attribute.c_str());
+}
+
+vtkDataArray * ShapePopulationData::GetPointAttribute(std::string a_attribute)
+{
+    vtkDataArray * array = this->GetAttribute(a_attribute);
+    if(array == NULL || !this->IsCellAttribute(a_attribute)) return array;
+    vtkDataArray * cellArray = array;
+
+    // Averaged again when the cell values changed
+    std::map<std::string, PointAttribute>::iterator it = m_PointAttributes.find(a_attribute);
+    if(it != m_PointAttributes.end() && it->second.cellArray == cellArray && it->second.cellTime >= cellArray->GetMTime()) return it->second.array;
+
+    PointAttribute entry;
+    entry.array = this->AverageToPoints(cellArray);
+    entry.cellArray = cellArray;
+    entry.cellTime = cellArray->GetMTime();
+    m_PointAttributes[a_attribute] = entry;
+    return entry.array;
+}
+
+vtkSmartPointer<vtkDataArray> ShapePopulationData::AverageToPoints(vtkDataArray * a_cellArray)
+{
+    SPV_PROFILE_SCOPE("AverageCellAttribute");
+    vtkIdType numPts = m_PolyData->GetNumberOfPoints();
+    int numberOfComponents = a_cellArray->GetNumberOfComponents();
+    std::vector<double> sums(numPts*numberOfComponents, 0.0);
+    std::vector<int> counts(numPts, 0);
+    std::vector<double> tuple(numberOfComponents);
+
+    // Mean of the cells of each point, as vtkCellDataToPointData, for this array only. The cell ids follow
+    // the verts, lines, polys and strips, whose connectivity is read through its pointer
+    vtkCellArray * cellArrays[4] = {m_PolyData->GetVerts(), m_PolyData->GetLines(), m_PolyData->GetPolys(), m_PolyData->GetStrips()};
+    vtkIdType cellId = 0;
+    vtkIdType numberOfCells = a_cellArray->GetNumberOfTuples();
+    for(int k = 0; k < 4; k++)
+    {
+        if(cellArrays[k] == NULL || cellArrays[k]->GetNumberOfCells() == 0) continue;
+        vtkIdType * cells = cellArrays[k]->GetPointer();
+        vtkIdType numberOfEntries = cellArrays[k]->GetNumberOfConnectivityEntries();
+        for(vtkIdType c = 0; c < numberOfEntries && cellId < numberOfCells; c += cells[c] + 1, cellId++)
+        {
+            a_cellArray->GetTuple(cellId, &tuple[0]);
+            for(vtkIdType p = 1; p <= cells[c]; p++)
+            {
+                vtkIdType v = cells[c + p];
+                if(v < 0 || v >= numPts) continue;
+                counts[v]++;
+                for(int t = 0; t < numberOfComponents; t++) sums[v*numberOfComponents + t] += tuple[t];
+            }
+        }
+    }
+
+    vtkSmartPointer<vtkDoubleArray> pointArray = vtkSmartPointer<vtkDoubleArray>::New();
+    pointArray->SetName(a_cellArray->GetName());
+    pointArray->SetNumberOfComponents(numberOfComponents);
+    pointArray->SetNumberOfTuples(numPts);
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        for(int t = 0; t < numberOfComponents; t++)
+        {
+            pointArray->SetComponent(v, t, (counts[v] > 0) ? sums[v*numberOfComponents + t]/counts[v] : 0.0);
+        }
+    }
+    ShapePopulationProfiler::AddCount("CellAttributesAveraged", 1);
+    return pointArray;
+}
+
+void ShapePopulationData::ConvertCellVectors(std::string a_attribute)
+{
+    if(!this->IsCellAttribute(a_attribute) || this->GetAttribute(a_attribute)->GetNumberOfComponents() != 3) return;
+
+    // The point vectors hide the cell vectors, with their magnitude
+    vtkSmartPointer<vtkDataArray> pointArray = this->GetPointAttribute(a_attribute);
+    m_PointAttributes.erase(a_attribute);
+    this->AddAttribute(pointArray);
+}
+
+void ShapePopulationData::SetActiveScalars(std::string a_name)
+{
+    // The array which is not found is no longer active : the mapper colours the points, or else the cells.
+    // A derived attribute is computed first
+    if(this->IsDerivedAttribute(a_name)) this->GetAttribute(a_name);
+    m_PolyData->GetPointData()->SetActiveScalars(a_name.c_str());
+    m_PolyData->GetCellData()->SetActiveScalars(a_name.c_str());
+}
+
+vtkDataArray * ShapePopulationData::GetActiveScalars()
+{
+    vtkDataArray * scalars = m_PolyData->GetPointData()->GetScalars();
+    if(scalars != NULL) return scalars;
+    return m_PolyData->GetCellData()->GetScalars();
+}
+
+const char * ShapePopulationData::GetActiveScalarsName()
+{
+    vtkDataArray * scalars = this->GetActiveScalars();
+    if(scalars == NULL || scalars->GetName() == NULL) return "";
+    return scalars->GetName();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       DERIVED ATTRIBUTES                                      * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+vtkDataArray * ShapePopulationData::UpdateDerivedAttribute(DerivedAttribute &a_derived)
+{
+    vtkDataSetAttributes * data = m_PolyData->GetPointData();
+    if(a_derived.cells) data = m_PolyData->GetCellData();
+    vtkDataArray * source = data->GetArray(a_derived.attribute.source.c_str());
+    if(source == NULL) return NULL;
+
+    // Computed again when the array changed (time series, morph) or was released
+    vtkDataArray * array = data->GetArray(a_derived.attribute.name.c_str());
+    if(array != NULL && a_derived.source == source && a_derived.sourceTime >= source->GetMTime()) return array;
+
+    vtkSmartPointer<vtkDoubleArray> derived = ShapePopulationComponents::Compute(source, a_derived.attribute);
+    data->AddArray(derived);                                            // replaces the previous one, active or not
+    a_derived.source = source;
+    a_derived.sourceTime = source->GetMTime();
+    return derived;
+}
+
+std::string ShapePopulationData::GetTensorSource(std::string a_attribute)
+{
+    std::map<std::string, DerivedAttribute>::iterator it = m_DerivedAttributes.find(a_attribute);
+    if(it == m_DerivedAttributes.end()) return "";
+    vtkDataArray * source = this->GetAttribute(it->second.attribute.source);
+    if(source == NULL || !ShapePopulationComponents::IsTensor(source->GetNumberOfComponents())) return "";
+    return it->second.attribute.source;
+}
+
+vtkDataArray * ShapePopulationData::GetTensors(std::string a_attribute)
+{
+    std::string tensors = this->GetTensorSource(a_attribute);
+    if(tensors.empty()) return NULL;
+
+    // Cell tensors are averaged to the points, where the glyphs are
+    vtkDataArray * source = this->GetPointAttribute(tensors);
+    if(source == NULL) return NULL;
+    if(m_Tensors != NULL && m_TensorsSource == source && m_TensorsTime >= source->GetMTime()) return m_Tensors;
+
+    m_Tensors = ShapePopulationComponents::ComputeTensors(source);
+    m_TensorsSource = source;
+    m_TensorsTime = source->GetMTime();
+    return m_Tensors;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            MEMORY                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationData::IsDerivedArray(std::string a_arrayName)
+{
+    // "_mag", "_ColorByDirection" and "_Tensors" arrays are computed from an attribute, their names end with a newline
+    std::string keys[3] = {"_mag\n", "_ColorByDirection\n", "_Tensors\n"};
+    for(int k = 0; k < 3; k++)
+    {
+        if(a_arrayName.size() >= keys[k].size() && a_arrayName.compare(a_arrayName.size() - keys[k].size(), keys[k].size(), keys[k]) == 0) return true;
+    }
+    return false;
+}
+
+void ShapePopulationData::GetMemoryUsage(unsigned long &a_geometry, unsigned long &a_attributes, unsigned long &a_derived)
+{
+    a_geometry = 0;
+    a_attributes = 0;
+    a_derived = 0;
+    if(m_PolyData == NULL) return;
+
+    if(m_PolyData->GetPoints() != NULL) a_geometry += m_PolyData->GetPoints()->GetActualMemorySize();
+    a_geometry += m_PolyData->GetVerts()->GetActualMemorySize() + m_PolyData->GetLines()->GetActualMemorySize();
+    a_geometry += m_PolyData->GetPolys()->GetActualMemorySize() + m_PolyData->GetStrips()->GetActualMemorySize();
+
+    vtkPointData * pointData = m_PolyData->GetPointData();
+    for(int j = 0; j < pointData->GetNumberOfArrays(); j++)
+    {
+        vtkDataArray * array = pointData->GetArray(j);
+        if(array == NULL) continue;
+        if(array == pointData->GetNormals()) a_geometry += array->GetActualMemorySize();
+        else if(array->GetName() != NULL && (IsDerivedArray(array->GetName()) || this->IsDerivedAttribute(array->GetName()))) a_derived += array->GetActualMemorySize();
+        else a_attributes += array->GetActualMemorySize();
+    }
+
+    vtkCellData * cellData = m_PolyData->GetCellData();
+    for(int j = 0; j < cellData->GetNumberOfArrays(); j++)
+    {
+        vtkDataArray * array = cellData->GetArray(j);
+        if(array == NULL) continue;
+        if(array->GetName() != NULL && this->IsDerivedAttribute(array->GetName())) a_derived += array->GetActualMemorySize();
+        else a_attributes += array->GetActualMemorySize();
+    }
+    std::map<std::string, PointAttribute>::iterator it;
+    for(it = m_PointAttributes.begin(); it != m_PointAttributes.end(); ++it) a_derived += it->second.array->GetActualMemorySize();
+    if(m_Tensors != NULL) a_derived += m_Tensors->GetActualMemorySize();
+}
+
+unsigned long ShapePopulationData::ReleaseMagnitudes()
+{
+    // The active scalars are displayed, they are kept
+    vtkPointData * pointData = m_PolyData->GetPointData();
+    vtkDataArray * activeScalars = pointData->GetScalars();
+    std::vector<std::string> names;
+    unsigned long released = 0;
+    for(int j = 0; j < pointData->GetNumberOfArrays(); j++)
+    {
+        vtkDataArray * array = pointData->GetArray(j);
+        if(array == NULL || array == activeScalars || array->GetName() == NULL) continue;
+        std::string name = array->GetName();
+        if(name.size() < 5 || name.compare(name.size() - 5, 5, "_mag\n") != 0) continue;
+        names.push_back(name);
+        released += array->GetActualMemorySize();
+    }
+    for(unsigned int j = 0; j < names.size(); j++) pointData->RemoveArray(names[j].c_str());
+
+    // Averaged or derived again when they are needed
+    std::map<std::string, PointAttribute>::iterator it;
+    for(it = m_PointAttributes.begin(); it != m_PointAttributes.end(); ++it) released += it->second.array->GetActualMemorySize();
+    m_PointAttributes.clear();
+    std::map<std::string, DerivedAttribute>::iterator derived;
+    for(derived = m_DerivedAttributes.begin(); derived != m_DerivedAttributes.end(); ++derived)
+    {
+        vtkDataSetAttributes * data = m_PolyData->GetPointData();
+        if(derived->second.cells) data = m_PolyData->GetCellData();
+        vtkDataArray * array = data->GetArray(derived->first.c_str());
+        if(array == NULL || array == data->GetScalars()) continue;
+        released += array->GetActualMemorySize();
+        data->RemoveArray(derived->first.c_str());
+    }
+    if(m_Tensors != NULL) released += m_Tensors->GetActualMemorySize();
+    m_Tensors = NULL;
+    m_TensorsSource = NULL;
+    return released;
+}
+
+void ShapePopulationData::RestoreMagnitudes()
+{
+    for(unsigned int j = 0; j < m_AttributeList.size(); j++)
+    {
+        vtkDataArray * array = m_PolyData->GetPointData()->GetArray(m_AttributeList[j].c_str());
+        if(array == NULL || array->GetNumberOfComponents() != 3) continue;
+
+        std::string magnitude = m_AttributeList[j] + "_mag\n";
+        if(m_PolyData->GetPointData()->GetArray(magnitude.c_str()) == NULL) this->ComputeMagnitude(m_AttributeList[j]);
+    }
+}
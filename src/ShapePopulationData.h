@@ -9,13 +9,20 @@
 #include <vtkXMLPolyDataReader.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
 
 #include "vtkPVPostFilter.h"
+#include "ShapePopulationComponents.h"
+#include "ShapePopulationReaders.h"
+#include "ShapePopulationProfiler.h"
 
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <sstream>
+#include <map>
 
 class ShapePopulationData
 {
@@ -25,13 +32,39 @@ class ShapePopulationData
     ~ShapePopulationData(){}
     
     void ReadMesh(std::string a_filePath);
-    vtkSmartPointer<vtkPolyData> ReadPolyData(std::string a_filePath);
+    static vtkSmartPointer<vtkPolyData> ReadPolyData(std::string a_filePath);      // by the reader of its format, NULL if there is none
+    void LoadPolyData(vtkSmartPointer<vtkPolyData> a_polyData, std::string a_filePath);   // mesh computed in memory, a_filePath only names it
+    void LoadProcessedPolyData(vtkSmartPointer<vtkPolyData> a_polyData, std::string a_filePath);  // normals already computed (session)
+    bool AddAttribute(vtkDataArray * a_attribute);                     // false if it has not one tuple per point
     
     vtkSmartPointer<vtkPolyData> GetPolyData() {return m_PolyData;}
     std::string GetFilePath() {return m_FilePath;}
     std::string GetFileName() {return m_FileName;}
     std::string GetFileDir() {return m_FileDir;}
     std::vector<std::string> GetAttributeList() {return m_AttributeList;}
+
+    // Attributes : the point arrays, and the cell arrays no point array hides (labels, parcellations). A cell
+    // scalar is displayed as it is, the mapper colouring the cells ; it is averaged to the points only when an
+    // operation needs a value per vertex, and the point array is kept until the cell values change
+    bool IsCellAttribute(std::string a_attribute);
+    vtkDataArray * GetAttribute(std::string a_attribute);               // point or cell array
+    vtkDataArray * GetPointAttribute(std::string a_attribute);
+    void ConvertCellVectors(std::string a_attribute);                   // the glyphs of a cell vector are drawn at the points
+    void SetActiveScalars(std::string a_name);                          // a point or a cell array
+    vtkDataArray * GetActiveScalars();
+    const char * GetActiveScalarsName();                                // "" when no array is displayed
+
+    // Attributes derived from the arrays of 2 or more than 3 components (see ShapePopulationComponents) :
+    // computed by GetAttribute into the point or cell data of their array, again when the array changed
+    bool IsDerivedAttribute(std::string a_attribute) {return (m_DerivedAttributes.find(a_attribute) != m_DerivedAttributes.end());}
+    std::string GetTensorSource(std::string a_attribute);               // tensor array of a derived attribute, "" if none
+    vtkDataArray * GetTensors(std::string a_attribute);                 // its 9 components at the points
+
+    // Memory in KB, the normals are counted with the geometry
+    static bool IsDerivedArray(std::string a_arrayName);
+    void GetMemoryUsage(unsigned long &a_geometry, unsigned long &a_attributes, unsigned long &a_derived);
+    unsigned long ReleaseMagnitudes();      // "_mag" and derived arrays which are not displayed, the cell attributes averaged to the points, returns the KB released
+    void RestoreMagnitudes();
     
     protected :
     
@@ -40,6 +73,34 @@ class ShapePopulationData
     std::string m_FileName;
     std::string m_FileDir;
     std::vector<std::string> m_AttributeList;
+
+    struct PointAttribute
+    {
+        vtkSmartPointer<vtkDataArray> array;                            // averaged to the points
+        vtkDataArray * cellArray;
+        unsigned long cellTime;
+    };
+    std::map<std::string, PointAttribute> m_PointAttributes;
+
+    struct DerivedAttribute
+    {
+        ShapePopulationComponents::DerivedAttribute attribute;
+        bool cells;
+        vtkDataArray * source;                                          // when the array was computed
+        unsigned long sourceTime;
+    };
+    std::map<std::string, DerivedAttribute> m_DerivedAttributes;
+    vtkSmartPointer<vtkDataArray> m_Tensors;                            // of the last tensor array displayed
+    vtkDataArray * m_TensorsSource;
+    unsigned long m_TensorsTime;
+
+    void AddDerivedAttributes(vtkDataArray * a_array, bool a_cells);
+    vtkDataArray * UpdateDerivedAttribute(DerivedAttribute &a_derived);
+
+    void SetFilePath(std::string a_filePath);
+    void UpdateAttributeList();
+    void ComputeMagnitude(std::string a_attribute);
+    vtkSmartPointer<vtkDataArray> AverageToPoints(vtkDataArray * a_cellArray);
 };
 
 
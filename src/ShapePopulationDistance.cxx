@@ -0,0 +1,382 @@
+#include "ShapePopulationDistance.h"
+
+#include <vtkMath.h>
+
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <limits>
+
+// Triangles per leaf of the hierarchy
+static const int s_leafSize = 4;
+
+// Number of points processed together by one thread
+static const vtkIdType s_pointBlock = 1024;
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            KERNELS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// Closest point of triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5).
+// Returns the feature holding it : 0 face, 1 a, 2 b, 3 c, 4 edge ab, 5 edge bc, 6 edge ca
+static int spvClosestPointOnTriangle(const double * p, const double * a, const double * b, const double * c, double * closest)
+{
+    double ab[3], ac[3], ap[3], bp[3], cp[3];
+    for(int k = 0; k < 3; k++)
+    {
+        ab[k] = b[k] - a[k];
+        ac[k] = c[k] - a[k];
+        ap[k] = p[k] - a[k];
+        bp[k] = p[k] - b[k];
+        cp[k] = p[k] - c[k];
+    }
+
+    double d1 = vtkMath::Dot(ab, ap);
+    double d2 = vtkMath::Dot(ac, ap);
+    if(d1 <= 0.0 && d2 <= 0.0)
+    {
+        for(int k = 0; k < 3; k++) closest[k] = a[k];
+        return 1;
+    }
+
+    double d3 = vtkMath::Dot(ab, bp);
+    double d4 = vtkMath::Dot(ac, bp);
+    if(d3 >= 0.0 && d4 <= d3)
+    {
+        for(int k = 0; k < 3; k++) closest[k] = b[k];
+        return 2;
+    }
+
+    double vc = d1*d4 - d3*d2;
+    if(vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+        double v = d1/(d1 - d3);
+        for(int k = 0; k < 3; k++) closest[k] = a[k] + v*ab[k];
+        return 4;
+    }
+
+    double d5 = vtkMath::Dot(ab, cp);
+    double d6 = vtkMath::Dot(ac, cp);
+    if(d6 >= 0.0 && d5 <= d6)
+    {
+        for(int k = 0; k < 3; k++) closest[k] = c[k];
+        return 3;
+    }
+
+    double vb = d5*d2 - d1*d6;
+    if(vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+        double w = d2/(d2 - d6);
+        for(int k = 0; k < 3; k++) closest[k] = a[k] + w*ac[k];
+        return 6;
+    }
+
+    double va = d3*d6 - d5*d4;
+    if(va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+        double w = (d4 - d3)/((d4 - d3) + (d5 - d6));
+        for(int k = 0; k < 3; k++) closest[k] = b[k] + w*(c[k] - b[k]);
+        return 5;
+    }
+
+    double denominator = 1.0/(va + vb + vc);
+    double v = vb*denominator;
+    double w = vc*denominator;
+    for(int k = 0; k < 3; k++) closest[k] = a[k] + ab[k]*v + ac[k]*w;
+    return 0;
+}
+
+// Squared distance from p to a box (0 inside)
+static inline double spvBoxDistance2(const double * a_bounds, const double * p)
+{
+    double distance2 = 0.0;
+    for(int k = 0; k < 3; k++)
+    {
+        double d = 0.0;
+        if(p[k] < a_bounds[2*k]) d = a_bounds[2*k] - p[k];
+        else if(p[k] > a_bounds[2*k + 1]) d = p[k] - a_bounds[2*k + 1];
+        distance2 += d*d;
+    }
+    return distance2;
+}
+
+struct DistanceInfo
+{
+    ShapePopulationDistance * distance;
+    vtkPoints * points;
+    double * values;
+};
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           HIERARCHY                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationDistance::ShapePopulationDistance()
+{
+}
+
+bool ShapePopulationDistance::SetReference(vtkPolyData * a_reference)
+{
+    m_ErrorMessage = "";
+    m_Points.clear();
+    m_Triangles.clear();
+    m_Nodes.clear();
+    m_Order.clear();
+
+    vtkIdType numPts = a_reference->GetNumberOfPoints();
+    m_Points.resize(3*numPts);
+    for(vtkIdType i = 0; i < numPts; i++) a_reference->GetPoint(i, &m_Points[3*i]);
+
+    // Triangles (fan of each polygon), without the degenerated ones
+    vtkCellArray * polys = a_reference->GetPolys();
+    vtkIdType npts = 0;
+    vtkIdType * pts = NULL;
+    for(polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+    {
+        for(vtkIdType k = 1; k + 1 < npts; k++)
+        {
+            const double * a = &m_Points[3*pts[0]];
+            const double * b = &m_Points[3*pts[k]];
+            const double * c = &m_Points[3*pts[k + 1]];
+            double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            double normal[3];
+            vtkMath::Cross(ab, ac, normal);
+            if(vtkMath::Norm(normal) == 0.0) continue;
+
+            m_Triangles.push_back(pts[0]);
+            m_Triangles.push_back(pts[k]);
+            m_Triangles.push_back(pts[k + 1]);
+        }
+    }
+    int numTriangles = (int)(m_Triangles.size()/3);
+    if(numTriangles == 0)
+    {
+        m_ErrorMessage = "The reference mesh has no polygon.";
+        return false;
+    }
+
+    // Pseudo-normals : face, edges (sum of the adjacent faces) and vertices (angle weighted)
+    m_FaceNormals.assign(3*numTriangles, 0.0);
+    m_EdgeNormals.assign(9*numTriangles, 0.0);
+    m_VertexNormals.assign(3*numPts, 0.0);
+    std::map< std::pair<vtkIdType, vtkIdType>, std::vector<int> > edges;
+    for(int t = 0; t < numTriangles; t++)
+    {
+        const vtkIdType * triangle = &m_Triangles[3*t];
+        double * normal = &m_FaceNormals[3*t];
+        double ab[3], ac[3];
+        for(int k = 0; k < 3; k++)
+        {
+            ab[k] = m_Points[3*triangle[1] + k] - m_Points[3*triangle[0] + k];
+            ac[k] = m_Points[3*triangle[2] + k] - m_Points[3*triangle[0] + k];
+        }
+        vtkMath::Cross(ab, ac, normal);
+        vtkMath::Normalize(normal);
+
+        for(int corner = 0; corner < 3; corner++)
+        {
+            const double * o = &m_Points[3*triangle[corner]];
+            const double * u = &m_Points[3*triangle[(corner + 1)%3]];
+            const double * w = &m_Points[3*triangle[(corner + 2)%3]];
+            double ou[3] = {u[0] - o[0], u[1] - o[1], u[2] - o[2]};
+            double ow[3] = {w[0] - o[0], w[1] - o[1], w[2] - o[2]};
+            vtkMath::Normalize(ou);
+            vtkMath::Normalize(ow);
+            double cosine = std::max(-1.0, std::min(1.0, vtkMath::Dot(ou, ow)));
+            double angle = acos(cosine);
+            for(int k = 0; k < 3; k++) m_VertexNormals[3*triangle[corner] + k] += angle*normal[k];
+
+            vtkIdType i0 = std::min(triangle[corner], triangle[(corner + 1)%3]);
+            vtkIdType i1 = std::max(triangle[corner], triangle[(corner + 1)%3]);
+            edges[std::make_pair(i0, i1)].push_back(3*t + corner);
+        }
+    }
+    std::map< std::pair<vtkIdType, vtkIdType>, std::vector<int> >::iterator edge;
+    for(edge = edges.begin(); edge != edges.end(); ++edge)
+    {
+        double normal[3] = {0.0, 0.0, 0.0};
+        for(unsigned int i = 0; i < edge->second.size(); i++)
+        {
+            int t = edge->second[i]/3;
+            for(int k = 0; k < 3; k++) normal[k] += m_FaceNormals[3*t + k];
+        }
+        for(unsigned int i = 0; i < edge->second.size(); i++)
+        {
+            for(int k = 0; k < 3; k++) m_EdgeNormals[3*edge->second[i] + k] = normal[k];
+        }
+    }
+
+    // Hierarchy
+    std::vector<double> centroids(3*numTriangles);
+    m_Order.resize(numTriangles);
+    for(int t = 0; t < numTriangles; t++)
+    {
+        m_Order[t] = t;
+        for(int k = 0; k < 3; k++)
+        {
+            centroids[3*t + k] = (m_Points[3*m_Triangles[3*t] + k] + m_Points[3*m_Triangles[3*t + 1] + k] + m_Points[3*m_Triangles[3*t + 2] + k])/3.0;
+        }
+    }
+    m_Nodes.reserve(2*numTriangles/s_leafSize + 1);
+    this->BuildNode(0, numTriangles, centroids);
+    return true;
+}
+
+// Compares the triangles by the coordinate of their centroid along one axis
+struct spvCentroidLess
+{
+    const std::vector<double> * centroids;
+    int axis;
+    bool operator()(int a_first, int a_second) const
+    {
+        return (*centroids)[3*a_first + axis] < (*centroids)[3*a_second + axis];
+    }
+};
+
+int ShapePopulationDistance::BuildNode(int a_first, int a_count, std::vector<double> &a_centroids)
+{
+    int index = (int)m_Nodes.size();
+    m_Nodes.push_back(Node());
+
+    double bounds[6] = {VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX};
+    double centroidBounds[6] = {VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX};
+    for(int i = a_first; i < a_first + a_count; i++)
+    {
+        int t = m_Order[i];
+        for(int k = 0; k < 3; k++)
+        {
+            for(int corner = 0; corner < 3; corner++)
+            {
+                double x = m_Points[3*m_Triangles[3*t + corner] + k];
+                bounds[2*k] = std::min(bounds[2*k], x);
+                bounds[2*k + 1] = std::max(bounds[2*k + 1], x);
+            }
+            centroidBounds[2*k] = std::min(centroidBounds[2*k], a_centroids[3*t + k]);
+            centroidBounds[2*k + 1] = std::max(centroidBounds[2*k + 1], a_centroids[3*t + k]);
+        }
+    }
+    for(int k = 0; k < 6; k++) m_Nodes[index].bounds[k] = bounds[k];
+
+    if(a_count <= s_leafSize)
+    {
+        m_Nodes[index].left = -1;
+        m_Nodes[index].right = -1;
+        m_Nodes[index].first = a_first;
+        m_Nodes[index].count = a_count;
+        return index;
+    }
+
+    // Median split along the longest axis of the centroids
+    int axis = 0;
+    for(int k = 1; k < 3; k++)
+    {
+        if(centroidBounds[2*k + 1] - centroidBounds[2*k] > centroidBounds[2*axis + 1] - centroidBounds[2*axis]) axis = k;
+    }
+    spvCentroidLess less;
+    less.centroids = &a_centroids;
+    less.axis = axis;
+    int half = a_count/2;
+    std::nth_element(m_Order.begin() + a_first, m_Order.begin() + a_first + half, m_Order.begin() + a_first + a_count, less);
+
+    int left = this->BuildNode(a_first, half, a_centroids);
+    int right = this->BuildNode(a_first + half, a_count - half, a_centroids);
+    m_Nodes[index].left = left;
+    m_Nodes[index].right = right;
+    m_Nodes[index].first = 0;
+    m_Nodes[index].count = 0;
+    return index;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            QUERIES                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+double ShapePopulationDistance::ComputeSignedDistance(const double a_point[3])
+{
+    double best = std::numeric_limits<double>::max();
+    double bestClosest[3] = {0.0, 0.0, 0.0};
+    const double * bestNormal = NULL;
+
+    int stack[128];
+    int size = 0;
+    stack[size++] = 0;
+    while(size > 0)
+    {
+        const Node &node = m_Nodes[stack[--size]];
+        if(spvBoxDistance2(node.bounds, a_point) >= best) continue;
+
+        if(node.count > 0)
+        {
+            for(int i = node.first; i < node.first + node.count; i++)
+            {
+                int t = m_Order[i];
+                const vtkIdType * triangle = &m_Triangles[3*t];
+                double closest[3];
+                int feature = spvClosestPointOnTriangle(a_point, &m_Points[3*triangle[0]], &m_Points[3*triangle[1]], &m_Points[3*triangle[2]], closest);
+                double distance2 = vtkMath::Distance2BetweenPoints(a_point, closest);
+                if(distance2 < best)
+                {
+                    best = distance2;
+                    for(int k = 0; k < 3; k++) bestClosest[k] = closest[k];
+                    if(feature == 0) bestNormal = &m_FaceNormals[3*t];
+                    else if(feature <= 3) bestNormal = &m_VertexNormals[3*triangle[feature - 1]];
+                    else bestNormal = &m_EdgeNormals[9*t + 3*(feature - 4)];
+                }
+            }
+        }
+        else
+        {
+            // Nearest child on top of the stack
+            double leftDistance2 = spvBoxDistance2(m_Nodes[node.left].bounds, a_point);
+            double rightDistance2 = spvBoxDistance2(m_Nodes[node.right].bounds, a_point);
+            if(leftDistance2 < rightDistance2)
+            {
+                stack[size++] = node.right;
+                stack[size++] = node.left;
+            }
+            else
+            {
+                stack[size++] = node.left;
+                stack[size++] = node.right;
+            }
+        }
+    }
+
+    double direction[3] = {a_point[0] - bestClosest[0], a_point[1] - bestClosest[1], a_point[2] - bestClosest[2]};
+    double distance = sqrt(best);
+    if(bestNormal != NULL && vtkMath::Dot(direction, bestNormal) < 0.0) distance = -distance;
+    return distance;
+}
+
+void ShapePopulationDistance::DistanceBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    DistanceInfo * info = static_cast<DistanceInfo *>(a_data);
+    for(vtkIdType v = a_begin; v < a_end; v++)
+    {
+        double point[3];
+        info->points->GetPoint(v, point);
+        info->values[v] = info->distance->ComputeSignedDistance(point);
+    }
+}
+
+vtkSmartPointer<vtkDoubleArray> ShapePopulationDistance::ComputeSignedDistance(vtkPolyData * a_mesh)
+{
+    if(m_Nodes.empty()) return NULL;
+
+    vtkIdType numPts = a_mesh->GetNumberOfPoints();
+    vtkSmartPointer<vtkDoubleArray> distance = vtkSmartPointer<vtkDoubleArray>::New();
+    distance->SetNumberOfComponents(1);
+    distance->SetNumberOfTuples(numPts);
+
+    DistanceInfo info;
+    info.distance = this;
+    info.points = a_mesh->GetPoints();
+    info.values = distance->GetPointer(0);
+    ShapePopulationParallel::For(numPts, s_pointBlock, DistanceBlock, &info);
+
+    return distance;
+}
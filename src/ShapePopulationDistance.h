@@ -0,0 +1,63 @@
+#ifndef SHAPEPOPULATIONDISTANCE_H
+#define SHAPEPOPULATIONDISTANCE_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationParallel.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <vtkDoubleArray.h>
+
+#include <vector>
+#include <string>
+
+// Signed point-to-surface distance to a reference mesh.
+// The triangles of the reference are stored in a bounding volume hierarchy, so each query
+// only visits the few boxes close to the point. The sign is given by the angle-weighted
+// pseudo-normal at the closest point (positive on the side the reference normals point to).
+class ShapePopulationDistance
+{
+    public :
+
+    ShapePopulationDistance();
+    ~ShapePopulationDistance(){}
+
+    // Builds the hierarchy, the polygons of a_reference are split in triangles
+    bool SetReference(vtkPolyData * a_reference);
+
+    // One value per point of a_mesh, NULL if no reference
+    vtkSmartPointer<vtkDoubleArray> ComputeSignedDistance(vtkPolyData * a_mesh);
+
+    double ComputeSignedDistance(const double a_point[3]);
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+
+    protected :
+
+    struct Node
+    {
+        double bounds[6];
+        int left;                       // children (inner node)
+        int right;
+        int first;                      // triangles m_Order[first, first + count) (leaf)
+        int count;
+    };
+
+    std::vector<double> m_Points;               // 3 per point of the reference
+    std::vector<vtkIdType> m_Triangles;         // 3 per triangle
+    std::vector<double> m_FaceNormals;          // 3 per triangle
+    std::vector<double> m_EdgeNormals;          // 9 per triangle : edges ab, bc, ca
+    std::vector<double> m_VertexNormals;        // 3 per point, angle weighted
+    std::vector<int> m_Order;                   // triangles sorted by leaf
+    std::vector<Node> m_Nodes;
+    std::string m_ErrorMessage;
+
+    int BuildNode(int a_first, int a_count, std::vector<double> &a_centroids);
+
+    static void DistanceBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
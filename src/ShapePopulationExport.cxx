@@ -0,0 +1,197 @@
+#include "ShapePopulationExport.h"
+
+#include <vtkWindowToImageFilter.h>
+#include <vtkPNGWriter.h>
+#include <vtkTIFFWriter.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+
+#include <cstring>
+
+struct ExportBatch
+{
+    ShapePopulationExport * exporter;
+    std::vector<vtkImageData *> * images;
+    std::vector<std::string> * filePaths;
+    std::vector<int> * tiles;
+    std::vector<int> * written;
+};
+
+ShapePopulationExport::ShapePopulationExport()
+{
+    m_Format = PNG;
+    m_Columns = 0;
+    m_Rows = 0;
+    m_TileSize[0] = m_TileSize[1] = 0;
+    m_Border = 4;
+}
+
+std::string ShapePopulationExport::GetExtension(int a_format)
+{
+    if(a_format == TIFF) return ".tif";
+    return ".png";
+}
+
+vtkSmartPointer<vtkImageData> ShapePopulationExport::CaptureWindow(vtkRenderWindow * a_window, int a_magnification)
+{
+    SPV_PROFILE_SCOPE("CaptureWindow");
+
+    // The window is rendered again in its back buffer, by tiles when magnified
+    vtkSmartPointer<vtkWindowToImageFilter> windowToImage = vtkSmartPointer<vtkWindowToImageFilter>::New();
+    windowToImage->SetInput(a_window);
+    windowToImage->SetMagnification(a_magnification);
+    windowToImage->SetInputBufferTypeToRGB();
+    windowToImage->ReadFrontBufferOff();
+    windowToImage->ShouldRerenderOn();
+    windowToImage->Update();
+
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->DeepCopy(windowToImage->GetOutput());
+    return image;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            MONTAGE                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationExport::InitializeMontage(int a_numberOfTiles, int a_columns, int a_tileSize[2], double a_background[3])
+{
+    m_Columns = (a_columns > 0) ? a_columns : 1;
+    m_Rows = (a_numberOfTiles + m_Columns - 1) / m_Columns;
+    m_TileSize[0] = a_tileSize[0];
+    m_TileSize[1] = a_tileSize[1];
+
+    m_Montage = vtkSmartPointer<vtkImageData>::New();
+    m_Montage->SetDimensions(m_Columns*(m_TileSize[0] + m_Border) + m_Border, m_Rows*(m_TileSize[1] + m_Border) + m_Border, 1);
+#if (VTK_MAJOR_VERSION < 6)
+    m_Montage->SetScalarTypeToUnsignedChar();
+    m_Montage->SetNumberOfScalarComponents(3);
+    m_Montage->AllocateScalars();
+#else
+    m_Montage->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+#endif
+
+    // Background color of the views in the borders
+    unsigned char background[3];
+    for(int k = 0; k < 3; k++) background[k] = (unsigned char)(255.0*a_background[k] + 0.5);
+    unsigned char * pixel = static_cast<unsigned char *>(m_Montage->GetScalarPointer());
+    vtkIdType numberOfPixels = m_Montage->GetNumberOfPoints();
+    for(vtkIdType p = 0; p < numberOfPixels; p++, pixel += 3)
+    {
+        pixel[0] = background[0];
+        pixel[1] = background[1];
+        pixel[2] = background[2];
+    }
+}
+
+void ShapePopulationExport::PasteTile(vtkImageData * a_image, int a_tile)
+{
+    if(m_Montage == NULL || a_image == NULL || a_tile < 0 || a_tile >= m_Columns*m_Rows) return;
+    if(a_image->GetScalarType() != VTK_UNSIGNED_CHAR || a_image->GetNumberOfScalarComponents() != 3) return;
+
+    int montageDims[3];
+    int imageDims[3];
+    m_Montage->GetDimensions(montageDims);
+    a_image->GetDimensions(imageDims);
+
+    // First tile at the top left, the images start at their bottom row
+    int column = a_tile % m_Columns;
+    int row = m_Rows - 1 - a_tile / m_Columns;
+    int x0 = m_Border + column*(m_TileSize[0] + m_Border);
+    int y0 = m_Border + row*(m_TileSize[1] + m_Border);
+    int width = (imageDims[0] < m_TileSize[0]) ? imageDims[0] : m_TileSize[0];
+    int height = (imageDims[1] < m_TileSize[1]) ? imageDims[1] : m_TileSize[1];
+
+    unsigned char * source = static_cast<unsigned char *>(a_image->GetScalarPointer());
+    unsigned char * destination = static_cast<unsigned char *>(m_Montage->GetScalarPointer());
+    for(int y = 0; y < height; y++)
+    {
+        memcpy(destination + 3*((vtkIdType)(y0 + y)*montageDims[0] + x0), source + 3*(vtkIdType)y*imageDims[0], 3*width);
+    }
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             WRITE                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationExport::WriteImage(vtkImageData * a_image, std::string a_filePath, int a_format)
+{
+    vtkSmartPointer<vtkImageWriter> writer;
+    if(a_format == TIFF) writer = vtkSmartPointer<vtkTIFFWriter>::New();
+    else writer = vtkSmartPointer<vtkPNGWriter>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    writer->SetInput(a_image);
+#else
+    writer->SetInputData(a_image);
+#endif
+    writer->SetFileName(a_filePath.c_str());
+    writer->Write();
+    return writer->GetErrorCode() == 0;
+}
+
+void ShapePopulationExport::WriteBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    ExportBatch * batch = static_cast<ExportBatch *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        // Every tile has its own area of the montage
+        vtkImageData * image = (*batch->images)[i];
+        (*batch->written)[i] = WriteImage(image, (*batch->filePaths)[i], batch->exporter->m_Format);
+        if(i < (vtkIdType)batch->tiles->size()) batch->exporter->PasteTile(image, (*batch->tiles)[i]);
+    }
+}
+
+bool ShapePopulationExport::WriteBatch(std::vector<vtkImageData *> a_images, std::vector<std::string> a_filePaths, std::vector<int> a_tiles)
+{
+    SPV_PROFILE_SCOPE("WriteExportBatch");
+    if(a_images.empty()) return true;
+
+    std::vector<int> written(a_images.size(), 0);
+    ExportBatch batch;
+    batch.exporter = this;
+    batch.images = &a_images;
+    batch.filePaths = &a_filePaths;
+    batch.tiles = &a_tiles;
+    batch.written = &written;
+    ShapePopulationParallel::For(a_images.size(), 1, WriteBlock, &batch);
+
+    bool success = true;
+    for(unsigned int i = 0; i < written.size(); i++)
+    {
+        if(written[i]) continue;
+        m_FailedFiles.push_back(a_filePaths[i]);
+        success = false;
+    }
+    return success;
+}
+
+void ShapePopulationExport::PasteBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    ExportBatch * batch = static_cast<ExportBatch *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++) batch->exporter->PasteTile((*batch->images)[i], (*batch->tiles)[i]);
+}
+
+void ShapePopulationExport::PasteTiles(std::vector<vtkImageData *> a_images, std::vector<int> a_tiles)
+{
+    SPV_PROFILE_SCOPE("PasteTiles");
+    if(a_images.empty() || a_tiles.size() != a_images.size()) return;
+
+    ExportBatch batch;
+    batch.exporter = this;
+    batch.images = &a_images;
+    batch.filePaths = NULL;
+    batch.tiles = &a_tiles;
+    batch.written = NULL;
+    ShapePopulationParallel::For(a_images.size(), 1, PasteBlock, &batch);
+}
+
+bool ShapePopulationExport::WriteMontage(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("WriteMontage");
+    if(m_Montage == NULL) return false;
+    if(WriteImage(m_Montage, a_filePath, m_Format)) return true;
+    m_FailedFiles.push_back(a_filePath);
+    return false;
+}
@@ -0,0 +1,62 @@
+#ifndef SHAPEPOPULATIONEXPORT_H
+#define SHAPEPOPULATIONEXPORT_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vtkImageData.h>
+#include <vtkRenderWindow.h>
+
+#include <vector>
+#include <string>
+
+// Export of the windows as images : the windows are rendered at a chosen resolution on the GUI thread,
+// then the images of a batch are encoded (PNG or TIFF) and written in parallel, while being pasted
+// into a montage of the exported windows.
+class ShapePopulationExport
+{
+    public :
+
+    enum ImageFormat {PNG = 0, TIFF = 1};
+
+    ShapePopulationExport();
+    ~ShapePopulationExport(){}
+
+    void SetFormat(int a_format) {m_Format = a_format;}
+    int GetFormat() {return m_Format;}
+    static std::string GetExtension(int a_format);
+
+    // GUI thread : renders the window a_magnification times larger than on screen (back buffer)
+    static vtkSmartPointer<vtkImageData> CaptureWindow(vtkRenderWindow * a_window, int a_magnification);
+
+    // Montage of a_numberOfTiles tiles of a_tileSize pixels, a_columns per row, separated by a border
+    void InitializeMontage(int a_numberOfTiles, int a_columns, int a_tileSize[2], double a_background[3]);
+    vtkImageData * GetMontage() {return m_Montage;}
+
+    // Worker threads : writes the images of a batch and pastes them at the positions a_tiles of the montage (if any)
+    bool WriteBatch(std::vector<vtkImageData *> a_images, std::vector<std::string> a_filePaths, std::vector<int> a_tiles);
+    void PasteTiles(std::vector<vtkImageData *> a_images, std::vector<int> a_tiles);
+    bool WriteMontage(std::string a_filePath);
+    std::vector<std::string> GetFailedFiles() {return m_FailedFiles;}
+
+    static bool WriteImage(vtkImageData * a_image, std::string a_filePath, int a_format);
+
+    protected :
+
+    int m_Format;
+    vtkSmartPointer<vtkImageData> m_Montage;
+    int m_Columns;
+    int m_Rows;
+    int m_TileSize[2];
+    int m_Border;
+    std::vector<std::string> m_FailedFiles;
+
+    void PasteTile(vtkImageData * a_image, int a_tile);
+    static void WriteBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static void PasteBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
@@ -0,0 +1,658 @@
+#include "ShapePopulationHeader.h"
+#include "ShapePopulationReaders.h"
+#include "ShapePopulationProfiler.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <limits>
+#include <cstdlib>
+#include <cctype>
+
+struct HeaderScan
+{
+    std::vector<std::string> * filePaths;
+    std::vector<ShapePopulationHeader> * headers;
+};
+
+static std::string spvLowerCase(std::string a_string)
+{
+    for(unsigned int i = 0; i < a_string.size(); i++) a_string[i] = tolower(a_string[i]);
+    return a_string;
+}
+
+static vtkIdType spvToIdType(std::string a_string)
+{
+    vtkIdType value = 0;
+    std::istringstream stream(a_string);
+    stream >> value;
+    return value;
+}
+
+ShapePopulationHeader::ShapePopulationHeader()
+{
+    m_Valid = false;
+    m_NumberOfPoints = 0;
+    m_NumberOfCells = 0;
+    m_NumberOfPolys = 0;
+}
+
+bool ShapePopulationHeader::Scan(std::string a_filePath)
+{
+    m_FilePath = a_filePath;
+    m_Valid = false;
+    m_NumberOfPoints = 0;
+    m_NumberOfCells = 0;
+    m_NumberOfPolys = 0;
+    m_Normals = "";
+    m_PointArrays.clear();
+    m_CellArrays.clear();
+
+    std::ifstream file(a_filePath.c_str(), std::ios::in | std::ios::binary);
+    if(!file) return false;
+
+    // The reader ShapePopulationData::ReadMesh uses, by the extension or the first bytes of the file
+    std::string format = ShapePopulationReaders::GetFormat(a_filePath);
+    if (format == "VTP") m_Valid = this->ScanXML(file);
+    else if (format == "VTK") m_Valid = this->ScanLegacy(file);
+    else if (format == "PLY") m_Valid = this->ScanPLY(file);
+    else if (format == "GIfTI") m_Valid = this->ScanGIfTI(file);
+    else if (format == "STL" || format == "OFF" || format == "OBJ") m_Valid = true;      // no arrays, their sizes are not scanned
+    return m_Valid;
+}
+
+std::vector<ShapePopulationHeader> ShapePopulationHeader::ScanFiles(std::vector<std::string> a_filePaths)
+{
+    SPV_PROFILE_SCOPE("ScanHeaders");
+    std::vector<ShapePopulationHeader> headers(a_filePaths.size());
+
+    // One file per block, the scans are limited by the disk rather than the CPU
+    HeaderScan scan;
+    scan.filePaths = &a_filePaths;
+    scan.headers = &headers;
+    ShapePopulationParallel::For(a_filePaths.size(), 1, ScanBlock, &scan);
+    return headers;
+}
+
+void ShapePopulationHeader::ScanBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    HeaderScan * scan = static_cast<HeaderScan *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        (*scan->headers)[i].Scan((*scan->filePaths)[i]);
+    }
+}
+
+std::vector<std::string> ShapePopulationHeader::ComputeCommonAttributes(std::vector<ShapePopulationHeader> &a_headers)
+{
+    std::vector<std::string> commonAttributes;
+    bool first = true;
+    for(unsigned int i = 0; i < a_headers.size(); i++)
+    {
+        if(!a_headers[i].IsValid()) continue;
+        std::vector<std::string> attributes = a_headers[i].GetAttributeList();
+        if(first)
+        {
+            commonAttributes = attributes;
+            first = false;
+            continue;
+        }
+
+        std::vector<std::string> intersection;
+        std::set_intersection(commonAttributes.begin(), commonAttributes.end(),
+                              attributes.begin(), attributes.end(),
+                              std::back_inserter(intersection));
+        commonAttributes = intersection;
+    }
+    return commonAttributes;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          ATTRIBUTES                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+std::vector<std::string> ShapePopulationHeader::GetAttributeList()
+{
+    std::vector<std::string> attributes;
+    std::vector<std::string> derived;
+    for(unsigned int j = 0; j < m_PointArrays.size(); j++)
+    {
+        int dim = m_PointArrays[j].numberOfComponents;
+        if((dim == 1 || dim == 3) && m_PointArrays[j].name != m_Normals) attributes.push_back(m_PointArrays[j].name);
+        this->AddDerivedAttributes(m_PointArrays[j], derived);
+    }
+    // vtkPolyDataNormals replaces the normals of the file
+    if(m_NumberOfPolys > 0) attributes.push_back("Normals");
+
+    // Cell arrays, hidden by the point arrays of the same name
+    unsigned int numberOfPointAttributes = attributes.size();
+    for(unsigned int j = 0; j < m_CellArrays.size(); j++)
+    {
+        if(this->GetPointArray(m_CellArrays[j].name) != NULL) continue;
+        this->AddDerivedAttributes(m_CellArrays[j], derived);
+        int dim = m_CellArrays[j].numberOfComponents;
+        if(dim != 1 && dim != 3) continue;
+        if(std::find(attributes.begin(), attributes.begin() + numberOfPointAttributes, m_CellArrays[j].name) == attributes.begin() + numberOfPointAttributes)
+        {
+            attributes.push_back(m_CellArrays[j].name);
+        }
+    }
+    attributes.insert(attributes.end(), derived.begin(), derived.end());
+
+    std::sort(attributes.begin(), attributes.end());
+    attributes.erase(std::unique(attributes.begin(), attributes.end()), attributes.end());
+    return attributes;
+}
+
+void ShapePopulationHeader::AddDerivedAttributes(const ArrayHeader &a_array, std::vector<std::string> &a_attributes)
+{
+    // As ShapePopulationData lists them : not when an array of the file has the name
+    std::vector<ShapePopulationComponents::DerivedAttribute> derived = ShapePopulationComponents::GetDerivedAttributes(a_array.name, a_array.numberOfComponents);
+    for(unsigned int k = 0; k < derived.size(); k++)
+    {
+        if(this->GetPointArray(derived[k].name) != NULL || this->GetCellArray(derived[k].name) != NULL) continue;
+        a_attributes.push_back(derived[k].name);
+    }
+}
+
+ShapePopulationHeader::ArrayHeader * ShapePopulationHeader::GetPointArray(std::string a_name)
+{
+    for(unsigned int j = 0; j < m_PointArrays.size(); j++)
+    {
+        if(m_PointArrays[j].name == a_name) return &m_PointArrays[j];
+    }
+    return NULL;
+}
+
+ShapePopulationHeader::ArrayHeader * ShapePopulationHeader::GetCellArray(std::string a_name)
+{
+    for(unsigned int j = 0; j < m_CellArrays.size(); j++)
+    {
+        if(m_CellArrays[j].name == a_name) return &m_CellArrays[j];
+    }
+    return NULL;
+}
+
+int ShapePopulationHeader::GetNumberOfComponents(std::string a_attribute)
+{
+    if(a_attribute == "Normals" && m_NumberOfPolys > 0) return 3;
+    for(unsigned int j = 0; j < m_PointArrays.size(); j++)
+    {
+        if(m_PointArrays[j].name == a_attribute && a_attribute != m_Normals) return m_PointArrays[j].numberOfComponents;
+    }
+    for(unsigned int j = 0; j < m_CellArrays.size(); j++)
+    {
+        if(m_CellArrays[j].name == a_attribute) return m_CellArrays[j].numberOfComponents;
+    }
+
+    // Derived attributes : scalars
+    std::vector<std::string> attributes = this->GetAttributeList();
+    if(std::find(attributes.begin(), attributes.end(), a_attribute) != attributes.end()) return 1;
+    return 0;
+}
+
+bool ShapePopulationHeader::GetRange(std::string a_attribute, double a_range[2])
+{
+    // The point array first, it hides the cell array
+    std::vector<ArrayHeader> * arrays[2] = {&m_PointArrays, &m_CellArrays};
+    for(int k = 0; k < 2; k++)
+    {
+        for(unsigned int j = 0; j < arrays[k]->size(); j++)
+        {
+            ArrayHeader &array = (*arrays[k])[j];
+            if(array.name != a_attribute) continue;
+            if(!array.hasRange) return false;
+            a_range[0] = array.range[0];
+            a_range[1] = array.range[1];
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShapePopulationHeader::AddPointArray(std::string a_name, int a_numberOfComponents)
+{
+    ArrayHeader array;
+    array.name = a_name;
+    array.numberOfComponents = a_numberOfComponents;
+    array.hasRange = false;
+    array.range[0] = array.range[1] = 0.0;
+    m_PointArrays.push_back(array);
+}
+
+void ShapePopulationHeader::AddCellArray(std::string a_name, int a_numberOfComponents)
+{
+    ArrayHeader array;
+    array.name = a_name;
+    array.numberOfComponents = a_numberOfComponents;
+    array.hasRange = false;
+    array.range[0] = array.range[1] = 0.0;
+    m_CellArrays.push_back(array);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           XML FILES                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+static std::string spvXMLDecode(std::string a_value)
+{
+    const char * entities[5][2] = {{"&lt;", "<"}, {"&gt;", ">"}, {"&quot;", "\""}, {"&apos;", "'"}, {"&amp;", "&"}};
+    for(int k = 0; k < 5; k++)
+    {
+        size_t position = 0;
+        while((position = a_value.find(entities[k][0], position)) != std::string::npos)
+        {
+            a_value.replace(position, std::string(entities[k][0]).size(), entities[k][1]);
+            position++;
+        }
+    }
+    return a_value;
+}
+
+// Value of the attribute a_attribute="..." of a tag
+static bool spvXMLAttribute(const std::string &a_tag, const char * a_attribute, std::string &a_value)
+{
+    std::string key = std::string(a_attribute) + "=\"";
+    size_t position = a_tag.find(key);
+    while(position != std::string::npos && (position == 0 || !isspace(a_tag[position - 1]))) position = a_tag.find(key, position + 1);
+    if(position == std::string::npos) return false;
+
+    size_t begin = position + key.size();
+    size_t end = a_tag.find('"', begin);
+    if(end == std::string::npos) return false;
+    a_value = spvXMLDecode(a_tag.substr(begin, end - begin));
+    return true;
+}
+
+bool ShapePopulationHeader::ScanXML(std::ifstream &a_file)
+{
+    bool polyData = false;
+    bool pointData = false;
+    bool cellData = false;
+    int numberOfPieces = 0;
+
+    // Text between the tags (inline data) is skipped, the appended data is never read
+    std::string tag;
+    while(a_file.ignore(std::numeric_limits<std::streamsize>::max(), '<') && std::getline(a_file, tag, '>'))
+    {
+        bool empty = !tag.empty() && tag[tag.size() - 1] == '/';
+        std::string element = tag.substr(0, tag.find_first_of(" \t\r\n/", 1));
+        std::string value;
+
+        if(element == "VTKFile")
+        {
+            if(!spvXMLAttribute(tag, "type", value) || value != "PolyData") return false;
+        }
+        else if(element == "PolyData") polyData = true;
+        else if(element == "Piece")
+        {
+            numberOfPieces++;
+            if(spvXMLAttribute(tag, "NumberOfPoints", value)) m_NumberOfPoints += spvToIdType(value);
+            const char * cells[4] = {"NumberOfVerts", "NumberOfLines", "NumberOfStrips", "NumberOfPolys"};
+            for(int k = 0; k < 4; k++)
+            {
+                if(!spvXMLAttribute(tag, cells[k], value)) continue;
+                m_NumberOfCells += spvToIdType(value);
+                if(k >= 2) m_NumberOfPolys += spvToIdType(value);
+            }
+        }
+        else if(element == "PointData" && numberOfPieces == 1)          // the pieces share their arrays
+        {
+            pointData = !empty;
+            if(spvXMLAttribute(tag, "Normals", value)) m_Normals = value;
+        }
+        else if(element == "/PointData") pointData = false;
+        else if(element == "CellData" && numberOfPieces == 1) cellData = !empty;
+        else if(element == "/CellData") cellData = false;
+        else if(element == "DataArray" && (pointData || cellData))
+        {
+            if(!spvXMLAttribute(tag, "Name", value)) continue;
+            std::string components;
+            int numberOfComponents = spvXMLAttribute(tag, "NumberOfComponents", components) ? atoi(components.c_str()) : 1;
+            if(pointData) this->AddPointArray(value, numberOfComponents);
+            else this->AddCellArray(value, numberOfComponents);
+            ArrayHeader &array = pointData ? m_PointArrays.back() : m_CellArrays.back();
+
+            std::string minimum, maximum;
+            if(spvXMLAttribute(tag, "RangeMin", minimum) && spvXMLAttribute(tag, "RangeMax", maximum))
+            {
+                array.hasRange = true;
+                array.range[0] = atof(minimum.c_str());
+                array.range[1] = atof(maximum.c_str());
+            }
+        }
+        else if(element == "AppendedData" || element == "/PolyData") break;
+    }
+    return polyData && numberOfPieces > 0;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                         LEGACY FILES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// Legacy names encode the spaces and special characters as %xx
+static std::string spvLegacyDecode(std::string a_name)
+{
+    std::string decoded;
+    for(unsigned int i = 0; i < a_name.size(); i++)
+    {
+        if(a_name[i] == '%' && i + 2 < a_name.size() && isxdigit(a_name[i + 1]) && isxdigit(a_name[i + 2]))
+        {
+            decoded += (char)strtol(a_name.substr(i + 1, 2).c_str(), NULL, 16);
+            i += 2;
+        }
+        else decoded += a_name[i];
+    }
+    return decoded;
+}
+
+// Bytes of a binary value, 0 for the types which can not be skipped
+static int spvLegacyTypeSize(std::string a_type)
+{
+    a_type = spvLowerCase(a_type);
+    if(a_type == "unsigned_char" || a_type == "char" || a_type == "signed_char") return 1;
+    if(a_type == "unsigned_short" || a_type == "short") return 2;
+    if(a_type == "unsigned_int" || a_type == "int" || a_type == "float" || a_type == "vtkidtype") return 4;
+    if(a_type == "unsigned_long" || a_type == "long") return sizeof(long);
+    if(a_type == "double" || a_type == "vtktypeint64" || a_type == "vtktypeuint64") return 8;
+    return 0;
+}
+
+// Skips the values which follow the current line
+static bool spvLegacySkip(std::ifstream &a_file, bool a_binary, std::string a_type, vtkIdType a_count)
+{
+    if(a_count < 0) return false;
+    if(!a_binary)
+    {
+        std::string value;
+        for(vtkIdType i = 0; i < a_count; i++)
+        {
+            if(!(a_file >> value)) return false;
+        }
+        return true;
+    }
+
+    std::streamoff bytes = 0;
+    if(spvLowerCase(a_type) == "bit") bytes = (a_count + 7)/8;
+    else if(spvLegacyTypeSize(a_type) > 0) bytes = (std::streamoff)a_count*spvLegacyTypeSize(a_type);
+    else return false;
+
+    a_file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    a_file.seekg(bytes, std::ios::cur);
+    return a_file.good();
+}
+
+// Blank line terminated
+static void spvLegacySkipMetaData(std::ifstream &a_file)
+{
+    std::string line;
+    std::getline(a_file, line);
+    while(std::getline(a_file, line))
+    {
+        if(line.find_first_not_of(" \t\r") == std::string::npos) break;
+    }
+}
+
+bool ShapePopulationHeader::ScanLegacy(std::ifstream &a_file)
+{
+    // # vtk DataFile Version x.x, title, ASCII or BINARY, DATASET POLYDATA
+    std::string line;
+    if(!std::getline(a_file, line) || line.find("vtk DataFile Version") == std::string::npos) return false;
+    double version = atof(line.substr(line.find("Version") + 7).c_str());
+    std::getline(a_file, line);
+
+    std::string token;
+    if(!(a_file >> token)) return false;
+    bool binary = (spvLowerCase(token) == "binary");
+    if(!(a_file >> token) || spvLowerCase(token) != "dataset") return false;
+    if(!(a_file >> token) || spvLowerCase(token) != "polydata") return false;
+
+    bool pointData = false;
+    vtkIdType numberOfTuples = 0;
+    while(a_file >> token)
+    {
+        std::string keyword = spvLowerCase(token);
+        std::string name, type;
+        int numberOfComponents = 1;
+
+        if(keyword == "points")
+        {
+            a_file >> m_NumberOfPoints >> type;
+            if(!spvLegacySkip(a_file, binary, type, 3*m_NumberOfPoints)) return false;
+        }
+        else if(keyword == "vertices" || keyword == "lines" || keyword == "polygons" || keyword == "triangle_strips")
+        {
+            vtkIdType numberOfCells = 0, size = 0;
+            a_file >> numberOfCells >> size;
+            if(version >= 5.0)
+            {
+                // OFFSETS (one more than the cells) and CONNECTIVITY arrays
+                a_file >> token >> type;
+                if(!spvLegacySkip(a_file, binary, type, numberOfCells)) return false;
+                a_file >> token >> type;
+                if(!spvLegacySkip(a_file, binary, type, size)) return false;
+                numberOfCells = std::max((vtkIdType)0, numberOfCells - 1);
+            }
+            else if(!spvLegacySkip(a_file, binary, "int", size)) return false;
+
+            m_NumberOfCells += numberOfCells;
+            if(keyword == "polygons" || keyword == "triangle_strips") m_NumberOfPolys += numberOfCells;
+        }
+        else if(keyword == "point_data" || keyword == "cell_data")
+        {
+            a_file >> numberOfTuples;
+            pointData = (keyword == "point_data");
+        }
+        else if(keyword == "scalars")
+        {
+            // SCALARS name type [numComp] then LOOKUP_TABLE name
+            std::getline(a_file, line);
+            std::istringstream header(line);
+            header >> name >> type;
+            if(!(header >> numberOfComponents)) numberOfComponents = 1;
+            if(!(a_file >> token) || spvLowerCase(token) != "lookup_table" || !(a_file >> token)) return false;
+            if(!spvLegacySkip(a_file, binary, type, numberOfComponents*numberOfTuples)) return false;
+            if(pointData) this->AddPointArray(spvLegacyDecode(name), numberOfComponents);
+            else this->AddCellArray(spvLegacyDecode(name), numberOfComponents);
+        }
+        else if(keyword == "color_scalars")
+        {
+            a_file >> name >> numberOfComponents;
+            if(!spvLegacySkip(a_file, binary, binary ? "unsigned_char" : "float", numberOfComponents*numberOfTuples)) return false;
+            if(pointData) this->AddPointArray(spvLegacyDecode(name), numberOfComponents);
+            else this->AddCellArray(spvLegacyDecode(name), numberOfComponents);
+        }
+        else if(keyword == "lookup_table")
+        {
+            vtkIdType size = 0;
+            a_file >> name >> size;
+            if(!spvLegacySkip(a_file, binary, binary ? "unsigned_char" : "float", 4*size)) return false;
+        }
+        else if(keyword == "vectors" || keyword == "normals" || keyword == "tensors" || keyword == "tensors6"
+                || keyword == "global_ids" || keyword == "pedigree_ids")
+        {
+            a_file >> name >> type;
+            if(keyword == "vectors" || keyword == "normals") numberOfComponents = 3;
+            else if(keyword == "tensors") numberOfComponents = 9;
+            else if(keyword == "tensors6") numberOfComponents = 6;
+            if(!spvLegacySkip(a_file, binary, type, numberOfComponents*numberOfTuples)) return false;
+
+            if(pointData) this->AddPointArray(spvLegacyDecode(name), numberOfComponents);
+            else this->AddCellArray(spvLegacyDecode(name), numberOfComponents);
+            if(pointData && keyword == "normals") m_Normals = spvLegacyDecode(name);
+        }
+        else if(keyword == "texture_coordinates")
+        {
+            a_file >> name >> numberOfComponents >> type;
+            if(!spvLegacySkip(a_file, binary, type, numberOfComponents*numberOfTuples)) return false;
+            if(pointData) this->AddPointArray(spvLegacyDecode(name), numberOfComponents);
+            else this->AddCellArray(spvLegacyDecode(name), numberOfComponents);
+        }
+        else if(keyword == "field")
+        {
+            // FIELD name numArrays, then for each array : name numComp numTuples type
+            int numberOfArrays = 0;
+            a_file >> name >> numberOfArrays;
+            for(int k = 0; k < numberOfArrays && a_file >> token; )
+            {
+                if(spvLowerCase(token) == "metadata")
+                {
+                    spvLegacySkipMetaData(a_file);
+                    continue;
+                }
+                k++;
+                if(spvLowerCase(token) == "null_array") continue;
+
+                vtkIdType fieldTuples = 0;
+                a_file >> numberOfComponents >> fieldTuples >> type;
+                if(!spvLegacySkip(a_file, binary, type, numberOfComponents*fieldTuples)) return false;
+                if(pointData) this->AddPointArray(spvLegacyDecode(token), numberOfComponents);
+                else this->AddCellArray(spvLegacyDecode(token), numberOfComponents);
+            }
+        }
+        else if(keyword == "metadata") spvLegacySkipMetaData(a_file);
+        else return false;                                              // unknown section, the rest can not be skipped
+
+        if(a_file.fail()) return false;
+    }
+    return true;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                              PLY                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationHeader::ScanPLY(std::ifstream &a_file)
+{
+    // ply, format, then the elements and their properties up to end_header
+    std::string line;
+    if(!std::getline(a_file, line) || line.compare(0, 3, "ply") != 0) return false;
+
+    std::string element;
+    while(std::getline(a_file, line))
+    {
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        std::istringstream stream(line);
+        std::string keyword, type, name;
+        stream >> keyword;
+        if(keyword == "end_header") return (m_NumberOfPoints > 0);
+        if(keyword == "element")
+        {
+            vtkIdType count = 0;
+            stream >> element >> count;
+            if(element == "vertex") m_NumberOfPoints = count;
+            if(element == "face")
+            {
+                m_NumberOfCells = count;
+                m_NumberOfPolys = count;
+            }
+        }
+        else if(keyword == "property" && element == "vertex")
+        {
+            // ShapePopulationSurfaceFormats::ReadPLY : coordinates, normals computed again, the rest as attributes
+            stream >> type >> name;
+            if(type == "list") return false;
+            if(name != "x" && name != "y" && name != "z" && name != "nx" && name != "ny" && name != "nz") this->AddPointArray(name, 1);
+        }
+    }
+    return false;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             GIFTI                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+struct spvGIfTIArrayHeader
+{
+    std::string intent;
+    std::string name;                                                   // from the meta data
+    vtkIdType numberOfTuples;
+    int numberOfComponents;
+};
+
+static std::string spvTrim(std::string a_string)
+{
+    size_t first = a_string.find_first_not_of(" \t\r\n");
+    size_t last = a_string.find_last_not_of(" \t\r\n");
+    return (first == std::string::npos) ? "" : a_string.substr(first, last - first + 1);
+}
+
+bool ShapePopulationHeader::ScanGIfTI(std::ifstream &a_file)
+{
+    // The start tags of the data arrays and their meta data, the text of the Data elements being skipped
+    bool gifti = false;
+    bool dataArray = false;
+    bool data = false;
+    std::vector<spvGIfTIArrayHeader> arrays;
+    std::string text, tag, content, metaDataName;
+    while(true)
+    {
+        if(data) a_file.ignore(std::numeric_limits<std::streamsize>::max(), '<');
+        else std::getline(a_file, text, '<');
+        if(!a_file || !std::getline(a_file, tag, '>')) break;
+
+        // <Value><![CDATA[thickness]]></Value>
+        if(tag.compare(0, 8, "![CDATA[") == 0)
+        {
+            content += tag.substr(8, tag.size() >= 10 ? tag.size() - 10 : 0);
+            continue;
+        }
+        std::string element = tag.substr(0, tag.find_first_of(" \t\r\n/", 1));
+        std::string value;
+        if(element == "GIFTI") gifti = true;
+        else if(element == "DataArray")
+        {
+            // Dimensions as ShapePopulationSurfaceFormats::ReadGIfTI decodes them
+            spvGIfTIArrayHeader array;
+            spvXMLAttribute(tag, "Intent", array.intent);
+            int dimensionality = spvXMLAttribute(tag, "Dimensionality", value) ? atoi(value.c_str()) : 0;
+            array.numberOfTuples = spvXMLAttribute(tag, "Dim0", value) ? spvToIdType(value) : 0;
+            array.numberOfComponents = (dimensionality == 2 && spvXMLAttribute(tag, "Dim1", value)) ? atoi(value.c_str()) : 1;
+            if(dimensionality < 1 || dimensionality > 2 || array.numberOfTuples <= 0 || array.numberOfComponents <= 0) return false;
+            arrays.push_back(array);
+            dataArray = true;
+        }
+        else if(element == "/DataArray") dataArray = false;
+        else if(element == "Data" && tag[tag.size() - 1] != '/') data = true;
+        else if(element == "/Data") data = false;
+        else if(element == "/Name") metaDataName = spvTrim(content + text);
+        else if(element == "/Value" && dataArray && metaDataName == "Name") arrays.back().name = spvTrim(content + text);
+        content = "";
+    }
+    if(!gifti) return false;
+
+    // The points and the triangles : the first arrays of their intent
+    for(unsigned int i = 0; i < arrays.size(); i++)
+    {
+        if(arrays[i].intent == "NIFTI_INTENT_POINTSET" && m_NumberOfPoints == 0) m_NumberOfPoints = arrays[i].numberOfTuples;
+        else if(arrays[i].intent == "NIFTI_INTENT_TRIANGLE" && m_NumberOfPolys == 0)
+        {
+            if(arrays[i].numberOfComponents != 3) return false;
+            m_NumberOfPolys = arrays[i].numberOfTuples;
+            m_NumberOfCells = m_NumberOfPolys;
+        }
+    }
+    if(m_NumberOfPoints == 0) return false;
+
+    // The other arrays of the vertices, named by their meta data or their intent
+    for(unsigned int i = 0; i < arrays.size(); i++)
+    {
+        const spvGIfTIArrayHeader &array = arrays[i];
+        if(array.intent == "NIFTI_INTENT_POINTSET" || array.intent == "NIFTI_INTENT_TRIANGLE") continue;
+        if(array.numberOfTuples != m_NumberOfPoints) continue;
+        std::string name = array.name;
+        if(name.empty())
+        {
+            std::ostringstream intentName;
+            intentName << ((array.intent.find("NIFTI_INTENT_") == 0) ? array.intent.substr(13) : "Array") << "_" << i;
+            name = intentName.str();
+        }
+        this->AddPointArray(name, array.numberOfComponents);
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef SHAPEPOPULATIONHEADER_H
+#define SHAPEPOPULATIONHEADER_H
+
+#include <vtkVersion.h>
+#include <vtkType.h>
+
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationComponents.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+// Sizes and attributes of a mesh file, read without loading its data.
+// .vtp files are read up to their appended data (inline data arrays are skipped, not decoded),
+// legacy .vtk files section by section, binary data being skipped with seekg. The attribute list
+// is the one ShapePopulationData::ReadMesh builds : point arrays of dimension 1 or 3, the normals
+// of the file being replaced by the computed "Normals", then the cell arrays of dimension 1 or 3
+// whose name no point attribute has, and the attributes derived from the arrays of 2 or more than 3
+// components. The header of .ply files is read too, and the start tags of the data arrays of GIfTI files.
+// The files are recognized as ShapePopulationReaders does; STL, OFF and OBJ files have no arrays, their
+// sizes are not scanned.
+class ShapePopulationHeader
+{
+    public :
+
+    ShapePopulationHeader();
+    ~ShapePopulationHeader(){}
+
+    bool Scan(std::string a_filePath);
+    static std::vector<ShapePopulationHeader> ScanFiles(std::vector<std::string> a_filePaths);     // in parallel
+    // Attributes of all the valid headers
+    static std::vector<std::string> ComputeCommonAttributes(std::vector<ShapePopulationHeader> &a_headers);
+
+    bool IsValid() {return m_Valid;}
+    std::string GetFilePath() {return m_FilePath;}
+    vtkIdType GetNumberOfPoints() {return m_NumberOfPoints;}
+    vtkIdType GetNumberOfCells() {return m_NumberOfCells;}
+    std::vector<std::string> GetAttributeList();
+    int GetNumberOfComponents(std::string a_attribute);                 // 0 if the file has no such attribute
+    bool GetRange(std::string a_attribute, double a_range[2]);          // range stored in a .vtp file (magnitude of the vectors)
+
+    protected :
+
+    struct ArrayHeader
+    {
+        std::string name;
+        int numberOfComponents;
+        bool hasRange;
+        double range[2];
+    };
+
+    std::string m_FilePath;
+    bool m_Valid;
+    vtkIdType m_NumberOfPoints;
+    vtkIdType m_NumberOfCells;
+    vtkIdType m_NumberOfPolys;                                          // polygons and strips, which get normals
+    std::string m_Normals;                                              // normals of the file
+    std::vector<ArrayHeader> m_PointArrays;
+    std::vector<ArrayHeader> m_CellArrays;
+
+    bool ScanXML(std::ifstream &a_file);
+    bool ScanLegacy(std::ifstream &a_file);
+    bool ScanPLY(std::ifstream &a_file);
+    bool ScanGIfTI(std::ifstream &a_file);
+    void AddPointArray(std::string a_name, int a_numberOfComponents);
+    void AddCellArray(std::string a_name, int a_numberOfComponents);
+    ArrayHeader * GetPointArray(std::string a_name);
+    ArrayHeader * GetCellArray(std::string a_name);
+    void AddDerivedAttributes(const ArrayHeader &a_array, std::vector<std::string> &a_attributes);
+
+    static void ScanBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
@@ -0,0 +1,192 @@
+#include "ShapePopulationHistogram.h"
+
+#include <vtkPointData.h>
+
+#include <cmath>
+#include <algorithm>
+
+// Default number of bins of an attribute
+static const int s_numberOfBins = 128;
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            KERNELS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+template <class T>
+static void spvBinValues(const T * a_data, int a_numComp, vtkIdType a_size, const double a_range[2], double * a_counts, int a_numberOfBins)
+{
+    double width = a_range[1] - a_range[0];
+    double scale = (width > 0.0) ? a_numberOfBins/width : 0.0;
+    const T * data = a_data;
+    for(vtkIdType v = 0; v < a_size; v++, data += a_numComp)
+    {
+        double value = static_cast<double>(data[0]);
+        if(a_numComp == 3)
+        {
+            double y = static_cast<double>(data[1]);
+            double z = static_cast<double>(data[2]);
+            value = sqrt(value*value + y*y + z*z);
+        }
+        if(value != value) continue;                // NaN
+
+        int bin = (int)((value - a_range[0])*scale);
+        if(bin < 0) bin = 0;
+        if(bin >= a_numberOfBins) bin = a_numberOfBins - 1;
+        a_counts[bin] += 1.0;
+    }
+}
+
+struct HistogramTask
+{
+    vtkDataArray * array;
+    const double * range;
+    std::vector<double> * counts;
+    int numberOfBins;
+};
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          HISTOGRAMS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationHistogram::ShapePopulationHistogram()
+{
+    m_NumberOfBins = s_numberOfBins;
+}
+
+void ShapePopulationHistogram::SetNumberOfBins(int a_numberOfBins)
+{
+    if(a_numberOfBins < 1 || a_numberOfBins == m_NumberOfBins) return;
+    m_NumberOfBins = a_numberOfBins;
+    m_Histograms.clear();
+}
+
+void ShapePopulationHistogram::Update(std::vector<ShapePopulationData *> a_meshes, std::vector<std::string> a_attributes)
+{
+    // Forget the attributes which are not common anymore
+    std::map<std::string, AttributeHistograms>::iterator it = m_Histograms.begin();
+    while(it != m_Histograms.end())
+    {
+        if(std::find(a_attributes.begin(), a_attributes.end(), it->first) == a_attributes.end()) m_Histograms.erase(it++);
+        else ++it;
+    }
+
+    // Histograms to compute : (attribute, mesh) pairs whose array or bins changed
+    std::vector<HistogramTask> tasks;
+    for(unsigned int a = 0; a < a_attributes.size(); a++)
+    {
+        std::vector<vtkDataArray *> arrays;
+        double range[2] = {0.0, 0.0};
+        for(unsigned int i = 0; i < a_meshes.size(); i++)
+        {
+            vtkDataArray * array = a_meshes[i]->GetAttribute(a_attributes[a]);
+            if(array == NULL) break;
+
+            double arrayRange[2];
+            array->GetRange(arrayRange, (array->GetNumberOfComponents() == 1) ? 0 : -1);
+            if(i == 0 || arrayRange[0] < range[0]) range[0] = arrayRange[0];
+            if(i == 0 || arrayRange[1] > range[1]) range[1] = arrayRange[1];
+            arrays.push_back(array);
+        }
+        if(arrays.size() != a_meshes.size()) continue;
+
+        AttributeHistograms &histograms = m_Histograms[a_attributes[a]];
+        bool sameBins = histograms.arrays.size() > 0 && histograms.numberOfBins == m_NumberOfBins
+                        && histograms.range[0] == range[0] && histograms.range[1] == range[1];
+        histograms.range[0] = range[0];
+        histograms.range[1] = range[1];
+        histograms.numberOfBins = m_NumberOfBins;
+        std::vector<vtkDataArray *> previousArrays = histograms.arrays;
+        std::vector<unsigned long> previousTimes = histograms.times;
+        histograms.arrays = arrays;
+        histograms.times.resize(arrays.size());
+        histograms.counts.resize(arrays.size());
+
+        for(unsigned int i = 0; i < arrays.size(); i++)
+        {
+            bool upToDate = sameBins && i < previousArrays.size() && previousArrays[i] == arrays[i] && previousTimes[i] == arrays[i]->GetMTime();
+            histograms.times[i] = arrays[i]->GetMTime();
+            if(upToDate) continue;
+
+            HistogramTask task;
+            task.array = arrays[i];
+            task.range = histograms.range;
+            task.counts = &histograms.counts[i];
+            task.numberOfBins = m_NumberOfBins;
+            tasks.push_back(task);
+        }
+    }
+
+    // One task per histogram, every task has its own counts
+    if(!tasks.empty()) ShapePopulationParallel::For(tasks.size(), 1, HistogramBlock, &tasks);
+}
+
+void ShapePopulationHistogram::HistogramBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    std::vector<HistogramTask> * tasks = static_cast<std::vector<HistogramTask> *>(a_data);
+    for(vtkIdType t = a_begin; t < a_end; t++)
+    {
+        HistogramTask &task = (*tasks)[t];
+        task.counts->assign(task.numberOfBins, 0.0);
+        vtkDataArray * array = task.array;
+        switch(array->GetDataType())
+        {
+            vtkTemplateMacro(spvBinValues(static_cast<VTK_TT *>(array->GetVoidPointer(0)), array->GetNumberOfComponents(),
+                                          array->GetNumberOfTuples(), task.range, &(*task.counts)[0], task.numberOfBins));
+        }
+    }
+}
+
+void ShapePopulationHistogram::GetRange(std::string a_attribute, double a_range[2])
+{
+    a_range[0] = 0.0;
+    a_range[1] = 0.0;
+    std::map<std::string, AttributeHistograms>::iterator it = m_Histograms.find(a_attribute);
+    if(it == m_Histograms.end()) return;
+    a_range[0] = it->second.range[0];
+    a_range[1] = it->second.range[1];
+}
+
+std::vector<double> ShapePopulationHistogram::GetHistogram(std::string a_attribute, unsigned int a_mesh)
+{
+    std::map<std::string, AttributeHistograms>::iterator it = m_Histograms.find(a_attribute);
+    if(it == m_Histograms.end() || a_mesh >= it->second.counts.size()) return std::vector<double>();
+    return it->second.counts[a_mesh];
+}
+
+std::vector<double> ShapePopulationHistogram::GetMergedHistogram(std::string a_attribute, std::vector<unsigned int> a_meshes)
+{
+    std::map<std::string, AttributeHistograms>::iterator it = m_Histograms.find(a_attribute);
+    if(it == m_Histograms.end()) return std::vector<double>();
+
+    std::vector<double> merged(it->second.numberOfBins, 0.0);
+    for(unsigned int i = 0; i < a_meshes.size(); i++)
+    {
+        if(a_meshes[i] >= it->second.counts.size()) continue;
+        const std::vector<double> &counts = it->second.counts[a_meshes[i]];
+        for(unsigned int b = 0; b < counts.size() && b < merged.size(); b++) merged[b] += counts[b];
+    }
+    return merged;
+}
+
+double ShapePopulationHistogram::ComputePercentile(const std::vector<double> &a_histogram, const double a_range[2], double a_percentile)
+{
+    double total = 0.0;
+    for(unsigned int b = 0; b < a_histogram.size(); b++) total += a_histogram[b];
+    if(total == 0.0) return a_range[0];
+
+    double target = std::max(0.0, std::min(100.0, a_percentile))/100.0*total;
+    double width = (a_range[1] - a_range[0])/a_histogram.size();
+    double cumulative = 0.0;
+    for(unsigned int b = 0; b < a_histogram.size(); b++)
+    {
+        if(a_histogram[b] > 0.0 && cumulative + a_histogram[b] >= target)
+        {
+            double fraction = (target - cumulative)/a_histogram[b];
+            return a_range[0] + (b + fraction)*width;
+        }
+        cumulative += a_histogram[b];
+    }
+    return a_range[1];
+}
@@ -0,0 +1,59 @@
+#ifndef SHAPEPOPULATIONHISTOGRAM_H
+#define SHAPEPOPULATIONHISTOGRAM_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+
+#include <vtkDataArray.h>
+
+#include <vector>
+#include <string>
+#include <map>
+
+// Fixed-bin histograms of the attributes of a population, the values of the points or of the cells.
+// All the meshes share the bins of an attribute (population range), so the histogram of any
+// selection is the sum of the cached per-mesh histograms. Attributes of dimension 3 are binned
+// by magnitude.
+class ShapePopulationHistogram
+{
+    public :
+
+    ShapePopulationHistogram();
+    ~ShapePopulationHistogram(){}
+
+    void SetNumberOfBins(int a_numberOfBins);
+    int GetNumberOfBins() {return m_NumberOfBins;}
+
+    // Only the histograms whose mesh, array or population range changed since the last call are computed again
+    void Update(std::vector<ShapePopulationData *> a_meshes, std::vector<std::string> a_attributes);
+    void Clear() {m_Histograms.clear();}
+
+    bool HasAttribute(std::string a_attribute) {return m_Histograms.find(a_attribute) != m_Histograms.end();}
+    void GetRange(std::string a_attribute, double a_range[2]);
+    std::vector<double> GetHistogram(std::string a_attribute, unsigned int a_mesh);
+    std::vector<double> GetMergedHistogram(std::string a_attribute, std::vector<unsigned int> a_meshes);
+
+    // a_percentile in [0, 100], linear inside the bins
+    static double ComputePercentile(const std::vector<double> &a_histogram, const double a_range[2], double a_percentile);
+
+    protected :
+
+    struct AttributeHistograms
+    {
+        double range[2];
+        int numberOfBins;
+        std::vector<vtkDataArray *> arrays;
+        std::vector<unsigned long> times;
+        std::vector< std::vector<double> > counts;      // one histogram per mesh
+    };
+
+    std::map<std::string, AttributeHistograms> m_Histograms;
+    int m_NumberOfBins;
+
+    static void HistogramBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
@@ -0,0 +1,235 @@
+#include "ShapePopulationLabels.h"
+
+#include <cmath>
+#include <sstream>
+
+// Above, the attribute is not taken for a label attribute
+static const unsigned int s_maximumNumberOfLabels = 1024;
+
+static double spvTriangleArea(vtkPolyData * a_polyData, vtkIdType a_first, vtkIdType a_second, vtkIdType a_third)
+{
+    double a[3], b[3], c[3];
+    a_polyData->GetPoint(a_first, a);
+    a_polyData->GetPoint(a_second, b);
+    a_polyData->GetPoint(a_third, c);
+    double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    double normal[3] = {ab[1]*ac[2] - ab[2]*ac[1], ab[2]*ac[0] - ab[0]*ac[2], ab[0]*ac[1] - ab[1]*ac[0]};
+    return 0.5*sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+}
+
+
+ShapePopulationLabels::ShapePopulationLabels()
+{
+    m_Categorical = false;
+    m_LookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    m_LookupTable->IndexedLookupOn();
+}
+
+void ShapePopulationLabels::Clear()
+{
+    m_Meshes.clear();
+    m_Attribute.clear();
+    m_Categorical = false;
+    m_ErrorMessage.clear();
+    m_Statistics.clear();
+    this->UpdateLookupTable();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                              SCAN                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationLabels::ScanMesh(MeshLabels &a_mesh, std::string a_attribute)
+{
+    vtkPolyData * polyData = a_mesh.mesh->GetPolyData();
+    vtkDataArray * array = a_mesh.mesh->GetAttribute(a_attribute);
+    if(array == NULL || array->GetNumberOfComponents() != 1) return false;
+    bool cells = a_mesh.mesh->IsCellAttribute(a_attribute);
+    vtkIdType numberOfTuples = array->GetNumberOfTuples();
+
+    // Area of each cell, or a third of each triangle for its points. The cell ids follow the verts, lines,
+    // polys and strips, whose connectivity is read through its pointer
+    std::vector<double> areas(numberOfTuples, 0.0);
+    vtkCellArray * cellArrays[4] = {polyData->GetVerts(), polyData->GetLines(), polyData->GetPolys(), polyData->GetStrips()};
+    vtkIdType cellId = 0;
+    for(int k = 0; k < 4; k++)
+    {
+        if(cellArrays[k] == NULL || cellArrays[k]->GetNumberOfCells() == 0) continue;
+        vtkIdType * connectivity = cellArrays[k]->GetPointer();
+        vtkIdType numberOfEntries = cellArrays[k]->GetNumberOfConnectivityEntries();
+        for(vtkIdType c = 0; c < numberOfEntries; c += connectivity[c] + 1, cellId++)
+        {
+            if(k < 2) continue;                                         // no area
+            vtkIdType npts = connectivity[c];
+            const vtkIdType * pts = &connectivity[c + 1];
+            for(vtkIdType t = 0; t + 2 < npts; t++)
+            {
+                // Fans of the polygons, consecutive triangles of the strips
+                vtkIdType triangle[3] = {pts[0], pts[t + 1], pts[t + 2]};
+                if(k == 3) triangle[0] = pts[t];
+                double area = spvTriangleArea(polyData, triangle[0], triangle[1], triangle[2]);
+                if(cells)
+                {
+                    if(cellId < numberOfTuples) areas[cellId] += area;
+                    continue;
+                }
+                for(int v = 0; v < 3; v++)
+                {
+                    if(triangle[v] < numberOfTuples) areas[triangle[v]] += area/3.0;
+                }
+            }
+        }
+    }
+
+    for(vtkIdType i = 0; i < numberOfTuples; i++)
+    {
+        double value = array->GetComponent(i, 0);
+        if(value != floor(value)) return false;
+        std::pair<vtkIdType, double> &label = a_mesh.labels[value];
+        label.first++;
+        label.second += areas[i];
+        if(a_mesh.labels.size() > s_maximumNumberOfLabels) return false;
+    }
+    return true;
+}
+
+void ShapePopulationLabels::ScanBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    Scan * scan = static_cast<Scan *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        MeshLabels &mesh = (*scan->meshes)[i];
+        mesh.valid = ScanMesh(mesh, scan->attribute);
+    }
+}
+
+bool ShapePopulationLabels::Compute(std::vector<ShapePopulationData *> a_meshes, std::string a_attribute)
+{
+    SPV_PROFILE_SCOPE("ComputeLabels");
+    this->Clear();
+    m_Meshes = a_meshes;
+    m_Attribute = a_attribute;
+    if(a_meshes.empty())
+    {
+        m_ErrorMessage = "No mesh is loaded.";
+        return false;
+    }
+
+    // A scan per mesh, in parallel
+    std::vector<MeshLabels> meshLabels(a_meshes.size());
+    for(unsigned int i = 0; i < a_meshes.size(); i++)
+    {
+        meshLabels[i].mesh = a_meshes[i];
+        meshLabels[i].valid = false;
+    }
+    Scan scan;
+    scan.meshes = &meshLabels;
+    scan.attribute = a_attribute;
+    ShapePopulationParallel::For(a_meshes.size(), 1, ScanBlock, &scan);
+
+    // Population : the labels of all the meshes
+    std::map<double, LabelStatistics> labels;
+    for(unsigned int i = 0; i < meshLabels.size(); i++)
+    {
+        if(!meshLabels[i].valid)
+        {
+            std::ostringstream strs;
+            strs << a_attribute << " of " << a_meshes[i]->GetFileName() << " is not a label attribute : one integer value per point or cell, "
+                 << s_maximumNumberOfLabels << " labels at most.";
+            m_ErrorMessage = strs.str();
+            return false;
+        }
+        std::map<double, std::pair<vtkIdType, double> >::iterator it;
+        for(it = meshLabels[i].labels.begin(); it != meshLabels[i].labels.end(); ++it)
+        {
+            LabelStatistics &label = labels[it->first];
+            if(label.numberOfMeshes == 0)
+            {
+                label.label = it->first;
+                label.count = 0;
+                label.area = 0.0;
+            }
+            label.numberOfMeshes++;
+            label.count += it->second.first;
+            label.area += it->second.second;
+        }
+        if(labels.size() > s_maximumNumberOfLabels)
+        {
+            std::ostringstream strs;
+            strs << a_attribute << " has more than " << s_maximumNumberOfLabels << " labels over the meshes loaded.";
+            m_ErrorMessage = strs.str();
+            return false;
+        }
+    }
+
+    std::map<double, LabelStatistics>::iterator it;
+    for(it = labels.begin(); it != labels.end(); ++it) m_Statistics.push_back(it->second);
+    m_Categorical = true;
+    this->UpdateLookupTable();
+    ShapePopulationProfiler::AddCount("Labels", m_Statistics.size());
+    return true;
+}
+
+bool ShapePopulationLabels::IsComputed(std::vector<ShapePopulationData *> a_meshes, std::string a_attribute)
+{
+    return (!m_Attribute.empty() && m_Attribute == a_attribute && m_Meshes == a_meshes);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            COLOURS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationLabels::GetColor(unsigned int a_index, double a_color[3])
+{
+    a_color[0] = a_color[1] = a_color[2] = 1.0;
+    if(a_index >= m_Statistics.size()) return;
+
+    // The hue follows the label, not its index : a label keeps its colour when the population changes.
+    // Golden ratio steps keep the hues of consecutive labels apart, the value alternates
+    long label = (long)m_Statistics[a_index].label;
+    double hue = fmod(fabs(label*0.618033988749895), 1.0);
+    double value = (label % 2 == 0) ? 0.95 : 0.75;
+    vtkMath::HSVToRGB(hue, 0.65, value, &a_color[0], &a_color[1], &a_color[2]);
+}
+
+void ShapePopulationLabels::UpdateLookupTable()
+{
+    // Indexed lookup : the value of each annotation gets the colour of the same index
+    m_LookupTable->ResetAnnotations();
+    m_LookupTable->SetNumberOfTableValues(m_Statistics.empty() ? 1 : m_Statistics.size());
+    for(unsigned int i = 0; i < m_Statistics.size(); i++)
+    {
+        double color[3];
+        this->GetColor(i, color);
+        m_LookupTable->SetTableValue(i, color[0], color[1], color[2], this->GetLabelVisibility(m_Statistics[i].label) ? 1.0 : 0.0);
+
+        std::ostringstream strs;
+        strs << m_Statistics[i].label;
+        m_LookupTable->SetAnnotation(vtkVariant(m_Statistics[i].label), strs.str());
+    }
+    m_LookupTable->Modified();
+}
+
+void ShapePopulationLabels::SetLabelVisibility(double a_label, bool a_visible)
+{
+    if(a_visible) m_Hidden.erase(a_label);
+    else m_Hidden[a_label] = true;
+
+    // Only the opacity of the label in the table
+    for(unsigned int i = 0; i < m_Statistics.size(); i++)
+    {
+        if(m_Statistics[i].label != a_label) continue;
+        double color[3];
+        this->GetColor(i, color);
+        m_LookupTable->SetTableValue(i, color[0], color[1], color[2], a_visible ? 1.0 : 0.0);
+        m_LookupTable->Modified();
+    }
+}
+
+bool ShapePopulationLabels::GetLabelVisibility(double a_label)
+{
+    return (m_Hidden.find(a_label) == m_Hidden.end());
+}
@@ -0,0 +1,82 @@
+#ifndef SHAPEPOPULATIONLABELS_H
+#define SHAPEPOPULATIONLABELS_H
+
+#include <vtkVersion.h>
+#include <vtkLookupTable.h>
+#include <vtkVariant.h>
+#include <vtkMath.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+#include <map>
+
+// Categorical attributes (labels, parcellations) : the distinct values of an integer attribute over a
+// population, found by a parallel scan of the meshes, with the number of points or cells and the area of
+// each label. Every label has an indexed colour in a vtkLookupTable shared by the mappers : hiding a label
+// only changes its colour in the table, the meshes are not touched.
+class ShapePopulationLabels
+{
+    public :
+
+    struct LabelStatistics
+    {
+        double label;
+        int numberOfMeshes;                                             // meshes which have the label
+        vtkIdType count;                                                // points or cells, over the population
+        double area;                                                    // of the cells, or a third of the triangles of the points
+    };
+
+    ShapePopulationLabels();
+    ~ShapePopulationLabels(){}
+
+    // False if a mesh has no such attribute, if a value is not an integer, or if there are too many labels
+    bool Compute(std::vector<ShapePopulationData *> a_meshes, std::string a_attribute);
+    bool IsComputed(std::vector<ShapePopulationData *> a_meshes, std::string a_attribute);
+    void Clear();
+
+    bool IsCategorical() {return m_Categorical;}
+    std::string GetAttribute() {return m_Attribute;}
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+    unsigned int GetNumberOfLabels() {return m_Statistics.size();}
+    std::vector<LabelStatistics> GetStatistics() {return m_Statistics;}
+
+    // Colours : the visibility of a label is kept for the next attributes which have it
+    vtkLookupTable * GetLookupTable() {return m_LookupTable;}
+    void GetColor(unsigned int a_index, double a_color[3]);
+    void SetLabelVisibility(double a_label, bool a_visible);
+    bool GetLabelVisibility(double a_label);
+
+    protected :
+
+    struct MeshLabels
+    {
+        ShapePopulationData * mesh;
+        bool valid;
+        std::map<double, std::pair<vtkIdType, double> > labels;         // count and area of each label
+    };
+
+    struct Scan
+    {
+        std::vector<MeshLabels> * meshes;
+        std::string attribute;
+    };
+
+    std::vector<ShapePopulationData *> m_Meshes;
+    std::string m_Attribute;
+    bool m_Categorical;
+    std::string m_ErrorMessage;
+    std::vector<LabelStatistics> m_Statistics;                          // sorted by label
+    std::map<double, bool> m_Hidden;
+    vtkSmartPointer<vtkLookupTable> m_LookupTable;
+
+    static void ScanBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static bool ScanMesh(MeshLabels &a_mesh, std::string a_attribute);
+    void UpdateLookupTable();
+};
+
+
+#endif
@@ -0,0 +1,192 @@
+#include "ShapePopulationMeshCache.h"
+
+#include <algorithm>
+
+// Default number of resident meshes
+static const unsigned int s_capacity = 300;
+
+
+ShapePopulationMeshCache::ShapePopulationMeshCache()
+{
+    m_Capacity = s_capacity;
+    m_CancelPrefetch = false;
+}
+
+ShapePopulationMeshCache::~ShapePopulationMeshCache()
+{
+    this->Clear();
+}
+
+void ShapePopulationMeshCache::SetCapacity(unsigned int a_numberOfMeshes)
+{
+    m_Lock.Lock();
+    m_Capacity = a_numberOfMeshes;
+    this->Evict();
+    m_Lock.Unlock();
+}
+
+unsigned int ShapePopulationMeshCache::GetNumberOfMeshes()
+{
+    m_Lock.Lock();
+    unsigned int numberOfMeshes = m_Meshes.size();
+    m_Lock.Unlock();
+    return numberOfMeshes;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            LOADING                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationData * ShapePopulationMeshCache::Get(std::string a_filePath)
+{
+    m_Lock.Lock();
+    ShapePopulationData * mesh = NULL;
+    std::map<std::string, ShapePopulationData *>::iterator it = m_Meshes.find(a_filePath);
+    if(it != m_Meshes.end())
+    {
+        mesh = it->second;
+        m_Order.remove(a_filePath);
+        m_Order.push_front(a_filePath);
+    }
+    m_Lock.Unlock();
+    return mesh;
+}
+
+ShapePopulationData * ShapePopulationMeshCache::Load(std::string a_filePath)
+{
+    ShapePopulationData * mesh = this->Get(a_filePath);
+    if(mesh != NULL) return mesh;
+
+    mesh = this->ReadMesh(a_filePath);
+    if(mesh == NULL) return NULL;
+
+    m_Lock.Lock();
+    mesh = this->Insert(a_filePath, mesh);
+    m_Lock.Unlock();
+    return mesh;
+}
+
+void ShapePopulationMeshCache::Prefetch(std::vector<std::string> a_filePaths)
+{
+    m_CancelPrefetch = false;
+    for(unsigned int i = 0; i < a_filePaths.size() && !m_CancelPrefetch; i++)
+    {
+        m_Lock.Lock();
+        bool resident = m_Meshes.find(a_filePaths[i]) != m_Meshes.end();
+        bool full = m_Meshes.size() >= m_Capacity;
+        m_Lock.Unlock();
+        if(resident) continue;
+        if(full) break;
+
+        ShapePopulationData * mesh = this->ReadMesh(a_filePaths[i]);
+        if(mesh == NULL) continue;
+
+        m_Lock.Lock();
+        this->Insert(a_filePaths[i], mesh);
+        m_Lock.Unlock();
+    }
+}
+
+ShapePopulationData * ShapePopulationMeshCache::ReadMesh(std::string a_filePath)
+{
+    ShapePopulationData * mesh = new ShapePopulationData;
+    mesh->ReadMesh(a_filePath);
+    if(mesh->GetPolyData() == NULL)
+    {
+        delete mesh;
+        return NULL;
+    }
+    return mesh;
+}
+
+ShapePopulationData * ShapePopulationMeshCache::Insert(std::string a_filePath, ShapePopulationData * a_mesh)
+{
+    // Read by another thread in the meantime
+    std::map<std::string, ShapePopulationData *>::iterator it = m_Meshes.find(a_filePath);
+    if(it != m_Meshes.end())
+    {
+        delete a_mesh;
+        return it->second;
+    }
+
+    m_Meshes[a_filePath] = a_mesh;
+    m_Order.push_front(a_filePath);
+    this->Evict();
+    return a_mesh;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           RESIDENCY                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationMeshCache::Evict()
+{
+    std::list<std::string>::iterator it = m_Order.end();
+    while(m_Meshes.size() > m_Capacity && it != m_Order.begin())
+    {
+        --it;
+        ShapePopulationData * mesh = m_Meshes[*it];
+        if(m_Pinned.find(mesh) != m_Pinned.end()) continue;
+
+        delete mesh;
+        m_Meshes.erase(*it);
+        it = m_Order.erase(it);
+    }
+}
+
+void ShapePopulationMeshCache::Pin(std::vector<ShapePopulationData *> a_meshes)
+{
+    m_Lock.Lock();
+    m_Pinned.clear();
+    m_Pinned.insert(a_meshes.begin(), a_meshes.end());
+    this->Evict();
+    m_Lock.Unlock();
+}
+
+bool ShapePopulationMeshCache::Contains(ShapePopulationData * a_mesh)
+{
+    m_Lock.Lock();
+    bool found = false;
+    std::map<std::string, ShapePopulationData *>::iterator it;
+    for(it = m_Meshes.begin(); it != m_Meshes.end() && !found; ++it)
+    {
+        found = (it->second == a_mesh);
+    }
+    m_Lock.Unlock();
+    return found;
+}
+
+bool ShapePopulationMeshCache::Remove(ShapePopulationData * a_mesh)
+{
+    m_Lock.Lock();
+    bool found = false;
+    std::map<std::string, ShapePopulationData *>::iterator it;
+    for(it = m_Meshes.begin(); it != m_Meshes.end(); ++it)
+    {
+        if(it->second != a_mesh) continue;
+        m_Order.remove(it->first);
+        m_Meshes.erase(it);
+        m_Pinned.erase(a_mesh);
+        delete a_mesh;
+        found = true;
+        break;
+    }
+    m_Lock.Unlock();
+    return found;
+}
+
+void ShapePopulationMeshCache::Clear()
+{
+    m_Lock.Lock();
+    std::map<std::string, ShapePopulationData *>::iterator it;
+    for(it = m_Meshes.begin(); it != m_Meshes.end(); ++it)
+    {
+        delete it->second;
+    }
+    m_Meshes.clear();
+    m_Order.clear();
+    m_Pinned.clear();
+    m_Lock.Unlock();
+}
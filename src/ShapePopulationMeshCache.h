@@ -0,0 +1,58 @@
+#ifndef SHAPEPOPULATIONMESHCACHE_H
+#define SHAPEPOPULATIONMESHCACHE_H
+
+#include <vtkVersion.h>
+#include <vtkMutexLock.h>
+
+#include "ShapePopulationData.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <set>
+
+// Resident meshes of a population browsed page by page.
+// The cache owns its meshes and deletes the least recently used ones beyond its capacity, except the
+// pinned meshes (the ones displayed). Prefetch can run in a worker thread while the GUI thread loads
+// or pins meshes : files are read outside of the lock, a mesh read twice is only kept once.
+class ShapePopulationMeshCache
+{
+    public :
+
+    ShapePopulationMeshCache();
+    ~ShapePopulationMeshCache();
+
+    void SetCapacity(unsigned int a_numberOfMeshes);
+    unsigned int GetCapacity() {return m_Capacity;}
+    unsigned int GetNumberOfMeshes();
+
+    // Resident mesh or NULL, the mesh becomes the most recently used one
+    ShapePopulationData * Get(std::string a_filePath);
+    // Resident mesh, read if needed, NULL if the file can not be read
+    ShapePopulationData * Load(std::string a_filePath);
+    // Reads the files which are not resident, in the order given, until the cache is full or CancelPrefetch is called
+    void Prefetch(std::vector<std::string> a_filePaths);
+    void CancelPrefetch() {m_CancelPrefetch = true;}
+
+    void Pin(std::vector<ShapePopulationData *> a_meshes);          // replaces the pinned meshes
+    bool Contains(ShapePopulationData * a_mesh);
+    bool Remove(ShapePopulationData * a_mesh);                      // deletes the mesh if the cache owns it
+    void Clear();
+
+    protected :
+
+    vtkSimpleMutexLock m_Lock;
+    unsigned int m_Capacity;
+    volatile bool m_CancelPrefetch;
+    std::list<std::string> m_Order;                                 // most recently used first
+    std::map<std::string, ShapePopulationData *> m_Meshes;
+    std::set<ShapePopulationData *> m_Pinned;
+
+    ShapePopulationData * ReadMesh(std::string a_filePath);
+    ShapePopulationData * Insert(std::string a_filePath, ShapePopulationData * a_mesh);
+    void Evict();
+};
+
+
+#endif
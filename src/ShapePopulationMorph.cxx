@@ -0,0 +1,291 @@
+#include "ShapePopulationMorph.h"
+
+#include <cmath>
+#include <algorithm>
+
+// Points per block of a blend
+static const vtkIdType s_blendGrain = 16384;
+
+struct MorphBlend
+{
+    ShapePopulationMorph * morph;
+    int numberOfTerms;
+    int shapes[4];
+    float weights[4];
+    std::vector<float *> * magnitudesFloat;                             // "_mag" array of each channel, if any
+    std::vector<double *> * magnitudesDouble;
+};
+
+
+ShapePopulationMorph::ShapePopulationMorph()
+{
+    m_NumberOfShapes = 0;
+    m_Position = 0.0;
+}
+
+bool ShapePopulationMorph::CopyArray(vtkDataArray * a_array, std::vector<float> &a_values)
+{
+    if(a_array == NULL) return false;
+    vtkIdType numberOfValues = a_array->GetNumberOfTuples()*a_array->GetNumberOfComponents();
+    a_values.resize(numberOfValues);
+    if(numberOfValues == 0) return true;
+
+    vtkFloatArray * floatArray = vtkFloatArray::SafeDownCast(a_array);
+    if(floatArray != NULL)
+    {
+        std::copy(floatArray->GetPointer(0), floatArray->GetPointer(0) + numberOfValues, a_values.begin());
+        return true;
+    }
+    int numberOfComponents = a_array->GetNumberOfComponents();
+    std::vector<double> tuple(numberOfComponents);
+    for(vtkIdType v = 0; v < a_array->GetNumberOfTuples(); v++)
+    {
+        a_array->GetTuple(v, &tuple[0]);
+        for(int k = 0; k < numberOfComponents; k++) a_values[v*numberOfComponents + k] = (float)tuple[k];
+    }
+    return true;
+}
+
+bool ShapePopulationMorph::SetShapes(std::vector<ShapePopulationData *> a_shapes)
+{
+    SPV_PROFILE_SCOPE("SetMorphShapes");
+    m_Channels.clear();
+    m_Morph = NULL;
+    m_NumberOfShapes = 0;
+    m_ErrorMessage.clear();
+
+    if(a_shapes.size() < 2)
+    {
+        m_ErrorMessage = "Select at least two corresponded meshes.";
+        return false;
+    }
+    vtkPolyData * first = a_shapes[0]->GetPolyData();
+    vtkIdType numPts = first->GetNumberOfPoints();
+    for(unsigned int s = 1; s < a_shapes.size(); s++)
+    {
+        if(a_shapes[s]->GetPolyData()->GetNumberOfPoints() == numPts) continue;
+        m_ErrorMessage = a_shapes[s]->GetFileName() + " does not have the same number of points as " + a_shapes[0]->GetFileName() + ".";
+        return false;
+    }
+
+    // Channels : positions, normals, and the attributes of the first shape that all the shapes have
+    Channel points;
+    points.name = "Points";
+    points.numberOfComponents = 3;
+    points.normals = false;
+    m_Channels.push_back(points);
+
+    Channel normals;
+    normals.name = "Normals";
+    normals.numberOfComponents = 3;
+    normals.normals = true;
+    m_Channels.push_back(normals);
+
+    std::vector<std::string> attributes = a_shapes[0]->GetAttributeList();
+    for(unsigned int j = 0; j < attributes.size(); j++)
+    {
+        if(ShapePopulationData::IsDerivedArray(attributes[j])) continue;
+        vtkDataArray * array = first->GetPointData()->GetArray(attributes[j].c_str());
+        if(array == NULL || array == first->GetPointData()->GetNormals()) continue;
+
+        bool common = true;
+        for(unsigned int s = 1; s < a_shapes.size() && common; s++)
+        {
+            vtkDataArray * other = a_shapes[s]->GetPolyData()->GetPointData()->GetArray(attributes[j].c_str());
+            common = (other != NULL && other->GetNumberOfComponents() == array->GetNumberOfComponents());
+        }
+        if(!common) continue;
+
+        Channel attribute;
+        attribute.name = attributes[j];
+        attribute.numberOfComponents = array->GetNumberOfComponents();
+        attribute.normals = false;
+        m_Channels.push_back(attribute);
+    }
+
+    // Values of every shape
+    for(unsigned int c = 0; c < m_Channels.size(); c++)
+    {
+        Channel &channel = m_Channels[c];
+        channel.shapes.resize(a_shapes.size());
+        for(unsigned int s = 0; s < a_shapes.size(); s++)
+        {
+            vtkPolyData * polyData = a_shapes[s]->GetPolyData();
+            vtkDataArray * array = NULL;
+            if(c == 0) array = polyData->GetPoints()->GetData();
+            else if(c == 1) array = polyData->GetPointData()->GetNormals();
+            else array = polyData->GetPointData()->GetArray(channel.name.c_str());
+            if(CopyArray(array, channel.shapes[s])) continue;
+
+            m_ErrorMessage = a_shapes[s]->GetFileName() + " has no " + channel.name + ".";
+            m_Channels.clear();
+            return false;
+        }
+
+        channel.output = vtkSmartPointer<vtkFloatArray>::New();
+        channel.output->SetName(channel.name.c_str());
+        channel.output->SetNumberOfComponents(channel.numberOfComponents);
+        channel.output->SetNumberOfTuples(numPts);
+    }
+
+    // Morph : the topology is shared with the first shape, the arrays are the outputs of the channels
+    m_Morph = vtkSmartPointer<vtkPolyData>::New();
+    vtkSmartPointer<vtkPoints> morphPoints = vtkSmartPointer<vtkPoints>::New();
+    morphPoints->SetData(m_Channels[0].output);
+    m_Morph->SetPoints(morphPoints);
+    m_Morph->SetVerts(first->GetVerts());
+    m_Morph->SetLines(first->GetLines());
+    m_Morph->SetPolys(first->GetPolys());
+    m_Morph->SetStrips(first->GetStrips());
+    m_Morph->GetPointData()->SetNormals(m_Channels[1].output);
+    for(unsigned int c = 2; c < m_Channels.size(); c++)
+    {
+        m_Morph->GetPointData()->AddArray(m_Channels[c].output);
+    }
+
+    m_NumberOfShapes = a_shapes.size();
+    this->Blend(0.0, LINEAR);
+    return true;
+}
+
+std::vector<std::string> ShapePopulationMorph::GetAttributes()
+{
+    std::vector<std::string> attributes;
+    for(unsigned int c = 2; c < m_Channels.size(); c++) attributes.push_back(m_Channels[c].name);
+    return attributes;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             BLEND                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+int ShapePopulationMorph::ComputeWeights(double a_position, int a_interpolation, int a_numberOfShapes, int a_shapes[4], float a_weights[4])
+{
+    if(a_numberOfShapes < 2) a_position = 0.0;
+    if(a_position < 0.0) a_position = 0.0;
+    if(a_position > a_numberOfShapes - 1) a_position = a_numberOfShapes - 1;
+
+    // Segment between the shapes k and k + 1
+    int k = (int)floor(a_position);
+    if(k > a_numberOfShapes - 2) k = a_numberOfShapes - 2;
+    if(k < 0) k = 0;
+    double u = a_position - k;
+
+    if(u == 0.0 || a_numberOfShapes < 2)
+    {
+        a_shapes[0] = k;
+        a_weights[0] = 1.0f;
+        return 1;
+    }
+    if(u == 1.0)
+    {
+        a_shapes[0] = k + 1;
+        a_weights[0] = 1.0f;
+        return 1;
+    }
+    if(a_interpolation != SPLINE)
+    {
+        a_shapes[0] = k;
+        a_shapes[1] = k + 1;
+        a_weights[0] = (float)(1.0 - u);
+        a_weights[1] = (float)u;
+        return 2;
+    }
+
+    // Catmull-Rom, the first and last shapes repeated at the ends
+    double u2 = u*u;
+    double u3 = u2*u;
+    a_shapes[0] = (k > 0) ? k - 1 : k;
+    a_shapes[1] = k;
+    a_shapes[2] = k + 1;
+    a_shapes[3] = (k + 2 < a_numberOfShapes) ? k + 2 : k + 1;
+    a_weights[0] = (float)(0.5*(-u3 + 2.0*u2 - u));
+    a_weights[1] = (float)(0.5*(3.0*u3 - 5.0*u2 + 2.0));
+    a_weights[2] = (float)(0.5*(-3.0*u3 + 4.0*u2 + u));
+    a_weights[3] = (float)(0.5*(u3 - u2));
+    return 4;
+}
+
+void ShapePopulationMorph::BlendBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    MorphBlend * blend = static_cast<MorphBlend *>(a_data);
+    std::vector<Channel> &channels = blend->morph->m_Channels;
+    for(unsigned int c = 0; c < channels.size(); c++)
+    {
+        Channel &channel = channels[c];
+        int numberOfComponents = channel.numberOfComponents;
+        vtkIdType count = numberOfComponents*(a_end - a_begin);
+        float * output = channel.output->GetPointer(numberOfComponents*a_begin);
+
+        // Weighted sum of contiguous values
+        const float * first = &channel.shapes[blend->shapes[0]][numberOfComponents*a_begin];
+        float weight = blend->weights[0];
+        for(vtkIdType i = 0; i < count; i++) output[i] = weight*first[i];
+        for(int t = 1; t < blend->numberOfTerms; t++)
+        {
+            const float * values = &channel.shapes[blend->shapes[t]][numberOfComponents*a_begin];
+            weight = blend->weights[t];
+            for(vtkIdType i = 0; i < count; i++) output[i] += weight*values[i];
+        }
+
+        if(channel.normals)
+        {
+            for(vtkIdType i = 0; i < count; i += 3)
+            {
+                float norm = sqrtf(output[i]*output[i] + output[i + 1]*output[i + 1] + output[i + 2]*output[i + 2]);
+                if(norm == 0.0f) continue;
+                output[i] /= norm;
+                output[i + 1] /= norm;
+                output[i + 2] /= norm;
+            }
+        }
+
+        // Magnitudes of the vectors
+        float * magnitudeFloat = (*blend->magnitudesFloat)[c];
+        double * magnitudeDouble = (*blend->magnitudesDouble)[c];
+        if(magnitudeFloat == NULL && magnitudeDouble == NULL) continue;
+        for(vtkIdType v = a_begin; v < a_end; v++)
+        {
+            const float * vector = output + 3*(v - a_begin);
+            float norm = sqrtf(vector[0]*vector[0] + vector[1]*vector[1] + vector[2]*vector[2]);
+            if(magnitudeFloat != NULL) magnitudeFloat[v] = norm;
+            else magnitudeDouble[v] = norm;
+        }
+    }
+}
+
+void ShapePopulationMorph::Blend(double a_position, int a_interpolation)
+{
+    SPV_PROFILE_SCOPE("BlendMorph");
+    if(m_Morph == NULL) return;
+
+    MorphBlend blend;
+    blend.morph = this;
+    blend.numberOfTerms = ComputeWeights(a_position, a_interpolation, m_NumberOfShapes, blend.shapes, blend.weights);
+
+    // "_mag" arrays computed when the morph is loaded, unless the memory budget released them
+    std::vector<float *> magnitudesFloat(m_Channels.size(), (float *)NULL);
+    std::vector<double *> magnitudesDouble(m_Channels.size(), (double *)NULL);
+    for(unsigned int c = 2; c < m_Channels.size(); c++)
+    {
+        if(m_Channels[c].numberOfComponents != 3) continue;
+        std::ostringstream strs;
+        strs << m_Channels[c].name << "_mag" << std::endl;
+        vtkDataArray * magnitude = m_Morph->GetPointData()->GetArray(strs.str().c_str());
+        if(magnitude == NULL || magnitude->GetNumberOfComponents() != 1 || magnitude->GetNumberOfTuples() != m_Morph->GetNumberOfPoints()) continue;
+        if(vtkFloatArray::SafeDownCast(magnitude) != NULL) magnitudesFloat[c] = vtkFloatArray::SafeDownCast(magnitude)->GetPointer(0);
+        else if(vtkDoubleArray::SafeDownCast(magnitude) != NULL) magnitudesDouble[c] = vtkDoubleArray::SafeDownCast(magnitude)->GetPointer(0);
+        else continue;
+        magnitude->Modified();
+    }
+    blend.magnitudesFloat = &magnitudesFloat;
+    blend.magnitudesDouble = &magnitudesDouble;
+
+    ShapePopulationParallel::For(m_Morph->GetNumberOfPoints(), s_blendGrain, BlendBlock, &blend);
+
+    for(unsigned int c = 0; c < m_Channels.size(); c++) m_Channels[c].output->Modified();
+    m_Morph->GetPoints()->Modified();
+    m_Morph->Modified();
+    m_Position = a_position;
+}
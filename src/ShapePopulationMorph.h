@@ -0,0 +1,67 @@
+#ifndef SHAPEPOPULATIONMORPH_H
+#define SHAPEPOPULATIONMORPH_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+
+#include <vector>
+#include <string>
+
+// Morph between corresponded shapes : the positions, normals and attributes common to the shapes are
+// interpolated (linearly or by a Catmull-Rom spline through the shapes) into the arrays of one polydata
+// created once. The values of every shape are kept as contiguous floats, so that a blend is a weighted
+// sum of at most four arrays, computed by blocks of points on all the cores and vectorized by the compiler.
+class ShapePopulationMorph
+{
+    public :
+
+    enum Interpolation {LINEAR = 0, SPLINE = 1};
+
+    ShapePopulationMorph();
+    ~ShapePopulationMorph(){}
+
+    // Shapes in the order of the morph, with the same number of points
+    bool SetShapes(std::vector<ShapePopulationData *> a_shapes);
+    unsigned int GetNumberOfShapes() {return m_NumberOfShapes;}
+    std::vector<std::string> GetAttributes();                           // interpolated attributes
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+
+    // Topology of the first shape, float points, normals and attributes written by Blend
+    vtkSmartPointer<vtkPolyData> GetMorph() {return m_Morph;}
+
+    // a_position : 0 first shape ... number of shapes - 1 last shape
+    void Blend(double a_position, int a_interpolation);
+    double GetPosition() {return m_Position;}
+
+    // Weights of the shapes a_shapes at a_position, returns the number of shapes involved (1, 2 or 4)
+    static int ComputeWeights(double a_position, int a_interpolation, int a_numberOfShapes, int a_shapes[4], float a_weights[4]);
+
+    protected :
+
+    struct Channel
+    {
+        std::string name;
+        int numberOfComponents;
+        bool normals;                                                   // normalized after the blend
+        std::vector< std::vector<float> > shapes;
+        vtkSmartPointer<vtkFloatArray> output;
+    };
+
+    std::vector<Channel> m_Channels;                                    // points, normals, then the attributes
+    vtkSmartPointer<vtkPolyData> m_Morph;
+    unsigned int m_NumberOfShapes;
+    double m_Position;
+    std::string m_ErrorMessage;
+
+    static bool CopyArray(vtkDataArray * a_array, std::vector<float> &a_values);
+    static void BlendBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
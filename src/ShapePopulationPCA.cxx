@@ -0,0 +1,392 @@
+#include "ShapePopulationPCA.h"
+
+#include <vtkMath.h>
+#include <vtkMutexLock.h>
+
+#include <cmath>
+#include <algorithm>
+
+// Number of coordinates processed together by one thread
+static const vtkIdType s_coordinateBlock = 1024;
+
+// Extra columns of the random projection, and power iterations refining it
+static const int s_oversampling = 10;
+static const int s_powerIterations = 2;
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            KERNELS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+template <class T>
+static void spvGatherCentered(const T * a_coordinates, const double * a_mean, vtkIdType a_begin, vtkIdType a_end, double * a_values)
+{
+    vtkIdType size = a_end - a_begin;
+    const T * coordinates = a_coordinates + a_begin;
+    const double * mean = a_mean + a_begin;
+    for(vtkIdType j = 0; j < size; j++)
+    {
+        a_values[j] = static_cast<double>(coordinates[j]) - mean[j];
+    }
+}
+
+template <class T>
+static void spvAccumulateCoordinates(const T * a_coordinates, vtkIdType a_begin, vtkIdType a_end, double * a_sum)
+{
+    for(vtkIdType j = a_begin; j < a_end; j++)
+    {
+        a_sum[j] += static_cast<double>(a_coordinates[j]);
+    }
+}
+
+// Random generator of the projection (splitmix64), same sequence on every platform
+static inline vtkTypeUInt64 spvNextRandom(vtkTypeUInt64 &a_state)
+{
+    vtkTypeUInt64 z = (a_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Modified Gram-Schmidt on the columns of a row-major rows x columns matrix.
+// Columns depending on the previous ones are set to zero.
+static void spvOrthonormalize(double * a_matrix, vtkIdType a_rows, int a_columns)
+{
+    for(int a = 0; a < a_columns; a++)
+    {
+        for(int b = 0; b < a; b++)
+        {
+            double dot = 0.0;
+            for(vtkIdType r = 0; r < a_rows; r++) dot += a_matrix[r*a_columns + a]*a_matrix[r*a_columns + b];
+            for(vtkIdType r = 0; r < a_rows; r++) a_matrix[r*a_columns + a] -= dot*a_matrix[r*a_columns + b];
+        }
+        double norm = 0.0;
+        for(vtkIdType r = 0; r < a_rows; r++) norm += a_matrix[r*a_columns + a]*a_matrix[r*a_columns + a];
+        norm = sqrt(norm);
+        double scale = (norm > 1e-12) ? 1.0/norm : 0.0;
+        for(vtkIdType r = 0; r < a_rows; r++) a_matrix[r*a_columns + a] *= scale;
+    }
+}
+
+struct PCAInfo
+{
+    std::vector<vtkDataArray *> subjects;   // point coordinates of each subject
+    const double * mean;
+    vtkIdType size;                         // 3 x number of points
+    int columns;                            // columns of the projection
+    double * coordinateSide;                // size x columns
+    double * subjectSide;                   // subjects x columns
+    double * sum;
+    std::vector<double> gram;               // columns x columns
+    double sumOfSquares;
+    vtkSimpleMutexLock lock;
+};
+
+static void GatherCentered(PCAInfo * a_info, unsigned int a_subject, vtkIdType a_begin, vtkIdType a_end, double * a_values)
+{
+    vtkDataArray * coordinates = a_info->subjects[a_subject];
+    switch(coordinates->GetDataType())
+    {
+        vtkTemplateMacro(spvGatherCentered(static_cast<VTK_TT *>(coordinates->GetVoidPointer(0)), a_info->mean, a_begin, a_end, a_values));
+    }
+}
+
+static void MeanBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PCAInfo * info = static_cast<PCAInfo *>(a_data);
+    for(unsigned int s = 0; s < info->subjects.size(); s++)
+    {
+        vtkDataArray * coordinates = info->subjects[s];
+        switch(coordinates->GetDataType())
+        {
+            vtkTemplateMacro(spvAccumulateCoordinates(static_cast<VTK_TT *>(coordinates->GetVoidPointer(0)), a_begin, a_end, info->sum));
+        }
+    }
+}
+
+// subjectSide = X * coordinateSide, one row per subject
+static void ProjectSubjectsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PCAInfo * info = static_cast<PCAInfo *>(a_data);
+    int columns = info->columns;
+    std::vector<double> values(s_coordinateBlock);
+
+    for(vtkIdType s = a_begin; s < a_end; s++)
+    {
+        double * row = info->subjectSide + s*columns;
+        for(int a = 0; a < columns; a++) row[a] = 0.0;
+
+        for(vtkIdType begin = 0; begin < info->size; begin += s_coordinateBlock)
+        {
+            vtkIdType end = std::min(begin + s_coordinateBlock, info->size);
+            GatherCentered(info, (unsigned int)s, begin, end, &values[0]);
+            for(vtkIdType j = begin; j < end; j++)
+            {
+                double value = values[j - begin];
+                const double * projection = info->coordinateSide + j*columns;
+                for(int a = 0; a < columns; a++) row[a] += value*projection[a];
+            }
+        }
+    }
+}
+
+// coordinateSide = X^T * subjectSide, one row per coordinate
+static void ProjectCoordinatesBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PCAInfo * info = static_cast<PCAInfo *>(a_data);
+    int columns = info->columns;
+    std::vector<double> values(a_end - a_begin);
+    double sumOfSquares = 0.0;
+
+    double * block = info->coordinateSide + a_begin*columns;
+    for(vtkIdType k = 0; k < (a_end - a_begin)*columns; k++) block[k] = 0.0;
+
+    for(unsigned int s = 0; s < info->subjects.size(); s++)
+    {
+        GatherCentered(info, s, a_begin, a_end, &values[0]);
+        const double * weights = info->subjectSide + s*columns;
+        for(vtkIdType j = 0; j < a_end - a_begin; j++)
+        {
+            double value = values[j];
+            double * row = block + j*columns;
+            for(int a = 0; a < columns; a++) row[a] += value*weights[a];
+            sumOfSquares += value*value;
+        }
+    }
+
+    info->lock.Lock();
+    info->sumOfSquares += sumOfSquares;
+    info->lock.Unlock();
+}
+
+// gram = coordinateSide^T * coordinateSide
+static void GramBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PCAInfo * info = static_cast<PCAInfo *>(a_data);
+    int columns = info->columns;
+    std::vector<double> gram(columns*columns, 0.0);
+
+    for(vtkIdType j = a_begin; j < a_end; j++)
+    {
+        const double * row = info->coordinateSide + j*columns;
+        for(int a = 0; a < columns; a++)
+        {
+            for(int b = a; b < columns; b++) gram[a*columns + b] += row[a]*row[b];
+        }
+    }
+
+    info->lock.Lock();
+    for(int a = 0; a < columns; a++)
+    {
+        for(int b = a; b < columns; b++) info->gram[a*columns + b] += gram[a*columns + b];
+    }
+    info->lock.Unlock();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          SHAPE MODES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationPCA::ShapePopulationPCA()
+{
+    m_TotalVariance = 0.0;
+}
+
+double ShapePopulationPCA::GetExplainedVariance(int a_mode)
+{
+    if(m_TotalVariance <= 0.0) return 0.0;
+    return m_StandardDeviations[a_mode]*m_StandardDeviations[a_mode]/m_TotalVariance;
+}
+
+void ShapePopulationPCA::ComputeMeanShape(std::vector<ShapePopulationData *> a_meshes)
+{
+    vtkPolyData * templateMesh = a_meshes[0]->GetPolyData();
+
+    vtkSmartPointer<vtkDoubleArray> meanPoints = vtkSmartPointer<vtkDoubleArray>::New();
+    meanPoints->SetNumberOfComponents(3);
+    meanPoints->SetNumberOfTuples(templateMesh->GetNumberOfPoints());
+    std::copy(m_Mean.begin(), m_Mean.end(), meanPoints->GetPointer(0));
+
+    // Same topology and attributes as the first mesh, mean positions
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetData(meanPoints);
+
+    m_MeanShape = vtkSmartPointer<vtkPolyData>::New();
+    m_MeanShape->ShallowCopy(templateMesh);
+    m_MeanShape->SetPoints(points);
+    m_MeanShape->GetPointData()->Initialize();
+    std::vector<std::string> attributes = a_meshes[0]->GetAttributeList();
+    for(unsigned int i = 0; i < attributes.size(); i++)
+    {
+        m_MeanShape->GetPointData()->AddArray(templateMesh->GetPointData()->GetArray(attributes[i].c_str()));
+    }
+}
+
+bool ShapePopulationPCA::ComputeModes(std::vector<ShapePopulationData *> a_meshes, int a_numberOfModes, unsigned int a_seed)
+{
+    m_ErrorMessage = "";
+    m_Mean.clear();
+    m_Modes.clear();
+    m_StandardDeviations.clear();
+    m_TotalVariance = 0.0;
+
+    if(a_meshes.size() < 3)
+    {
+        m_ErrorMessage = "The shape modes need at least three meshes.";
+        return false;
+    }
+    vtkIdType numPts = a_meshes[0]->GetPolyData()->GetNumberOfPoints();
+    for(unsigned int i = 0; i < a_meshes.size(); i++)
+    {
+        if(a_meshes[i]->GetPolyData()->GetNumberOfPoints() != numPts)
+        {
+            m_ErrorMessage = "The meshes are not in correspondence (different number of points): " + a_meshes[i]->GetFileName();
+            return false;
+        }
+    }
+
+    // At most (number of subjects - 1) modes once centered
+    int numberOfSubjects = (int)a_meshes.size();
+    int numberOfModes = std::min(a_numberOfModes, numberOfSubjects - 1);
+    if(numberOfModes < 1)
+    {
+        m_ErrorMessage = "The number of modes must be positive.";
+        return false;
+    }
+    int columns = std::min(numberOfModes + s_oversampling, numberOfSubjects);
+
+    PCAInfo info;
+    for(unsigned int i = 0; i < a_meshes.size(); i++)
+    {
+        info.subjects.push_back(a_meshes[i]->GetPolyData()->GetPoints()->GetData());
+    }
+    info.size = 3*numPts;
+    info.columns = columns;
+    info.sumOfSquares = 0.0;
+
+    // Mean
+    m_Mean.assign(info.size, 0.0);
+    info.sum = &m_Mean[0];
+    ShapePopulationParallel::For(info.size, s_coordinateBlock, MeanBlock, &info);
+    for(vtkIdType j = 0; j < info.size; j++) m_Mean[j] /= (double)numberOfSubjects;
+    info.mean = &m_Mean[0];
+
+    // Random projection (+1/-1), the row of coordinate j only depends on (seed, j)
+    std::vector<double> coordinateSide(info.size*columns);
+    std::vector<double> subjectSide(numberOfSubjects*columns);
+    info.coordinateSide = &coordinateSide[0];
+    info.subjectSide = &subjectSide[0];
+    for(vtkIdType j = 0; j < info.size; j++)
+    {
+        vtkTypeUInt64 state = (vtkTypeUInt64)a_seed*0x100000001B3ULL + (vtkTypeUInt64)j;
+        for(int a = 0; a < columns; a++)
+        {
+            coordinateSide[j*columns + a] = (spvNextRandom(state) & 1) ? 1.0 : -1.0;
+        }
+    }
+
+    // Range of X : Y = X * Omega, refined by power iterations Y = X * X^T * Y
+    ShapePopulationParallel::For(numberOfSubjects, 1, ProjectSubjectsBlock, &info);
+    for(int q = 0; q < s_powerIterations; q++)
+    {
+        spvOrthonormalize(info.subjectSide, numberOfSubjects, columns);
+        ShapePopulationParallel::For(info.size, s_coordinateBlock, ProjectCoordinatesBlock, &info);
+        spvOrthonormalize(info.coordinateSide, info.size, columns);
+        ShapePopulationParallel::For(numberOfSubjects, 1, ProjectSubjectsBlock, &info);
+    }
+    spvOrthonormalize(info.subjectSide, numberOfSubjects, columns);
+
+    // B^T = X^T * Q (coordinates x columns), then the small eigenproblem B * B^T
+    info.sumOfSquares = 0.0;
+    ShapePopulationParallel::For(info.size, s_coordinateBlock, ProjectCoordinatesBlock, &info);
+    m_TotalVariance = info.sumOfSquares/(double)(numberOfSubjects - 1);
+
+    info.gram.assign(columns*columns, 0.0);
+    ShapePopulationParallel::For(info.size, s_coordinateBlock, GramBlock, &info);
+
+    std::vector<double> gramData(columns*columns);
+    std::vector<double> eigenvectorData(columns*columns);
+    std::vector<double *> gram(columns);
+    std::vector<double *> eigenvectors(columns);
+    std::vector<double> eigenvalues(columns);
+    for(int a = 0; a < columns; a++)
+    {
+        gram[a] = &gramData[a*columns];
+        eigenvectors[a] = &eigenvectorData[a*columns];
+        for(int b = 0; b < columns; b++)
+        {
+            gram[a][b] = (b >= a) ? info.gram[a*columns + b] : info.gram[b*columns + a];
+        }
+    }
+    if(!vtkMath::JacobiN(&gram[0], columns, &eigenvalues[0], &eigenvectors[0]))
+    {
+        m_ErrorMessage = "The eigen decomposition of the shape modes did not converge.";
+        return false;
+    }
+
+    // Modes (right singular vectors) V_k = B^T * U_k / sigma_k, eigenvalues sorted in decreasing order
+    double tolerance = 1e-12*std::max(eigenvalues[0], 0.0);
+    for(int k = 0; k < numberOfModes; k++)
+    {
+        if(eigenvalues[k] <= tolerance) break;
+        double sigma = sqrt(eigenvalues[k]);
+        m_StandardDeviations.push_back(sigma/sqrt((double)(numberOfSubjects - 1)));
+
+        m_Modes.resize((k + 1)*info.size);
+        double * mode = &m_Modes[k*info.size];
+        for(vtkIdType j = 0; j < info.size; j++)
+        {
+            const double * row = info.coordinateSide + j*columns;
+            double value = 0.0;
+            for(int a = 0; a < columns; a++) value += row[a]*eigenvectors[a][k];
+            mode[j] = value/sigma;
+        }
+    }
+    if(m_StandardDeviations.empty())
+    {
+        m_ErrorMessage = "The meshes do not vary: no shape mode.";
+        return false;
+    }
+
+    this->ComputeMeanShape(a_meshes);
+    return true;
+}
+
+void ShapePopulationPCA::GenerateShape(std::vector<double> a_coefficients, double * a_points, double * a_displacement)
+{
+    vtkIdType size = m_Mean.size();
+    std::copy(m_Mean.begin(), m_Mean.end(), a_points);
+
+    int numberOfModes = std::min((int)a_coefficients.size(), this->GetNumberOfModes());
+    for(int k = 0; k < numberOfModes; k++)
+    {
+        if(a_coefficients[k] == 0.0) continue;
+        double weight = a_coefficients[k]*m_StandardDeviations[k];
+        const double * mode = &m_Modes[k*size];
+        for(vtkIdType j = 0; j < size; j++) a_points[j] += weight*mode[j];
+    }
+
+    if(a_displacement == NULL) return;
+    for(vtkIdType v = 0; v < size/3; v++)
+    {
+        double dx = a_points[3*v] - m_Mean[3*v];
+        double dy = a_points[3*v + 1] - m_Mean[3*v + 1];
+        double dz = a_points[3*v + 2] - m_Mean[3*v + 2];
+        a_displacement[v] = sqrt(dx*dx + dy*dy + dz*dz);
+    }
+}
+
+double ShapePopulationPCA::GetMaximumDisplacement(int a_mode, double a_standardDeviations)
+{
+    vtkIdType size = m_Mean.size();
+    const double * mode = &m_Modes[a_mode*size];
+    double maximum = 0.0;
+    for(vtkIdType v = 0; v < size/3; v++)
+    {
+        double norm = mode[3*v]*mode[3*v] + mode[3*v + 1]*mode[3*v + 1] + mode[3*v + 2]*mode[3*v + 2];
+        if(norm > maximum) maximum = norm;
+    }
+    return fabs(a_standardDeviations)*m_StandardDeviations[a_mode]*sqrt(maximum);
+}
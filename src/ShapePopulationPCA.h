@@ -0,0 +1,58 @@
+#ifndef SHAPEPOPULATIONPCA_H
+#define SHAPEPOPULATIONPCA_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkDoubleArray.h>
+#include <vtkPolyDataNormals.h>
+
+#include <vector>
+#include <string>
+
+// Principal modes of variation of corresponded meshes (same number of points).
+// The modes are computed with a randomized SVD of the centered subject x coordinate matrix :
+// the subjects are only read through products with thin matrices (coordinates x a few columns),
+// so neither the covariance matrix nor a copy of the coordinates is ever formed.
+class ShapePopulationPCA
+{
+    public :
+
+    ShapePopulationPCA();
+    ~ShapePopulationPCA(){}
+
+    // The random projection only depends on a_seed
+    bool ComputeModes(std::vector<ShapePopulationData *> a_meshes, int a_numberOfModes, unsigned int a_seed = 0);
+
+    vtkSmartPointer<vtkPolyData> GetMeanShape() {return m_MeanShape;}
+    int GetNumberOfModes() {return (int)m_StandardDeviations.size();}
+    double GetStandardDeviation(int a_mode) {return m_StandardDeviations[a_mode];}
+    double GetExplainedVariance(int a_mode);                                        // fraction of the total variance
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+
+    // Mean + sum of a_coefficients[k] standard deviations along mode k.
+    // a_points (3 x number of points) receives the coordinates, a_displacement (optional) the distance to the mean
+    void GenerateShape(std::vector<double> a_coefficients, double * a_points, double * a_displacement);
+
+    // Largest distance to the mean at a_standardDeviations along a_mode
+    double GetMaximumDisplacement(int a_mode, double a_standardDeviations);
+
+    protected :
+
+    vtkSmartPointer<vtkPolyData> m_MeanShape;
+    std::vector<double> m_Mean;                   // 3 x number of points
+    std::vector<double> m_Modes;                  // mode after mode, unit vectors of 3 x number of points
+    std::vector<double> m_StandardDeviations;
+    double m_TotalVariance;
+    std::string m_ErrorMessage;
+
+    void ComputeMeanShape(std::vector<ShapePopulationData *> a_meshes);
+};
+
+
+#endif
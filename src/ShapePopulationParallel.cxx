@@ -0,0 +1,76 @@
+#include "ShapePopulationParallel.h"
+
+int ShapePopulationParallel::m_numberOfThreads = 0;
+
+struct ParallelForInfo
+{
+    vtkIdType size;
+    vtkIdType grain;
+    vtkIdType next;
+    ShapePopulationParallel::RangeFunction function;
+    void * data;
+    vtkSimpleMutexLock lock;
+};
+
+static VTK_THREAD_RETURN_TYPE ParallelForExecute(void * arg)
+{
+    vtkMultiThreader::ThreadInfo * threadInfo = static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    ParallelForInfo * info = static_cast<ParallelForInfo *>(threadInfo->UserData);
+
+    while(true)
+    {
+        info->lock.Lock();
+        vtkIdType begin = info->next;
+        info->next += info->grain;
+        info->lock.Unlock();
+
+        if(begin >= info->size) break;
+        vtkIdType end = begin + info->grain;
+        if(end > info->size) end = info->size;
+
+        info->function(begin, end, info->data);
+    }
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+int ShapePopulationParallel::GetNumberOfThreads()
+{
+    if(m_numberOfThreads > 0) return m_numberOfThreads;
+    return vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+void ShapePopulationParallel::SetNumberOfThreads(int numberOfThreads)
+{
+    if(numberOfThreads < 0) numberOfThreads = 0;
+    if(numberOfThreads > VTK_MAX_THREADS) numberOfThreads = VTK_MAX_THREADS;
+    m_numberOfThreads = numberOfThreads;
+}
+
+void ShapePopulationParallel::For(vtkIdType size, vtkIdType grain, RangeFunction function, void * data)
+{
+    if(size <= 0) return;
+    if(grain < 1) grain = 1;
+
+    vtkIdType numberOfBlocks = (size + grain - 1) / grain;
+    int numberOfThreads = GetNumberOfThreads();
+    if(numberOfBlocks < numberOfThreads) numberOfThreads = (int)numberOfBlocks;
+
+    // Not worth spawning threads
+    if(numberOfThreads <= 1)
+    {
+        function(0, size, data);
+        return;
+    }
+
+    ParallelForInfo info;
+    info.size = size;
+    info.grain = grain;
+    info.next = 0;
+    info.function = function;
+    info.data = data;
+
+    vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(ParallelForExecute, &info);
+    threader->SingleMethodExecute();
+}
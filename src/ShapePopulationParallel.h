@@ -0,0 +1,30 @@
+#ifndef SHAPEPOPULATIONPARALLEL_H
+#define SHAPEPOPULATIONPARALLEL_H
+
+#include <vtkVersion.h>
+#include <vtkType.h>
+#include <vtkSmartPointer.h>
+#include <vtkMultiThreader.h>
+#include <vtkMutexLock.h>
+
+// Small parallel-for used by the population engines.
+// The range [0, size) is cut into blocks of 'grain' items which are handed out
+// dynamically to the VTK threads, so uneven blocks do not stall the whole loop.
+class ShapePopulationParallel
+{
+    public :
+
+    typedef void (*RangeFunction)(vtkIdType begin, vtkIdType end, void * data);
+
+    static void For(vtkIdType size, vtkIdType grain, RangeFunction function, void * data);
+
+    static int GetNumberOfThreads();
+    static void SetNumberOfThreads(int numberOfThreads);   // 0 = use all the cores
+
+    protected :
+
+    static int m_numberOfThreads;
+};
+
+
+#endif
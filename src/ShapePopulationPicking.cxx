@@ -0,0 +1,205 @@
+#include "ShapePopulationPicking.h"
+
+#include <cmath>
+
+struct PickingBuild
+{
+    ShapePopulationPicking * picking;
+    std::vector<bool> * built;
+};
+
+
+ShapePopulationPicking::ShapePopulationPicking()
+{
+    m_CancelBuild = false;
+}
+
+ShapePopulationPicking::Locator ShapePopulationPicking::CreateLocator(ShapePopulationData * a_mesh)
+{
+    Locator entry;
+    entry.points = NULL;
+    entry.pointsTime = 0;
+
+    vtkPolyData * polyData = a_mesh->GetPolyData();
+    if(polyData == NULL || polyData->GetPoints() == NULL || polyData->GetNumberOfPoints() == 0) return entry;
+
+    // The locator is built over a copy of the points : the worker reads it while the GUI thread moves the
+    // points of the mesh (shape modes, morph) or swaps them (time series)
+    vtkDataArray * points = polyData->GetPoints()->GetData();
+    vtkSmartPointer<vtkPoints> locatorPoints = vtkSmartPointer<vtkPoints>::New();
+    locatorPoints->DeepCopy(polyData->GetPoints());
+    vtkSmartPointer<vtkPolyData> locatorData = vtkSmartPointer<vtkPolyData>::New();
+    locatorData->SetPoints(locatorPoints);
+
+    entry.locator = vtkSmartPointer<vtkPointLocator>::New();
+    entry.locator->SetDataSet(locatorData);
+    entry.points = points;
+    entry.pointsTime = polyData->GetPoints()->GetMTime();
+    return entry;
+}
+
+bool ShapePopulationPicking::IsUpToDate(ShapePopulationData * a_mesh, const Locator &a_locator)
+{
+    vtkPolyData * polyData = a_mesh->GetPolyData();
+    if(polyData == NULL || polyData->GetPoints() == NULL) return false;
+    // vtkPoints::SetPoint writes into the array without modifying it (shape modes, morph) : the time of the
+    // vtkPoints, which includes the time of the array, tells the points moved
+    vtkDataArray * points = polyData->GetPoints()->GetData();
+    return (points == a_locator.points && polyData->GetPoints()->GetMTime() <= a_locator.pointsTime);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            LOCATORS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationPicking::SetMeshes(std::vector<ShapePopulationData *> a_meshes)
+{
+    m_Lock.Lock();
+    m_Meshes = std::set<ShapePopulationData *>(a_meshes.begin(), a_meshes.end());
+
+    // Deleted meshes
+    std::map<ShapePopulationData *, Locator>::iterator it = m_Locators.begin();
+    while(it != m_Locators.end())
+    {
+        if(m_Meshes.find(it->first) == m_Meshes.end()) m_Locators.erase(it++);
+        else ++it;
+    }
+
+    m_Queue.clear();
+    for(unsigned int i = 0; i < a_meshes.size(); i++)
+    {
+        it = m_Locators.find(a_meshes[i]);
+        if(it != m_Locators.end() && IsUpToDate(a_meshes[i], it->second)) continue;
+
+        Locator entry = CreateLocator(a_meshes[i]);
+        if(entry.locator != NULL) m_Queue.push_back(std::make_pair(a_meshes[i], entry));
+    }
+    m_Lock.Unlock();
+}
+
+void ShapePopulationPicking::BuildBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PickingBuild * build = static_cast<PickingBuild *>(a_data);
+    std::vector< std::pair<ShapePopulationData *, Locator> > &queue = build->picking->m_Queue;
+    for(vtkIdType i = a_begin; i < a_end && !build->picking->m_CancelBuild; i++)
+    {
+        queue[i].second.locator->BuildLocator();
+        (*build->built)[i] = true;
+    }
+}
+
+void ShapePopulationPicking::BuildLocators()
+{
+    SPV_PROFILE_SCOPE("BuildVertexLocators");
+    m_CancelBuild = false;
+
+    // The queue is only changed by SetMeshes, which is not called while the worker runs
+    m_Lock.Lock();
+    unsigned int numberOfLocators = m_Queue.size();
+    m_Lock.Unlock();
+    if(numberOfLocators == 0) return;
+
+    std::vector<bool> built(numberOfLocators, false);
+    PickingBuild build;
+    build.picking = this;
+    build.built = &built;
+    ShapePopulationParallel::For(numberOfLocators, 1, BuildBlock, &build);
+
+    m_Lock.Lock();
+    unsigned int numberOfBuilt = 0;
+    for(unsigned int i = 0; i < m_Queue.size(); i++)
+    {
+        if(!built[i] || m_Meshes.find(m_Queue[i].first) == m_Meshes.end()) continue;
+
+        // A pick may have built a more recent one meanwhile
+        std::map<ShapePopulationData *, Locator>::iterator it = m_Locators.find(m_Queue[i].first);
+        if(it != m_Locators.end() && it->second.points == m_Queue[i].second.points && it->second.pointsTime >= m_Queue[i].second.pointsTime) continue;
+        m_Locators[m_Queue[i].first] = m_Queue[i].second;
+        numberOfBuilt++;
+    }
+    m_Queue.clear();
+    m_Lock.Unlock();
+    ShapePopulationProfiler::AddCount("VertexLocators", numberOfBuilt);
+}
+
+void ShapePopulationPicking::Clear()
+{
+    m_Lock.Lock();
+    m_Locators.clear();
+    m_Queue.clear();
+    m_Meshes.clear();
+    m_Lock.Unlock();
+}
+
+unsigned int ShapePopulationPicking::GetNumberOfLocators()
+{
+    m_Lock.Lock();
+    unsigned int numberOfLocators = 0;
+    std::map<ShapePopulationData *, Locator>::iterator it;
+    for(it = m_Locators.begin(); it != m_Locators.end(); ++it)
+    {
+        if(IsUpToDate(it->first, it->second)) numberOfLocators++;
+    }
+    m_Lock.Unlock();
+    return numberOfLocators;
+}
+
+bool ShapePopulationPicking::HasLocator(ShapePopulationData * a_mesh)
+{
+    m_Lock.Lock();
+    std::map<ShapePopulationData *, Locator>::iterator it = m_Locators.find(a_mesh);
+    bool upToDate = (it != m_Locators.end() && IsUpToDate(a_mesh, it->second));
+    m_Lock.Unlock();
+    return upToDate;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             PICKING                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+vtkIdType ShapePopulationPicking::FindClosestPoint(ShapePopulationData * a_mesh, const double a_point[3])
+{
+    m_Lock.Lock();
+    vtkSmartPointer<vtkPointLocator> locator;
+    std::map<ShapePopulationData *, Locator>::iterator it = m_Locators.find(a_mesh);
+    if(it != m_Locators.end() && IsUpToDate(a_mesh, it->second)) locator = it->second.locator;
+    m_Lock.Unlock();
+
+    // Not built yet, or the points changed since
+    if(locator == NULL)
+    {
+        Locator entry = CreateLocator(a_mesh);
+        if(entry.locator == NULL) return -1;
+        entry.locator->BuildLocator();
+        locator = entry.locator;
+
+        m_Lock.Lock();
+        m_Locators[a_mesh] = entry;
+        m_Lock.Unlock();
+        ShapePopulationProfiler::AddCount("VertexLocatorsBuiltOnPick", 1);
+    }
+    return locator->FindClosestPoint(a_point);
+}
+
+bool ShapePopulationPicking::GetValue(ShapePopulationData * a_mesh, std::string a_attribute, vtkIdType a_vertex, double &a_value)
+{
+    a_value = 0.0;
+    vtkDataArray * array = a_mesh->GetPointAttribute(a_attribute);
+    if(array == NULL || a_vertex < 0 || a_vertex >= array->GetNumberOfTuples()) return false;
+
+    int numberOfComponents = array->GetNumberOfComponents();
+    if(numberOfComponents == 1)
+    {
+        a_value = array->GetComponent(a_vertex, 0);
+        return true;
+    }
+    for(int k = 0; k < numberOfComponents; k++)
+    {
+        double component = array->GetComponent(a_vertex, k);
+        a_value += component*component;
+    }
+    a_value = sqrt(a_value);
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef SHAPEPOPULATIONPICKING_H
+#define SHAPEPOPULATIONPICKING_H
+
+#include <vtkVersion.h>
+#include <vtkMutexLock.h>
+#include <vtkPointLocator.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+
+// Vertex picking : a point locator per mesh, kept between the picks. The locators of the meshes loaded are
+// built by a worker thread, in parallel, over a copy of the points array of the mesh, so that the GUI thread
+// can swap or change the points of the mesh meanwhile. A locator whose points changed (time series, morph)
+// is built again by the pick which needs it.
+class ShapePopulationPicking
+{
+    public :
+
+    ShapePopulationPicking();
+    ~ShapePopulationPicking(){}
+
+    // GUI thread, the worker stopped : the locators of the meshes which are not in a_meshes are forgotten,
+    // the missing or outdated ones are queued for BuildLocators
+    void SetMeshes(std::vector<ShapePopulationData *> a_meshes);
+
+    // Worker : builds the queued locators, until it is done or CancelBuild is called
+    void BuildLocators();
+    void CancelBuild() {m_CancelBuild = true;}
+    void Clear();
+
+    unsigned int GetNumberOfLocators();                                 // built and up to date
+    bool HasLocator(ShapePopulationData * a_mesh);
+
+    // GUI thread : vertex of a_mesh closest to a_point, -1 if the mesh has no points
+    vtkIdType FindClosestPoint(ShapePopulationData * a_mesh, const double a_point[3]);
+
+    // Value of a_attribute at a_vertex, the magnitude for a vector, the mean of the cells for a cell attribute
+    static bool GetValue(ShapePopulationData * a_mesh, std::string a_attribute, vtkIdType a_vertex, double &a_value);
+
+    protected :
+
+    struct Locator
+    {
+        vtkSmartPointer<vtkPointLocator> locator;
+        vtkSmartPointer<vtkDataArray> points;                           // points array of the mesh when the locator was built, kept
+                                                                        // so that no new array takes its address
+        unsigned long pointsTime;
+    };
+
+    vtkSimpleMutexLock m_Lock;
+    std::map<ShapePopulationData *, Locator> m_Locators;
+    std::vector< std::pair<ShapePopulationData *, Locator> > m_Queue;
+    std::set<ShapePopulationData *> m_Meshes;
+    volatile bool m_CancelBuild;
+
+    static Locator CreateLocator(ShapePopulationData * a_mesh);
+    static bool IsUpToDate(ShapePopulationData * a_mesh, const Locator &a_locator);
+    static void BuildBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
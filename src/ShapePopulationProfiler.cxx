@@ -0,0 +1,237 @@
+#include "ShapePopulationProfiler.h"
+
+#include <vtkTimerLog.h>
+#include <vtkMultiThreader.h>
+#include <vtkMutexLock.h>
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+// Events kept for the trace, the summary keeps counting after that
+static const size_t s_maximumNumberOfEvents = 200000;
+
+struct ProfilerEvent
+{
+    const char * name;
+    double start;
+    double value;                       // duration of an event, total of a counter
+    int thread;
+    bool counter;
+};
+
+struct ProfilerStatistics
+{
+    int calls;
+    double total;
+    double maximum;
+};
+
+struct ProfilerData
+{
+    vtkSimpleMutexLock lock;
+    double origin;
+    std::vector<ProfilerEvent> events;
+    std::map<std::string, ProfilerStatistics> statistics;
+    std::map<std::string, double> counters;
+    std::vector<vtkMultiThreaderIDType> threads;
+    std::map<vtkObject *, double> objectStarts;
+    size_t droppedEvents;
+};
+
+static ProfilerData s_data;
+
+// s_data is constructed first (same translation unit)
+static bool spvEnabledFromEnvironment()
+{
+    if(getenv("SPV_PROFILING") == NULL) return false;
+    ShapePopulationProfiler::Reset();
+    return true;
+}
+
+bool ShapePopulationProfiler::m_enabled = spvEnabledFromEnvironment();
+
+// Small thread index for the trace, the lock must be held
+static int spvThreadIndex()
+{
+    vtkMultiThreaderIDType thread = vtkMultiThreader::GetCurrentThreadID();
+    for(unsigned int i = 0; i < s_data.threads.size(); i++)
+    {
+        if(vtkMultiThreader::ThreadsEqual(s_data.threads[i], thread)) return i;
+    }
+    s_data.threads.push_back(thread);
+    return (int)s_data.threads.size() - 1;
+}
+
+static void spvAddEvent(const char * a_name, double a_start, double a_value, bool a_counter)
+{
+    if(s_data.events.size() >= s_maximumNumberOfEvents)
+    {
+        s_data.droppedEvents++;
+        return;
+    }
+    ProfilerEvent event;
+    event.name = a_name;
+    event.start = a_start;
+    event.value = a_value;
+    event.thread = spvThreadIndex();
+    event.counter = a_counter;
+    s_data.events.push_back(event);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           RECORDING                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationProfiler::SetEnabled(bool a_enabled)
+{
+    if(a_enabled && !m_enabled) Reset();
+    m_enabled = a_enabled;
+}
+
+void ShapePopulationProfiler::Reset()
+{
+    s_data.lock.Lock();
+    s_data.origin = GetTime();
+    s_data.events.clear();
+    s_data.statistics.clear();
+    s_data.counters.clear();
+    s_data.objectStarts.clear();
+    s_data.droppedEvents = 0;
+    s_data.lock.Unlock();
+}
+
+double ShapePopulationProfiler::GetTime()
+{
+    return vtkTimerLog::GetUniversalTime();
+}
+
+void ShapePopulationProfiler::AddEvent(const char * a_name, double a_start, double a_end)
+{
+    if(!m_enabled) return;
+    s_data.lock.Lock();
+    spvAddEvent(a_name, a_start, a_end - a_start, false);
+
+    ProfilerStatistics &statistics = s_data.statistics[a_name];
+    if(statistics.calls == 0) statistics.maximum = 0.0;
+    statistics.calls++;
+    statistics.total += a_end - a_start;
+    statistics.maximum = std::max(statistics.maximum, a_end - a_start);
+    s_data.lock.Unlock();
+}
+
+void ShapePopulationProfiler::AddCount(const char * a_counter, double a_value)
+{
+    if(!m_enabled) return;
+    s_data.lock.Lock();
+    double &total = s_data.counters[a_counter];
+    total += a_value;
+    spvAddEvent(a_counter, GetTime(), total, true);
+    s_data.lock.Unlock();
+}
+
+void ShapePopulationProfiler::BeginObject(vtkObject * a_object)
+{
+    if(!m_enabled) return;
+    s_data.lock.Lock();
+    s_data.objectStarts[a_object] = GetTime();
+    s_data.lock.Unlock();
+}
+
+void ShapePopulationProfiler::EndObject(vtkObject * a_object, const char * a_name)
+{
+    if(!m_enabled) return;
+    s_data.lock.Lock();
+    std::map<vtkObject *, double>::iterator it = s_data.objectStarts.find(a_object);
+    if(it == s_data.objectStarts.end())
+    {
+        s_data.lock.Unlock();
+        return;
+    }
+    double start = it->second;
+    s_data.objectStarts.erase(it);
+    s_data.lock.Unlock();
+
+    AddEvent(a_name, start, GetTime());
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            REPORTS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+static bool spvLargerTotal(const std::pair<std::string, ProfilerStatistics> &a_first, const std::pair<std::string, ProfilerStatistics> &a_second)
+{
+    return a_first.second.total > a_second.second.total;
+}
+
+std::string ShapePopulationProfiler::GetSummary(unsigned int a_maximumNumberOfEvents)
+{
+    s_data.lock.Lock();
+    std::vector< std::pair<std::string, ProfilerStatistics> > statistics(s_data.statistics.begin(), s_data.statistics.end());
+    std::map<std::string, double> counters = s_data.counters;
+    double elapsed = GetTime() - s_data.origin;
+    s_data.lock.Unlock();
+
+    std::sort(statistics.begin(), statistics.end(), spvLargerTotal);
+
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(1);
+    summary << "Profiling (" << elapsed << " s)" << std::endl;
+    for(unsigned int i = 0; i < statistics.size() && i < a_maximumNumberOfEvents; i++)
+    {
+        summary << statistics[i].first << " : " << statistics[i].second.calls << " x, "
+                << 1000.0*statistics[i].second.total << " ms (max " << 1000.0*statistics[i].second.maximum << " ms)" << std::endl;
+    }
+    std::map<std::string, double>::iterator it;
+    for(it = counters.begin(); it != counters.end(); ++it)
+    {
+        summary << it->first << " : " << it->second << std::endl;
+    }
+    return summary.str();
+}
+
+// Names are written as JSON strings
+static std::string spvEscape(const char * a_name)
+{
+    std::string escaped;
+    for(const char * c = a_name; *c != '\0'; c++)
+    {
+        if(*c == '"' || *c == '\\') escaped += '\\';
+        if(*c == '\n') continue;
+        escaped += *c;
+    }
+    return escaped;
+}
+
+bool ShapePopulationProfiler::WriteChromeTrace(std::string a_filePath)
+{
+    std::ofstream file(a_filePath.c_str());
+    if(!file) return false;
+
+    s_data.lock.Lock();
+    std::vector<ProfilerEvent> events = s_data.events;
+    double origin = s_data.origin;
+    size_t droppedEvents = s_data.droppedEvents;
+    s_data.lock.Unlock();
+
+    // Microseconds since the reset of the profiler
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[" << std::endl;
+    for(unsigned int i = 0; i < events.size(); i++)
+    {
+        const ProfilerEvent &event = events[i];
+        file << "{\"name\":\"" << spvEscape(event.name) << "\",\"pid\":1,\"tid\":" << event.thread
+             << ",\"ts\":" << 1.0e6*(event.start - origin);
+        if(event.counter) file << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+        else file << ",\"ph\":\"X\",\"dur\":" << 1.0e6*event.value << "}";
+        file << ((i + 1 < events.size()) ? "," : "") << std::endl;
+    }
+    file << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedEvents << "}}" << std::endl;
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef SHAPEPOPULATIONPROFILER_H
+#define SHAPEPOPULATIONPROFILER_H
+
+#include <vtkVersion.h>
+#include <vtkObject.h>
+
+#include <string>
+
+// Scoped timers and counters of the hot paths.
+// Nothing is recorded while the profiler is disabled (the default, or set the SPV_PROFILING
+// environment variable), so the instrumentation can stay in the code. The events can be
+// summarized for the overlay or written as Chrome trace-event JSON (chrome://tracing).
+class ShapePopulationProfiler
+{
+    public :
+
+    static void SetEnabled(bool a_enabled);
+    static bool IsEnabled() {return m_enabled;}
+    static void Reset();
+
+    static double GetTime();                                                    // seconds
+    static void AddEvent(const char * a_name, double a_start, double a_end);
+    static void AddCount(const char * a_counter, double a_value);
+
+    // Pipeline objects timed between their StartEvent and EndEvent
+    static void BeginObject(vtkObject * a_object);
+    static void EndObject(vtkObject * a_object, const char * a_name);
+
+    // Calls, total and maximum time of each event (largest totals first), then the counters
+    static std::string GetSummary(unsigned int a_maximumNumberOfEvents);
+    static bool WriteChromeTrace(std::string a_filePath);
+
+    protected :
+
+    static bool m_enabled;
+};
+
+class ShapePopulationScopedTimer
+{
+    public :
+
+    ShapePopulationScopedTimer(const char * a_name)
+    {
+        m_name = a_name;
+        m_start = ShapePopulationProfiler::IsEnabled() ? ShapePopulationProfiler::GetTime() : -1.0;
+    }
+    ~ShapePopulationScopedTimer()
+    {
+        if(m_start >= 0.0 && ShapePopulationProfiler::IsEnabled()) ShapePopulationProfiler::AddEvent(m_name, m_start, ShapePopulationProfiler::GetTime());
+    }
+
+    protected :
+
+    const char * m_name;
+    double m_start;
+};
+
+#define SPV_PROFILE_SCOPE(name) ShapePopulationScopedTimer spvScopedTimer(name)
+
+
+#endif
@@ -15,10 +15,34 @@ ShapePopulationQT::ShapePopulationQT()
     m_lastDirectory = "";
     m_colormapDirectory = "";
     m_exportDirectory = "";
+    m_exportMagnification = 1;
+    m_pageSize = 100;
+    m_pageIndex = 0;
+    m_lassoWindow = 0;
     m_cameraDialog = new cameraDialogQT(this);
     m_backgroundDialog = new backgroundDialogQT(this);
     m_CSVloaderDialog = new CSVloaderQT(this);
     m_customizeColorMapByDirectionDialog = new customizeColorMapByDirectionDialogQT(this);
+    m_permutationTestDialog = new permutationTestDialogQT(this);
+    m_shapeModesDialog = new shapeModesDialogQT(this);
+    m_morphDialog = new morphDialogQT(this);
+    m_vertexPickingDialog = new vertexPickingDialogQT(this);
+    m_regionStatisticsDialog = new regionStatisticsDialogQT(this);
+    m_labelsDialog = new labelsDialogQT(this);
+    m_histogramDialog = new histogramDialogQT(this);
+    m_covariatesDialog = new covariatesDialogQT(this);
+    m_animationDialog = new animationDialogQT(this);
+
+    // Profiling overlay, on top of the meshes
+    m_profilingOverlay = new QLabel(this->scrollArea);
+    m_profilingOverlay->setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: white; padding: 4px; font-family: monospace; }");
+    m_profilingOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_profilingOverlay->move(10,10);
+    m_profilingOverlay->hide();
+    m_profilingTimer = new QTimer(this);
+    m_profilingTimer->setInterval(500);
+    m_playbackTimer = new QTimer(this);
+    m_playbackFrameRate = 5.0;
 
     
     // GUI disable
@@ -27,6 +51,7 @@ ShapePopulationQT::ShapePopulationQT()
     toolBox->setDisabled(true);
     this->gradientWidget_VISU->disable();
     menuOptions->setDisabled(true);
+    menuStatistics->setDisabled(true);
     actionDelete->setDisabled(true);
     actionDelete_All->setDisabled(true);
     menuExport->setDisabled(true);
@@ -35,6 +60,10 @@ ShapePopulationQT::ShapePopulationQT()
     menuExport->clear();
     menuExport->addAction("PDF");
     connect(menuExport->actions().at(0),SIGNAL(triggered()),this,SLOT(showNoExportWindow()));
+    menuExport->addSeparator();
+    menuExport->addAction(actionTo_PNG);
+    menuExport->addAction(actionTo_TIFF);
+    menuExport->addAction(actionTo_Animation);
 #endif
     
     //Pushbuttons color
@@ -70,7 +99,10 @@ ShapePopulationQT::ShapePopulationQT()
     connect(actionOpen_Directory,SIGNAL(triggered()),this,SLOT(openDirectory()));
     connect(actionOpen_VTK_Files,SIGNAL(triggered()),this,SLOT(openFiles()));
     connect(actionLoad_CSV,SIGNAL(triggered()),this,SLOT(loadCSV()));
+    connect(actionOpen_Session,SIGNAL(triggered()),this,SLOT(openSession()));
+    connect(actionSave_Session,SIGNAL(triggered()),this,SLOT(saveSession()));
     connect(m_CSVloaderDialog,SIGNAL(sig_itemsSelected(QFileInfoList)),this,SLOT(slot_itemsSelected(QFileInfoList)));
+    connect(m_CSVloaderDialog,SIGNAL(sig_covariatesLoaded(QStringList,QList<QStringList>)),this,SLOT(slot_covariatesLoaded(QStringList,QList<QStringList>)));
     connect(actionDelete,SIGNAL(triggered()),this,SLOT(deleteSelection()));
     connect(actionDelete_All,SIGNAL(triggered()),this,SLOT(deleteAll()));
     connect(actionCameraConfig,SIGNAL(triggered()),this,SLOT(showCameraConfigWindow()));
@@ -78,6 +110,38 @@ ShapePopulationQT::ShapePopulationQT()
     connect(pushButton_customizeColorMapByDirection,SIGNAL(clicked()),this,SLOT(showCustomizeColorMapByDirectionConfigWindow()));
     connect(actionLoad_Colorbar,SIGNAL(triggered()),this,SLOT(loadColorMap()));
     connect(actionSave_Colorbar,SIGNAL(triggered()),this,SLOT(saveColorMap()));
+    connect(actionAttribute_Distribution,SIGNAL(triggered()),this,SLOT(showHistogram()));
+    connect(m_histogramDialog,SIGNAL(sig_autoRange(double,double)),this,SLOT(slot_histogram_autoRange(double,double)));
+    connect(actionCovariates,SIGNAL(triggered()),this,SLOT(showCovariates()));
+    connect(m_covariatesDialog,SIGNAL(sig_displayChanged()),this,SLOT(slot_covariates_displayChanged()));
+    connect(actionProfiling_Overlay,SIGNAL(toggled(bool)),this,SLOT(showProfilingOverlay(bool)));
+    connect(actionExport_Profiling_Trace,SIGNAL(triggered()),this,SLOT(exportProfilingTrace()));
+    connect(actionAdaptive_Quality,SIGNAL(toggled(bool)),this,SLOT(setAdaptiveQuality_QT(bool)));
+    connect(actionTarget_Frame_Rate,SIGNAL(triggered()),this,SLOT(setTargetFrameRate_QT()));
+    connect(actionMemory_Budget,SIGNAL(triggered()),this,SLOT(setMemoryBudget_QT()));
+    connect(actionPaged_Browsing,SIGNAL(triggered()),this,SLOT(setPageSize_QT()));
+    connect(actionPrevious_Page,SIGNAL(triggered()),this,SLOT(previousPage()));
+    connect(actionNext_Page,SIGNAL(triggered()),this,SLOT(nextPage()));
+    connect(scrollArea->verticalScrollBar(),SIGNAL(valueChanged(int)),this,SLOT(slot_memory_update()));
+    connect(scrollArea->horizontalScrollBar(),SIGNAL(valueChanged(int)),this,SLOT(slot_memory_update()));
+    connect(m_profilingTimer,SIGNAL(timeout()),this,SLOT(updateProfilingOverlay()));
+    connect(actionPlay_Timepoints,SIGNAL(toggled(bool)),this,SLOT(playTimepoints(bool)));
+    connect(actionPick_Vertices,SIGNAL(toggled(bool)),this,SLOT(pickVertices(bool)));
+    connect(actionDraw_Region,SIGNAL(toggled(bool)),this,SLOT(drawRegion(bool)));
+    connect(actionClear_Region,SIGNAL(triggered()),this,SLOT(clearRegion_QT()));
+    connect(actionRegion_Statistics,SIGNAL(triggered()),this,SLOT(showRegionStatistics()));
+    connect(actionLabel_Mode,SIGNAL(toggled(bool)),this,SLOT(displayLabels(bool)));
+    connect(actionTensor_Ellipsoids,SIGNAL(toggled(bool)),this,SLOT(displayTensors_QT(bool)));
+    connect(actionTimepoint_Rate,SIGNAL(triggered()),this,SLOT(setTimepointRate_QT()));
+    connect(m_playbackTimer,SIGNAL(timeout()),this,SLOT(showNextTimepoint()));
+    if(ShapePopulationProfiler::IsEnabled()) actionProfiling_Overlay->setChecked(true);      // SPV_PROFILING environment variable
+    connect(actionSet_Group_A,SIGNAL(triggered()),this,SLOT(setSelectionAsGroupA()));
+    connect(actionSet_Group_B,SIGNAL(triggered()),this,SLOT(setSelectionAsGroupB()));
+    connect(actionCompare_Groups,SIGNAL(triggered()),this,SLOT(compareGroups()));
+    connect(actionPermutation_Test,SIGNAL(triggered()),this,SLOT(permutationTest()));
+    connect(actionShape_Modes,SIGNAL(triggered()),this,SLOT(showShapeModes()));
+    connect(actionMorph,SIGNAL(triggered()),this,SLOT(showMorph()));
+    connect(actionSurface_Distance,SIGNAL(triggered()),this,SLOT(surfaceDistance()));
 #ifndef SPV_EXTENSION
     connect(actionTo_PDF,SIGNAL(triggered()),this,SLOT(exportToPDF()));
     connect(actionTo_PS,SIGNAL(triggered()),this,SLOT(exportToPS()));
@@ -85,6 +149,11 @@ ShapePopulationQT::ShapePopulationQT()
     connect(actionTo_TEX,SIGNAL(triggered()),this,SLOT(exportToTEX()));
     connect(actionTo_SVG,SIGNAL(triggered()),this,SLOT(exportToSVG()));
 #endif
+    connect(actionTo_PNG,SIGNAL(triggered()),this,SLOT(exportToPNG()));
+    connect(actionTo_TIFF,SIGNAL(triggered()),this,SLOT(exportToTIFF()));
+    connect(actionTo_Animation,SIGNAL(triggered()),this,SLOT(exportAnimation()));
+    connect(actionAdd_Camera_Keyframe,SIGNAL(triggered()),this,SLOT(addCameraKeyframe()));
+    connect(actionClear_Camera_Keyframes,SIGNAL(triggered()),this,SLOT(clearCameraKeyframes()));
     //gradView Signals
     connect(gradientWidget_VISU,SIGNAL(arrowMovedSignal(qreal)), this, SLOT(slot_gradArrow_moved(qreal)));
     connect(gradientWidget_VISU,SIGNAL(arrowSelectedSignal(qreal)), this, SLOT(slot_gradArrow_selected(qreal)));
@@ -106,6 +175,12 @@ ShapePopulationQT::ShapePopulationQT()
     connect(this,SIGNAL(sig_backgroundColor_valueChanged(double, double, double, bool)), m_customizeColorMapByDirectionDialog, SLOT(updateBackgroundColor_valueChanged(double, double, double, bool)));
     connect(this,SIGNAL(sig_resetColor()), m_customizeColorMapByDirectionDialog, SLOT(resetColor()));
 
+    //shapeModesDialog signals
+    connect(m_shapeModesDialog,SIGNAL(sig_shapeMode_valueChanged(int, double)), this, SLOT(slot_shapeMode_valueChanged(int, double)));
+    connect(m_morphDialog,SIGNAL(sig_morph_valueChanged(double, int)), this, SLOT(slot_morph_valueChanged(double, int)));
+    connect(m_regionStatisticsDialog,SIGNAL(sig_exportCSV()), this, SLOT(exportRegionStatistics()));
+    connect(m_labelsDialog,SIGNAL(sig_labelVisibilityChanged(double, bool)), this, SLOT(slot_labelVisibilityChanged(double, bool)));
+
     //cameraDialog signals
     connect(this,SIGNAL(sig_updateCameraConfig(cameraConfigStruct)), m_cameraDialog, SLOT(updateCameraConfig(cameraConfigStruct)));
     connect(m_cameraDialog,SIGNAL(sig_newCameraConfig(cameraConfigStruct)), this, SLOT(slot_newCameraConfig(cameraConfigStruct)));
@@ -143,6 +218,22 @@ ShapePopulationQT::~ShapePopulationQT()
     delete m_backgroundDialog;
     delete m_CSVloaderDialog;
     delete m_customizeColorMapByDirectionDialog;
+    delete m_permutationTestDialog;
+    delete m_shapeModesDialog;
+    delete m_morphDialog;
+    delete m_vertexPickingDialog;
+    delete m_regionStatisticsDialog;
+    delete m_labelsDialog;
+    delete m_histogramDialog;
+    delete m_covariatesDialog;
+    delete m_animationDialog;
+    m_meshCache.CancelPrefetch();
+    m_prefetch.waitForFinished();
+    m_timeSeries.CancelPrefetch();
+    m_timeSeriesPrefetch.waitForFinished();
+    for (unsigned int i = 0; i < m_loadedTimepoints.size(); i++) delete m_loadedTimepoints[i];
+    m_picking.CancelBuild();
+    m_locatorBuild.waitForFinished();
 }
 
 void ShapePopulationQT::slotExit()
@@ -183,21 +274,13 @@ void ShapePopulationQT::loadVTKFilesCLP(QFileInfoList a_fileList)
 {
     //m_fileList.append(file);                      // Add to filelist
     m_fileList.append(a_fileList);
-    if(!m_fileList.isEmpty()) this->CreateWidgets();    // Display widgets
+    this->displayFiles_QT();                            // Display widgets
 }
 
 void ShapePopulationQT::loadCSVFileCLP(QFileInfo file)
 {
-    //Read .CSV with VTK
-    vtkSmartPointer<vtkDelimitedTextReader> CSVreader = vtkSmartPointer<vtkDelimitedTextReader>::New();
-    CSVreader->SetFieldDelimiterCharacters(",");
-    CSVreader->SetFileName(file.absoluteFilePath().toStdString().c_str());
-    CSVreader->SetHaveHeaders(true);
-    CSVreader->Update();
-    vtkSmartPointer<vtkTable> table = CSVreader->GetOutput();
-    
-    //Display in CSVloaderQT
-    m_CSVloaderDialog->displayTable(table,file.absoluteDir());
+    //Read .CSV off the GUI thread and display it in CSVloaderQT
+    m_CSVloaderDialog->loadCSVFile(file);
 }
 
 void ShapePopulationQT::loadVTKDirCLP(QDir vtkDir)
@@ -209,7 +292,7 @@ void ShapePopulationQT::loadVTKDirCLP(QDir vtkDir)
     for (int i = 0; i < m_fileList.size(); i++)
     {
         QString QFilePath = m_fileList.at(i).canonicalFilePath();
-        if (!QFilePath.endsWith(".vtk") && !QFilePath.endsWith(".vtp"))
+        if (!ShapePopulationReaders::IsSupported(QFilePath.toStdString()))
         {
             m_fileList.removeAt(i);
             i--;
@@ -217,7 +300,7 @@ void ShapePopulationQT::loadVTKDirCLP(QDir vtkDir)
     }
     
     // Display widgets
-    if(!m_fileList.isEmpty()) this->CreateWidgets();
+    this->displayFiles_QT();
 }
 
 void ShapePopulationQT::loadColorMapCLP(std::string a_filePath)
@@ -233,6 +316,11 @@ void ShapePopulationQT::loadCameraCLP(std::string a_filePath)
     m_cameraDialog->loadCameraConfig(QString(a_filePath.c_str()));
 }
 
+void ShapePopulationQT::loadSessionCLP(std::string a_filePath)
+{
+    this->loadSession(QString(a_filePath.c_str()));
+}
+
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
 // *                                        MENU FUNCTIONS                                         * //
 // * ///////////////////////////////////////////////////////////////////////////////////////////// * //
@@ -253,7 +341,7 @@ void ShapePopulationQT::openDirectory()
     for (int i = 0; i < m_fileList.size(); i++)
     {
         QString QFilePath = m_fileList.at(i).canonicalFilePath();
-        if (!QFilePath.endsWith(".vtk") && !QFilePath.endsWith(".vtp"))
+        if (!ShapePopulationReaders::IsSupported(QFilePath.toStdString()))
         {
             m_fileList.removeAt(i);
             i--;
@@ -261,13 +349,14 @@ void ShapePopulationQT::openDirectory()
     }
     
     // Display widgets
-    if(!m_fileList.isEmpty()) this->CreateWidgets();
+    this->displayFiles_QT();
 }
 
 
 void ShapePopulationQT::openFiles()
 {
-    QStringList stringList = QFileDialog::getOpenFileNames(this,tr("Open Files"),m_lastDirectory,"VTK Files (*.vtk *.vtp)");
+    QString filter = QString("Surface Files (%1)").arg(ShapePopulationReaders::GetFileFilter().c_str());
+    QStringList stringList = QFileDialog::getOpenFileNames(this,tr("Open Files"),m_lastDirectory,filter);
     if(stringList.isEmpty())
     {
         return ;
@@ -282,10 +371,7 @@ void ShapePopulationQT::openFiles()
     }
     
     // Display widgets
-    if(!m_fileList.isEmpty())
-    {
-        this->CreateWidgets();
-    }
+    this->displayFiles_QT();
 }
 
 
@@ -299,17 +385,8 @@ void ShapePopulationQT::loadCSV()
     QFileInfo file(filename);
     m_lastDirectory= file.path();
     
-    //Read .CSV with VTK
-    vtkSmartPointer<vtkDelimitedTextReader> CSVreader = vtkSmartPointer<vtkDelimitedTextReader>::New();
-    CSVreader->SetFieldDelimiterCharacters(",");
-    CSVreader->SetFileName(filename.toStdString().c_str());
-    CSVreader->SetHaveHeaders(true);
-    CSVreader->Update();
-    vtkSmartPointer<vtkTable> table = CSVreader->GetOutput();
-    
-    //Display in CSVloaderQT
-    m_CSVloaderDialog->displayTable(table,file.absoluteDir());
-    
+    //Read .CSV off the GUI thread and display it in CSVloaderQT
+    m_CSVloaderDialog->loadCSVFile(file);
 }
 
 
@@ -322,18 +399,53 @@ void ShapePopulationQT::slot_itemsSelected(QFileInfoList fileList)
     }
     
     // Display widgets
-    if(!m_fileList.isEmpty()) this->CreateWidgets();
+    this->displayFiles_QT();
 }
 
 void ShapePopulationQT::deleteAll()
 {
+    // Leave the paged browsing
+    m_meshCache.CancelPrefetch();
+    m_prefetch.waitForFinished();
+    m_pagedFiles.clear();
+    m_pagedHeaders.clear();
+    m_pageIndex = 0;
+    m_covariates.Clear();
+    m_covariatesDialog->setColumns(QStringList());
+    m_region.Clear();
+
+    this->unloadMeshes();
+    m_meshCache.Clear();
+    this->updatePageInfo_QT();
+}
+
+void ShapePopulationQT::unloadMeshes()
+{
+    this->stopTimepoints();
+    this->stopDrawingRegion();
+
+    // The windows of the overlays are deleted with the widgets, the region stays for the next page
+    m_picking.CancelBuild();
+    m_locatorBuild.waitForFinished();
+    m_picking.Clear();
+    m_overlays.clear();
+    m_labels.Clear();
+    m_pickedVertex = -1;
+    m_vertexPickingDialog->hide();
+
     //clear any Content from the layout
     QGridLayout *Qlayout = (QGridLayout *)this->scrollAreaWidgetContents->layout();
+    for (unsigned int i = 0; i < m_groupLabels.size(); i++)
+    {
+        Qlayout->removeWidget(m_groupLabels[i]);
+        delete m_groupLabels[i];
+    }
+    m_groupLabels.clear();
     for (unsigned int i = 0; i < m_widgetList.size(); i++)
     {
         Qlayout->removeWidget(m_widgetList.at(i));
         delete m_widgetList.at(i);
-        delete m_meshList.at(i);
+        if(!m_meshCache.Contains(m_meshList.at(i))) delete m_meshList.at(i);        //the cache keeps the pages around the displayed one
     }
     
     //Disable buttons
@@ -341,21 +453,26 @@ void ShapePopulationQT::deleteAll()
     gradientWidget_VISU->disable();
     actionDelete_All->setDisabled(true);
     actionDelete->setDisabled(true);
+    actionSave_Session->setDisabled(true);
     menuExport->setDisabled(true);
     menuOptions->setDisabled(true);
+    menuStatistics->setDisabled(true);
     
     //Initialize Menu actions
     actionOpen_Directory->setText("Open Directory");
-    actionOpen_VTK_Files->setText("Open VTK Files");
+    actionOpen_VTK_Files->setText("Open Surface Files");
     actionLoad_CSV->setText("Load CSV File");
     
     //Empty the meshes FileInfo List
     m_fileList.clear();
     m_meshList.clear();
     m_glyphList.clear();
+    m_tensorGlyphList.clear();
     m_selectedIndex.clear();
     m_windowsList.clear();
     m_widgetList.clear();
+    m_groupA.clear();
+    m_groupB.clear();
     m_numberOfMeshes = 0;
 
     axisColorStruct * axisColor = new axisColorStruct;
@@ -380,6 +497,8 @@ void ShapePopulationQT::deleteAll()
 void ShapePopulationQT::deleteSelection()
 {
     if(m_selectedIndex.size() == 0) return;
+    this->stopTimepoints();
+    this->stopDrawingRegion();
 
         this->scrollArea->setVisible(false);
 
@@ -389,6 +508,10 @@ void ShapePopulationQT::deleteSelection()
         // delete markers widgets
         deleteAllWidgets();
 
+        // the groups refer to the indices before deletion
+        m_groupA.clear();
+        m_groupB.clear();
+
 
 
         for (unsigned int i = 0; i < m_selectedIndex.size(); i++)
@@ -397,11 +520,19 @@ void ShapePopulationQT::deleteSelection()
             {
                 if( j == m_selectedIndex[i])
                 {
+                    //the file leaves the population when browsing by pages
+                    for(int k = 0; k < m_pagedFiles.size(); k++)
+                    {
+                        if(m_pagedFiles[k].absoluteFilePath() != m_fileList[j].absoluteFilePath()) continue;
+                        m_pagedFiles.removeAt(k);
+                        m_pagedHeaders.erase(m_pagedHeaders.begin() + k--);
+                    }
                     m_fileList.removeAt(j);
 
-                    delete m_meshList.at(j);
+                    if(!m_meshCache.Remove(m_meshList.at(j))) delete m_meshList.at(j);
                     m_meshList.erase(m_meshList.begin()+j);
                     m_glyphList.erase(m_glyphList.begin()+j);
+                    m_tensorGlyphList.erase(m_tensorGlyphList.begin()+j);
 
                     m_selectedIndex.erase(m_selectedIndex.begin()+i);           // CAREFUL : erase i value not j value, different vector here
                     for(unsigned int k = 0; k < m_selectedIndex.size() ; k++)
@@ -440,10 +571,14 @@ void ShapePopulationQT::deleteSelection()
         // initialization of all axis, sphere, and titles widgets
         initializationAllWidgets();
 
-        computeCommonAttributes();                                                  // get the common attributes in m_commonAttributes
+        computeCommonAttributes(m_pagedHeaders);                                    // get the common attributes in m_commonAttributes
 
-        // If no more widgets, do as deleteAll
-        if(m_numberOfMeshes == 0)
+        // If no more widgets, do as deleteAll, or display what is left of the page
+        if(m_numberOfMeshes == 0 && !m_pagedFiles.isEmpty())
+        {
+            this->showPage(m_pageIndex);
+        }
+        else if(m_numberOfMeshes == 0)
         {
             deleteAll();
         }
@@ -462,7 +597,7 @@ void ShapePopulationQT::deleteSelection()
                 m_selectedIndex.clear();
                 m_selectedIndex.push_back(j);
 
-                const char * a_cmap = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+                const char * a_cmap = m_meshList[m_selectedIndex[0]]->GetActiveScalarsName();
                 std::string cmap = std::string(a_cmap);
                 size_t found1 = cmap.rfind("_mag");
                 cmap = cmap.substr(0,found1);
@@ -488,7 +623,7 @@ void ShapePopulationQT::deleteSelection()
                     comboBox_VISU_attribute->addItem(QString(m_commonAttributes[i].c_str()));   // Then add the attribute to the comboBox
 
                     // color map by direction
-                    int dimension = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[i].c_str())->GetNumberOfComponents();
+                    int dimension = m_meshList[0]->GetAttribute(m_commonAttributes[i].c_str())->GetNumberOfComponents();
                     magnitudStruct * magnitude = new magnitudStruct;
                     if (dimension == 3 )
                     {
@@ -565,6 +700,12 @@ void ShapePopulationQT::deleteSelection()
             this->UnselectAll();
 //            this->updateInfo_QT();
             on_spinBox_DISPLAY_columns_valueChanged();
+
+            this->buildVertexLocators();
+            this->highlightVertex(m_pickedVertex);
+            this->updatePickedVertex_QT();
+            this->updateRegionStatistics_QT();
+            this->updateLabels_QT();
         }
 }
 
@@ -640,7 +781,7 @@ void ShapePopulationQT::slot_sameColor_valueChanged(bool checked)
         // update color map
         for(unsigned int j = 0 ; j < m_commonAttributes.size() ; j++)
         {
-            int dimension = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[j].c_str())->GetNumberOfComponents();
+            int dimension = m_meshList[m_selectedIndex[0]]->GetAttribute(m_commonAttributes[j].c_str())->GetNumberOfComponents();
             if (dimension == 3 )
             {
                 UpdateColorMapByDirection(m_commonAttributes[j].c_str(),j);
@@ -670,7 +811,7 @@ void ShapePopulationQT::slot_complementaryColor_valueChanged(bool checked)
         // update color map
         for(unsigned int j = 0 ; j < m_commonAttributes.size() ; j++)
         {
-            int dimension = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[j].c_str())->GetNumberOfComponents();
+            int dimension = m_meshList[m_selectedIndex[0]]->GetAttribute(m_commonAttributes[j].c_str())->GetNumberOfComponents();
             if (dimension == 3 )
             {
                 UpdateColorMapByDirection(m_commonAttributes[j].c_str(),j);
@@ -701,7 +842,7 @@ void ShapePopulationQT::slot_plusXAxis_valueChanged(QColor color)
     // update color map
     for(unsigned int j = 0 ; j < m_commonAttributes.size() ; j++)
     {
-        int dimension = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[j].c_str())->GetNumberOfComponents();
+        int dimension = m_meshList[m_selectedIndex[0]]->GetAttribute(m_commonAttributes[j].c_str())->GetNumberOfComponents();
         if (dimension == 3 )
         {
             UpdateColorMapByDirection(m_commonAttributes[j].c_str(),j);
@@ -731,7 +872,7 @@ void ShapePopulationQT::slot_plusYAxis_valueChanged(QColor color)
     // update color map
     for(unsigned int j = 0 ; j < m_commonAttributes.size() ; j++)
     {
-        int dimension = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[j].c_str())->GetNumberOfComponents();
+        int dimension = m_meshList[m_selectedIndex[0]]->GetAttribute(m_commonAttributes[j].c_str())->GetNumberOfComponents();
         if (dimension == 3 )
         {
             UpdateColorMapByDirection(m_commonAttributes[j].c_str(),j);
@@ -761,7 +902,7 @@ void ShapePopulationQT::slot_plusZAxis_valueChanged(QColor color)
     // update color map
     for(unsigned int j = 0 ; j < m_commonAttributes.size() ; j++)
     {
-        int dimension = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[j].c_str())->GetNumberOfComponents();
+        int dimension = m_meshList[m_selectedIndex[0]]->GetAttribute(m_commonAttributes[j].c_str())->GetNumberOfComponents();
         if (dimension == 3 )
         {
             UpdateColorMapByDirection(m_commonAttributes[j].c_str(),j);
@@ -849,74 +990,1265 @@ void ShapePopulationQT::slot_viewup_vx_valueChanged(double arg1)
     this->RenderSelection();
     m_renderAllSelection = false;
 }
-void ShapePopulationQT::slot_viewup_vy_valueChanged(double arg1)
+void ShapePopulationQT::slot_viewup_vy_valueChanged(double arg1)
+{
+    double * viewup = m_headcam->GetViewUp();
+    m_headcam->SetViewUp(viewup[0],arg1,viewup[2]);
+    m_renderAllSelection = true;
+    this->RenderSelection();
+    m_renderAllSelection = false;
+}
+void ShapePopulationQT::slot_viewup_vz_valueChanged(double arg1)
+{
+    double * viewup = m_headcam->GetViewUp();
+    m_headcam->SetViewUp(viewup[0],viewup[1],arg1);
+    m_renderAllSelection = true;
+    this->RenderSelection();
+    m_renderAllSelection = false;
+}
+void ShapePopulationQT::slot_scale_valueChanged(double arg1)
+{
+    m_headcam->SetParallelScale(arg1);
+    m_renderAllSelection = true;
+    this->RenderSelection();
+    m_renderAllSelection = false;
+}
+
+void ShapePopulationQT::slot_newCameraConfig(cameraConfigStruct cam)
+{
+    m_headcam->SetPosition(cam.pos_x,cam.pos_y,cam.pos_z);
+    m_headcam->SetFocalPoint(cam.foc_x,cam.foc_y,cam.foc_z);
+    m_headcam->SetViewUp(cam.view_vx,cam.view_vy,cam.view_vz);
+    m_headcam->SetParallelScale(cam.scale);
+    m_renderAllSelection = true;
+    this->RenderSelection();
+    m_renderAllSelection = false;
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       LOAD/SAVE COLORBAR                                      * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::loadColorMap()
+{
+    QString filename = QFileDialog::getOpenFileName(this,tr("Open .spvcm file"),m_colormapDirectory,"SPVCM file (*.spvcm)");
+    if(filename == "") return;
+    
+    QFileInfo file(filename);
+    m_colormapDirectory= file.path();
+    gradientWidget_VISU->loadColorPointList(filename, &m_usedColorBar->colorPointList);
+    
+    this->updateColorbar_QT();
+}
+
+
+void ShapePopulationQT::saveColorMap()
+{
+    QString filename = QFileDialog::getSaveFileName(this,tr("Save .spvcm file"),m_colormapDirectory,"SPVCM file (*.spvcm)");
+    if(filename == "") return;
+    
+    QFileInfo file(filename);
+    m_colormapDirectory= file.path();
+    if(file.suffix() != QString("spvcm")) filename += ".spvcm";
+    gradientWidget_VISU->saveColorPointList(filename);
+}
+
+void ShapePopulationQT::showCustomizeColorMapByDirectionConfigWindow()
+{
+    m_customizeColorMapByDirectionDialog->raise();
+    m_customizeColorMapByDirectionDialog->show();
+    m_customizeColorMapByDirectionDialog->AxisColor();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          HISTOGRAMS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::showHistogram()
+{
+    m_histogramDialog->raise();
+    m_histogramDialog->show();
+    this->updateHistogram_QT();
+}
+
+void ShapePopulationQT::updateHistogram_QT()
+{
+    if(!m_histogramDialog->isVisible() || m_selectedIndex.empty()) return;
+
+    std::string attribute = comboBox_VISU_attribute->currentText().toStdString();
+    this->updateHistograms();
+    if(!m_histograms.HasAttribute(attribute)) return;
+
+    double range[2];
+    m_histograms.GetRange(attribute, range);
+    std::vector< std::vector<double> > meshes;
+    for(unsigned int i = 0 ; i < m_selectedIndex.size() ; i++)
+    {
+        meshes.push_back(m_histograms.GetHistogram(attribute, m_selectedIndex[i]));
+    }
+    m_histogramDialog->setHistograms(QString(attribute.c_str()), range, m_histograms.GetMergedHistogram(attribute, m_selectedIndex), meshes);
+    m_histogramDialog->setColorbarRange(m_usedColorBar->range[0], m_usedColorBar->range[1]);
+}
+
+void ShapePopulationQT::slot_histogram_autoRange(double lowPercentile, double highPercentile)
+{
+    if(m_selectedIndex.empty()) return;
+
+    double range[2];
+    if(!this->computePercentileRange(comboBox_VISU_attribute->currentText().toStdString(), lowPercentile, highPercentile, range)) return;
+
+    m_noChange = true;
+    m_usedColorBar->range[0] = range[0];
+    spinBox_VISU_min->setValue(m_usedColorBar->range[0]);
+    m_usedColorBar->range[1] = range[1];
+    spinBox_VISU_max->setValue(m_usedColorBar->range[1]);
+
+    this->updateColorbar_QT();
+    this->updateArrowPosition();
+
+    m_noChange = false;
+}
+
+void ShapePopulationQT::showProfilingOverlay(bool display)
+{
+    if(display)
+    {
+        ShapePopulationProfiler::SetEnabled(true);
+        this->updateProfilingOverlay();
+        m_profilingOverlay->show();
+        m_profilingOverlay->raise();
+        m_profilingTimer->start();
+    }
+    else
+    {
+        m_profilingTimer->stop();
+        m_profilingOverlay->hide();
+    }
+}
+
+void ShapePopulationQT::updateProfilingOverlay()
+{
+    double lastFrame, meanFrame, maximumFrame;
+    this->getFrameStatistics(lastFrame, meanFrame, maximumFrame);
+    QString frames = QString("Frames : %1 ms (mean %2 ms, max %3 ms), quality level %4")
+            .arg(1000.0*lastFrame,0,'f',1).arg(1000.0*meanFrame,0,'f',1).arg(1000.0*maximumFrame,0,'f',1).arg(m_qualityLevel);
+    m_profilingOverlay->setText(QString::fromStdString(ShapePopulationProfiler::GetSummary(10)).trimmed() + "\n" + frames);
+    m_profilingOverlay->adjustSize();
+}
+
+void ShapePopulationQT::exportProfilingTrace()
+{
+    if(!ShapePopulationProfiler::IsEnabled())
+    {
+        QMessageBox::information(this,"Profiling","The profiler is disabled: display the profiling overlay or set the SPV_PROFILING environment variable before recording.",QMessageBox::Ok);
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this,tr("Export Profiling Trace"),QDir(m_exportDirectory).filePath("trace.json"),"Chrome Trace (*.json)");
+    if(fileName.isEmpty()) return;
+    if(!fileName.endsWith(".json")) fileName += ".json";
+    m_exportDirectory = QFileInfo(fileName).path();
+
+    if(!ShapePopulationProfiler::WriteChromeTrace(fileName.toStdString()))
+    {
+        QMessageBox::critical(this,"Profiling",QString("Could not write ") + fileName,QMessageBox::Ok);
+    }
+}
+
+void ShapePopulationQT::setAdaptiveQuality_QT(bool adaptive)
+{
+    this->setAdaptiveQuality(adaptive);
+    actionTarget_Frame_Rate->setEnabled(adaptive);
+}
+
+void ShapePopulationQT::setTargetFrameRate_QT()
+{
+    bool ok;
+    double frameRate = QInputDialog::getDouble(this,"Adaptive Quality","Target frame rate during interactions (frames per second) :",
+                                               m_targetFrameRate,1.0,120.0,1,&ok);
+    if(ok) this->setTargetFrameRate(frameRate);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            MEMORY                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+static QString spvMemoryString(unsigned long a_kiloBytes)
+{
+    return QString::number(a_kiloBytes/1024.0,'f',1) + " MB";
+}
+
+bool ShapePopulationQT::isWindowVisible(unsigned int a_index)
+{
+    if(a_index >= m_widgetList.size()) return true;
+    return !m_widgetList[a_index]->visibleRegion().isEmpty();
+}
+
+void ShapePopulationQT::setMemoryBudget_QT()
+{
+    bool ok;
+    int budget = QInputDialog::getInt(this,"Memory Budget","Memory budget of the population (MB, 0 for no budget) :\n"
+                                      "Over the budget, the data derived from the unselected meshes is released.",
+                                      (int)(m_memoryBudget/1024),0,1024*1024,256,&ok);
+    if(!ok) return;
+    m_memoryBudget = (unsigned long)budget*1024;
+    this->slot_memory_update();
+}
+
+void ShapePopulationQT::slot_memory_update()
+{
+    if(m_meshList.empty()) return;
+    this->enforceMemoryBudget();
+    this->updateMemoryInfo_QT();
+}
+
+void ShapePopulationQT::updateMemoryInfo_QT()
+{
+    if(m_meshList.empty()) return;
+
+    memoryUsageStruct total = this->computePopulationMemoryUsage();
+    QString population = spvMemoryString(totalMemory(total));
+    if(m_memoryBudget > 0) population += " / " + spvMemoryString(m_memoryBudget) + " budget";
+    this->lineEdit_memoryTotal->setText(population);
+
+    if(m_selectedIndex.size() != 1)
+    {
+        this->lineEdit_memory->setText(QString(""));
+        this->lineEdit_memory->setToolTip(QString(""));
+        return;
+    }
+    memoryUsageStruct usage = this->computeMemoryUsage(m_selectedIndex[0]);
+    this->lineEdit_memory->setText(spvMemoryString(totalMemory(usage)));
+    this->lineEdit_memory->setToolTip(QString("Geometry : %1\nAttributes : %2\nDerived arrays : %3\nGlyphs : %4\nGPU buffers (estimate) : %5")
+                                      .arg(spvMemoryString(usage.geometry)).arg(spvMemoryString(usage.attributes))
+                                      .arg(spvMemoryString(usage.derived)).arg(spvMemoryString(usage.glyphs))
+                                      .arg(spvMemoryString(usage.graphics)));
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                        PAGED BROWSING                                         * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::displayFiles_QT()
+{
+    if(m_fileList.size() <= (int)m_numberOfMeshes) return;
+
+    // Large populations are browsed by pages : m_pagedFiles holds the population, m_fileList the displayed page
+    if(m_pageSize > 0 && (!m_pagedFiles.isEmpty() || (m_numberOfMeshes == 0 && m_fileList.size() > m_pageSize)))
+    {
+        // The headers give the attributes of the whole population without loading it
+        std::vector<std::string> filePaths;
+        for (int i = m_numberOfMeshes; i < m_fileList.size(); i++)
+        {
+            m_pagedFiles.append(m_fileList[i]);
+            filePaths.push_back(std::string(m_fileList[i].absoluteFilePath().toLatin1().data()));
+        }
+        std::vector<ShapePopulationHeader> headers = ShapePopulationHeader::ScanFiles(filePaths);
+        m_pagedHeaders.insert(m_pagedHeaders.end(), headers.begin(), headers.end());
+        while(m_fileList.size() > (int)m_numberOfMeshes) m_fileList.removeLast();
+
+        this->showPage(m_numberOfMeshes == 0 ? 0 : m_pageIndex);        // the attributes of the new files may change the common ones
+        return;
+    }
+    this->CreateWidgets();
+}
+
+void ShapePopulationQT::showPage(int a_page)
+{
+    int numberOfPages = (m_pagedFiles.size() + m_pageSize - 1)/m_pageSize;
+    if(numberOfPages == 0) return;
+    if(a_page >= numberOfPages) a_page = numberOfPages - 1;
+    if(a_page < 0) a_page = 0;
+
+    // The prefetcher stops after the file it is reading
+    m_meshCache.CancelPrefetch();
+    m_prefetch.waitForFinished();
+
+    this->unloadMeshes();
+    m_pageIndex = a_page;
+    m_meshCache.SetCapacity(3*m_pageSize);
+
+    // Meshes of the page, read now unless they were prefetched
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::vector<ShapePopulationData *> pageMeshes;
+    for (int i = a_page*m_pageSize; i < m_pagedFiles.size() && i < (a_page + 1)*m_pageSize; i++)
+    {
+        std::string filePath = std::string(m_pagedFiles[i].absoluteFilePath().toLatin1().data());
+        ShapePopulationData * mesh = m_meshCache.Load(filePath);
+        if(mesh == NULL) continue;
+        pageMeshes.push_back(mesh);
+        m_generatedMeshes[filePath] = mesh;                         // CreateWidgets picks it up instead of reading the file
+        m_fileList.append(m_pagedFiles[i]);
+    }
+    m_meshCache.Pin(pageMeshes);
+    QApplication::restoreOverrideCursor();
+
+    if(!m_fileList.isEmpty()) this->CreateWidgets();
+    this->updatePageInfo_QT();
+
+    // Prefetch the next page, then the previous one
+    std::vector<std::string> filePaths;
+    for (int i = (a_page + 1)*m_pageSize; i < m_pagedFiles.size() && i < (a_page + 2)*m_pageSize; i++)
+    {
+        filePaths.push_back(std::string(m_pagedFiles[i].absoluteFilePath().toLatin1().data()));
+    }
+    for (int i = (a_page - 1)*m_pageSize; i >= 0 && i < a_page*m_pageSize; i++)
+    {
+        filePaths.push_back(std::string(m_pagedFiles[i].absoluteFilePath().toLatin1().data()));
+    }
+    if(!filePaths.empty()) m_prefetch = QtConcurrent::run(&m_meshCache, &ShapePopulationMeshCache::Prefetch, filePaths);
+}
+
+void ShapePopulationQT::previousPage()
+{
+    if(m_pageIndex > 0) this->showPage(m_pageIndex - 1);
+}
+
+void ShapePopulationQT::nextPage()
+{
+    if((m_pageIndex + 1)*m_pageSize < m_pagedFiles.size()) this->showPage(m_pageIndex + 1);
+}
+
+void ShapePopulationQT::setPageSize_QT()
+{
+    bool ok;
+    int pageSize = QInputDialog::getInt(this,"Paged Browsing","Meshes per page when a directory is larger (0 to load every mesh) :",
+                                        m_pageSize,0,10000,10,&ok);
+    if(!ok || pageSize == m_pageSize) return;
+    if(pageSize == 0 && !m_pagedFiles.isEmpty())
+    {
+        QMessageBox::information(this,"Paged Browsing","Paged browsing stops when the population is deleted.",QMessageBox::Ok);
+        return;
+    }
+    // Same first mesh on the new page
+    int firstMesh = m_pageIndex*m_pageSize;
+    m_pageSize = pageSize;
+    if(!m_pagedFiles.isEmpty()) this->showPage(firstMesh/m_pageSize);
+}
+
+void ShapePopulationQT::updatePageInfo_QT()
+{
+    bool paged = !m_pagedFiles.isEmpty();
+    int numberOfPages = paged ? (m_pagedFiles.size() + m_pageSize - 1)/m_pageSize : 0;
+    actionPrevious_Page->setEnabled(paged && m_pageIndex > 0);
+    actionNext_Page->setEnabled(paged && m_pageIndex + 1 < numberOfPages);
+    if(paged)
+    {
+        QString page = QString(" (page %1/%2, meshes %3-%4 of %5)").arg(m_pageIndex + 1).arg(numberOfPages)
+                .arg(m_pageIndex*m_pageSize + 1).arg(std::min((m_pageIndex + 1)*m_pageSize, m_pagedFiles.size())).arg(m_pagedFiles.size());
+        actionPrevious_Page->setText("Previous Page" + page);
+        actionNext_Page->setText("Next Page" + page);
+    }
+    else
+    {
+        actionPrevious_Page->setText("Previous Page");
+        actionNext_Page->setText("Next Page");
+    }
+}
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          COVARIATES                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::slot_covariatesLoaded(QStringList columns, QList<QStringList> covariates)
+{
+    std::vector<std::string> columnNames;
+    for (int j = 0; j < columns.size(); j++) columnNames.push_back(columns[j].toStdString());
+    std::vector<std::string> filePaths;
+    std::vector< std::vector<std::string> > rows;
+    for (int i = 0; i < covariates.size(); i++)
+    {
+        if(covariates[i].isEmpty()) continue;
+        filePaths.push_back(std::string(covariates[i][0].toLatin1().data()));
+        std::vector<std::string> values;
+        for (int j = 1; j < covariates[i].size(); j++) values.push_back(covariates[i][j].toStdString());
+        rows.push_back(values);
+    }
+    m_covariates.AddTable(columnNames, filePaths, rows);
+
+    QStringList allColumns;
+    std::vector<std::string> covariateColumns = m_covariates.GetColumns();
+    for (unsigned int j = 0; j < covariateColumns.size(); j++) allColumns.append(QString(covariateColumns[j].c_str()));
+    m_covariatesDialog->setColumns(allColumns);
+}
+
+void ShapePopulationQT::computeDisplayOrder()
+{
+    std::vector<std::string> filePaths;
+    for (unsigned int i = 0; i < m_numberOfMeshes; i++) filePaths.push_back(std::string(m_fileList[i].absoluteFilePath().toLatin1().data()));
+
+    std::string groupColumn = m_covariatesDialog->getGroupColumn();
+    m_displayOrder = m_covariates.ComputeOrder(filePaths, groupColumn, m_covariatesDialog->getSortColumn(), m_covariatesDialog->getDescending(),
+                                               m_covariatesDialog->getFilterColumn(), m_covariatesDialog->getFilterText());
+
+    // Group of each displayed mesh, the groups being in the display order
+    m_displayGroups.assign(m_displayOrder.size(), 0);
+    m_displayGroupNames.clear();
+    if(groupColumn.empty()) return;
+    for (unsigned int i = 0; i < m_displayOrder.size(); i++)
+    {
+        std::string group = m_covariates.GetValue(filePaths[m_displayOrder[i]], groupColumn);
+        if(m_displayGroupNames.empty() || m_displayGroupNames.back() != group) m_displayGroupNames.push_back(group);
+        m_displayGroups[i] = m_displayGroupNames.size() - 1;
+    }
+}
+
+void ShapePopulationQT::showCovariates()
+{
+    if(m_covariates.IsEmpty())
+    {
+        QMessageBox::information(this,"Covariates","Load a CSV file to get the covariates of the meshes : the columns of their rows.",QMessageBox::Ok);
+        return;
+    }
+    m_covariatesDialog->raise();
+    m_covariatesDialog->show();
+    this->updateCovariates_QT();
+}
+
+void ShapePopulationQT::slot_covariates_displayChanged()
+{
+    this->on_spinBox_DISPLAY_columns_valueChanged();
+    this->updateCovariates_QT();
+}
+
+void ShapePopulationQT::updateCovariates_QT()
+{
+    if(!m_covariatesDialog->isVisible() || m_numberOfMeshes == 0) return;
+
+    // Statistics of the displayed meshes, one group if the grid is not grouped
+    std::vector<int> groups(m_meshList.size(), -1);
+    for (unsigned int i = 0; i < m_displayOrder.size() && i < m_displayGroups.size(); i++)
+    {
+        if(m_displayOrder[i] < groups.size()) groups[m_displayOrder[i]] = m_displayGroups[i];
+    }
+    QStringList groupNames;
+    for (unsigned int g = 0; g < m_displayGroupNames.size(); g++) groupNames.append(QString(m_displayGroupNames[g].c_str()));
+    if(groupNames.isEmpty()) groupNames.append("All the meshes");
+
+    std::string attribute = comboBox_VISU_attribute->currentText().toStdString();
+    std::vector<ShapePopulationCovariates::GroupStatistics> statistics = ShapePopulationCovariates::ComputeGroupStatistics(m_meshList, groups, groupNames.size(), attribute);
+    m_covariatesDialog->setGroupStatistics(QString(attribute.c_str()), groupNames, statistics);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          TIME SERIES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::playTimepoints(bool play)
+{
+    if(!play)
+    {
+        m_playbackTimer->stop();
+        m_timeSeries.CancelPrefetch();
+        m_timeSeriesPrefetch.waitForFinished();
+        m_timeSeries.Clear();
+
+        // Back to the files loaded
+        for (unsigned int i = 0; i < m_loadedTimepoints.size(); i++)
+        {
+            if(m_loadedTimepoints[i] == NULL) continue;
+            if(i < m_meshList.size()) this->setMeshFrame(i, m_loadedTimepoints[i]);
+            delete m_loadedTimepoints[i];
+        }
+        m_loadedTimepoints.clear();
+        actionPlay_Timepoints->setText("Play Timepoints");
+        this->RenderAll();
+        return;
+    }
+
+    // Timepoints of the windows, numbers shared by the files loaded number the subjects instead
+    std::set<std::string> loadedFiles;
+    for (unsigned int i = 0; i < m_meshList.size(); i++) loadedFiles.insert(m_meshList[i]->GetFilePath());
+    std::vector< std::vector<std::string> > tracks(m_meshList.size());
+    unsigned int numberOfTracks = 0;
+    for (unsigned int i = 0; i < m_meshList.size(); i++)
+    {
+        std::string filePath = m_meshList[i]->GetFilePath();
+        std::vector<std::string> timepoints = ShapePopulationTimeSeries::FindTimepoints(filePath);
+        if(timepoints.size() < 2) continue;
+
+        bool subjects = false;
+        for (unsigned int j = 0; j < timepoints.size() && !subjects; j++)
+        {
+            subjects = (timepoints[j] != filePath && loadedFiles.find(timepoints[j]) != loadedFiles.end());
+        }
+        if(subjects) continue;
+        tracks[i] = timepoints;
+        numberOfTracks++;
+    }
+    if(numberOfTracks == 0)
+    {
+        std::ostringstream strs;
+        strs << "No timepoints found." << std::endl << std::endl
+             << "The timepoints of a subject are the files of its directory whose names only differ by their last number "
+             << "(subject_t0.vtk, subject_t1.vtk...). Open one timepoint of each subject." << std::endl;
+        QMessageBox::critical(this,"Time Series",QString(strs.str().c_str()),QMessageBox::Ok);
+        actionPlay_Timepoints->setChecked(false);
+        return;
+    }
+
+    // Data displayed now, the arrays are shared and swapped back when the playback stops
+    m_loadedTimepoints.assign(m_meshList.size(), (ShapePopulationData *)NULL);
+    for (unsigned int i = 0; i < m_meshList.size(); i++)
+    {
+        if(tracks[i].empty()) continue;
+        vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+        polyData->ShallowCopy(m_meshList[i]->GetPolyData());
+        vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+        points->SetData(m_meshList[i]->GetPolyData()->GetPoints()->GetData());
+        polyData->SetPoints(points);
+        m_loadedTimepoints[i] = new ShapePopulationData;
+        m_loadedTimepoints[i]->LoadProcessedPolyData(polyData, m_meshList[i]->GetFilePath());
+    }
+
+    m_timeSeries.SetTracks(tracks);
+    m_timeSeriesPrefetch = QtConcurrent::run(&m_timeSeries, &ShapePopulationTimeSeries::Prefetch);
+    m_playbackTimer->start((int)(1000.0/m_playbackFrameRate));
+}
+
+void ShapePopulationQT::showNextTimepoint()
+{
+    SPV_PROFILE_SCOPE("showNextTimepoint");
+
+    // The playback waits for the prefetcher instead of reading the files on the GUI thread
+    if(!m_timeSeries.IsStepReady())
+    {
+        ShapePopulationProfiler::AddCount("TimepointStalls", 1);
+        if(m_timeSeriesPrefetch.isFinished()) m_timeSeriesPrefetch = QtConcurrent::run(&m_timeSeries, &ShapePopulationTimeSeries::Prefetch);
+        return;
+    }
+
+    for (unsigned int i = 0; i < m_timeSeries.GetNumberOfTracks() && i < m_meshList.size(); i++)
+    {
+        ShapePopulationData * frame = m_timeSeries.GetFrame(i);
+        if(frame == NULL || this->setMeshFrame(i, frame)) continue;
+
+        std::ostringstream strs;
+        strs << frame->GetFileName() << " does not have the same number of points as " << m_meshList[i]->GetFileName() << "." << std::endl;
+        actionPlay_Timepoints->setChecked(false);
+        QMessageBox::critical(this,"Time Series",QString(strs.str().c_str()),QMessageBox::Ok);
+        return;
+    }
+    this->RenderAll();
+    actionPlay_Timepoints->setText(QString("Play Timepoints (%1/%2)").arg(m_timeSeries.GetCurrentStep() + 1).arg(m_timeSeries.GetNumberOfSteps()));
+
+    m_timeSeries.Advance();
+    if(m_timeSeriesPrefetch.isFinished()) m_timeSeriesPrefetch = QtConcurrent::run(&m_timeSeries, &ShapePopulationTimeSeries::Prefetch);
+}
+
+void ShapePopulationQT::setTimepointRate_QT()
+{
+    bool ok;
+    double frameRate = QInputDialog::getDouble(this,"Time Series","Timepoints displayed per second :",
+                                               m_playbackFrameRate,0.5,60.0,1,&ok);
+    if(!ok) return;
+    m_playbackFrameRate = frameRate;
+    if(m_playbackTimer->isActive()) m_playbackTimer->setInterval((int)(1000.0/m_playbackFrameRate));
+}
+
+void ShapePopulationQT::stopTimepoints()
+{
+    // toggled() restores the files loaded
+    if(actionPlay_Timepoints->isChecked()) actionPlay_Timepoints->setChecked(false);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                         VERTEX PICKING                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::buildVertexLocators()
+{
+    // The locators of the meshes loaded are built in the background, the picks before wait for none
+    m_picking.CancelBuild();
+    m_locatorBuild.waitForFinished();
+    m_picking.SetMeshes(m_meshList);
+    m_locatorBuild = QtConcurrent::run(&m_picking, &ShapePopulationPicking::BuildLocators);
+}
+
+void ShapePopulationQT::pickVertices(bool pick)
+{
+    // Leaving the picking mode hides the markers
+    if(pick)
+    {
+        actionDraw_Region->setChecked(false);
+        return;
+    }
+
+    this->highlightVertex(-1);
+    m_vertexPickingDialog->hide();
+    this->RenderAll();
+}
+
+void ShapePopulationQT::updatePickedVertex_QT()
+{
+    if(m_pickedVertex < 0) return;
+
+    // Values of the attribute displayed, at the same vertex of every mesh
+    std::string attribute = comboBox_VISU_attribute->currentText().toStdString();
+    QStringList meshes;
+    std::vector<double> values;
+    std::vector<bool> defined;
+    for (unsigned int i = 0; i < m_meshList.size(); i++)
+    {
+        double value;
+        meshes << QString(m_meshList[i]->GetFileName().c_str());
+        defined.push_back(ShapePopulationPicking::GetValue(m_meshList[i], attribute, m_pickedVertex, value));
+        values.push_back(value);
+    }
+    m_vertexPickingDialog->setValues((int)m_pickedVertex, QString(attribute.c_str()), meshes, values, defined);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       REGION OF INTEREST                                      * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::drawRegion(bool draw)
+{
+    // The drag draws the lasso instead of moving the camera
+    if(draw)
+    {
+        actionPick_Vertices->setChecked(false);
+        m_interactorStyles.clear();
+        for (unsigned int i = 0; i < m_widgetList.size(); i++)
+        {
+            m_interactorStyles.push_back(m_widgetList[i]->GetInteractor()->GetInteractorStyle());
+            m_widgetList[i]->GetInteractor()->SetInteractorStyle(NULL);
+        }
+        return;
+    }
+
+    for (unsigned int i = 0; i < m_widgetList.size() && i < m_interactorStyles.size(); i++)
+    {
+        m_widgetList[i]->GetInteractor()->SetInteractorStyle(m_interactorStyles[i]);
+    }
+    m_interactorStyles.clear();
+    if(!m_lasso.empty() && m_lassoWindow < m_windowsList.size())
+    {
+        this->drawLasso(m_lassoWindow, std::vector<double>());
+        m_windowsList[m_lassoWindow]->Render();
+    }
+    m_lasso.clear();
+}
+
+void ShapePopulationQT::stopDrawingRegion()
+{
+    // toggled() gives the camera interaction back to the widgets
+    if(actionDraw_Region->isChecked()) actionDraw_Region->setChecked(false);
+}
+
+void ShapePopulationQT::clearRegion_QT()
+{
+    this->clearRegion();
+    this->updateRegionStatistics_QT();
+    this->RenderAll();
+}
+
+void ShapePopulationQT::showRegionStatistics()
+{
+    if(m_region.GetNumberOfVertices() == 0)
+    {
+        QMessageBox::critical(this,"Region Statistics","Draw a region first, with Options > Draw Region.", QMessageBox::Ok);
+        return;
+    }
+    m_regionStatisticsDialog->raise();
+    m_regionStatisticsDialog->show();
+    this->updateRegionStatistics_QT();
+}
+
+void ShapePopulationQT::updateRegionStatistics_QT()
+{
+    if(!m_regionStatisticsDialog->isVisible()) return;
+
+    // Attribute displayed, every mesh loaded
+    std::string attribute = comboBox_VISU_attribute->currentText().toStdString();
+    std::vector<ShapePopulationRegion::Statistics> statistics = m_region.ComputeStatistics(m_meshList, attribute);
+    QStringList meshes;
+    for (unsigned int i = 0; i < m_meshList.size(); i++) meshes << QString(m_meshList[i]->GetFileName().c_str());
+    m_regionStatisticsDialog->setStatistics(m_region.GetNumberOfVertices(), QString(attribute.c_str()), meshes, statistics);
+}
+
+void ShapePopulationQT::exportRegionStatistics()
+{
+    QString fileName = QFileDialog::getSaveFileName(this,tr("Export Region Statistics"),QDir(m_exportDirectory).filePath("region.csv"),"CSV file (*.csv)");
+    if(fileName.isEmpty()) return;
+    if(!fileName.endsWith(".csv")) fileName += ".csv";
+    m_exportDirectory = QFileInfo(fileName).path();
+
+    std::string attribute = comboBox_VISU_attribute->currentText().toStdString();
+    std::vector<ShapePopulationRegion::Statistics> statistics = m_region.ComputeStatistics(m_meshList, attribute);
+    std::vector<std::string> meshes;
+    for (unsigned int i = 0; i < m_meshList.size(); i++) meshes.push_back(m_meshList[i]->GetFileName());
+    if(!ShapePopulationRegion::WriteCSV(fileName.toStdString(), attribute, meshes, statistics))
+    {
+        QMessageBox::critical(this,"Region Statistics",QString("Could not write ") + fileName,QMessageBox::Ok);
+    }
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             LABELS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::displayLabels(bool display)
+{
+    m_displayLabels = display;
+    if(display)
+    {
+        std::string attribute = comboBox_VISU_attribute->currentText().toStdString();
+        if(attribute.empty())
+        {
+            QMessageBox::critical(this,"Label Mode","Load meshes with a label attribute first.", QMessageBox::Ok);
+            actionLabel_Mode->setChecked(false);
+            return;
+        }
+
+        // One scan of the meshes loaded for each attribute
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        bool categorical = this->updateLabels(attribute);
+        QApplication::restoreOverrideCursor();
+        if(!categorical)
+        {
+            QMessageBox::critical(this,"Label Mode",QString(m_labels.GetErrorMessage().c_str()), QMessageBox::Ok);
+            actionLabel_Mode->setChecked(false);                        // toggled() colors with the color bar again
+            return;
+        }
+        m_labelsDialog->raise();
+        m_labelsDialog->show();
+        this->updateLabels_QT();
+    }
+    else m_labelsDialog->hide();
+
+    // The color bar or the labels, for the selection
+    this->UpdateColorMapByMagnitude(m_selectedIndex);
+    this->RenderAll();
+}
+
+void ShapePopulationQT::updateLabels_QT()
+{
+    if(!m_labelsDialog->isVisible()) return;
+
+    // Labels of the attribute displayed, none if it is not a label attribute
+    this->updateLabels(comboBox_VISU_attribute->currentText().toStdString());
+    m_labelsDialog->setLabels(&m_labels);
+}
+
+void ShapePopulationQT::slot_labelVisibilityChanged(double a_label, bool a_visible)
+{
+    // The lookup table is shared by the windows : only the color of the label changes
+    m_labels.SetLabelVisibility(a_label, a_visible);
+    this->RenderAll();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            TENSORS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::displayTensors_QT(bool display)
+{
+    // Ellipsoids of the selection when its attribute comes from a tensor array (trace, FA, a component...)
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    this->displayTensors(display);
+    QApplication::restoreOverrideCursor();
+    this->RenderAll();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            SESSION                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::openSession()
+{
+    QString filename = QFileDialog::getOpenFileName(this,tr("Open .spvs file"),m_lastDirectory,"SPVS file (*.spvs)");
+    if(filename.isEmpty() || !QFileInfo(filename).exists()) return;
+
+    m_lastDirectory = QFileInfo(filename).path();
+    this->loadSession(filename);
+}
+
+void ShapePopulationQT::saveSession()
+{
+    if(m_numberOfMeshes == 0) return;
+    QString filename = QFileDialog::getSaveFileName(this,tr("Save .spvs file"),m_lastDirectory,"SPVS file (*.spvs)");
+    if(filename == "") return;
+
+    QFileInfo file(filename);
+    m_lastDirectory = file.path();
+    if(file.suffix() != QString("spvs")) filename += ".spvs";
+
+    // A paged population is read again page by page, its meshes are not embedded
+    bool embed = false;
+    if(m_pagedFiles.isEmpty())
+    {
+        QMessageBox::StandardButton answer = QMessageBox::question(this,"Save Session",
+                "Embed the processed meshes in binary .vtp files next to the session ?\n"
+                "The session is then restored without reading and processing the original files, "
+                "and the meshes computed in memory are kept.",
+                QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel, QMessageBox::Yes);
+        if(answer == QMessageBox::Cancel) return;
+        embed = (answer == QMessageBox::Yes);
+    }
+
+    ShapePopulationSession session;
+    this->captureSession(session);
+    ShapePopulationSession::ViewState &view = session.GetView();
+    view.attribute = std::string(comboBox_VISU_attribute->currentText().toLatin1().data());
+    view.columns = spinBox_DISPLAY_columns->value();
+    view.alignment = comboBox_alignment->currentIndex();
+    if(!m_pagedFiles.isEmpty())
+    {
+        view.pageSize = m_pageSize;
+        view.pageIndex = m_pageIndex;
+        for (int i = 0; i < m_pagedFiles.size(); i++)
+        {
+            session.GetPopulation().push_back(std::string(m_pagedFiles[i].absoluteFilePath().toLatin1().data()));
+        }
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::string errorMessage;
+    bool written = session.Write(std::string(filename.toLatin1().data()), embed ? m_meshList : std::vector<ShapePopulationData *>(), errorMessage);
+    QApplication::restoreOverrideCursor();
+    if(!written) QMessageBox::critical(this,"Save Session",QString(errorMessage.c_str()),QMessageBox::Ok);
+}
+
+void ShapePopulationQT::loadSession(QString a_filePath)
+{
+    ShapePopulationSession session;
+    std::string errorMessage;
+    if(!session.Read(std::string(a_filePath.toLatin1().data()), errorMessage))
+    {
+        QMessageBox::critical(this,"Open Session",QString(errorMessage.c_str()),QMessageBox::Ok);
+        return;
+    }
+    this->deleteAll();
+
+    // The embedded meshes are read in parallel and given to CreateWidgets, the other ones are read from their files
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::vector<ShapePopulationData *> embedded = session.ReadEmbeddedMeshes();
+    QApplication::restoreOverrideCursor();
+
+    std::vector<ShapePopulationSession::MeshState> &meshes = session.GetMeshes();
+    std::vector<std::string> &population = session.GetPopulation();
+    ShapePopulationSession::ViewState &view = session.GetView();
+    std::vector<std::string> filePaths = population;
+    if(population.empty())
+    {
+        for (unsigned int i = 0; i < meshes.size(); i++) filePaths.push_back(meshes[i].filePath);
+    }
+    std::ostringstream strs;
+    int numberOfErrors = 0;
+    for (unsigned int i = 0; i < filePaths.size(); i++)
+    {
+        QFileInfo file(QString(filePaths[i].c_str()));
+        std::string absolutePath = std::string(file.absoluteFilePath().toLatin1().data());
+        ShapePopulationData * mesh = (population.empty() && i < embedded.size()) ? embedded[i] : NULL;
+        if(mesh != NULL && m_generatedMeshes.find(absolutePath) == m_generatedMeshes.end())
+        {
+            m_generatedMeshes[absolutePath] = mesh;
+        }
+        else
+        {
+            delete mesh;
+            if(!file.exists())
+            {
+                if(numberOfErrors++ < 20) strs << filePaths[i] << std::endl;
+                continue;
+            }
+        }
+        m_fileList.append(file);
+    }
+    if(numberOfErrors > 0)
+    {
+        if(numberOfErrors > 20) strs << "... and " << numberOfErrors - 20 << " more." << std::endl;
+        std::ostringstream title;
+        title << numberOfErrors << " of the " << filePaths.size() << " meshes of the session can not be found :" << std::endl;
+        QMessageBox::critical(this,"Open Session",QString((title.str() + strs.str()).c_str()),QMessageBox::Ok);
+    }
+    if(m_fileList.isEmpty()) return;
+
+    // Meshes, on the page of the session if the population was browsed by pages
+    int pageSize = m_pageSize;
+    if(population.empty()) m_pageSize = 0;                                      // all loaded, whatever their number
+    else if(view.pageSize > 0) m_pageSize = view.pageSize;
+    this->displayFiles_QT();
+    if(population.empty()) m_pageSize = pageSize;
+    if(!m_pagedFiles.isEmpty() && view.pageIndex != m_pageIndex) this->showPage(view.pageIndex);
+    if(m_numberOfMeshes == 0) return;
+
+    // Global view
+    checkBox_displayColorbar->setChecked(view.displayColorbar);
+    checkBox_displayAttribute->setChecked(view.displayAttribute);
+    checkBox_displayMeshName->setChecked(view.displayMeshName);
+    checkBox_displaySphere->setChecked(view.displaySphere);
+    comboBox_alignment->setCurrentIndex(view.alignment);
+    int attribute = comboBox_VISU_attribute->findText(QString(view.attribute.c_str()));
+    if(attribute != -1) comboBox_VISU_attribute->setCurrentIndex(attribute);
+
+    // Colorbars, meshes, colors and camera
+    this->restoreSession(session);
+    this->on_comboBox_VISU_attribute_currentIndexChanged();                    // ranges of the restored colorbar
+    if(!m_selectedIndex.empty()) this->updateMeshControls_QT(m_selectedIndex[0]);
+    if(view.columns > 0 && view.columns <= spinBox_DISPLAY_columns->maximum()) spinBox_DISPLAY_columns->setValue(view.columns);
+
+    this->UpdateCameraConfig();
+    this->RenderAll();
+}
+
+void ShapePopulationQT::updateMeshControls_QT(unsigned int a_index)
+{
+    // The controls show the state of the mesh without applying it to the selection
+    QList<QWidget *> controls;
+    controls << spinbox_meshOpacity << slider_meshOpacity << spinbox_vectorScale << slider_vectorScale << spinbox_arrowDens << slider_arrowDens
+             << radioButton_displayColorMapByMagnitude << radioButton_displayColorMapByDirection << checkBox_displayVectors
+             << radioButton_displayVectorsbyMagnitude << radioButton_displayVectorsbyDirection;
+    for (int i = 0; i < controls.size(); i++) controls[i]->blockSignals(true);
+
+    spinbox_meshOpacity->setValue(m_meshOpacity[a_index]);
+    slider_meshOpacity->setValue(m_meshOpacity[a_index]);
+    spinbox_vectorScale->setValue(m_vectorScale[a_index]);
+    slider_vectorScale->setValue(m_vectorScale[a_index]);
+    spinbox_arrowDens->setValue(m_vectorDensity[a_index]);
+    slider_arrowDens->setValue(m_vectorDensity[a_index]);
+
+    if(m_displayColorMapByDirection[a_index])
+    {
+        radioButton_displayColorMapByDirection->setChecked(true);
+        stackedWidget_ColorMapByDirection->show();
+        stackedWidget_ColorMapByMagnitude->hide();
+    }
+    else
+    {
+        radioButton_displayColorMapByMagnitude->setChecked(true);
+        stackedWidget_ColorMapByMagnitude->show();
+        stackedWidget_ColorMapByDirection->hide();
+    }
+
+    checkBox_displayVectors->setChecked(m_displayVectors[a_index]);
+    if(m_displayVectors[a_index])
+    {
+        m_firstDisplayVector = false;
+        if(m_displayVectorsByDirection[a_index]) radioButton_displayVectorsbyDirection->setChecked(true);
+        else radioButton_displayVectorsbyMagnitude->setChecked(true);
+    }
+    widget_VISU_colorVectors->setEnabled(m_displayVectors[a_index]);
+    widget_VISU_optionVectors->setEnabled(m_displayVectors[a_index]);
+
+    for (int i = 0; i < controls.size(); i++) controls[i]->blockSignals(false);
+
+    emit sig_axisColor_value(m_axisColor[a_index], m_customizeColorMapByDirectionDialog->isVisible());
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          STATISTICS                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationQT::setSelectionAsGroupA()
+{
+    m_groupA = m_selectedIndex;
+    std::sort(m_groupA.begin(),m_groupA.end());
+}
+
+void ShapePopulationQT::setSelectionAsGroupB()
+{
+    m_groupB = m_selectedIndex;
+    std::sort(m_groupB.begin(),m_groupB.end());
+}
+
+void ShapePopulationQT::compareGroups()
+{
+    if(m_groupA.empty() || m_groupB.empty())
+    {
+        QMessageBox::critical(this,"Group comparison","Select the meshes of each group and use \"Set Selection as Group A\" and \"Set Selection as Group B\" first.", QMessageBox::Ok);
+        return;
+    }
+    
+    // Compare an attribute or the point positions
+    QStringList items;
+    items << "Point positions (displacement)";
+    for(unsigned int i = 0 ; i < m_commonAttributes.size() ; i++)
+    {
+        items << QString(m_commonAttributes[i].c_str());
+    }
+    bool ok = false;
+    QString item = QInputDialog::getItem(this,tr("Group comparison"),tr("Compare:"),items,0,false,&ok);
+    if(!ok) return;
+    
+    std::string attribute = "";
+    if(item != items.at(0)) attribute = item.toStdString();
+    
+    std::string errorMessage;
+    ShapePopulationData * mesh = this->computeGroupComparison(attribute, errorMessage);
+    if(mesh == NULL)
+    {
+        QMessageBox::critical(this,"Group comparison",QString(errorMessage.c_str()), QMessageBox::Ok);
+        return;
+    }
+    
+    this->addGeneratedMesh(mesh);
+    
+    // Display the t-map
+    std::string label = attribute.empty() ? std::string("Displacement") : attribute;
+    int index = comboBox_VISU_attribute->findText(QString((label + "_WelchT").c_str()));
+    if(index >= 0) comboBox_VISU_attribute->setCurrentIndex(index);
+}
+
+
+void ShapePopulationQT::permutationTest()
 {
-    double * viewup = m_headcam->GetViewUp();
-    m_headcam->SetViewUp(viewup[0],arg1,viewup[2]);
-    m_renderAllSelection = true;
-    this->RenderSelection();
-    m_renderAllSelection = false;
+    if(m_groupA.empty() || m_groupB.empty())
+    {
+        QMessageBox::critical(this,"Permutation test","Select the meshes of each group and use \"Set Selection as Group A\" and \"Set Selection as Group B\" first.", QMessageBox::Ok);
+        return;
+    }
+    
+    QStringList items;
+    items << "Point positions (displacement)";
+    for(unsigned int i = 0 ; i < m_commonAttributes.size() ; i++)
+    {
+        items << QString(m_commonAttributes[i].c_str());
+    }
+    m_permutationTestDialog->setAttributes(items);
+    if(m_permutationTestDialog->exec() != QDialog::Accepted) return;
+    
+    std::string attribute = "";
+    int attributeIndex = m_permutationTestDialog->getAttributeIndex();
+    if(attributeIndex > 0) attribute = items.at(attributeIndex).toStdString();
+    int numberOfPermutations = m_permutationTestDialog->getNumberOfPermutations();
+    unsigned int seed = m_permutationTestDialog->getSeed();
+    
+    std::vector<ShapePopulationData *> groupA;
+    std::vector<ShapePopulationData *> groupB;
+    this->getGroupMeshes(groupA, groupB);
+    
+    // The derived and cell attributes compared are computed here, the worker only reads them
+    if(!attribute.empty())
+    {
+        for(unsigned int i = 0 ; i < groupA.size() ; i++) ShapePopulationStatistics::GetComparedArray(groupA[i], attribute);
+        for(unsigned int i = 0 ; i < groupB.size() ; i++) ShapePopulationStatistics::GetComparedArray(groupB[i], attribute);
+    }
+    
+    // The test runs in a worker thread (itself spreading the vertices on all the cores)
+    // while the GUI shows its progress and can cancel it
+    ShapePopulationStatistics statistics;
+    QFuture<bool> future = QtConcurrent::run(&statistics, &ShapePopulationStatistics::ComputePermutationTest,
+                                             groupA, groupB, attribute, numberOfPermutations, seed);
+    QFutureWatcher<bool> watcher;
+    watcher.setFuture(future);
+    
+    QProgressDialog progress("Running the permutation test...", "Cancel", 0, 100, this);
+    progress.setWindowTitle("Permutation test");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setValue(0);
+    
+    while(!future.isFinished())
+    {
+        QEventLoop loop;
+        connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+        QTimer::singleShot(100, &loop, SLOT(quit()));
+        loop.exec();
+        
+        if(progress.wasCanceled()) statistics.Abort();
+        else progress.setValue((int)(100 * statistics.GetProgress()));
+    }
+    progress.setValue(100);
+    
+    if(!future.result())
+    {
+        if(!progress.wasCanceled()) QMessageBox::critical(this,"Permutation test",QString(statistics.GetErrorMessage().c_str()), QMessageBox::Ok);
+        return;
+    }
+    
+    this->addGeneratedMesh(this->createStatisticsMesh(&statistics, attribute, true));
+    
+    // Display the FDR-corrected map
+    std::string label = attribute.empty() ? std::string("Displacement") : attribute;
+    int index = comboBox_VISU_attribute->findText(QString((label + "_qFDR").c_str()));
+    if(index >= 0) comboBox_VISU_attribute->setCurrentIndex(index);
 }
-void ShapePopulationQT::slot_viewup_vz_valueChanged(double arg1)
+
+void ShapePopulationQT::showShapeModes()
 {
-    double * viewup = m_headcam->GetViewUp();
-    m_headcam->SetViewUp(viewup[0],viewup[1],arg1);
-    m_renderAllSelection = true;
-    this->RenderSelection();
-    m_renderAllSelection = false;
+    if(m_selectedIndex.size() < 3)
+    {
+        QMessageBox::critical(this,"Shape modes","Select at least three corresponded meshes first.", QMessageBox::Ok);
+        return;
+    }
+    
+    bool ok = false;
+    int numberOfModes = QInputDialog::getInt(this,tr("Shape modes"),tr("Number of modes:"),10,1,50,1,&ok);
+    if(!ok) return;
+    
+    std::string errorMessage;
+    ShapePopulationData * mesh = this->computeShapeModes(numberOfModes, errorMessage);
+    if(mesh == NULL)
+    {
+        QMessageBox::critical(this,"Shape modes",QString(errorMessage.c_str()), QMessageBox::Ok);
+        return;
+    }
+    this->addGeneratedMesh(mesh);
+    
+    // Display the displacement, with a colorbar covering the whole sweep (+/- 3 standard deviations)
+    QStringList modes;
+    double maximum = 0.0;
+    for(int k = 0 ; k < m_shapeModes.GetNumberOfModes() ; k++)
+    {
+        modes << QString("Mode %1 (%2 %)").arg(k + 1).arg(100.0*m_shapeModes.GetExplainedVariance(k), 0, 'f', 1);
+        maximum = std::max(maximum, m_shapeModes.GetMaximumDisplacement(k, 3.0));
+    }
+    int index = comboBox_VISU_attribute->findText(QString("ShapeMode_Displacement"));
+    if(index >= 0)
+    {
+        m_colorBarList[index]->range[0] = 0.0;
+        m_colorBarList[index]->range[1] = maximum;
+        if(index == comboBox_VISU_attribute->currentIndex()) this->on_comboBox_VISU_attribute_currentIndexChanged();
+        else comboBox_VISU_attribute->setCurrentIndex(index);
+    }
+    
+    m_shapeModesDialog->setModes(modes);
+    m_shapeModesDialog->raise();
+    m_shapeModesDialog->show();
 }
-void ShapePopulationQT::slot_scale_valueChanged(double arg1)
+
+void ShapePopulationQT::slot_shapeMode_valueChanged(int mode, double standardDeviations)
 {
-    m_headcam->SetParallelScale(arg1);
-    m_renderAllSelection = true;
-    this->RenderSelection();
-    m_renderAllSelection = false;
+    ShapePopulationData * mesh = this->getShapeModesMesh();
+    if(mesh == NULL) return;
+    
+    this->setShapeMode(mode, standardDeviations);
+    for(unsigned int i = 0 ; i < m_meshList.size() ; i++)
+    {
+        if(m_meshList[i] == mesh) m_windowsList[i]->Render();
+    }
 }
 
-void ShapePopulationQT::slot_newCameraConfig(cameraConfigStruct cam)
+void ShapePopulationQT::showMorph()
 {
-    m_headcam->SetPosition(cam.pos_x,cam.pos_y,cam.pos_z);
-    m_headcam->SetFocalPoint(cam.foc_x,cam.foc_y,cam.foc_z);
-    m_headcam->SetViewUp(cam.view_vx,cam.view_vy,cam.view_vz);
-    m_headcam->SetParallelScale(cam.scale);
-    m_renderAllSelection = true;
-    this->RenderSelection();
-    m_renderAllSelection = false;
+    if(m_selectedIndex.size() < 2)
+    {
+        QMessageBox::critical(this,"Morph","Select at least two corresponded meshes first, in the order of the morph.", QMessageBox::Ok);
+        return;
+    }
+
+    // Names before the new window changes the selection
+    QStringList shapes;
+    ShapePopulationData * previousMesh = this->getMorphMesh();
+    for(unsigned int i = 0 ; i < m_selectedIndex.size() ; i++)
+    {
+        if(m_meshList[m_selectedIndex[i]] != previousMesh) shapes << QString(m_meshList[m_selectedIndex[i]]->GetFileName().c_str());
+    }
+
+    std::string errorMessage;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    ShapePopulationData * mesh = this->computeMorph(errorMessage);
+    QApplication::restoreOverrideCursor();
+    if(mesh == NULL)
+    {
+        QMessageBox::critical(this,"Morph",QString(errorMessage.c_str()), QMessageBox::Ok);
+        return;
+    }
+    this->addGeneratedMesh(mesh);
+
+    m_morphDialog->setShapes(shapes);
+    m_morphDialog->raise();
+    m_morphDialog->show();
 }
 
-// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
-// *                                       LOAD/SAVE COLORBAR                                      * //
-// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+void ShapePopulationQT::slot_morph_valueChanged(double position, int interpolation)
+{
+    ShapePopulationData * mesh = this->getMorphMesh();
+    if(mesh == NULL) return;
 
-void ShapePopulationQT::loadColorMap()
+    this->setMorphPosition(position, interpolation);
+    for(unsigned int i = 0 ; i < m_meshList.size() ; i++)
+    {
+        if(m_meshList[i] == mesh) m_windowsList[i]->Render();
+    }
+}
+
+void ShapePopulationQT::surfaceDistance()
 {
-    QString filename = QFileDialog::getOpenFileName(this,tr("Open .spvcm file"),m_colormapDirectory,"SPVCM file (*.spvcm)");
-    if(filename == "") return;
+    if(m_selectedIndex.empty())
+    {
+        QMessageBox::critical(this,"Surface distance","Select the meshes to compare to the reference first.", QMessageBox::Ok);
+        return;
+    }
     
-    QFileInfo file(filename);
-    m_colormapDirectory= file.path();
-    gradientWidget_VISU->loadColorPointList(filename, &m_usedColorBar->colorPointList);
+    // Numbered items : meshes of different directories may have the same name, the number gives back the index
+    QStringList items;
+    for(unsigned int i = 0 ; i < m_meshList.size() ; i++)
+    {
+        items << QString("%1. %2").arg(i + 1).arg(m_meshList[i]->GetFileName().c_str());
+    }
+    bool ok = false;
+    QString item = QInputDialog::getItem(this,tr("Surface distance"),tr("Reference mesh:"),items,0,false,&ok);
+    if(!ok) return;
     
-    this->updateColorbar_QT();
+    std::string attribute;
+    std::string errorMessage;
+    if(!this->computeSurfaceDistance(items.indexOf(item), attribute, errorMessage))
+    {
+        QMessageBox::critical(this,"Surface distance",QString(errorMessage.c_str()), QMessageBox::Ok);
+        return;
+    }
+    
+    if(m_selectedIndex.size() < m_meshList.size())
+    {
+        QMessageBox::information(this,"Surface distance",QString("The distance was only computed on the selected meshes, it will be listed in the attributes once every mesh has it."), QMessageBox::Ok);
+        return;
+    }
+    this->updateCommonAttribute_QT(attribute);
 }
 
-
-void ShapePopulationQT::saveColorMap()
+void ShapePopulationQT::updateCommonAttribute_QT(std::string a_attribute)
 {
-    QString filename = QFileDialog::getSaveFileName(this,tr("Save .spvcm file"),m_colormapDirectory,"SPVCM file (*.spvcm)");
-    if(filename == "") return;
+    // Adds the colorbar of a new attribute without resetting the ones of the other attributes
+    this->computeCommonAttributes(m_pagedHeaders);
+    std::vector<std::string>::iterator it = std::find(m_commonAttributes.begin(), m_commonAttributes.end(), a_attribute);
+    if(it == m_commonAttributes.end()) return;
+    int index = (int)(it - m_commonAttributes.begin());
     
-    QFileInfo file(filename);
-    m_colormapDirectory= file.path();
-    if(file.suffix() != QString("spvcm")) filename += ".spvcm";
-    gradientWidget_VISU->saveColorPointList(filename);
+    m_updateOnAttributeChanged = false;
+    if(comboBox_VISU_attribute->findText(QString(a_attribute.c_str())) == -1)
+    {
+        colorBarStruct * colorBar = new colorBarStruct;
+        gradientWidget_VISU->reset();
+        gradientWidget_VISU->getAllColors(&colorBar->colorPointList);
+        m_colorBarList.insert(m_colorBarList.begin() + index, colorBar);
+        
+        magnitudStruct * magnitude = new magnitudStruct;
+        magnitude->min = 0.0;
+        magnitude->max = 0.0;
+        m_magnitude.insert(m_magnitude.begin() + index, magnitude);
+        
+        comboBox_VISU_attribute->insertItem(index, QString(a_attribute.c_str()));
+    }
+    this->UpdateAttribute(a_attribute.c_str(), m_selectedIndex);
+    m_colorBarList[index]->range[0] = m_commonRange[0];
+    m_colorBarList[index]->range[1] = m_commonRange[1];
+    this->gradientWidget_VISU->setAllColors(&m_usedColorBar->colorPointList);
+    m_updateOnAttributeChanged = true;
+    
+    if(index == comboBox_VISU_attribute->currentIndex()) this->on_comboBox_VISU_attribute_currentIndexChanged();
+    else comboBox_VISU_attribute->setCurrentIndex(index);
 }
 
-void ShapePopulationQT::showCustomizeColorMapByDirectionConfigWindow()
+void ShapePopulationQT::addGeneratedMesh(ShapePopulationData * a_mesh)
 {
-    m_customizeColorMapByDirectionDialog->raise();
-    m_customizeColorMapByDirectionDialog->show();
-    m_customizeColorMapByDirectionDialog->AxisColor();
+    // New window with the mean shape, CreateWidgets picks it up from m_generatedMeshes
+    QFileInfo meshFile(QString(a_mesh->GetFilePath().c_str()));
+    m_generatedMeshes[std::string(meshFile.absoluteFilePath().toLatin1().data())] = a_mesh;
+    m_fileList.append(meshFile);
+    this->CreateWidgets();
 }
 
 
@@ -926,6 +2258,8 @@ void ShapePopulationQT::showCustomizeColorMapByDirectionConfigWindow()
 
 void ShapePopulationQT::CreateWidgets()
 {
+    this->stopTimepoints();
+    this->stopDrawingRegion();
     this->scrollArea->setVisible(false);
     
     /* VTK WINDOWS */
@@ -935,7 +2269,14 @@ void ShapePopulationQT::CreateWidgets()
         QByteArray path = m_fileList[i].absoluteFilePath().toLatin1();
         const char *filePath = path.data();
         
-        CreateNewWindow(filePath);
+        //meshes computed in memory are not read from the disk
+        std::map<std::string, ShapePopulationData *>::iterator generated = m_generatedMeshes.find(std::string(filePath));
+        if(generated != m_generatedMeshes.end())
+        {
+            CreateNewWindow(generated->second);
+            m_generatedMeshes.erase(generated);
+        }
+        else CreateNewWindow(filePath);
     }
     
     /* QT WIDGETS */
@@ -945,6 +2286,8 @@ void ShapePopulationQT::CreateWidgets()
         m_widgetList.push_back(meshWidget);
         meshWidget->GetRenderWindow()->AddRenderer(m_windowsList.at(i)->GetRenderers()->GetFirstRenderer());
         meshWidget->GetInteractor()->AddObserver(vtkCommand::LeftButtonPressEvent, this, &ShapePopulationQT::ClickEvent);
+        meshWidget->GetInteractor()->AddObserver(vtkCommand::MouseMoveEvent, this, &ShapePopulationQT::LassoMoveEvent);
+        meshWidget->GetInteractor()->AddObserver(vtkCommand::LeftButtonReleaseEvent, this, &ShapePopulationQT::LassoReleaseEvent);
         meshWidget->GetInteractor()->AddObserver(vtkCommand::KeyPressEvent, this, &ShapePopulationBase::KeyPressEventVTK);
         meshWidget->GetInteractor()->AddObserver(vtkCommand::ModifiedEvent, this, &ShapePopulationBase::CameraChangedEventVTK);
         meshWidget->GetInteractor()->AddObserver(vtkCommand::StartInteractionEvent, this, &ShapePopulationBase::StartEventVTK);
@@ -1015,7 +2358,7 @@ void ShapePopulationQT::CreateWidgets()
         m_axisColor.push_back(axisColor);
     }
 
-    computeCommonAttributes();                                                  // get the common attributes in m_commonAttributes
+    computeCommonAttributes(m_pagedHeaders);                                    // get the common attributes in m_commonAttributes, of all the pages
     comboBox_VISU_attribute->clear();                                           // clear the Attributes in the comboBox
     m_colorBarList.clear();                                                     // clear the existing colorbars
     m_magnitude.clear();
@@ -1034,7 +2377,7 @@ void ShapePopulationQT::CreateWidgets()
         comboBox_VISU_attribute->addItem(QString(m_commonAttributes[i].c_str()));   // Then add the attribute to the comboBox
         
         // color map by direction
-        int dimension = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[i].c_str())->GetNumberOfComponents();
+        int dimension = m_meshList[0]->GetAttribute(m_commonAttributes[i].c_str())->GetNumberOfComponents();
         magnitudStruct * magnitude = new magnitudStruct;
         if (dimension == 3 )
         {
@@ -1099,8 +2442,8 @@ void ShapePopulationQT::CreateWidgets()
     }
 
     /* Options enabled or not for Vectors */
-    const char * cmap = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars()->GetName();
-    int dimension = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars(cmap)->GetNumberOfComponents();
+    const char * cmap = m_meshList[0]->GetActiveScalarsName();
+    int dimension = m_meshList[0]->GetAttribute(cmap)->GetNumberOfComponents();
     std::string new_cmap = std::string(cmap);
     size_t found = new_cmap.rfind("_mag");
     new_cmap = new_cmap.substr(0,found);
@@ -1123,11 +2466,13 @@ void ShapePopulationQT::CreateWidgets()
 
     this->gradientWidget_VISU->enable(&m_usedColorBar->colorPointList);
     this->menuOptions->setEnabled(true);
+    this->menuStatistics->setEnabled(true);
     this->actionDelete->setEnabled(true);
     this->actionDelete_All->setEnabled(true);
+    this->actionSave_Session->setEnabled(true);
     this->menuExport->setEnabled(true);
     this->actionOpen_Directory->setText("Add Directory");
-    this->actionOpen_VTK_Files->setText("Add VTK/VTP files");
+    this->actionOpen_VTK_Files->setText("Add surface files");
     this->actionLoad_CSV->setText("Add CSV file");
     
     /* DISPLAY INFOS */
@@ -1146,6 +2491,13 @@ void ShapePopulationQT::CreateWidgets()
 
 
     m_noUpdateVectorsByDirection = false;
+
+    /* VERTEX PICKING & REGION */
+    this->buildVertexLocators();
+    this->highlightVertex(m_pickedVertex);
+    this->updatePickedVertex_QT();
+    for (unsigned int i = 0; i < m_windowsList.size(); i++) this->updateRegionDisplay(i);
+    this->updateRegionStatistics_QT();
 }
 
 
@@ -1162,6 +2514,32 @@ void ShapePopulationQT::ClickEvent(vtkObject* a_selectedObject, unsigned long no
     vtkSmartPointer<vtkRenderWindow> selectedWindow = selectedInteractor->GetRenderWindow();
     unsigned int index = getSelectedIndex(selectedWindow);
 
+    // Picking a vertex leaves the selection as it is
+    if(actionPick_Vertices->isChecked())
+    {
+        int * position = selectedInteractor->GetEventPosition();
+        vtkIdType vertex = this->pickVertex(index, position[0], position[1]);
+        if(vertex < 0) return;
+        this->highlightVertex(vertex);
+        this->updatePickedVertex_QT();
+        m_vertexPickingDialog->raise();
+        m_vertexPickingDialog->show();
+        this->RenderAll();
+        return;
+    }
+
+    // Drawing a region : the lasso starts at the cursor, the selection does not change
+    if(actionDraw_Region->isChecked())
+    {
+        if(index >= m_windowsList.size()) return;
+        int * position = selectedInteractor->GetEventPosition();
+        m_lasso.clear();
+        m_lasso.push_back(position[0]);
+        m_lasso.push_back(position[1]);
+        m_lassoWindow = index;
+        return;
+    }
+
     //if the renderwindow already is in the renderselectedWindows...
     if( (std::find(m_selectedIndex.begin(), m_selectedIndex.end(), index)) != (m_selectedIndex.end()) )
     {
@@ -1190,8 +2568,8 @@ void ShapePopulationQT::ClickEvent(vtkObject* a_selectedObject, unsigned long no
         this->groupBox_VIEW->setEnabled(true);
         this->groupBox_VISU->setEnabled(true);
         
-        const char * cmap = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
-        int dim = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars(cmap)->GetNumberOfComponents();
+        const char * cmap = m_meshList[m_selectedIndex[0]]->GetActiveScalarsName();
+        int dim = m_meshList[m_selectedIndex[0]]->GetAttribute(cmap)->GetNumberOfComponents();
         
         std::string new_cmap = std::string(cmap);
         size_t found = new_cmap.rfind("_mag");
@@ -1243,7 +2621,7 @@ void ShapePopulationQT::ClickEvent(vtkObject* a_selectedObject, unsigned long no
                     {
                         for(unsigned int i = 0 ; i < m_commonAttributes.size() ; i++)
                         {
-                            int dimension = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[i].c_str())->GetNumberOfComponents();
+                            int dimension = m_meshList[0]->GetAttribute(m_commonAttributes[i].c_str())->GetNumberOfComponents();
                             if(dimension == 3)
                             {
                                 m_axisColor[index]->sameColor = m_axisColor[m_selectedIndex[0]]->sameColor;
@@ -1321,7 +2699,7 @@ void ShapePopulationQT::ClickEvent(vtkObject* a_selectedObject, unsigned long no
                     // Update the color map for the range
                     for(unsigned int i = 0 ; i < m_commonAttributes.size() ; i++)
                     {
-                        int dimension = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[i].c_str())->GetNumberOfComponents();
+                        int dimension = m_meshList[0]->GetAttribute(m_commonAttributes[i].c_str())->GetNumberOfComponents();
                         if(dimension == 3)
                         {
                             this->UpdateColorMapByDirection(m_commonAttributes[i].c_str(),i);
@@ -1359,10 +2737,43 @@ void ShapePopulationQT::ClickEvent(vtkObject* a_selectedObject, unsigned long no
             }
         }
     }
+    this->slot_memory_update();
     this->RenderAll();
 
 }
 
+void ShapePopulationQT::LassoMoveEvent(vtkObject* a_selectedObject, unsigned long, void*)
+{
+    if(!actionDraw_Region->isChecked() || m_lasso.empty()) return;
+    QVTKInteractor * selectedInteractor = (QVTKInteractor*)a_selectedObject;
+    if(getSelectedIndex(selectedInteractor->GetRenderWindow()) != m_lassoWindow) return;
+
+    // A new vertex of the lasso every few pixels
+    int * position = selectedInteractor->GetEventPosition();
+    double dx = position[0] - m_lasso[m_lasso.size() - 2];
+    double dy = position[1] - m_lasso[m_lasso.size() - 1];
+    if(dx*dx + dy*dy < 9.0) return;
+    m_lasso.push_back(position[0]);
+    m_lasso.push_back(position[1]);
+    this->drawLasso(m_lassoWindow, m_lasso);
+    m_windowsList[m_lassoWindow]->Render();
+}
+
+void ShapePopulationQT::LassoReleaseEvent(vtkObject* a_selectedObject, unsigned long, void*)
+{
+    if(!actionDraw_Region->isChecked() || m_lasso.empty()) return;
+    QVTKInteractor * selectedInteractor = (QVTKInteractor*)a_selectedObject;
+
+    // Ctrl removes the vertices of the lasso from the region
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    this->drawLasso(m_lassoWindow, std::vector<double>());
+    this->selectRegion(m_lassoWindow, m_lasso, selectedInteractor->GetControlKey() == 0);
+    m_lasso.clear();
+    this->updateRegionStatistics_QT();
+    QApplication::restoreOverrideCursor();
+    this->RenderAll();
+}
+
 void ShapePopulationQT::SelectAll()
 {
     // if everything already selected
@@ -1415,6 +2826,8 @@ void ShapePopulationQT::UnselectAll()
     this->groupBox_VISU->setDisabled(true);
     this->gradientWidget_VISU->disable();
     this->tabWidget->setDisabled(true);
+
+    this->slot_memory_update();
 }
 
 void ShapePopulationQT::keyPressEvent(QKeyEvent * keyEvent)
@@ -1451,12 +2864,16 @@ int ShapePopulationQT::getNumberOfColumns()
 
 int ShapePopulationQT::getNumberOfRows(unsigned int colNumber)
 {
-    unsigned int rowNumber = m_numberOfMeshes/colNumber;
-    if (m_numberOfMeshes%colNumber != 0)
+    // Every group starts a new row
+    unsigned int rowNumber = 0;
+    unsigned int groupStart = 0;
+    for (unsigned int i = 1; i <= m_displayOrder.size(); i++)
     {
-        rowNumber++;
+        if(i < m_displayOrder.size() && m_displayGroups[i] == m_displayGroups[groupStart]) continue;
+        rowNumber += (i - groupStart + colNumber - 1)/colNumber;
+        groupStart = i;
     }
-    return rowNumber;
+    return std::max(rowNumber, (unsigned int)1);
 }
 
 
@@ -1464,11 +2881,40 @@ void ShapePopulationQT::placeWidgetInArea(unsigned int colNumber)
 {
     unsigned int i_col = 0;
     unsigned int i_row = 0;
+    QGridLayout *Qlayout = (QGridLayout *)this->scrollAreaWidgetContents->layout();
     
+    // Only the existing widgets are moved, the meshes are never reloaded
+    this->computeDisplayOrder();
+    for (unsigned int i = 0; i < m_groupLabels.size(); i++)
+    {
+        Qlayout->removeWidget(m_groupLabels[i]);
+        delete m_groupLabels[i];
+    }
+    m_groupLabels.clear();
     for (unsigned int i = 0; i < m_numberOfMeshes ;i++)
     {
-        QGridLayout *Qlayout = (QGridLayout *)this->scrollAreaWidgetContents->layout();
-        Qlayout->addWidget(m_widgetList.at(i),i_row,i_col);
+        if(std::find(m_displayOrder.begin(), m_displayOrder.end(), i) != m_displayOrder.end()) continue;
+        Qlayout->removeWidget(m_widgetList.at(i));                  // filtered out
+        m_widgetList.at(i)->hide();
+    }
+    
+    for (unsigned int i = 0; i < m_displayOrder.size() ;i++)
+    {
+        // Name of the group above its first row
+        if(!m_displayGroupNames.empty() && (i == 0 || m_displayGroups[i] != m_displayGroups[i-1]))
+        {
+            if(i_col != 0) i_row++;
+            i_col = 0;
+            QString name = QString(m_displayGroupNames[m_displayGroups[i]].c_str());
+            QLabel * groupLabel = new QLabel(name.isEmpty() ? QString("(no value)") : name, this->scrollAreaWidgetContents);
+            groupLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+            Qlayout->addWidget(groupLabel,i_row,0,1,colNumber);
+            m_groupLabels.push_back(groupLabel);
+            i_row++;
+        }
+        
+        Qlayout->addWidget(m_widgetList.at(m_displayOrder[i]),i_row,i_col);
+        m_widgetList.at(m_displayOrder[i])->show();
         
         if (i_col == colNumber-1)
         {
@@ -1542,7 +2988,7 @@ void ShapePopulationQT::dropEvent(QDropEvent* Qevent)
         for (int i = 0; i < urlList.size(); ++i)
         {
             QString filePath = urlList.at(i).toLocalFile();
-            if((filePath.endsWith(".vtk") || filePath.endsWith(".vtp")) && QFileInfo(filePath).exists())
+            if(ShapePopulationReaders::IsSupported(filePath.toStdString()) && QFileInfo(filePath).exists())
             {
                 fileList.append(QFileInfo(filePath));
                 load = true;
@@ -1559,6 +3005,10 @@ void ShapePopulationQT::dropEvent(QDropEvent* Qevent)
             {
                 loadCameraCLP(filePath.toStdString());
             }
+            else if(filePath.endsWith(".spvs") && QFileInfo(filePath).exists())
+            {
+                this->loadSession(filePath);
+            }
             else if(QDir(filePath).exists())
             {
                 this->loadVTKDirCLP(QDir(filePath));
@@ -1717,7 +3167,7 @@ void ShapePopulationQT::on_comboBox_VISU_attribute_currentIndexChanged()
         this->updateArrowPosition();
 
         /* Options enabled or not for Vectors */
-        int dimension = m_meshList[0]->GetPolyData()->GetPointData()->GetScalars(cmap)->GetNumberOfComponents();
+        int dimension = m_meshList[0]->GetAttribute(cmap)->GetNumberOfComponents();
         if (dimension == 1)
         {
             // Tab Vectors
@@ -1766,6 +3216,12 @@ void ShapePopulationQT::on_comboBox_VISU_attribute_currentIndexChanged()
         m_renderAllSelection = true;
         this->RenderSelection();
         m_renderAllSelection = false;
+
+        this->updateHistogram_QT();
+        this->updateCovariates_QT();
+        this->updatePickedVertex_QT();
+        this->updateRegionStatistics_QT();
+        this->updateLabels_QT();
     }
 }
 
@@ -1773,6 +3229,7 @@ void ShapePopulationQT::updateColorbar_QT()
 {
     // Update m_colorPointList from colorbar
     gradientWidget_VISU->getAllColors(&m_usedColorBar->colorPointList);
+    m_histogramDialog->setColorbarRange(m_usedColorBar->range[0], m_usedColorBar->range[1]);
     
     // Get Attribute in ComboBox
     QString text = this->comboBox_VISU_attribute->currentText();
@@ -1787,7 +3244,7 @@ void ShapePopulationQT::updateColorbar_QT()
     std::vector<unsigned int > windowsIndex;
     for(unsigned int i = 0 ; i < m_selectedIndex.size() ; i++)
     {
-        const char * thisCmap = m_meshList[m_selectedIndex[i]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+        const char * thisCmap = m_meshList[m_selectedIndex[i]]->GetActiveScalarsName();
         if(std::string(thisCmap) == std::string(cmap) || std::string(thisCmap) == cmap_mag)
         {
             windowsIndex.push_back(m_selectedIndex[i]);
@@ -1820,7 +3277,7 @@ void ShapePopulationQT::UpdateColorMapByDirection_QT()
     std::vector<unsigned int > windowsIndex;
     for(unsigned int i = 0 ; i < m_selectedIndex.size() ; i++)
     {
-        const char * thisCmap = m_meshList[m_selectedIndex[i]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+        const char * thisCmap = m_meshList[m_selectedIndex[i]]->GetActiveScalarsName();
         if(std::string(thisCmap) == std::string(cmap) || std::string(thisCmap) == cmap_dir)
         {
             windowsIndex.push_back(m_selectedIndex[i]);
@@ -2105,7 +3562,7 @@ void ShapePopulationQT::updateInfo_QT()
             
             //Dimension
             ShapePopulationData * mesh = m_meshList[0];
-            int dim = mesh->GetPolyData()->GetPointData()->GetScalars(m_commonAttributes[i].c_str())->GetNumberOfComponents();
+            int dim = mesh->GetAttribute(m_commonAttributes[i].c_str())->GetNumberOfComponents();
             strs.str(""); strs.clear();
             strs <<dim;
             QStandardItem * dimension = new QStandardItem(QString(strs.str().c_str()));
@@ -2157,7 +3614,7 @@ void ShapePopulationQT::updateInfo_QT()
             
             //Dimension
             ShapePopulationData * mesh = m_meshList[index];
-            int dim = mesh->GetPolyData()->GetPointData()->GetScalars(AttributesList[i].c_str())->GetNumberOfComponents();
+            int dim = mesh->GetAttribute(AttributesList[i].c_str())->GetNumberOfComponents();
             strs.str(""); strs.clear();
             strs <<dim;
             QStandardItem * dimension = new QStandardItem(QString(strs.str().c_str()));
@@ -2186,13 +3643,16 @@ void ShapePopulationQT::updateInfo_QT()
     tableView->resizeColumnToContents(0);
     tableView->resizeColumnToContents(1);
     on_tabWidget_currentChanged(1);
+
+    this->updateHistogram_QT();
+    this->updateMemoryInfo_QT();
 }
 
 void ShapePopulationQT::updateAttribute_QT()
 {
     if(m_selectedIndex.size() == 1)  // if new selection (TODO : wrong if unselect one and one left)
     {
-        const char * cmap = m_meshList[m_selectedIndex[0]]->GetPolyData()->GetPointData()->GetScalars()->GetName();
+        const char * cmap = m_meshList[m_selectedIndex[0]]->GetActiveScalarsName();
         int index = comboBox_VISU_attribute->findText(cmap);
         if (index != comboBox_VISU_attribute->currentIndex() && index != -1) // 1. different attribute (scalar)
         {
@@ -2333,16 +3793,6 @@ void ShapePopulationQT::exportToSVG()
     this->exportTo(4);
 }
 
-int ShapePopulationQT::getExportDirectory()
-{
-    QFileDialog dirWindow;
-    QString dir = dirWindow.getExistingDirectory(this,tr("Save to Directory"),m_exportDirectory);
-    if(dir.isEmpty()) return 0;
-    
-    m_exportDirectory= dir;
-    return 1;
-}
-
 void ShapePopulationQT::exportTo(int fileFormat)
 {
     vtkGL2PSExporter * exporter = vtkGL2PSExporter::New();
@@ -2354,7 +3804,7 @@ void ShapePopulationQT::exportTo(int fileFormat)
         ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
         QFileInfo meshfile(mesh->GetFileName().c_str());
         QString meshName = meshfile.baseName();
-        QString meshAttribute(mesh->GetPolyData()->GetPointData()->GetScalars()->GetName());
+        QString meshAttribute(mesh->GetActiveScalarsName());
         QString filePrefix = m_exportDirectory + "/" + meshName + "_" + meshAttribute;
         
         exporter->SetInput(m_windowsList[m_selectedIndex[i]]);
@@ -2369,6 +3819,308 @@ void ShapePopulationQT::exportTo(int fileFormat)
 }
 #endif
 
+int ShapePopulationQT::getExportDirectory()
+{
+    QFileDialog dirWindow;
+    QString dir = dirWindow.getExistingDirectory(this,tr("Save to Directory"),m_exportDirectory);
+    if(dir.isEmpty()) return 0;
+    
+    m_exportDirectory= dir;
+    return 1;
+}
+
+void ShapePopulationQT::exportToPNG()
+{
+    this->exportImages(ShapePopulationExport::PNG);
+}
+void ShapePopulationQT::exportToTIFF()
+{
+    this->exportImages(ShapePopulationExport::TIFF);
+}
+
+void ShapePopulationQT::exportImages(int format)
+{
+    if(m_selectedIndex.empty()) return;
+    if(this->getExportDirectory() == 0) return;
+
+    bool ok;
+    int magnification = QInputDialog::getInt(this,"Export Images","Resolution of the images (times the size of the windows) :",
+                                             m_exportMagnification,1,8,1,&ok);
+    if(!ok) return;
+    m_exportMagnification = magnification;
+
+    unsigned int numberOfImages = m_selectedIndex.size();
+    bool montage = false;
+    if(numberOfImages > 1)
+    {
+        QMessageBox::StandardButton answer = QMessageBox::question(this,"Export Images","Compose also a montage of the windows, labelled with the mesh names ?",
+                                                                   QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel, QMessageBox::Yes);
+        if(answer == QMessageBox::Cancel) return;
+        montage = (answer == QMessageBox::Yes);
+    }
+
+    ShapePopulationExport exporter;
+    exporter.SetFormat(format);
+    std::string extension = ShapePopulationExport::GetExtension(format);
+    std::string directory = m_exportDirectory.toStdString();
+    bool displayMeshName = m_displayMeshName;
+    if(montage)
+    {
+        if(!displayMeshName) this->displayMeshName(true);
+        int * windowSize = m_windowsList[m_selectedIndex[0]]->GetSize();
+        int tileSize[2] = {magnification*windowSize[0], magnification*windowSize[1]};
+        int columns = std::min(spinBox_DISPLAY_columns->value(), (int)numberOfImages);
+        exporter.InitializeMontage(numberOfImages, columns, tileSize, m_unselectedColor);
+    }
+
+    QProgressDialog progress("Exporting the images...", "Cancel", 0, numberOfImages, this);
+    progress.setWindowTitle("Export Images");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setValue(0);
+
+    // The windows of a batch are rendered on the GUI thread while the workers encode the previous batch
+    unsigned int batchSize = 2*ShapePopulationParallel::GetNumberOfThreads();
+    std::vector< vtkSmartPointer<vtkImageData> > written;              // images of the batch being encoded
+    std::set<std::string> fileNames;
+    QFuture<bool> future;
+    QFutureWatcher<bool> watcher;
+    for(unsigned int begin = 0; begin < numberOfImages && !progress.wasCanceled(); begin += batchSize)
+    {
+        unsigned int end = std::min(begin + batchSize, numberOfImages);
+        std::vector< vtkSmartPointer<vtkImageData> > captured;
+        std::vector<vtkImageData *> images;
+        std::vector<std::string> filePaths;
+        std::vector<int> tiles;
+        for(unsigned int i = begin; i < end; i++)
+        {
+            ShapePopulationData * mesh = m_meshList[m_selectedIndex[i]];
+            captured.push_back(ShapePopulationExport::CaptureWindow(m_windowsList[m_selectedIndex[i]], magnification));
+            images.push_back(captured.back());
+            if(montage) tiles.push_back(i);
+
+            // meshName_attribute, numbered when two meshes have the same name
+            std::string fileName = QFileInfo(mesh->GetFileName().c_str()).baseName().toStdString();
+            vtkDataArray * scalars = mesh->GetActiveScalars();
+            if(scalars != NULL && scalars->GetName() != NULL) fileName += std::string("_") + scalars->GetName();
+            fileName = fileName.erase(fileName.find_last_not_of(" \n\r\t") + 1);
+            std::string uniqueName = fileName;
+            for(int n = 2; fileNames.count(uniqueName) > 0; n++)
+            {
+                std::ostringstream strs;
+                strs << fileName << "_" << n;
+                uniqueName = strs.str();
+            }
+            fileNames.insert(uniqueName);
+            filePaths.push_back(directory + "/" + uniqueName + extension);
+        }
+
+        while(!future.isFinished())
+        {
+            QEventLoop loop;
+            connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+            QTimer::singleShot(100, &loop, SLOT(quit()));
+            loop.exec();
+        }
+        progress.setValue(begin);
+
+        written = captured;
+        future = QtConcurrent::run(&exporter, &ShapePopulationExport::WriteBatch, images, filePaths, tiles);
+        watcher.setFuture(future);
+    }
+    while(!future.isFinished())
+    {
+        QEventLoop loop;
+        connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+        QTimer::singleShot(100, &loop, SLOT(quit()));
+        loop.exec();
+    }
+    progress.setValue(numberOfImages);
+
+    if(montage)
+    {
+        if(!progress.wasCanceled())
+        {
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            exporter.WriteMontage(directory + "/montage" + extension);
+            QApplication::restoreOverrideCursor();
+        }
+        if(!displayMeshName) this->displayMeshName(false);
+        this->RenderAll();
+    }
+
+    std::vector<std::string> failedFiles = exporter.GetFailedFiles();
+    if(!failedFiles.empty())
+    {
+        std::ostringstream strs;
+        strs << "Couldn't write " << failedFiles.size() << " of the images :" << std::endl;
+        for(unsigned int i = 0; i < failedFiles.size() && i < 20; i++) strs << failedFiles[i] << std::endl;
+        if(failedFiles.size() > 20) strs << "... and " << failedFiles.size() - 20 << " more." << std::endl;
+        QMessageBox::critical(this,"Export Images",QString(strs.str().c_str()),QMessageBox::Ok);
+    }
+}
+
+void ShapePopulationQT::addCameraKeyframe()
+{
+    if(m_selectedIndex.empty()) return;
+
+    this->ShapePopulationBase::UpdateCameraConfig();
+    m_cameraKeyframes.push_back(m_headcamConfig);
+    actionClear_Camera_Keyframes->setText(QString("Clear Camera Keyframes (%1)").arg(m_cameraKeyframes.size()));
+    actionClear_Camera_Keyframes->setEnabled(true);
+}
+
+void ShapePopulationQT::clearCameraKeyframes()
+{
+    m_cameraKeyframes.clear();
+    actionClear_Camera_Keyframes->setText("Clear Camera Keyframes");
+    actionClear_Camera_Keyframes->setEnabled(false);
+}
+
+void ShapePopulationQT::exportAnimation()
+{
+    if(m_selectedIndex.empty()) return;
+
+    m_animationDialog->setNumberOfKeyframes(m_cameraKeyframes.size());
+    if(m_animationDialog->exec() != QDialog::Accepted) return;
+    int path = m_animationDialog->getPath();
+    double degrees = m_animationDialog->getDegrees();
+    double duration = m_animationDialog->getDuration();
+    int output = m_animationDialog->getOutput();
+    if(path == animationDialogQT::KEYFRAMES && m_cameraKeyframes.size() < 2)
+    {
+        QMessageBox::critical(this,"Camera Animation","Add two camera keyframes at least (Options > Add Camera Keyframe).",QMessageBox::Ok);
+        return;
+    }
+
+    // Camera path, from the current view for the turntable and the tour of the views
+    this->ShapePopulationBase::UpdateCameraConfig();
+    cameraConfigStruct initialCamera = m_headcamConfig;
+    ShapePopulationAnimation animation;
+    if(path == animationDialogQT::TURNTABLE) animation.CreateOrbit(initialCamera, degrees, duration);
+    else if(path == animationDialogQT::VIEW_TOUR) animation.CreateViewTour(initialCamera, duration);
+    else
+    {
+        for(unsigned int i = 0; i < m_cameraKeyframes.size(); i++) animation.AddKeyframe(duration*i/(m_cameraKeyframes.size() - 1), m_cameraKeyframes[i]);
+    }
+
+    QString fileName = "animation.png";
+    QString filter = "PNG images (*.png)";
+    if(output == ShapePopulationAnimation::TIFF_SEQUENCE)
+    {
+        fileName = "animation.tif";
+        filter = "TIFF images (*.tif)";
+    }
+    else if(output == ShapePopulationAnimation::RAW_VIDEO)
+    {
+        fileName = "animation.rgb";
+        filter = "Raw RGB video (*.rgb)";
+    }
+    fileName = QFileDialog::getSaveFileName(this,tr("Export Camera Animation"),QDir(m_exportDirectory).filePath(fileName),filter);
+    if(fileName.isEmpty()) return;
+    m_exportDirectory = QFileInfo(fileName).path();
+
+    // The frames wait in a queue of a fixed size, the GUI renders them as fast as the worker writes them
+    std::string errorMessage;
+    if(!animation.Open(fileName.toStdString(), output, 8, errorMessage))
+    {
+        QMessageBox::critical(this,"Camera Animation",QString(errorMessage.c_str()),QMessageBox::Ok);
+        return;
+    }
+    QFuture<bool> future = QtConcurrent::run(&animation, &ShapePopulationAnimation::WriteFrames);
+    QFutureWatcher<bool> watcher;
+    watcher.setFuture(future);
+
+    // A closed path does not repeat its first frame
+    bool closedPath = (path == animationDialogQT::VIEW_TOUR) || (path == animationDialogQT::TURNTABLE && fmod(fabs(degrees), 360.0) == 0.0);
+    int numberOfFrames = std::max(2, (int)(duration*m_animationDialog->getFrameRate() + 0.5));
+    double step = closedPath ? duration/numberOfFrames : duration/(numberOfFrames - 1);
+
+    int magnification = m_animationDialog->getMagnification();
+    unsigned int numberOfTiles = m_selectedIndex.size();
+    int * windowSize = m_windowsList[m_selectedIndex[0]]->GetSize();
+    int tileSize[2] = {magnification*windowSize[0], magnification*windowSize[1]};
+    int columns = std::min(spinBox_DISPLAY_columns->value(), (int)numberOfTiles);
+    ShapePopulationExport montage;
+    std::vector<int> tiles;
+    for(unsigned int i = 0; i < numberOfTiles; i++) tiles.push_back(i);
+    int frameSize[2] = {0, 0};
+
+    QProgressDialog progress("Rendering the animation...", "Cancel", 0, numberOfFrames, this);
+    progress.setWindowTitle("Camera Animation");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setValue(0);
+
+    for(int f = 0; f < numberOfFrames; f++)
+    {
+        while(animation.GetNumberOfQueuedFrames() >= animation.GetQueueSize() && !future.isFinished())
+        {
+            QEventLoop loop;
+            connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+            QTimer::singleShot(20, &loop, SLOT(quit()));
+            loop.exec();
+        }
+        if(progress.wasCanceled() || future.isFinished()) break;
+
+        cameraConfigStruct cam = animation.GetCamera(f*step);
+        m_headcam->SetPosition(cam.pos_x,cam.pos_y,cam.pos_z);
+        m_headcam->SetFocalPoint(cam.foc_x,cam.foc_y,cam.foc_z);
+        m_headcam->SetViewUp(cam.view_vx,cam.view_vy,cam.view_vz);
+        m_headcam->SetParallelScale(cam.scale);
+
+        // Every selected window in the frame, as in the grid
+        std::vector< vtkSmartPointer<vtkImageData> > captured;
+        std::vector<vtkImageData *> images;
+        for(unsigned int i = 0; i < numberOfTiles; i++)
+        {
+            m_windowsList[m_selectedIndex[i]]->GetRenderers()->GetFirstRenderer()->ResetCameraClippingRange();
+            captured.push_back(ShapePopulationExport::CaptureWindow(m_windowsList[m_selectedIndex[i]], magnification));
+            images.push_back(captured.back());
+        }
+        vtkImageData * frame = images[0];
+        if(numberOfTiles > 1)
+        {
+            montage.InitializeMontage(numberOfTiles, columns, tileSize, m_unselectedColor);
+            montage.PasteTiles(images, tiles);
+            frame = montage.GetMontage();
+        }
+        int dims[3];
+        frame->GetDimensions(dims);
+        frameSize[0] = dims[0];
+        frameSize[1] = dims[1];
+        if(!animation.PushFrame(frame)) break;
+        progress.setValue(f);
+    }
+
+    if(progress.wasCanceled()) animation.Abort();
+    else animation.Close();
+    while(!future.isFinished())
+    {
+        QEventLoop loop;
+        connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+        QTimer::singleShot(100, &loop, SLOT(quit()));
+        loop.exec();
+    }
+    progress.setValue(numberOfFrames);
+    this->slot_newCameraConfig(initialCamera);
+    this->UpdateCameraConfig();
+
+    if(!future.result())
+    {
+        QMessageBox::critical(this,"Camera Animation",QString(animation.GetErrorMessage().c_str()),QMessageBox::Ok);
+    }
+    else if(output == ShapePopulationAnimation::RAW_VIDEO && !progress.wasCanceled())
+    {
+        std::ostringstream strs;
+        strs << animation.GetNumberOfWrittenFrames() << " frames of " << frameSize[0] << "x" << frameSize[1] << " pixels (rgb24) written." << std::endl << std::endl
+             << "To encode them, for instance :" << std::endl
+             << "ffmpeg -f rawvideo -pixel_format rgb24 -video_size " << frameSize[0] << "x" << frameSize[1]
+             << " -framerate " << m_animationDialog->getFrameRate() << " -i " << fileName.toStdString() << " animation.mp4" << std::endl;
+        QMessageBox::information(this,"Camera Animation",QString(strs.str().c_str()),QMessageBox::Ok);
+    }
+}
+
 void ShapePopulationQT::showNoExportWindow()
 {
     std::ostringstream strs;
@@ -9,8 +9,23 @@
 #include "backgroundDialogQT.h"
 #include "CSVloaderQT.h"
 #include "customizeColorMapByDirectionDialogQT.h"
+#include "permutationTestDialogQT.h"
+#include "shapeModesDialogQT.h"
+#include "morphDialogQT.h"
+#include "vertexPickingDialogQT.h"
+#include "regionStatisticsDialogQT.h"
+#include "labelsDialogQT.h"
+#include "histogramDialogQT.h"
+#include "covariatesDialogQT.h"
+#include "animationDialogQT.h"
+#include "ShapePopulationMeshCache.h"
+#include "ShapePopulationExport.h"
+#include "ShapePopulationAnimation.h"
+#include "ShapePopulationTimeSeries.h"
 #include <iostream>
+#include <map>
 #include <vtkInteractorStyleTrackballCamera.h>
+#include <vtkInteractorObserver.h>
 
 // QT
 #include <QMainWindow>
@@ -20,6 +35,15 @@
 #include <QKeyEvent>                //KeyPressEvent
 #include <QStandardItemModel>       //Data Array
 #include <QColorDialog>             //ColorPicker
+#include <QInputDialog>             //Choose attribute
+#include <QMessageBox>              //Errors
+#include <QProgressDialog>          //Permutation test
+#include <QtConcurrentRun>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QTimer>
+#include <QLabel>                   //Profiling overlay
+#include <QScrollBar>               //Memory budget of the off-screen meshes
 #include <vtkDelimitedTextReader.h> //CSVloader
 #include <QUrl>                     //DropFiles
 
@@ -45,6 +69,7 @@ public:
     void loadVTKDirCLP(QDir vtkDir);
     void loadColorMapCLP(std::string a_filePath);
     void loadCameraCLP(std::string a_filePath);
+    void loadSessionCLP(std::string a_filePath);
     
     
 protected:
@@ -58,19 +83,57 @@ protected:
     QString m_lastDirectory;
     QString m_colormapDirectory;
     QString m_exportDirectory;
+    int m_exportMagnification;                                          // resolution of the exported images, times the window size
     QString m_pathSphere;
     QFileInfoList m_fileList;
     std::vector<QVTKWidget *> m_widgetList;
+    std::map<std::string, ShapePopulationData *> m_generatedMeshes;     // meshes computed in memory, waiting for their widget
     cameraDialogQT * m_cameraDialog;
     backgroundDialogQT * m_backgroundDialog;
     CSVloaderQT * m_CSVloaderDialog;
     customizeColorMapByDirectionDialogQT* m_customizeColorMapByDirectionDialog;
+    permutationTestDialogQT * m_permutationTestDialog;
+    shapeModesDialogQT * m_shapeModesDialog;
+    morphDialogQT * m_morphDialog;
+    vertexPickingDialogQT * m_vertexPickingDialog;
+    regionStatisticsDialogQT * m_regionStatisticsDialog;
+    labelsDialogQT * m_labelsDialog;
+    histogramDialogQT * m_histogramDialog;
+    covariatesDialogQT * m_covariatesDialog;
+    animationDialogQT * m_animationDialog;
+    std::vector<cameraConfigStruct> m_cameraKeyframes;
+    ShapePopulationCovariates m_covariates;
+    std::vector<unsigned int> m_displayOrder;                           // widgets of the grid in their order, without the ones filtered out
+    std::vector<int> m_displayGroups;                                   // group of each widget of m_displayOrder
+    std::vector<std::string> m_displayGroupNames;                       // empty if the grid is not grouped
+    std::vector<QLabel *> m_groupLabels;
+    QLabel * m_profilingOverlay;
+    QTimer * m_profilingTimer;
+    ShapePopulationMeshCache m_meshCache;
+    QFileInfoList m_pagedFiles;                                         // population browsed page by page, m_fileList is the page
+    std::vector<ShapePopulationHeader> m_pagedHeaders;                  // headers of m_pagedFiles
+    int m_pageSize;
+    int m_pageIndex;
+    QFuture<void> m_prefetch;
+    ShapePopulationTimeSeries m_timeSeries;
+    std::vector<ShapePopulationData *> m_loadedTimepoints;              // data of the windows when the playback started, NULL without timepoints
+    QTimer * m_playbackTimer;
+    double m_playbackFrameRate;                                         // timepoints per second
+    QFuture<void> m_timeSeriesPrefetch;
+    QFuture<void> m_locatorBuild;
+    std::vector<double> m_lasso;                                        // display coordinates of the lasso being drawn
+    unsigned int m_lassoWindow;
+    std::vector< vtkSmartPointer<vtkInteractorObserver> > m_interactorStyles;  // camera interaction, off while drawing a region
 
     void CreateWidgets();
+    void addGeneratedMesh(ShapePopulationData * a_mesh);
+    void updateCommonAttribute_QT(std::string a_attribute);
 
     
     //SELECTION
     void ClickEvent(vtkObject* a_selectedObject, unsigned long notUseduLong, void* notUsedVoid);
+    void LassoMoveEvent(vtkObject* a_selectedObject, unsigned long, void*);
+    void LassoReleaseEvent(vtkObject* a_selectedObject, unsigned long, void*);
     void SelectAll();
     void UnselectAll();
     void keyPressEvent(QKeyEvent * keyEvent);
@@ -92,6 +155,39 @@ protected:
     void updateAttribute_QT();
     void updateArrowPosition();
     void updateInfo_QT();
+    void updateHistogram_QT();
+    void updateMemoryInfo_QT();
+
+    //MEMORY
+    bool isWindowVisible(unsigned int a_index);
+
+    //PAGED BROWSING
+    void displayFiles_QT();
+    void unloadMeshes();
+    void showPage(int a_page);
+    void updatePageInfo_QT();
+
+    //COVARIATES
+    void computeDisplayOrder();
+    void updateCovariates_QT();
+
+    //TIME SERIES
+    void stopTimepoints();
+
+    //VERTEX PICKING
+    void buildVertexLocators();
+    void updatePickedVertex_QT();
+
+    //REGION OF INTEREST
+    void stopDrawingRegion();
+    void updateRegionStatistics_QT();
+
+    //LABELS
+    void updateLabels_QT();
+
+    //SESSION
+    void loadSession(QString a_filePath);
+    void updateMeshControls_QT(unsigned int a_index);
         
     protected slots:
     
@@ -106,6 +202,22 @@ protected:
     void slot_itemsSelected(QFileInfoList fileList);
     void deleteAll();
     void deleteSelection();
+    void previousPage();
+    void nextPage();
+    void setPageSize_QT();
+    void openSession();
+    void saveSession();
+    
+    //STATISTICS
+    void setSelectionAsGroupA();
+    void setSelectionAsGroupB();
+    void compareGroups();
+    void permutationTest();
+    void showShapeModes();
+    void slot_shapeMode_valueChanged(int mode, double standardDeviations);
+    void showMorph();
+    void slot_morph_valueChanged(double position, int interpolation);
+    void surfaceDistance();
     
     //OPTIONS
     void showCameraConfigWindow();
@@ -113,6 +225,29 @@ protected:
     void loadColorMap();
     void saveColorMap();
     void showCustomizeColorMapByDirectionConfigWindow();
+    void showHistogram();
+    void slot_histogram_autoRange(double lowPercentile, double highPercentile);
+    void showCovariates();
+    void slot_covariates_displayChanged();
+    void slot_covariatesLoaded(QStringList columns, QList<QStringList> covariates);
+    void showProfilingOverlay(bool display);
+    void updateProfilingOverlay();
+    void exportProfilingTrace();
+    void setAdaptiveQuality_QT(bool adaptive);
+    void setTargetFrameRate_QT();
+    void setMemoryBudget_QT();
+    void slot_memory_update();
+    void playTimepoints(bool play);
+    void showNextTimepoint();
+    void setTimepointRate_QT();
+    void pickVertices(bool pick);
+    void drawRegion(bool draw);
+    void clearRegion_QT();
+    void showRegionStatistics();
+    void exportRegionStatistics();
+    void displayLabels(bool display);
+    void slot_labelVisibilityChanged(double a_label, bool a_visible);
+    void displayTensors_QT(bool display);
     
     //DISPLAY INFO RANGE
     void on_tabWidget_currentChanged(int index);
@@ -206,9 +341,15 @@ protected:
     void exportToEPS();
     void exportToTEX();
     void exportToSVG();
-    int getExportDirectory();
     void exportTo(int fileFormat);
 #endif
+    int getExportDirectory();
+    void exportToPNG();
+    void exportToTIFF();
+    void exportImages(int format);
+    void exportAnimation();
+    void addCameraKeyframe();
+    void clearCameraKeyframes();
     void showNoExportWindow();
     
     void UpdateCameraConfig();
@@ -0,0 +1,200 @@
+#include "ShapePopulationReaders.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#include <ctype.h>
+
+static const size_t s_magicSize = 512;                                  // bytes read to recognize a file without extension
+
+// Filled before main, so that the meshes read by several threads never initialize it
+std::vector<ShapePopulationReaders::Reader> ShapePopulationReaders::s_readers;
+bool ShapePopulationReaders::s_builtInReaders = ShapePopulationReaders::RegisterBuiltInReaders();
+
+static std::string spvLowerCase(std::string a_string)
+{
+    for(size_t i = 0; i < a_string.size(); i++) a_string[i] = tolower(a_string[i]);
+    return a_string;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           REGISTRY                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationReaders::RegisterBuiltInReaders()
+{
+    Register("VTK", ".vtk", &ShapePopulationReaders::ReadLegacy, &ShapePopulationReaders::IsLegacy);
+    Register("VTP", ".vtp", &ShapePopulationReaders::ReadXML, &ShapePopulationReaders::IsXML);
+    Register("PLY", ".ply", &ShapePopulationSurfaceFormats::ReadPLY, &ShapePopulationSurfaceFormats::IsPLY);
+    Register("STL", ".stl", &ShapePopulationSurfaceFormats::ReadSTL, &ShapePopulationSurfaceFormats::IsSTL);
+    Register("OFF", ".off", &ShapePopulationSurfaceFormats::ReadOFF, &ShapePopulationSurfaceFormats::IsOFF);
+    Register("OBJ", ".obj", &ShapePopulationSurfaceFormats::ReadOBJ, NULL);
+    Register("GIfTI", ".gii", &ShapePopulationSurfaceFormats::ReadGIfTI, &ShapePopulationSurfaceFormats::IsGIfTI);
+    return true;
+}
+
+void ShapePopulationReaders::Register(std::string a_name, std::string a_extensions, ReadFunction a_read, MagicFunction a_magic)
+{
+    if(a_read == NULL) return;
+
+    Reader reader;
+    reader.name = a_name;
+    reader.read = a_read;
+    reader.magic = a_magic;
+    std::istringstream extensions(spvLowerCase(a_extensions));
+    std::string extension;
+    while(extensions >> extension)
+    {
+        if(extension[0] != '.') extension = "." + extension;
+        if(std::find(reader.extensions.begin(), reader.extensions.end(), extension) != reader.extensions.end()) continue;
+        reader.extensions.push_back(extension);
+
+        // The extension is taken from the previous readers
+        for(unsigned int i = 0; i < s_readers.size(); i++)
+        {
+            std::vector<std::string> &previous = s_readers[i].extensions;
+            previous.erase(std::remove(previous.begin(), previous.end(), extension), previous.end());
+        }
+    }
+    s_readers.push_back(reader);
+}
+
+std::string ShapePopulationReaders::GetExtension(std::string a_filePath)
+{
+    size_t dot = a_filePath.rfind('.');
+    size_t slash = a_filePath.find_last_of("/\\");
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+    return spvLowerCase(a_filePath.substr(dot));
+}
+
+const ShapePopulationReaders::Reader * ShapePopulationReaders::FindReader(std::string a_filePath)
+{
+    const Reader * reader = FindReaderByExtension(a_filePath);
+    return (reader != NULL) ? reader : FindReaderByMagic(a_filePath);
+}
+
+const ShapePopulationReaders::Reader * ShapePopulationReaders::FindReaderByExtension(std::string a_filePath)
+{
+    std::string extension = GetExtension(a_filePath);
+    if(extension.empty()) return NULL;
+
+    // An extension has one reader at most, Register takes it from the previous ones
+    for(unsigned int i = 0; i < s_readers.size(); i++)
+    {
+        const std::vector<std::string> &extensions = s_readers[i].extensions;
+        if(std::find(extensions.begin(), extensions.end(), extension) != extensions.end()) return &s_readers[i];
+    }
+    return NULL;
+}
+
+const ShapePopulationReaders::Reader * ShapePopulationReaders::FindReaderByMagic(std::string a_filePath)
+{
+    // Unknown extension : the first bytes of the file
+    std::ifstream file(a_filePath.c_str(), std::ios::in | std::ios::binary);
+    if(!file.is_open()) return NULL;
+    char bytes[s_magicSize];
+    file.read(bytes, s_magicSize);
+    size_t size = (size_t)file.gcount();
+    file.close();
+
+    for(unsigned int i = 0; i < s_readers.size(); i++)
+    {
+        if(s_readers[i].magic != NULL && s_readers[i].magic(bytes, size)) return &s_readers[i];
+    }
+    return NULL;
+}
+
+bool ShapePopulationReaders::IsSupported(std::string a_filePath)
+{
+    return FindReader(a_filePath) != NULL;
+}
+
+std::string ShapePopulationReaders::GetFormat(std::string a_filePath)
+{
+    const Reader * reader = FindReader(a_filePath);
+    return (reader != NULL) ? reader->name : "";
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             READ                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+vtkSmartPointer<vtkPolyData> ShapePopulationReaders::Read(std::string a_filePath)
+{
+    const Reader * reader = FindReader(a_filePath);
+    return (reader != NULL) ? reader->read(a_filePath) : NULL;
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationReaders::ReadLegacy(std::string a_filePath)
+{
+    vtkSmartPointer<vtkPolyDataReader> meshReader = vtkSmartPointer<vtkPolyDataReader>::New();
+    meshReader->SetFileName(a_filePath.c_str());
+    meshReader->Update();
+    return meshReader->GetOutput();
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationReaders::ReadXML(std::string a_filePath)
+{
+    // Appended arrays decoded in parallel, the other layouts by the VTK reader
+    ShapePopulationXMLReader appendedReader;
+    vtkSmartPointer<vtkPolyData> polyData = appendedReader.Read(a_filePath);
+    if(polyData != NULL) return polyData;
+
+    vtkSmartPointer<vtkXMLPolyDataReader> meshReader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+    meshReader->SetFileName(a_filePath.c_str());
+    meshReader->Update();
+    return meshReader->GetOutput();
+}
+
+bool ShapePopulationReaders::IsLegacy(const char * a_bytes, size_t a_size)
+{
+    return a_size >= 22 && strncmp(a_bytes, "# vtk DataFile Version", 22) == 0;
+}
+
+bool ShapePopulationReaders::IsXML(const char * a_bytes, size_t a_size)
+{
+    std::string header(a_bytes, a_size);
+    return header.find("<VTKFile") != std::string::npos && header.find("PolyData") != std::string::npos;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                         FILE FILTERS                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+std::vector<std::string> ShapePopulationReaders::GetExtensions()
+{
+    std::vector<std::string> extensions;
+    for(unsigned int i = 0; i < s_readers.size(); i++)
+    {
+        extensions.insert(extensions.end(), s_readers[i].extensions.begin(), s_readers[i].extensions.end());
+    }
+    return extensions;
+}
+
+std::string ShapePopulationReaders::GetFileFilter()
+{
+    std::vector<std::string> extensions = GetExtensions();
+    std::string filter;
+    for(unsigned int i = 0; i < extensions.size(); i++)
+    {
+        if(i > 0) filter += " ";
+        filter += "*" + extensions[i];
+    }
+    return filter;
+}
+
+std::string ShapePopulationReaders::GetFormatList()
+{
+    std::vector<std::string> extensions = GetExtensions();
+    std::string list;
+    for(unsigned int i = 0; i < extensions.size(); i++)
+    {
+        if(i > 0) list += "/";
+        list += extensions[i].substr(1);
+    }
+    return list;
+}
@@ -0,0 +1,68 @@
+#ifndef SHAPEPOPULATIONREADERS_H
+#define SHAPEPOPULATIONREADERS_H
+
+#include <vtkVersion.h>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataReader.h>
+#include <vtkXMLPolyDataReader.h>
+
+#include "ShapePopulationXMLReader.h"
+#include "ShapePopulationSurfaceFormats.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+
+// Registry of the mesh file readers : every loader (files, directories, drops, command line, sessions,
+// caches, time series) reads its meshes through it. A reader is chosen by the extension of the file,
+// or by the first bytes of the file when no reader has its extension. The readers registered at start
+// are the VTK ones (.vtk, .vtp) and the native ones of ShapePopulationSurfaceFormats (.ply, .stl, .off,
+// .obj, .gii). Readers must be thread safe : several meshes are read at the same time.
+class ShapePopulationReaders
+{
+    public :
+
+    typedef vtkSmartPointer<vtkPolyData> (*ReadFunction)(std::string a_filePath);    // NULL if the file can't be read
+    typedef bool (*MagicFunction)(const char * a_bytes, size_t a_size);            // first bytes of a file : is it of the format
+
+    struct Reader
+    {
+        std::string name;                                               // "VTK", "PLY"...
+        std::vector<std::string> extensions;                            // lower case, with the dot : ".ply"
+        ReadFunction read;
+        MagicFunction magic;                                            // may be NULL
+    };
+
+    // From the GUI thread, before meshes are loaded. A new reader of an extension replaces the previous one
+    static void Register(std::string a_name, std::string a_extensions, ReadFunction a_read, MagicFunction a_magic);   // extensions : ".ply .PLY"
+    static std::vector<Reader> GetReaders() {return s_readers;}
+
+    static bool IsSupported(std::string a_filePath);                    // by extension, or by the first bytes of the file
+    static vtkSmartPointer<vtkPolyData> Read(std::string a_filePath);
+    static std::string GetFormat(std::string a_filePath);               // name of the reader, "" if none
+
+    // File filters
+    static std::vector<std::string> GetExtensions();
+    static std::string GetFileFilter();                                 // "*.vtk *.vtp *.ply..."
+    static std::string GetFormatList();                                 // "vtk/vtp/ply..."
+
+    protected :
+
+    static std::vector<Reader> s_readers;
+    static bool s_builtInReaders;
+
+    static bool RegisterBuiltInReaders();
+    static std::string GetExtension(std::string a_filePath);            // lower case, "" if none
+    static const Reader * FindReader(std::string a_filePath);          // by extension, then by the first bytes
+    static const Reader * FindReaderByExtension(std::string a_filePath);
+    static const Reader * FindReaderByMagic(std::string a_filePath);
+
+    static vtkSmartPointer<vtkPolyData> ReadLegacy(std::string a_filePath);
+    static vtkSmartPointer<vtkPolyData> ReadXML(std::string a_filePath);
+    static bool IsLegacy(const char * a_bytes, size_t a_size);
+    static bool IsXML(const char * a_bytes, size_t a_size);
+};
+
+
+#endif
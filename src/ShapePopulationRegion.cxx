@@ -0,0 +1,277 @@
+#include "ShapePopulationRegion.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+// Points per block of a lasso
+static const vtkIdType s_selectGrain = 16384;
+
+// Depth a vertex may lie behind the Z-buffer and still be visible : the triangles between the vertices
+// of a curved surface are rasterized in front of them
+static const double s_depthTolerance = 1e-3;
+
+struct RegionSelect
+{
+    vtkPolyData * polyData;
+    const double * projection;
+    const std::vector<double> * polygon;
+    std::vector<char> * mask;
+    char value;
+    const float * depth;
+    int width;
+    int height;
+};
+
+struct RegionStatistics
+{
+    ShapePopulationRegion * region;
+    std::vector<ShapePopulationData *> * meshes;
+    std::string attribute;
+    std::vector<ShapePopulationRegion::Statistics> * statistics;
+};
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             REGION                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+vtkIdType ShapePopulationRegion::GetNumberOfVertices()
+{
+    vtkIdType numberOfVertices = 0;
+    for(unsigned int v = 0; v < m_Mask.size(); v++)
+    {
+        if(m_Mask[v]) numberOfVertices++;
+    }
+    return numberOfVertices;
+}
+
+void ShapePopulationRegion::SetVertices(std::vector<vtkIdType> a_vertices)
+{
+    m_Mask.clear();
+    for(unsigned int i = 0; i < a_vertices.size(); i++)
+    {
+        if(a_vertices[i] < 0) continue;
+        if(a_vertices[i] >= (vtkIdType)m_Mask.size()) m_Mask.resize(a_vertices[i] + 1, 0);
+        m_Mask[a_vertices[i]] = 1;
+    }
+}
+
+std::vector<vtkIdType> ShapePopulationRegion::GetVertices()
+{
+    std::vector<vtkIdType> vertices;
+    for(unsigned int v = 0; v < m_Mask.size(); v++)
+    {
+        if(m_Mask[v]) vertices.push_back(v);
+    }
+    return vertices;
+}
+
+vtkSmartPointer<vtkCellArray> ShapePopulationRegion::GetVertexCells(vtkIdType a_numberOfPoints)
+{
+    vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+    for(vtkIdType v = 0; v < a_numberOfPoints && v < (vtkIdType)m_Mask.size(); v++)
+    {
+        if(m_Mask[v]) cells->InsertNextCell(1, &v);
+    }
+    return cells;
+}
+
+bool ShapePopulationRegion::IsInsidePolygon(double a_x, double a_y, const std::vector<double> &a_polygon)
+{
+    // Crossings of a ray towards +x with the edges
+    bool inside = false;
+    unsigned int numberOfVertices = a_polygon.size()/2;
+    for(unsigned int i = 0, j = numberOfVertices - 1; i < numberOfVertices; j = i++)
+    {
+        double xi = a_polygon[2*i];
+        double yi = a_polygon[2*i + 1];
+        double xj = a_polygon[2*j];
+        double yj = a_polygon[2*j + 1];
+        if((yi > a_y) == (yj > a_y)) continue;
+        if(a_x < (xj - xi)*(a_y - yi)/(yj - yi) + xi) inside = !inside;
+    }
+    return inside;
+}
+
+bool ShapePopulationRegion::IsVisible(double a_x, double a_y, double a_z, const float * a_depth, int a_width, int a_height)
+{
+    if(a_depth == NULL || a_width <= 0 || a_height <= 0) return true;
+
+    // Farthest depth of the pixel and its neighbours, the vertices of the silhouette fall on either side of it
+    int px = (int)floor(0.5*(a_x + 1.0)*a_width);
+    int py = (int)floor(0.5*(a_y + 1.0)*a_height);
+    double depth = 0.0;
+    for(int j = py - 1; j <= py + 1; j++)
+    {
+        for(int i = px - 1; i <= px + 1; i++)
+        {
+            int ci = std::min(std::max(i, 0), a_width - 1);
+            int cj = std::min(std::max(j, 0), a_height - 1);
+            depth = std::max(depth, (double)a_depth[cj*a_width + ci]);
+        }
+    }
+    return 0.5*(a_z + 1.0) <= depth + s_depthTolerance;
+}
+
+void ShapePopulationRegion::SelectBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    RegionSelect * select = static_cast<RegionSelect *>(a_data);
+    const double * m = select->projection;
+    for(vtkIdType v = a_begin; v < a_end; v++)
+    {
+        double p[3];
+        select->polyData->GetPoint(v, p);
+        double w = m[12]*p[0] + m[13]*p[1] + m[14]*p[2] + m[15];
+        if(w <= 0.0) continue;
+        double x = (m[0]*p[0] + m[1]*p[1] + m[2]*p[2] + m[3])/w;
+        double y = (m[4]*p[0] + m[5]*p[1] + m[6]*p[2] + m[7])/w;
+        if(!IsInsidePolygon(x, y, *select->polygon)) continue;
+        double z = (m[8]*p[0] + m[9]*p[1] + m[10]*p[2] + m[11])/w;
+        if(IsVisible(x, y, z, select->depth, select->width, select->height)) (*select->mask)[v] = select->value;
+    }
+}
+
+void ShapePopulationRegion::SelectInPolygon(vtkPolyData * a_polyData, const double a_projection[16], const std::vector<double> &a_polygon, bool a_add,
+                                            const float * a_depth, int a_width, int a_height)
+{
+    SPV_PROFILE_SCOPE("SelectRegion");
+    if(a_polygon.size() < 6) return;
+
+    vtkIdType numPts = a_polyData->GetNumberOfPoints();
+    if((vtkIdType)m_Mask.size() < numPts) m_Mask.resize(numPts, 0);
+
+    RegionSelect select;
+    select.polyData = a_polyData;
+    select.projection = a_projection;
+    select.polygon = &a_polygon;
+    select.mask = &m_Mask;
+    select.value = a_add ? 1 : 0;
+    select.depth = a_depth;
+    select.width = a_width;
+    select.height = a_height;
+    ShapePopulationParallel::For(numPts, s_selectGrain, SelectBlock, &select);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                           STATISTICS                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationRegion::Statistics ShapePopulationRegion::ComputeMeshStatistics(ShapePopulationData * a_mesh, std::string a_attribute)
+{
+    Statistics statistics = {0, 0.0, 0.0, 0.0, 0.0, false};
+    vtkPolyData * polyData = a_mesh->GetPolyData();
+    vtkDataArray * array = a_mesh->GetPointAttribute(a_attribute);
+    if(array == NULL) return statistics;
+
+    vtkIdType numPts = polyData->GetNumberOfPoints();
+    if(numPts > (vtkIdType)m_Mask.size()) numPts = m_Mask.size();
+    int numberOfComponents = array->GetNumberOfComponents();
+    std::vector<double> values(numPts, 0.0);
+    std::vector<double> areas(numPts, 0.0);
+
+    // Values of the region, the magnitudes of the vectors
+    double sum = 0.0;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        if(!m_Mask[v]) continue;
+        double value = 0.0;
+        if(numberOfComponents == 1) value = array->GetComponent(v, 0);
+        else
+        {
+            for(int k = 0; k < numberOfComponents; k++) value += array->GetComponent(v, k)*array->GetComponent(v, k);
+            value = sqrt(value);
+        }
+        values[v] = value;
+        if(statistics.numberOfVertices == 0 || value > statistics.maximum) statistics.maximum = value;
+        sum += value;
+        statistics.numberOfVertices++;
+    }
+    if(statistics.numberOfVertices == 0) return statistics;
+    statistics.mean = sum/statistics.numberOfVertices;
+
+    // Area of the vertices : a third of each triangle of the polygon fans. The connectivity is read through
+    // its pointer, the traversal of the cell array is not shared between the threads
+    vtkCellArray * polys = polyData->GetPolys();
+    vtkIdType * cells = polys->GetPointer();
+    vtkIdType numberOfEntries = polys->GetNumberOfConnectivityEntries();
+    for(vtkIdType c = 0; c < numberOfEntries; c += cells[c] + 1)
+    {
+        vtkIdType npts = cells[c];
+        const vtkIdType * pts = &cells[c + 1];
+        for(vtkIdType k = 1; k + 1 < npts; k++)
+        {
+            vtkIdType triangle[3] = {pts[0], pts[k], pts[k + 1]};
+            bool inRegion = false;
+            for(int t = 0; t < 3; t++) inRegion = inRegion || (triangle[t] < numPts && m_Mask[triangle[t]]);
+            if(!inRegion) continue;
+
+            double a[3], b[3], d[3];
+            polyData->GetPoint(triangle[0], a);
+            polyData->GetPoint(triangle[1], b);
+            polyData->GetPoint(triangle[2], d);
+            double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            double ad[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+            double normal[3] = {ab[1]*ad[2] - ab[2]*ad[1], ab[2]*ad[0] - ab[0]*ad[2], ab[0]*ad[1] - ab[1]*ad[0]};
+            double third = sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2])/6.0;
+            for(int t = 0; t < 3; t++)
+            {
+                if(triangle[t] < numPts) areas[triangle[t]] += third;
+            }
+        }
+    }
+
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        if(!m_Mask[v]) continue;
+        statistics.area += areas[v];
+        statistics.integral += areas[v]*values[v];
+    }
+    statistics.defined = true;
+    return statistics;
+}
+
+void ShapePopulationRegion::StatisticsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    RegionStatistics * data = static_cast<RegionStatistics *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        (*data->statistics)[i] = data->region->ComputeMeshStatistics((*data->meshes)[i], data->attribute);
+    }
+}
+
+std::vector<ShapePopulationRegion::Statistics> ShapePopulationRegion::ComputeStatistics(std::vector<ShapePopulationData *> a_meshes, std::string a_attribute)
+{
+    SPV_PROFILE_SCOPE("ComputeRegionStatistics");
+    Statistics undefined = {0, 0.0, 0.0, 0.0, 0.0, false};
+    std::vector<Statistics> statistics(a_meshes.size(), undefined);
+
+    RegionStatistics data;
+    data.region = this;
+    data.meshes = &a_meshes;
+    data.attribute = a_attribute;
+    data.statistics = &statistics;
+    ShapePopulationParallel::For(a_meshes.size(), 1, StatisticsBlock, &data);
+    return statistics;
+}
+
+bool ShapePopulationRegion::WriteCSV(std::string a_filePath, std::string a_attribute, std::vector<std::string> a_meshes, std::vector<Statistics> a_statistics)
+{
+    std::ofstream file(a_filePath.c_str());
+    if(!file) return false;
+
+    // Empty cells for the meshes without the region or the attribute
+    file << std::setprecision(10);
+    file << "Mesh,Vertices,Area,Mean " << a_attribute << ",Maximum " << a_attribute << ",Integral " << a_attribute << std::endl;
+    for(unsigned int i = 0; i < a_meshes.size() && i < a_statistics.size(); i++)
+    {
+        const Statistics &statistics = a_statistics[i];
+        file << "\"" << a_meshes[i] << "\"," << statistics.numberOfVertices << ",";
+        if(statistics.defined) file << statistics.area << "," << statistics.mean << "," << statistics.maximum << "," << statistics.integral;
+        else file << ",,,";
+        file << std::endl;
+    }
+    return true;
+}
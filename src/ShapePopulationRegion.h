@@ -0,0 +1,67 @@
+#ifndef SHAPEPOPULATIONREGION_H
+#define SHAPEPOPULATIONREGION_H
+
+#include <vtkVersion.h>
+#include <vtkCellArray.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+
+// Region of interest : a set of vertex ids, drawn with a lasso on one mesh and carried to the corresponded
+// meshes by id. The statistics of the region are computed for every mesh in parallel : vertex mean and
+// maximum of an attribute (a cell attribute averaged to the vertices), area of the region and integral of
+// the attribute over it, each vertex weighing a third of the area of its triangles.
+class ShapePopulationRegion
+{
+    public :
+
+    struct Statistics
+    {
+        vtkIdType numberOfVertices;                                     // vertices of the region the mesh has
+        double area;
+        double mean;
+        double maximum;
+        double integral;
+        bool defined;                                                   // false : no vertex of the region, or no such attribute
+    };
+
+    ShapePopulationRegion(){}
+    ~ShapePopulationRegion(){}
+
+    // REGION
+    void Clear() {m_Mask.clear();}
+    vtkIdType GetNumberOfVertices();
+    bool Contains(vtkIdType a_vertex) {return (a_vertex >= 0 && a_vertex < (vtkIdType)m_Mask.size() && m_Mask[a_vertex]);}
+    void SetVertices(std::vector<vtkIdType> a_vertices);
+    std::vector<vtkIdType> GetVertices();
+    vtkSmartPointer<vtkCellArray> GetVertexCells(vtkIdType a_numberOfPoints);  // one vertex cell per vertex of the region
+
+    // Lasso : the points of a_polyData projected by a_projection (row-major, world to normalized device
+    // coordinates) inside a_polygon (x0, y0, x1, y1... in normalized device coordinates) are added to the
+    // region, or removed from it. With the Z-buffer of the view (a_width x a_height depths in [0, 1], first
+    // row at the bottom), the points hidden by the surface are left as they are
+    void SelectInPolygon(vtkPolyData * a_polyData, const double a_projection[16], const std::vector<double> &a_polygon, bool a_add,
+                         const float * a_depth = NULL, int a_width = 0, int a_height = 0);
+    static bool IsInsidePolygon(double a_x, double a_y, const std::vector<double> &a_polygon);
+    static bool IsVisible(double a_x, double a_y, double a_z, const float * a_depth, int a_width, int a_height);   // normalized device coordinates
+
+    // STATISTICS
+    // The magnitude of a vector attribute
+    std::vector<Statistics> ComputeStatistics(std::vector<ShapePopulationData *> a_meshes, std::string a_attribute);
+    static bool WriteCSV(std::string a_filePath, std::string a_attribute, std::vector<std::string> a_meshes, std::vector<Statistics> a_statistics);
+
+    protected :
+
+    std::vector<char> m_Mask;                                           // by vertex id, not vector<bool> : written by several threads
+
+    static void SelectBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static void StatisticsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    Statistics ComputeMeshStatistics(ShapePopulationData * a_mesh, std::string a_attribute);
+};
+
+
+#endif
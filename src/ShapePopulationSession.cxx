@@ -0,0 +1,454 @@
+#include "ShapePopulationSession.h"
+
+#include <vtkXMLUtilities.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <vtksys/SystemTools.hxx>
+
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+
+struct SessionMeshes
+{
+    std::vector<std::string> * filePaths;                   // absolute paths of the embedded files
+    std::vector<std::string> * meshPaths;
+    std::vector<ShapePopulationData *> * meshes;
+    std::vector<int> * written;
+};
+
+static std::string spvFormat(const double * a_values, int a_count)
+{
+    // Full precision, the camera is restored exactly
+    std::ostringstream strs;
+    strs.precision(17);
+    for(int i = 0; i < a_count; i++) strs << (i > 0 ? " " : "") << a_values[i];
+    return strs.str();
+}
+
+static int spvIntAttribute(vtkXMLDataElement * a_element, const char * a_name, int a_default)
+{
+    int value = a_default;
+    if(a_element != NULL) a_element->GetScalarAttribute(a_name, value);
+    return value;
+}
+
+static double spvDoubleAttribute(vtkXMLDataElement * a_element, const char * a_name, double a_default)
+{
+    double value = a_default;
+    if(a_element != NULL) a_element->GetScalarAttribute(a_name, value);
+    return value;
+}
+
+ShapePopulationSession::ShapePopulationSession()
+{
+    this->Clear();
+}
+
+void ShapePopulationSession::Clear()
+{
+    m_FilePath = "";
+    m_Meshes.clear();
+    m_Attributes.clear();
+    m_Population.clear();
+
+    // Defaults of ShapePopulationBase
+    m_View.attribute = "";
+    m_View.displayColorbar = true;
+    m_View.displayAttribute = true;
+    m_View.displayMeshName = true;
+    m_View.displaySphere = true;
+    double selectedColor[3] = {0.1, 0.0, 0.3};
+    for(int k = 0; k < 3; k++)
+    {
+        m_View.selectedColor[k] = selectedColor[k];
+        m_View.unselectedColor[k] = 0.0;
+        m_View.labelColor[k] = 1.0;
+    }
+    cameraConfigStruct camera = {0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0};
+    m_View.camera = camera;
+    m_View.columns = 0;
+    m_View.alignment = 0;
+    m_View.pageSize = 0;
+    m_View.pageIndex = 0;
+}
+
+ShapePopulationSession::MeshState ShapePopulationSession::DefaultMeshState(std::string a_filePath)
+{
+    MeshState state;
+    state.filePath = a_filePath;
+    state.embeddedFile = "";
+    state.opacity = 100;
+    state.vectorScale = 100;
+    state.vectorDensity = 100;
+    state.colorMapByDirection = false;
+    state.displayVectors = false;
+    state.vectorsByDirection = false;
+    axisColorStruct axisColor = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}, true, false};
+    state.axisColor = axisColor;
+    return state;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             WRITE                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationSession::Write(std::string a_filePath, std::vector<ShapePopulationData *> a_meshes, std::string &a_errorMessage)
+{
+    SPV_PROFILE_SCOPE("WriteSession");
+    m_FilePath = a_filePath;
+
+    // Embedded meshes : <session>_meshes/meshXXXX.vtp
+    if(!a_meshes.empty())
+    {
+        std::string directoryName = vtksys::SystemTools::GetFilenameWithoutLastExtension(a_filePath) + "_meshes";
+        std::string directory = vtksys::SystemTools::GetFilenamePath(a_filePath);
+        directory = directory.empty() ? directoryName : directory + "/" + directoryName;
+        if(!vtksys::SystemTools::MakeDirectory(directory.c_str()))
+        {
+            a_errorMessage = "Couldn't create the directory " + directory;
+            return false;
+        }
+
+        std::vector<std::string> filePaths;
+        for(unsigned int i = 0; i < m_Meshes.size() && i < a_meshes.size(); i++)
+        {
+            char fileName[32];
+            sprintf(fileName, "mesh%04u.vtp", i);
+            m_Meshes[i].embeddedFile = directoryName + "/" + fileName;
+            filePaths.push_back(directory + "/" + fileName);
+        }
+        std::vector<int> written(filePaths.size(), 0);
+        SessionMeshes data;
+        data.filePaths = &filePaths;
+        data.meshPaths = NULL;
+        data.meshes = &a_meshes;
+        data.written = &written;
+        ShapePopulationParallel::For(filePaths.size(), 1, WriteMeshBlock, &data);
+        for(unsigned int i = 0; i < written.size(); i++)
+        {
+            if(written[i]) continue;
+            a_errorMessage = "Couldn't write " + filePaths[i];
+            return false;
+        }
+    }
+    else
+    {
+        for(unsigned int i = 0; i < m_Meshes.size(); i++) m_Meshes[i].embeddedFile = "";
+    }
+
+    vtkSmartPointer<vtkXMLDataElement> session = vtkSmartPointer<vtkXMLDataElement>::New();
+    session->SetName("session");
+    session->SetIntAttribute("version", 1);
+
+    // View
+    vtkSmartPointer<vtkXMLDataElement> view = vtkSmartPointer<vtkXMLDataElement>::New();
+    view->SetName("view");
+    view->SetAttribute("attribute", m_View.attribute.c_str());
+    view->SetIntAttribute("displayColorbar", m_View.displayColorbar);
+    view->SetIntAttribute("displayAttribute", m_View.displayAttribute);
+    view->SetIntAttribute("displayMeshName", m_View.displayMeshName);
+    view->SetIntAttribute("displaySphere", m_View.displaySphere);
+    view->SetAttribute("selectedColor", spvFormat(m_View.selectedColor, 3).c_str());
+    view->SetAttribute("unselectedColor", spvFormat(m_View.unselectedColor, 3).c_str());
+    view->SetAttribute("labelColor", spvFormat(m_View.labelColor, 3).c_str());
+    view->SetIntAttribute("columns", m_View.columns);
+    view->SetIntAttribute("alignment", m_View.alignment);
+    session->AddNestedElement(view);
+
+    vtkSmartPointer<vtkXMLDataElement> camera = vtkSmartPointer<vtkXMLDataElement>::New();
+    camera->SetName("camera");
+    cameraConfigStruct &cam = m_View.camera;
+    double position[3] = {cam.pos_x, cam.pos_y, cam.pos_z};
+    double focalPoint[3] = {cam.foc_x, cam.foc_y, cam.foc_z};
+    double viewUp[3] = {cam.view_vx, cam.view_vy, cam.view_vz};
+    camera->SetAttribute("position", spvFormat(position, 3).c_str());
+    camera->SetAttribute("focalpoint", spvFormat(focalPoint, 3).c_str());
+    camera->SetAttribute("viewup", spvFormat(viewUp, 3).c_str());
+    camera->SetAttribute("scale", spvFormat(&cam.scale, 1).c_str());
+    session->AddNestedElement(camera);
+
+    // Colorbars
+    for(unsigned int i = 0; i < m_Attributes.size(); i++)
+    {
+        vtkSmartPointer<vtkXMLDataElement> attribute = vtkSmartPointer<vtkXMLDataElement>::New();
+        attribute->SetName("attribute");
+        attribute->SetAttribute("name", m_Attributes[i].name.c_str());
+        attribute->SetAttribute("range", spvFormat(m_Attributes[i].colorBar.range, 2).c_str());
+        double magnitude[2] = {m_Attributes[i].magnitude.min, m_Attributes[i].magnitude.max};
+        attribute->SetAttribute("magnitude", spvFormat(magnitude, 2).c_str());
+        std::vector<colorPointStruct> &colorPoints = m_Attributes[i].colorBar.colorPointList;
+        for(unsigned int j = 0; j < colorPoints.size(); j++)
+        {
+            vtkSmartPointer<vtkXMLDataElement> colorPoint = vtkSmartPointer<vtkXMLDataElement>::New();
+            colorPoint->SetName("colorpoint");
+            double values[4] = {colorPoints[j].pos, colorPoints[j].r, colorPoints[j].g, colorPoints[j].b};
+            colorPoint->SetAttribute("position", spvFormat(values, 1).c_str());
+            colorPoint->SetAttribute("RGB", spvFormat(values + 1, 3).c_str());
+            attribute->AddNestedElement(colorPoint);
+        }
+        session->AddNestedElement(attribute);
+    }
+
+    // Meshes
+    for(unsigned int i = 0; i < m_Meshes.size(); i++)
+    {
+        MeshState &state = m_Meshes[i];
+        vtkSmartPointer<vtkXMLDataElement> mesh = vtkSmartPointer<vtkXMLDataElement>::New();
+        mesh->SetName("mesh");
+        mesh->SetAttribute("file", state.filePath.c_str());
+        if(!state.embeddedFile.empty()) mesh->SetAttribute("embedded", state.embeddedFile.c_str());
+        mesh->SetIntAttribute("opacity", state.opacity);
+        mesh->SetIntAttribute("vectorScale", state.vectorScale);
+        mesh->SetIntAttribute("vectorDensity", state.vectorDensity);
+        mesh->SetAttribute("colorMap", state.colorMapByDirection ? "direction" : "magnitude");
+        mesh->SetIntAttribute("displayVectors", state.displayVectors);
+        mesh->SetAttribute("vectorsColor", state.vectorsByDirection ? "direction" : "magnitude");
+
+        vtkSmartPointer<vtkXMLDataElement> axisColor = vtkSmartPointer<vtkXMLDataElement>::New();
+        axisColor->SetName("axisColor");
+        axisColor->SetAttribute("X", spvFormat(state.axisColor.XAxiscolor, 3).c_str());
+        axisColor->SetAttribute("Y", spvFormat(state.axisColor.YAxiscolor, 3).c_str());
+        axisColor->SetAttribute("Z", spvFormat(state.axisColor.ZAxiscolor, 3).c_str());
+        axisColor->SetIntAttribute("sameColor", state.axisColor.sameColor);
+        axisColor->SetIntAttribute("complementaryColor", state.axisColor.complementaryColor);
+        mesh->AddNestedElement(axisColor);
+        session->AddNestedElement(mesh);
+    }
+
+    // Population browsed by pages
+    if(!m_Population.empty())
+    {
+        vtkSmartPointer<vtkXMLDataElement> population = vtkSmartPointer<vtkXMLDataElement>::New();
+        population->SetName("population");
+        population->SetIntAttribute("pageSize", m_View.pageSize);
+        population->SetIntAttribute("pageIndex", m_View.pageIndex);
+        for(unsigned int i = 0; i < m_Population.size(); i++)
+        {
+            vtkSmartPointer<vtkXMLDataElement> file = vtkSmartPointer<vtkXMLDataElement>::New();
+            file->SetName("file");
+            file->SetAttribute("path", m_Population[i].c_str());
+            population->AddNestedElement(file);
+        }
+        session->AddNestedElement(population);
+    }
+
+    vtkIndent indent;
+    if(!vtkXMLUtilities::WriteElementToFile(session, a_filePath.c_str(), &indent))
+    {
+        a_errorMessage = "Couldn't write " + a_filePath;
+        return false;
+    }
+    return true;
+}
+
+void ShapePopulationSession::WriteMeshBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    SessionMeshes * data = static_cast<SessionMeshes *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        // The arrays computed from the attributes are not saved : their names end with a newline, or they are
+        // derived from an array of several components
+        ShapePopulationData * mesh = (*data->meshes)[i];
+        vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+        polyData->ShallowCopy(mesh->GetPolyData());
+        std::vector<std::string> derived;
+        for(int j = 0; j < polyData->GetPointData()->GetNumberOfArrays(); j++)
+        {
+            const char * name = polyData->GetPointData()->GetArrayName(j);
+            if(name != NULL && (ShapePopulationData::IsDerivedArray(name) || mesh->IsDerivedAttribute(name))) derived.push_back(name);
+        }
+        for(unsigned int j = 0; j < derived.size(); j++) polyData->GetPointData()->RemoveArray(derived[j].c_str());
+        derived.clear();
+        for(int j = 0; j < polyData->GetCellData()->GetNumberOfArrays(); j++)
+        {
+            const char * name = polyData->GetCellData()->GetArrayName(j);
+            if(name != NULL && mesh->IsDerivedAttribute(name)) derived.push_back(name);
+        }
+        for(unsigned int j = 0; j < derived.size(); j++) polyData->GetCellData()->RemoveArray(derived[j].c_str());
+
+        // Raw binary, read back without decoding
+        vtkSmartPointer<vtkXMLPolyDataWriter> writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+#if (VTK_MAJOR_VERSION < 6)
+        writer->SetInput(polyData);
+#else
+        writer->SetInputData(polyData);
+#endif
+        writer->SetFileName((*data->filePaths)[i].c_str());
+        writer->SetDataModeToAppended();
+        writer->EncodeAppendedDataOff();
+        (*data->written)[i] = writer->Write();
+    }
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             READ                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationSession::ReadVector(vtkXMLDataElement * a_element, const char * a_name, double a_vector[3])
+{
+    double vector[3];
+    if(a_element == NULL || a_element->GetVectorAttribute(a_name, 3, vector) != 3) return false;
+    for(int k = 0; k < 3; k++) a_vector[k] = vector[k];
+    return true;
+}
+
+bool ShapePopulationSession::Read(std::string a_filePath, std::string &a_errorMessage)
+{
+    SPV_PROFILE_SCOPE("ReadSession");
+    this->Clear();
+
+    vtkXMLDataElement * session = vtkXMLUtilities::ReadElementFromFile(a_filePath.c_str());
+    if(session == NULL)
+    {
+        a_errorMessage = "Couldn't read " + a_filePath;
+        return false;
+    }
+    if(session->GetName() == NULL || strcmp(session->GetName(), "session") != 0)
+    {
+        session->Delete();
+        a_errorMessage = a_filePath + " is not a session file";
+        return false;
+    }
+    m_FilePath = a_filePath;
+
+    // View
+    vtkXMLDataElement * view = session->FindNestedElementWithName("view");
+    if(view != NULL)
+    {
+        if(view->GetAttribute("attribute") != NULL) m_View.attribute = view->GetAttribute("attribute");
+        m_View.displayColorbar = spvIntAttribute(view, "displayColorbar", 1) != 0;
+        m_View.displayAttribute = spvIntAttribute(view, "displayAttribute", 1) != 0;
+        m_View.displayMeshName = spvIntAttribute(view, "displayMeshName", 1) != 0;
+        m_View.displaySphere = spvIntAttribute(view, "displaySphere", 1) != 0;
+        ReadVector(view, "selectedColor", m_View.selectedColor);
+        ReadVector(view, "unselectedColor", m_View.unselectedColor);
+        ReadVector(view, "labelColor", m_View.labelColor);
+        m_View.columns = spvIntAttribute(view, "columns", 0);
+        m_View.alignment = spvIntAttribute(view, "alignment", 0);
+    }
+
+    vtkXMLDataElement * camera = session->FindNestedElementWithName("camera");
+    double position[3], focalPoint[3], viewUp[3];
+    if(ReadVector(camera, "position", position) && ReadVector(camera, "focalpoint", focalPoint) && ReadVector(camera, "viewup", viewUp))
+    {
+        cameraConfigStruct cam = {position[0], position[1], position[2], focalPoint[0], focalPoint[1], focalPoint[2],
+                                  viewUp[0], viewUp[1], viewUp[2], spvDoubleAttribute(camera, "scale", 1.0)};
+        m_View.camera = cam;
+    }
+
+    for(int i = 0; i < session->GetNumberOfNestedElements(); i++)
+    {
+        vtkXMLDataElement * element = session->GetNestedElement(i);
+        if(element->GetName() == NULL) continue;
+
+        // Colorbars
+        if(strcmp(element->GetName(), "attribute") == 0 && element->GetAttribute("name") != NULL)
+        {
+            AttributeState attribute;
+            attribute.name = element->GetAttribute("name");
+            double range[2] = {0.0, 0.0};
+            double magnitude[2] = {0.0, 0.0};
+            element->GetVectorAttribute("range", 2, range);
+            element->GetVectorAttribute("magnitude", 2, magnitude);
+            attribute.colorBar.range[0] = range[0];
+            attribute.colorBar.range[1] = range[1];
+            attribute.magnitude.min = magnitude[0];
+            attribute.magnitude.max = magnitude[1];
+            for(int j = 0; j < element->GetNumberOfNestedElements(); j++)
+            {
+                vtkXMLDataElement * point = element->GetNestedElement(j);
+                double rgb[3];
+                if(point->GetName() == NULL || strcmp(point->GetName(), "colorpoint") != 0 || !ReadVector(point, "RGB", rgb)) continue;
+                colorPointStruct colorPoint;
+                colorPoint.pos = spvDoubleAttribute(point, "position", 0.0);
+                colorPoint.r = rgb[0];
+                colorPoint.g = rgb[1];
+                colorPoint.b = rgb[2];
+                attribute.colorBar.colorPointList.push_back(colorPoint);
+            }
+            m_Attributes.push_back(attribute);
+        }
+
+        // Meshes
+        else if(strcmp(element->GetName(), "mesh") == 0 && element->GetAttribute("file") != NULL)
+        {
+            MeshState state = DefaultMeshState(element->GetAttribute("file"));
+            if(element->GetAttribute("embedded") != NULL) state.embeddedFile = element->GetAttribute("embedded");
+            state.opacity = spvIntAttribute(element, "opacity", state.opacity);
+            state.vectorScale = spvIntAttribute(element, "vectorScale", state.vectorScale);
+            state.vectorDensity = spvIntAttribute(element, "vectorDensity", state.vectorDensity);
+            state.colorMapByDirection = element->GetAttribute("colorMap") != NULL && strcmp(element->GetAttribute("colorMap"), "direction") == 0;
+            state.displayVectors = spvIntAttribute(element, "displayVectors", 0) != 0;
+            state.vectorsByDirection = element->GetAttribute("vectorsColor") != NULL && strcmp(element->GetAttribute("vectorsColor"), "direction") == 0;
+
+            vtkXMLDataElement * axisColor = element->FindNestedElementWithName("axisColor");
+            if(axisColor != NULL)
+            {
+                ReadVector(axisColor, "X", state.axisColor.XAxiscolor);
+                ReadVector(axisColor, "Y", state.axisColor.YAxiscolor);
+                ReadVector(axisColor, "Z", state.axisColor.ZAxiscolor);
+                state.axisColor.sameColor = spvIntAttribute(axisColor, "sameColor", 0) != 0;
+                state.axisColor.complementaryColor = spvIntAttribute(axisColor, "complementaryColor", 1) != 0;
+            }
+            m_Meshes.push_back(state);
+        }
+
+        // Population browsed by pages
+        else if(strcmp(element->GetName(), "population") == 0)
+        {
+            m_View.pageSize = spvIntAttribute(element, "pageSize", 0);
+            m_View.pageIndex = spvIntAttribute(element, "pageIndex", 0);
+            for(int j = 0; j < element->GetNumberOfNestedElements(); j++)
+            {
+                const char * path = element->GetNestedElement(j)->GetAttribute("path");
+                if(path != NULL) m_Population.push_back(path);
+            }
+        }
+    }
+    session->Delete();
+    return true;
+}
+
+std::vector<ShapePopulationData *> ShapePopulationSession::ReadEmbeddedMeshes()
+{
+    SPV_PROFILE_SCOPE("ReadEmbeddedMeshes");
+    std::string directory = vtksys::SystemTools::GetFilenamePath(m_FilePath);
+    std::vector<std::string> filePaths;
+    std::vector<std::string> meshPaths;
+    for(unsigned int i = 0; i < m_Meshes.size(); i++)
+    {
+        std::string filePath = "";
+        if(!m_Meshes[i].embeddedFile.empty()) filePath = vtksys::SystemTools::CollapseFullPath(m_Meshes[i].embeddedFile.c_str(), directory.c_str());
+        filePaths.push_back(filePath);
+        meshPaths.push_back(m_Meshes[i].filePath);
+    }
+
+    // One mesh per block, as the mesh cache does
+    std::vector<ShapePopulationData *> meshes(m_Meshes.size(), (ShapePopulationData *)NULL);
+    SessionMeshes data;
+    data.filePaths = &filePaths;
+    data.meshPaths = &meshPaths;
+    data.meshes = &meshes;
+    data.written = NULL;
+    if(!meshes.empty()) ShapePopulationParallel::For(meshes.size(), 1, ReadMeshBlock, &data);
+    return meshes;
+}
+
+void ShapePopulationSession::ReadMeshBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    SessionMeshes * data = static_cast<SessionMeshes *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        const std::string &filePath = (*data->filePaths)[i];
+        if(filePath.empty() || !vtksys::SystemTools::FileExists(filePath.c_str())) continue;
+
+        vtkSmartPointer<vtkPolyData> polyData = ShapePopulationData::ReadPolyData(filePath);
+        if(polyData == NULL || polyData->GetNumberOfPoints() == 0) continue;
+
+        ShapePopulationData * mesh = new ShapePopulationData;
+        mesh->LoadProcessedPolyData(polyData, (*data->meshPaths)[i]);
+        (*data->meshes)[i] = mesh;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SHAPEPOPULATIONSESSION_H
+#define SHAPEPOPULATIONSESSION_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+#include "colorBarStruct.h"
+#include "cameraConfigStruct.h"
+#include "magnitudStruct.h"
+#include "axisColorStruct.h"
+
+#include <vtkXMLDataElement.h>
+
+#include <vector>
+#include <string>
+
+// Workspace saved in a .spvs file (XML) : the meshes with their view state, the colorbars of the
+// attributes and the global view. The processed meshes (normals and attributes computed in memory)
+// can be embedded as binary .vtp files in a "<session>_meshes" directory next to the session,
+// a session then being restored without reading the original files again.
+class ShapePopulationSession
+{
+    public :
+
+    struct MeshState
+    {
+        std::string filePath;                                           // file of the mesh, or name of a mesh computed in memory
+        std::string embeddedFile;                                       // relative to the session directory, "" if not embedded
+        int opacity;
+        int vectorScale;
+        int vectorDensity;
+        bool colorMapByDirection;                                       // by magnitude otherwise
+        bool displayVectors;
+        bool vectorsByDirection;                                        // by magnitude otherwise
+        axisColorStruct axisColor;
+    };
+
+    struct AttributeState
+    {
+        std::string name;
+        colorBarStruct colorBar;
+        magnitudStruct magnitude;
+    };
+
+    struct ViewState
+    {
+        std::string attribute;
+        bool displayColorbar;
+        bool displayAttribute;
+        bool displayMeshName;
+        bool displaySphere;
+        double selectedColor[3];
+        double unselectedColor[3];
+        double labelColor[3];
+        cameraConfigStruct camera;
+        int columns;                                                    // 0 : as when the meshes are loaded
+        int alignment;
+        int pageSize;                                                   // paged browsing, 0 if the meshes are all loaded
+        int pageIndex;
+    };
+
+    ShapePopulationSession();
+    ~ShapePopulationSession(){}
+
+    void Clear();
+
+    // a_meshes (same order as the mesh states) are embedded if not empty
+    bool Write(std::string a_filePath, std::vector<ShapePopulationData *> a_meshes, std::string &a_errorMessage);
+    bool Read(std::string a_filePath, std::string &a_errorMessage);
+    // Embedded meshes, read in parallel (NULL for the meshes which are not embedded)
+    std::vector<ShapePopulationData *> ReadEmbeddedMeshes();
+
+    std::vector<MeshState> &GetMeshes() {return m_Meshes;}
+    std::vector<AttributeState> &GetAttributes() {return m_Attributes;}
+    std::vector<std::string> &GetPopulation() {return m_Population;}
+    ViewState &GetView() {return m_View;}
+    std::string GetFilePath() {return m_FilePath;}
+
+    static MeshState DefaultMeshState(std::string a_filePath);
+
+    protected :
+
+    std::string m_FilePath;
+    std::vector<MeshState> m_Meshes;
+    std::vector<AttributeState> m_Attributes;
+    std::vector<std::string> m_Population;                              // files browsed by pages, the meshes being the ones of the page
+    ViewState m_View;
+
+    static void WriteMeshBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static void ReadMeshBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static bool ReadVector(vtkXMLDataElement * a_element, const char * a_name, double a_vector[3]);
+};
+
+
+#endif
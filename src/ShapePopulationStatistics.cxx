@@ -0,0 +1,634 @@
+#include "ShapePopulationStatistics.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SPV_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+// Number of vertices processed together by one thread
+static const vtkIdType s_vertexBlock = 2048;
+
+// Size in bytes of the part of the vertex x subject matrix read by one block of the permutation test
+static const vtkIdType s_permutationBlockBytes = 64*1024;
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            KERNELS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+template <class T>
+static void spvGatherValues(const T * a_data, int a_numComp, vtkIdType a_begin, vtkIdType a_end, double * a_values)
+{
+    const T * data = a_data + a_begin*a_numComp;
+    vtkIdType size = a_end - a_begin;
+    for(vtkIdType v = 0; v < size; v++, data += a_numComp)
+    {
+        a_values[v] = static_cast<double>(*data);
+    }
+}
+
+template <class T>
+static void spvAccumulatePoints(const T * a_points, vtkIdType a_begin, vtkIdType a_end, double * a_sum)
+{
+    const T * points = a_points + 3*a_begin;
+    double * sum = a_sum + 3*a_begin;
+    vtkIdType size = 3*(a_end - a_begin);
+    for(vtkIdType k = 0; k < size; k++)
+    {
+        sum[k] += static_cast<double>(points[k]);
+    }
+}
+
+template <class T>
+static void spvGatherDisplacements(const T * a_points, const double * a_mean, const double * a_normals,
+                                   vtkIdType a_begin, vtkIdType a_end, double * a_values)
+{
+    const T * p = a_points + 3*a_begin;
+    const double * m = a_mean + 3*a_begin;
+    const double * n = a_normals + 3*a_begin;
+    vtkIdType size = a_end - a_begin;
+    for(vtkIdType v = 0; v < size; v++, p += 3, m += 3, n += 3)
+    {
+        a_values[v] = (static_cast<double>(p[0]) - m[0])*n[0]
+                    + (static_cast<double>(p[1]) - m[1])*n[1]
+                    + (static_cast<double>(p[2]) - m[2])*n[2];
+    }
+}
+
+// Sum and sum of squares of the values x[i] with mask[i] = 1, size multiple of 4
+static inline void spvMaskedSums(const float * a_values, const float * a_mask, int a_size, float &a_sum, float &a_sumOfSquares)
+{
+#ifdef SPV_USE_SSE
+    __m128 sum = _mm_setzero_ps();
+    __m128 sumOfSquares = _mm_setzero_ps();
+    for(int i = 0; i < a_size; i += 4)
+    {
+        __m128 values = _mm_loadu_ps(a_values + i);
+        __m128 masked = _mm_mul_ps(_mm_loadu_ps(a_mask + i), values);
+        sum = _mm_add_ps(sum, masked);
+        sumOfSquares = _mm_add_ps(sumOfSquares, _mm_mul_ps(masked, values));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum);
+    a_sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm_storeu_ps(lanes, sumOfSquares);
+    a_sumOfSquares = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float sumOfSquares[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for(int i = 0; i < a_size; i += 4)
+    {
+        for(int k = 0; k < 4; k++)
+        {
+            float masked = a_mask[i + k]*a_values[i + k];
+            sum[k] += masked;
+            sumOfSquares[k] += masked*a_values[i + k];
+        }
+    }
+    a_sum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    a_sumOfSquares = (sumOfSquares[0] + sumOfSquares[1]) + (sumOfSquares[2] + sumOfSquares[3]);
+#endif
+}
+
+// Welch t from the sums of each group
+static inline double spvWelchT(double a_sumA, double a_sumOfSquaresA, double a_nA, double a_sumB, double a_sumOfSquaresB, double a_nB)
+{
+    double meanA = a_sumA/a_nA;
+    double meanB = a_sumB/a_nB;
+    double varA = (a_sumOfSquaresA - a_sumA*meanA)/(a_nA - 1.0);
+    double varB = (a_sumOfSquaresB - a_sumB*meanB)/(a_nB - 1.0);
+    if(varA < 0.0) varA = 0.0;
+    if(varB < 0.0) varB = 0.0;
+    double standardError = sqrt(varA/a_nA + varB/a_nB);
+    return (standardError > 0.0) ? (meanA - meanB)/standardError : 0.0;
+}
+
+// Random generator of the permutations (splitmix64), same sequence on every platform
+static inline vtkTypeUInt64 spvNextRandom(vtkTypeUInt64 &a_state)
+{
+    vtkTypeUInt64 z = (a_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct MeanShapeInfo
+{
+    std::vector<vtkDataArray *> points;
+    double * sum;
+};
+
+static void MeanShapeBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    MeanShapeInfo * info = static_cast<MeanShapeInfo *>(a_data);
+    for(unsigned int s = 0; s < info->points.size(); s++)
+    {
+        vtkDataArray * points = info->points[s];
+        switch(points->GetDataType())
+        {
+            vtkTemplateMacro(spvAccumulatePoints(static_cast<VTK_TT *>(points->GetVoidPointer(0)), a_begin, a_end, info->sum));
+        }
+    }
+}
+
+struct GroupComparisonInfo
+{
+    const ShapePopulationStatistics * statistics;
+    double * difference;
+    double * welchT;
+    double * cohenD;
+};
+
+struct PermutationInfo
+{
+    ShapePopulationStatistics * statistics;
+    int numberOfSubjects;
+    int stride;                         // numberOfSubjects rounded to a multiple of 4
+    int numberOfPermutations;           // permutation 0 holds the observed labels
+    vtkTypeUInt64 seed;
+    std::vector<float> matrix;          // vertex x subject, centered on the vertex mean
+    std::vector<double> sums;           // per vertex sum over all the subjects
+    std::vector<double> sumsOfSquares;
+    std::vector<float> labels;          // permutation x subject, 1 for group A
+    double * observedT;
+    std::vector<int> exceedances;       // per vertex, permutations with |t| >= |observed t|
+    std::vector<double> maxT;           // per permutation, max |t| over the vertices
+    vtkSimpleMutexLock maxTLock;
+};
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       GROUP COMPARISON                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+ShapePopulationStatistics::ShapePopulationStatistics()
+{
+    m_NumberInGroupA = 0;
+    m_ProgressDone = 0;
+    m_ProgressTotal = 0;
+    m_AbortRequested = false;
+}
+
+vtkDataArray * ShapePopulationStatistics::GetComparedArray(ShapePopulationData * a_mesh, std::string a_attribute)
+{
+    // The derived attributes and the cell attributes averaged to the points are computed when they are missing,
+    // the cell vectors become point vectors with their magnitude, as when they are displayed
+    a_mesh->ConvertCellVectors(a_attribute);
+    vtkDataArray * array = a_mesh->GetPointAttribute(a_attribute);
+    if(array == NULL) return NULL;
+    if(array->GetNumberOfComponents() == 1) return array;
+    if(array->GetNumberOfComponents() != 3) return NULL;
+
+    std::ostringstream strs;
+    strs.str("");
+    strs.clear();
+    strs << a_attribute << "_mag" << std::endl;
+    vtkPointData * pointData = a_mesh->GetPolyData()->GetPointData();
+    if(pointData->GetArray(strs.str().c_str()) == NULL) a_mesh->RestoreMagnitudes();
+    return pointData->GetArray(strs.str().c_str());
+}
+
+double ShapePopulationStatistics::GetProgress()
+{
+    m_ProgressLock.Lock();
+    double progress = (m_ProgressTotal > 0) ? (double)m_ProgressDone/(double)m_ProgressTotal : 0.0;
+    m_ProgressLock.Unlock();
+    return progress;
+}
+
+void ShapePopulationStatistics::AddProgress(vtkIdType a_done)
+{
+    m_ProgressLock.Lock();
+    m_ProgressDone += a_done;
+    m_ProgressLock.Unlock();
+}
+
+void ShapePopulationStatistics::Abort()
+{
+    m_ProgressLock.Lock();
+    m_AbortRequested = true;
+    m_ProgressLock.Unlock();
+}
+
+bool ShapePopulationStatistics::IsAbortRequested()
+{
+    m_ProgressLock.Lock();
+    bool abortRequested = m_AbortRequested;
+    m_ProgressLock.Unlock();
+    return abortRequested;
+}
+
+void ShapePopulationStatistics::ComputeMeanShape(std::vector<ShapePopulationData *> a_meshes)
+{
+    vtkPolyData * templateMesh = a_meshes[0]->GetPolyData();
+    vtkIdType numPts = templateMesh->GetNumberOfPoints();
+
+    vtkSmartPointer<vtkDoubleArray> meanPoints = vtkSmartPointer<vtkDoubleArray>::New();
+    meanPoints->SetNumberOfComponents(3);
+    meanPoints->SetNumberOfTuples(numPts);
+    meanPoints->FillComponent(0, 0.0);
+    meanPoints->FillComponent(1, 0.0);
+    meanPoints->FillComponent(2, 0.0);
+
+    MeanShapeInfo info;
+    for(unsigned int s = 0; s < a_meshes.size(); s++)
+    {
+        info.points.push_back(a_meshes[s]->GetPolyData()->GetPoints()->GetData());
+    }
+    info.sum = meanPoints->GetPointer(0);
+    ShapePopulationParallel::For(numPts, s_vertexBlock, MeanShapeBlock, &info);
+
+    double * mean = meanPoints->GetPointer(0);
+    for(vtkIdType k = 0; k < 3*numPts; k++) mean[k] /= (double)a_meshes.size();
+
+    // Same topology and attributes as the first mesh, mean positions
+    // (the derived arrays of the first mesh are not copied, they are computed again when loading the mean shape)
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetData(meanPoints);
+
+    vtkSmartPointer<vtkPolyData> meanShape = vtkSmartPointer<vtkPolyData>::New();
+    meanShape->ShallowCopy(templateMesh);
+    meanShape->SetPoints(points);
+    meanShape->GetPointData()->Initialize();
+    std::vector<std::string> attributes = a_meshes[0]->GetAttributeList();
+    for(unsigned int i = 0; i < attributes.size(); i++)
+    {
+        meanShape->GetPointData()->AddArray(templateMesh->GetPointData()->GetArray(attributes[i].c_str()));
+    }
+
+    vtkSmartPointer<vtkPolyDataNormals> normalGenerator = vtkSmartPointer<vtkPolyDataNormals>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    normalGenerator->SetInput(meanShape);
+#else
+    normalGenerator->SetInputData(meanShape);
+#endif
+    normalGenerator->SplittingOff();
+    normalGenerator->ComputePointNormalsOn();
+    normalGenerator->ComputeCellNormalsOff();
+    normalGenerator->Update();
+    m_MeanShape = normalGenerator->GetOutput();
+}
+
+bool ShapePopulationStatistics::PrepareGroups(std::vector<ShapePopulationData *> a_groupA, std::vector<ShapePopulationData *> a_groupB, std::string a_attribute)
+{
+    m_ErrorMessage = "";
+    m_ProgressLock.Lock();
+    m_AbortRequested = false;
+    m_ProgressLock.Unlock();
+    m_Subjects.clear();
+    m_MeanPoints.clear();
+    m_MeanNormals.clear();
+
+    if(a_groupA.size() < 2 || a_groupB.size() < 2)
+    {
+        m_ErrorMessage = "Each group needs at least two meshes.";
+        return false;
+    }
+
+    std::vector<ShapePopulationData *> meshes(a_groupA);
+    meshes.insert(meshes.end(), a_groupB.begin(), a_groupB.end());
+
+    vtkIdType numPts = meshes[0]->GetPolyData()->GetNumberOfPoints();
+    for(unsigned int i = 0; i < meshes.size(); i++)
+    {
+        if(meshes[i]->GetPolyData()->GetNumberOfPoints() != numPts)
+        {
+            m_ErrorMessage = "The meshes are not in correspondence (different number of points): " + meshes[i]->GetFileName();
+            return false;
+        }
+        if(!a_attribute.empty() && GetComparedArray(meshes[i], a_attribute) == NULL)
+        {
+            m_ErrorMessage = "The attribute " + a_attribute + " is missing or has a wrong dimension in " + meshes[i]->GetFileName();
+            return false;
+        }
+    }
+
+    this->ComputeMeanShape(meshes);
+
+    for(unsigned int i = 0; i < meshes.size(); i++)
+    {
+        if(a_attribute.empty()) m_Subjects.push_back(meshes[i]->GetPolyData()->GetPoints()->GetData());
+        else m_Subjects.push_back(GetComparedArray(meshes[i], a_attribute));
+    }
+    m_NumberInGroupA = a_groupA.size();
+
+    if(a_attribute.empty())
+    {
+        vtkDataArray * meanNormals = m_MeanShape->GetPointData()->GetNormals();
+        m_MeanPoints.resize(3*numPts);
+        m_MeanNormals.resize(3*numPts);
+        for(vtkIdType v = 0; v < numPts; v++)
+        {
+            m_MeanShape->GetPoint(v, &m_MeanPoints[3*v]);
+            meanNormals->GetTuple(v, &m_MeanNormals[3*v]);
+        }
+    }
+    return true;
+}
+
+void ShapePopulationStatistics::GatherSubjectValues(unsigned int a_subject, vtkIdType a_begin, vtkIdType a_end, double * a_values) const
+{
+    vtkDataArray * array = m_Subjects[a_subject];
+    if(!m_MeanNormals.empty())
+    {
+        switch(array->GetDataType())
+        {
+            vtkTemplateMacro(spvGatherDisplacements(static_cast<VTK_TT *>(array->GetVoidPointer(0)), &m_MeanPoints[0], &m_MeanNormals[0], a_begin, a_end, a_values));
+        }
+    }
+    else
+    {
+        int numComp = array->GetNumberOfComponents();
+        switch(array->GetDataType())
+        {
+            vtkTemplateMacro(spvGatherValues(static_cast<VTK_TT *>(array->GetVoidPointer(0)), numComp, a_begin, a_end, a_values));
+        }
+    }
+}
+
+void ShapePopulationStatistics::GroupComparisonBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    GroupComparisonInfo * info = static_cast<GroupComparisonInfo *>(a_data);
+    const ShapePopulationStatistics * statistics = info->statistics;
+    vtkIdType size = a_end - a_begin;
+
+    std::vector<double> values(size);
+    std::vector<double> mean[2];
+    std::vector<double> m2[2];
+    double count[2] = {0.0, 0.0};
+    mean[0].assign(size, 0.0);
+    mean[1].assign(size, 0.0);
+    m2[0].assign(size, 0.0);
+    m2[1].assign(size, 0.0);
+
+    // Welford accumulation, one subject at a time over the whole block
+    for(unsigned int s = 0; s < statistics->m_Subjects.size(); s++)
+    {
+        int g = (s < statistics->m_NumberInGroupA) ? 0 : 1;
+        statistics->GatherSubjectValues(s, a_begin, a_end, &values[0]);
+
+        count[g] += 1.0;
+        double * groupMean = &mean[g][0];
+        double * groupM2 = &m2[g][0];
+        for(vtkIdType v = 0; v < size; v++)
+        {
+            double delta = values[v] - groupMean[v];
+            groupMean[v] += delta/count[g];
+            groupM2[v] += delta*(values[v] - groupMean[v]);
+        }
+    }
+
+    double nA = count[0];
+    double nB = count[1];
+    for(vtkIdType v = 0; v < size; v++)
+    {
+        double difference = mean[0][v] - mean[1][v];
+        double varA = m2[0][v]/(nA - 1.0);
+        double varB = m2[1][v]/(nB - 1.0);
+
+        double standardError = sqrt(varA/nA + varB/nB);
+        double pooledDeviation = sqrt(((nA - 1.0)*varA + (nB - 1.0)*varB)/(nA + nB - 2.0));
+
+        // constant values in both groups : no statistic, keep the colormap range finite
+        info->difference[a_begin + v] = difference;
+        info->welchT[a_begin + v] = (standardError > 0.0) ? difference/standardError : 0.0;
+        info->cohenD[a_begin + v] = (pooledDeviation > 0.0) ? difference/pooledDeviation : 0.0;
+    }
+}
+
+bool ShapePopulationStatistics::ComputeGroupComparison(std::vector<ShapePopulationData *> a_groupA, std::vector<ShapePopulationData *> a_groupB, std::string a_attribute)
+{
+    if(!this->PrepareGroups(a_groupA, a_groupB, a_attribute)) return false;
+    vtkIdType numPts = m_MeanShape->GetNumberOfPoints();
+
+    m_MeanDifference = vtkSmartPointer<vtkDoubleArray>::New();
+    m_WelchT = vtkSmartPointer<vtkDoubleArray>::New();
+    m_CohenD = vtkSmartPointer<vtkDoubleArray>::New();
+    m_MeanDifference->SetNumberOfTuples(numPts);
+    m_WelchT->SetNumberOfTuples(numPts);
+    m_CohenD->SetNumberOfTuples(numPts);
+
+    GroupComparisonInfo info;
+    info.statistics = this;
+    info.difference = m_MeanDifference->GetPointer(0);
+    info.welchT = m_WelchT->GetPointer(0);
+    info.cohenD = m_CohenD->GetPointer(0);
+
+    ShapePopulationParallel::For(numPts, s_vertexBlock, GroupComparisonBlock, &info);
+
+    return true;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                       PERMUTATION TEST                                        * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationStatistics::PermutationMatrixBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PermutationInfo * info = static_cast<PermutationInfo *>(a_data);
+    vtkIdType size = a_end - a_begin;
+    int stride = info->stride;
+
+    std::vector<double> values(size);
+    std::vector<double> mean(size, 0.0);
+    for(int s = 0; s < info->numberOfSubjects; s++)
+    {
+        info->statistics->GatherSubjectValues(s, a_begin, a_end, &values[0]);
+        for(vtkIdType v = 0; v < size; v++)
+        {
+            info->matrix[(a_begin + v)*stride + s] = (float)values[v];
+            mean[v] += values[v];
+        }
+    }
+
+    // Centering keeps the single precision sums accurate
+    for(vtkIdType v = 0; v < size; v++)
+    {
+        float * row = &info->matrix[(a_begin + v)*stride];
+        float center = (float)(mean[v]/info->numberOfSubjects);
+        double sum = 0.0;
+        double sumOfSquares = 0.0;
+        for(int s = 0; s < info->numberOfSubjects; s++)
+        {
+            row[s] -= center;
+            sum += row[s];
+            sumOfSquares += (double)row[s]*row[s];
+        }
+        info->sums[a_begin + v] = sum;
+        info->sumsOfSquares[a_begin + v] = sumOfSquares;
+    }
+}
+
+void ShapePopulationStatistics::PermutationLabelsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PermutationInfo * info = static_cast<PermutationInfo *>(a_data);
+    int numberInGroupA = (int)info->statistics->m_NumberInGroupA;
+    std::vector<int> order(info->numberOfSubjects);
+
+    for(vtkIdType p = a_begin; p < a_end; p++)
+    {
+        for(int s = 0; s < info->numberOfSubjects; s++) order[s] = s;
+
+        // Fisher-Yates shuffle, the observed labels are kept for permutation 0
+        if(p > 0)
+        {
+            vtkTypeUInt64 state = info->seed*0x100000001B3ULL + (vtkTypeUInt64)p;
+            for(int s = info->numberOfSubjects - 1; s > 0; s--)
+            {
+                double uniform = (double)(spvNextRandom(state) >> 11)*(1.0/9007199254740992.0);
+                int k = (int)(uniform*(s + 1));
+                std::swap(order[s], order[k]);
+            }
+        }
+
+        float * labels = &info->labels[p*info->stride];
+        for(int s = 0; s < numberInGroupA; s++) labels[order[s]] = 1.0f;
+    }
+}
+
+void ShapePopulationStatistics::PermutationTestBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    PermutationInfo * info = static_cast<PermutationInfo *>(a_data);
+    ShapePopulationStatistics * statistics = info->statistics;
+    if(statistics->IsAbortRequested()) return;
+
+    vtkIdType size = a_end - a_begin;
+    int stride = info->stride;
+    double nA = (double)statistics->m_NumberInGroupA;
+    double nB = (double)(info->numberOfSubjects - statistics->m_NumberInGroupA);
+
+    std::vector<double> blockMaxT(info->numberOfPermutations + 1, 0.0);
+    std::vector<double> observed(size, 0.0);
+
+    // All the permutations for this block of vertices : the block stays in cache, one label row at a time
+    for(int p = 0; p <= info->numberOfPermutations; p++)
+    {
+        const float * labels = &info->labels[p*stride];
+        double maxT = 0.0;
+        for(vtkIdType v = 0; v < size; v++)
+        {
+            float sumA, sumOfSquaresA;
+            spvMaskedSums(&info->matrix[(a_begin + v)*stride], labels, stride, sumA, sumOfSquaresA);
+            double sumB = info->sums[a_begin + v] - sumA;
+            double sumOfSquaresB = info->sumsOfSquares[a_begin + v] - sumOfSquaresA;
+            double t = spvWelchT(sumA, sumOfSquaresA, nA, sumB, sumOfSquaresB, nB);
+
+            if(p == 0)
+            {
+                observed[v] = fabs(t);
+                info->observedT[a_begin + v] = t;
+            }
+            else if(fabs(t) >= observed[v])
+            {
+                info->exceedances[a_begin + v]++;
+            }
+            if(fabs(t) > maxT) maxT = fabs(t);
+        }
+        blockMaxT[p] = maxT;
+    }
+
+    info->maxTLock.Lock();
+    for(int p = 0; p <= info->numberOfPermutations; p++)
+    {
+        if(blockMaxT[p] > info->maxT[p]) info->maxT[p] = blockMaxT[p];
+    }
+    info->maxTLock.Unlock();
+
+    statistics->AddProgress(size);
+}
+
+bool ShapePopulationStatistics::ComputePermutationTest(std::vector<ShapePopulationData *> a_groupA, std::vector<ShapePopulationData *> a_groupB, std::string a_attribute,
+                                                       int a_numberOfPermutations, unsigned int a_seed)
+{
+    m_ProgressLock.Lock();
+    m_ProgressDone = 0;
+    m_ProgressTotal = 0;
+    m_ProgressLock.Unlock();
+
+    if(!this->PrepareGroups(a_groupA, a_groupB, a_attribute)) return false;
+    if(a_numberOfPermutations < 1)
+    {
+        m_ErrorMessage = "The number of permutations must be positive.";
+        return false;
+    }
+    vtkIdType numPts = m_MeanShape->GetNumberOfPoints();
+
+    m_ProgressLock.Lock();
+    m_ProgressTotal = numPts;
+    m_ProgressLock.Unlock();
+
+    PermutationInfo info;
+    info.statistics = this;
+    info.numberOfSubjects = m_Subjects.size();
+    info.stride = 4*((info.numberOfSubjects + 3)/4);
+    info.numberOfPermutations = a_numberOfPermutations;
+    info.seed = a_seed;
+
+    // Vertex x subject matrix, padding with zeros
+    info.matrix.assign(numPts*info.stride, 0.0f);
+    info.sums.resize(numPts);
+    info.sumsOfSquares.resize(numPts);
+    ShapePopulationParallel::For(numPts, s_vertexBlock, PermutationMatrixBlock, &info);
+
+    // Labels of every permutation, generated before the test
+    info.labels.assign((a_numberOfPermutations + 1)*info.stride, 0.0f);
+    ShapePopulationParallel::For(a_numberOfPermutations + 1, 64, PermutationLabelsBlock, &info);
+
+    m_WelchT = vtkSmartPointer<vtkDoubleArray>::New();
+    m_WelchT->SetNumberOfTuples(numPts);
+    info.observedT = m_WelchT->GetPointer(0);
+    info.exceedances.assign(numPts, 0);
+    info.maxT.assign(a_numberOfPermutations + 1, 0.0);
+
+    vtkIdType grain = s_permutationBlockBytes/(info.stride*sizeof(float));
+    if(grain < 1) grain = 1;
+    ShapePopulationParallel::For(numPts, grain, PermutationTestBlock, &info);
+
+    if(this->IsAbortRequested())
+    {
+        m_ErrorMessage = "The permutation test has been canceled.";
+        return false;
+    }
+
+    // Uncorrected and max-T (family-wise) corrected p-values
+    std::vector<double> maxT(info.maxT.begin() + 1, info.maxT.end());
+    std::sort(maxT.begin(), maxT.end());
+
+    m_UncorrectedP = vtkSmartPointer<vtkDoubleArray>::New();
+    m_MaxTCorrectedP = vtkSmartPointer<vtkDoubleArray>::New();
+    m_FDRCorrectedP = vtkSmartPointer<vtkDoubleArray>::New();
+    m_UncorrectedP->SetNumberOfTuples(numPts);
+    m_MaxTCorrectedP->SetNumberOfTuples(numPts);
+    m_FDRCorrectedP->SetNumberOfTuples(numPts);
+    double * uncorrectedP = m_UncorrectedP->GetPointer(0);
+    double * maxTCorrectedP = m_MaxTCorrectedP->GetPointer(0);
+    double * FDRCorrectedP = m_FDRCorrectedP->GetPointer(0);
+
+    double numberOfPermutations = (double)a_numberOfPermutations;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        uncorrectedP[v] = (1.0 + info.exceedances[v])/(numberOfPermutations + 1.0);
+        double observed = fabs(info.observedT[v]);
+        size_t above = maxT.end() - std::lower_bound(maxT.begin(), maxT.end(), observed);
+        maxTCorrectedP[v] = (1.0 + above)/(numberOfPermutations + 1.0);
+    }
+
+    // Benjamini-Hochberg adjusted p-values
+    std::vector< std::pair<double, vtkIdType> > ranks(numPts);
+    for(vtkIdType v = 0; v < numPts; v++) ranks[v] = std::make_pair(uncorrectedP[v], v);
+    std::sort(ranks.begin(), ranks.end());
+    double adjusted = 1.0;
+    for(vtkIdType r = numPts - 1; r >= 0; r--)
+    {
+        double q = ranks[r].first*(double)numPts/(double)(r + 1);
+        if(q < adjusted) adjusted = q;
+        FDRCorrectedP[ranks[r].second] = adjusted;
+    }
+
+    return true;
+}
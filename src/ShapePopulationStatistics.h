@@ -0,0 +1,90 @@
+#ifndef SHAPEPOPULATIONSTATISTICS_H
+#define SHAPEPOPULATIONSTATISTICS_H
+
+#include <vtkVersion.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkDoubleArray.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkMutexLock.h>
+
+#include <vector>
+#include <string>
+
+// Vertex-wise comparison of two groups of corresponded meshes (same number of points).
+// The vertices are processed by blocks, each block reading the values of all the subjects
+// before moving on, so that the accumulators stay in cache.
+class ShapePopulationStatistics
+{
+    public :
+
+    ShapePopulationStatistics();
+    ~ShapePopulationStatistics(){}
+
+    // a_attribute : point attribute of dimension 1, or 3 (its magnitude is compared)
+    //               empty string to compare the point positions (displacement along the normals of the mean shape)
+    bool ComputeGroupComparison(std::vector<ShapePopulationData *> a_groupA, std::vector<ShapePopulationData *> a_groupB, std::string a_attribute);
+
+    // Two-sided Welch t permutation test. The labels of permutation i only depend on (a_seed, i),
+    // so the maps are the same whatever the number of threads.
+    bool ComputePermutationTest(std::vector<ShapePopulationData *> a_groupA, std::vector<ShapePopulationData *> a_groupB, std::string a_attribute,
+                                int a_numberOfPermutations, unsigned int a_seed);
+
+    vtkSmartPointer<vtkPolyData> GetMeanShape() {return m_MeanShape;}           // pooled mean of both groups
+    vtkSmartPointer<vtkDoubleArray> GetMeanDifference() {return m_MeanDifference;}
+    vtkSmartPointer<vtkDoubleArray> GetWelchT() {return m_WelchT;}
+    vtkSmartPointer<vtkDoubleArray> GetCohenD() {return m_CohenD;}
+    vtkSmartPointer<vtkDoubleArray> GetUncorrectedP() {return m_UncorrectedP;}
+    vtkSmartPointer<vtkDoubleArray> GetMaxTCorrectedP() {return m_MaxTCorrectedP;}
+    vtkSmartPointer<vtkDoubleArray> GetFDRCorrectedP() {return m_FDRCorrectedP;}
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+
+    // Can be called from another thread while a computation is running
+    double GetProgress();
+    void Abort();
+
+    // Array compared for a_attribute on one mesh (the "_mag" array for vectors), NULL if missing. Derived and
+    // cell attributes are computed on the mesh : GUI thread, before the comparison starts
+    static vtkDataArray * GetComparedArray(ShapePopulationData * a_mesh, std::string a_attribute);
+
+    protected :
+
+    vtkSmartPointer<vtkPolyData> m_MeanShape;
+    vtkSmartPointer<vtkDoubleArray> m_MeanDifference;
+    vtkSmartPointer<vtkDoubleArray> m_WelchT;
+    vtkSmartPointer<vtkDoubleArray> m_CohenD;
+    vtkSmartPointer<vtkDoubleArray> m_UncorrectedP;
+    vtkSmartPointer<vtkDoubleArray> m_MaxTCorrectedP;
+    vtkSmartPointer<vtkDoubleArray> m_FDRCorrectedP;
+    std::string m_ErrorMessage;
+
+    // Subjects of the comparison : group A first, then group B
+    std::vector<vtkDataArray *> m_Subjects;
+    unsigned int m_NumberInGroupA;
+    std::vector<double> m_MeanPoints;           // displacement mode only
+    std::vector<double> m_MeanNormals;          // displacement mode only
+
+    vtkSimpleMutexLock m_ProgressLock;
+    vtkIdType m_ProgressDone;
+    vtkIdType m_ProgressTotal;
+    bool m_AbortRequested;                      // guarded by m_ProgressLock too
+
+    bool PrepareGroups(std::vector<ShapePopulationData *> a_groupA, std::vector<ShapePopulationData *> a_groupB, std::string a_attribute);
+    void ComputeMeanShape(std::vector<ShapePopulationData *> a_meshes);
+    void GatherSubjectValues(unsigned int a_subject, vtkIdType a_begin, vtkIdType a_end, double * a_values) const;
+    void AddProgress(vtkIdType a_done);
+    bool IsAbortRequested();
+
+    static void GroupComparisonBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static void PermutationMatrixBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static void PermutationLabelsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+    static void PermutationTestBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
@@ -0,0 +1,1106 @@
+#include "ShapePopulationSurfaceFormats.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+static const vtkIdType s_lineGrain = 4096;                              // ascii lines parsed by a thread at once
+static const vtkIdType s_recordGrain = 16384;                           // binary vertices
+#ifdef VTK_WORDS_BIGENDIAN
+static const bool s_bigEndian = true;
+#else
+static const bool s_bigEndian = false;
+#endif
+
+// Where a value of a vertex goes : a coordinate of the points or an attribute, nowhere if values is NULL
+struct spvOutput
+{
+    float * values;
+    int stride;
+};
+
+static spvOutput spvCreateOutput(float * a_values, int a_stride)
+{
+    spvOutput output;
+    output.values = a_values;
+    output.stride = a_stride;
+    return output;
+}
+
+static bool spvStartsWith(const char * a_bytes, size_t a_size, const char * a_prefix)
+{
+    size_t length = strlen(a_prefix);
+    return (a_size >= length && strncmp(a_bytes, a_prefix, length) == 0);
+}
+
+static const char * spvFind(const char * a_begin, const char * a_end, const char * a_pattern)
+{
+    return std::search(a_begin, a_end, a_pattern, a_pattern + strlen(a_pattern));
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                          ASCII LINES                                          * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+static const char * spvSkipSpaces(const char * a_position)
+{
+    while(*a_position == ' ' || *a_position == '\t' || *a_position == '\r') a_position++;
+    return a_position;
+}
+
+// Empty line or comment
+static bool spvIsBlank(const char * a_position)
+{
+    a_position = spvSkipSpaces(a_position);
+    return (*a_position == '\n' || *a_position == '\0' || *a_position == '#');
+}
+
+static size_t spvNextLine(const std::vector<char> &a_buffer, size_t a_position)
+{
+    size_t size = a_buffer.size() - 1;
+    if(a_position >= size) return size;
+    const char * end = static_cast<const char *>(memchr(&a_buffer[a_position], '\n', size - a_position));
+    return (end == NULL) ? size : (size_t)(end - &a_buffer[0]) + 1;
+}
+
+// Are there a_count records of a_recordSize bytes at least after a_position : bounds the counts of a header
+// before anything is allocated from them
+static bool spvHasRecords(const std::vector<char> &a_buffer, size_t a_position, vtkIdType a_count, size_t a_recordSize)
+{
+    size_t size = a_buffer.size() - 1;
+    if(a_count < 0 || a_position > size) return false;
+    return ((size_t)a_count <= (size - a_position)/std::max(a_recordSize, (size_t)1));
+}
+
+// The starts of the next a_count lines that are not blank
+static bool spvFindLines(const std::vector<char> &a_buffer, size_t &a_position, vtkIdType a_count, std::vector<size_t> &a_lines)
+{
+    a_lines.clear();
+    if(!spvHasRecords(a_buffer, a_position, a_count, 1)) return false;
+    a_lines.reserve((size_t)a_count);
+    size_t size = a_buffer.size() - 1;
+    while((vtkIdType)a_lines.size() < a_count && a_position < size)
+    {
+        if(!spvIsBlank(&a_buffer[a_position])) a_lines.push_back(a_position);
+        a_position = spvNextLine(a_buffer, a_position);
+    }
+    return ((vtkIdType)a_lines.size() == a_count);
+}
+
+// Next number of the line, false at its end : strtod would go on to the next line
+static bool spvReadNumber(const char * &a_position, double &a_value)
+{
+    const char * position = spvSkipSpaces(a_position);
+    if(*position == '\n' || *position == '\0') return false;
+    char * end;
+    a_value = strtod(position, &end);
+    if(end == position) return false;
+    a_position = end;
+    return true;
+}
+
+static bool spvReadInteger(const char * &a_position, vtkIdType &a_value)
+{
+    const char * position = spvSkipSpaces(a_position);
+    if(*position == '\n' || *position == '\0') return false;
+    char * end;
+    a_value = static_cast<vtkIdType>(strtol(position, &end, 10));
+    if(end == position) return false;
+    a_position = end;
+    return true;
+}
+
+struct spvLines
+{
+    const char * buffer;
+    const std::vector<size_t> * lines;                                  // start of each line
+    const std::vector<spvOutput> * outputs;                             // one for each value of a line
+    std::vector<char> * valid;                                          // by block of lines
+};
+
+static void spvParseLinesBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    spvLines * lines = static_cast<spvLines *>(a_data);
+    const std::vector<spvOutput> &outputs = *lines->outputs;
+    bool valid = true;
+    for(vtkIdType i = a_begin; i < a_end && valid; i++)
+    {
+        const char * position = lines->buffer + (*lines->lines)[i];
+        for(unsigned int k = 0; k < outputs.size() && valid; k++)
+        {
+            double value;
+            valid = spvReadNumber(position, value);
+            if(outputs[k].values != NULL) outputs[k].values[i*outputs[k].stride] = static_cast<float>(value);
+        }
+    }
+    if(!valid) (*lines->valid)[a_begin/s_lineGrain] = 0;                // one call for the whole range on one thread
+}
+
+// The first values of each line, parsed in parallel : the lines are independent once their starts are known
+static bool spvParseLines(const std::vector<char> &a_buffer, const std::vector<size_t> &a_lines, const std::vector<spvOutput> &a_outputs)
+{
+    std::vector<char> valid((a_lines.size() + s_lineGrain - 1)/s_lineGrain, 1);
+    spvLines lines;
+    lines.buffer = &a_buffer[0];
+    lines.lines = &a_lines;
+    lines.outputs = &a_outputs;
+    lines.valid = &valid;
+    ShapePopulationParallel::For(a_lines.size(), s_lineGrain, spvParseLinesBlock, &lines);
+    return (std::find(valid.begin(), valid.end(), 0) == valid.end());
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             MESH                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+bool ShapePopulationSurfaceFormats::ReadFile(std::string a_filePath, std::vector<char> &a_buffer)
+{
+    std::ifstream file(a_filePath.c_str(), std::ios::in | std::ios::binary);
+    if(!file.is_open()) return false;
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    if(size < 0) return false;
+    file.seekg(0);
+    a_buffer.resize((size_t)size + 1);
+    if(size > 0 && !file.read(&a_buffer[0], size)) return false;
+    a_buffer[(size_t)size] = '\0';                                       // the ascii parsers stop on it
+    return true;
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationSurfaceFormats::CreatePolyData(vtkDataArray * a_points, const std::vector<vtkIdType> &a_polys, vtkIdType a_numberOfPolys)
+{
+    if(a_points == NULL || a_points->GetNumberOfComponents() != 3 || a_points->GetNumberOfTuples() == 0) return NULL;
+    vtkIdType numberOfPoints = a_points->GetNumberOfTuples();
+
+    // Faces : a number of points then their ids
+    size_t position = 0;
+    for(vtkIdType i = 0; i < a_numberOfPolys; i++)
+    {
+        if(position >= a_polys.size()) return NULL;
+        vtkIdType size = a_polys[position];
+        if(size < 1 || position + 1 + (size_t)size > a_polys.size()) return NULL;
+        for(size_t j = position + 1; j <= position + (size_t)size; j++)
+        {
+            if(a_polys[j] < 0 || a_polys[j] >= numberOfPoints) return NULL;
+        }
+        position += 1 + (size_t)size;
+    }
+    if(position != a_polys.size()) return NULL;
+
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(vtkSmartPointer<vtkPoints>::New());
+    polyData->GetPoints()->SetData(a_points);
+    if(a_numberOfPolys > 0)
+    {
+        vtkSmartPointer<vtkIdTypeArray> legacy = vtkSmartPointer<vtkIdTypeArray>::New();
+        legacy->SetNumberOfValues(a_polys.size());
+        memcpy(legacy->GetPointer(0), &a_polys[0], a_polys.size()*sizeof(vtkIdType));
+        vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+        polys->SetCells(a_numberOfPolys, legacy);
+        polyData->SetPolys(polys);
+    }
+    return polyData;
+}
+
+static vtkSmartPointer<vtkFloatArray> spvCreatePoints(vtkIdType a_numberOfPoints)
+{
+    vtkSmartPointer<vtkFloatArray> points = vtkSmartPointer<vtkFloatArray>::New();
+    points->SetNumberOfComponents(3);
+    points->SetNumberOfTuples(a_numberOfPoints);
+    return points;
+}
+
+static std::vector<spvOutput> spvPointsOutputs(vtkFloatArray * a_points)
+{
+    std::vector<spvOutput> outputs;
+    float * values = (a_points->GetNumberOfTuples() > 0) ? a_points->GetPointer(0) : NULL;
+    for(int k = 0; k < 3; k++) outputs.push_back(spvCreateOutput((values != NULL) ? values + k : NULL, 3));
+    return outputs;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                              PLY                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+struct spvPLYProperty
+{
+    std::string name;
+    int type;
+    int size;                                                           // bytes
+    int countType;                                                      // of a list, VTK_VOID for a value
+    int countSize;
+};
+
+struct spvPLYElement
+{
+    std::string name;
+    vtkIdType count;
+    std::vector<spvPLYProperty> properties;
+};
+
+static bool spvPLYType(std::string a_name, int &a_type, int &a_size)
+{
+    const char * names[16] = {"char", "int8", "uchar", "uint8", "short", "int16", "ushort", "uint16",
+                              "int", "int32", "uint", "uint32", "float", "float32", "double", "float64"};
+    const int types[8] = {VTK_SIGNED_CHAR, VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_INT, VTK_UNSIGNED_INT, VTK_FLOAT, VTK_DOUBLE};
+    const int sizes[8] = {1, 1, 2, 2, 4, 4, 4, 8};
+    for(int k = 0; k < 16; k++)
+    {
+        if(a_name != names[k]) continue;
+        a_type = types[k/2];
+        a_size = sizes[k/2];
+        return true;
+    }
+    return false;
+}
+
+template <class T>
+static double spvBinaryValue(const char * a_bytes)
+{
+    T value;
+    memcpy(&value, a_bytes, sizeof(T));
+    return static_cast<double>(value);
+}
+
+// A value in the byte order of the file
+static double spvReadBinary(const char * a_position, int a_type, int a_size, bool a_swap)
+{
+    char bytes[8];
+    for(int k = 0; k < a_size; k++) bytes[k] = a_swap ? a_position[a_size - 1 - k] : a_position[k];
+    switch(a_type)
+    {
+        case VTK_SIGNED_CHAR: return spvBinaryValue<signed char>(bytes);
+        case VTK_UNSIGNED_CHAR: return spvBinaryValue<unsigned char>(bytes);
+        case VTK_SHORT: return spvBinaryValue<short>(bytes);
+        case VTK_UNSIGNED_SHORT: return spvBinaryValue<unsigned short>(bytes);
+        case VTK_INT: return spvBinaryValue<int>(bytes);
+        case VTK_UNSIGNED_INT: return spvBinaryValue<unsigned int>(bytes);
+        case VTK_FLOAT: return spvBinaryValue<float>(bytes);
+        default: return spvBinaryValue<double>(bytes);
+    }
+}
+
+// Format (0 ascii, 1 little endian, 2 big endian) and elements, a_position set to the data
+static bool spvReadPLYHeader(const std::vector<char> &a_buffer, size_t &a_position, int &a_format, std::vector<spvPLYElement> &a_elements)
+{
+    a_position = 0;
+    a_format = -1;
+    size_t size = a_buffer.size() - 1;
+    for(int l = 0; a_position < size; l++)
+    {
+        size_t next = spvNextLine(a_buffer, a_position);
+        std::string line(&a_buffer[a_position], next - a_position);
+        a_position = next;
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if(l == 0 && keyword != "ply") return false;
+        if(keyword == "format")
+        {
+            std::string format;
+            stream >> format;
+            if(format == "ascii") a_format = 0;
+            else if(format == "binary_little_endian") a_format = 1;
+            else if(format == "binary_big_endian") a_format = 2;
+            else return false;
+        }
+        else if(keyword == "element")
+        {
+            spvPLYElement element;
+            element.count = -1;
+            stream >> element.name >> element.count;
+            if(element.count < 0) return false;
+            a_elements.push_back(element);
+        }
+        else if(keyword == "property")
+        {
+            if(a_elements.empty()) return false;
+            spvPLYProperty property;
+            property.countType = VTK_VOID;
+            property.countSize = 0;
+            std::string type;
+            stream >> type;
+            if(type == "list")
+            {
+                std::string countType;
+                stream >> countType >> type;
+                if(!spvPLYType(countType, property.countType, property.countSize)) return false;
+            }
+            if(!spvPLYType(type, property.type, property.size)) return false;
+            stream >> property.name;
+            a_elements.back().properties.push_back(property);
+        }
+        else if(keyword == "end_header")
+        {
+            return (a_format >= 0);
+        }
+    }
+    return false;
+}
+
+struct spvPLYVertices
+{
+    const char * data;                                                  // first vertex
+    size_t stride;                                                      // bytes of a vertex
+    bool swap;
+    const std::vector<spvPLYProperty> * properties;
+    std::vector<size_t> offsets;                                        // of each property in a vertex
+    const std::vector<spvOutput> * outputs;
+};
+
+static void spvPLYVerticesBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    spvPLYVertices * vertices = static_cast<spvPLYVertices *>(a_data);
+    const std::vector<spvPLYProperty> &properties = *vertices->properties;
+    const std::vector<spvOutput> &outputs = *vertices->outputs;
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        const char * vertex = vertices->data + i*vertices->stride;
+        for(unsigned int k = 0; k < properties.size(); k++)
+        {
+            if(outputs[k].values == NULL) continue;
+            double value = spvReadBinary(vertex + vertices->offsets[k], properties[k].type, properties[k].size, vertices->swap);
+            outputs[k].values[i*outputs[k].stride] = static_cast<float>(value);
+        }
+    }
+}
+
+// Faces, or any other element that is skipped if a_polys is NULL. The records of a list have no fixed size
+static bool spvReadPLYElement(const std::vector<char> &a_buffer, size_t &a_position, int a_format, bool a_swap,
+                              const spvPLYElement &a_element, std::vector<vtkIdType> * a_polys)
+{
+    size_t size = a_buffer.size() - 1;
+    bool lists = false;
+    size_t stride = 0;
+    for(unsigned int k = 0; k < a_element.properties.size(); k++)
+    {
+        lists = lists || (a_element.properties[k].countType != VTK_VOID);
+        stride += a_element.properties[k].size;
+    }
+    if(a_format != 0 && !lists)
+    {
+        if(stride*(size_t)a_element.count > size - a_position) return false;
+        a_position += stride*(size_t)a_element.count;
+        return true;
+    }
+
+    for(vtkIdType i = 0; i < a_element.count; i++)
+    {
+        const char * position = NULL;
+        if(a_format == 0)
+        {
+            while(a_position < size && spvIsBlank(&a_buffer[a_position])) a_position = spvNextLine(a_buffer, a_position);
+            if(a_position >= size) return false;
+            position = &a_buffer[a_position];
+            a_position = spvNextLine(a_buffer, a_position);
+            if(a_polys == NULL) continue;
+        }
+
+        for(unsigned int k = 0; k < a_element.properties.size(); k++)
+        {
+            const spvPLYProperty &property = a_element.properties[k];
+            bool indices = (a_polys != NULL && (property.name == "vertex_indices" || property.name == "vertex_index"));
+            double count = 1;
+            if(a_format == 0)
+            {
+                if(property.countType != VTK_VOID && !spvReadNumber(position, count)) return false;
+            }
+            else if(property.countType != VTK_VOID)
+            {
+                if(a_position + property.countSize > size) return false;
+                count = spvReadBinary(&a_buffer[a_position], property.countType, property.countSize, a_swap);
+                a_position += property.countSize;
+            }
+            if(count < 0) return false;
+            if(indices) a_polys->push_back(static_cast<vtkIdType>(count));
+
+            for(vtkIdType j = 0; j < static_cast<vtkIdType>(count); j++)
+            {
+                double value;
+                if(a_format == 0)
+                {
+                    if(!spvReadNumber(position, value)) return false;
+                }
+                else
+                {
+                    if(a_position + property.size > size) return false;
+                    if(indices) value = spvReadBinary(&a_buffer[a_position], property.type, property.size, a_swap);
+                    a_position += property.size;
+                }
+                if(indices) a_polys->push_back(static_cast<vtkIdType>(value));
+            }
+        }
+    }
+    return true;
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationSurfaceFormats::ReadPLY(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("ReadPLY");
+    std::vector<char> buffer;
+    size_t position;
+    int format;
+    std::vector<spvPLYElement> elements;
+    if(!ReadFile(a_filePath, buffer) || !spvReadPLYHeader(buffer, position, format, elements)) return NULL;
+    bool swap = (format == (s_bigEndian ? 1 : 2));
+
+    vtkSmartPointer<vtkFloatArray> points;
+    std::vector< vtkSmartPointer<vtkFloatArray> > attributes;
+    std::vector<vtkIdType> polys;
+    vtkIdType numberOfPolys = 0;
+    for(unsigned int e = 0; e < elements.size(); e++)
+    {
+        const spvPLYElement &element = elements[e];
+
+        // A line per element in ascii, the properties and the counts of the lists in binary
+        size_t recordSize = 0;
+        for(unsigned int k = 0; k < element.properties.size(); k++)
+        {
+            const spvPLYProperty &property = element.properties[k];
+            recordSize += (property.countType != VTK_VOID) ? property.countSize : property.size;
+        }
+        if(!spvHasRecords(buffer, position, element.count, (format == 0) ? 1 : recordSize)) return NULL;
+
+        if(element.name == "face" && polys.empty())
+        {
+            if(!spvReadPLYElement(buffer, position, format, swap, element, &polys)) return NULL;
+            numberOfPolys = element.count;
+            continue;
+        }
+        if(element.name != "vertex" || points != NULL)
+        {
+            if(!spvReadPLYElement(buffer, position, format, swap, element, NULL)) return NULL;
+            continue;
+        }
+
+        // Coordinates to the points, normals computed again, the other properties to attributes
+        points = spvCreatePoints(element.count);
+        std::vector<spvOutput> pointsOutputs = spvPointsOutputs(points);
+        std::vector<spvOutput> outputs;
+        int coordinates = 0;
+        for(unsigned int k = 0; k < element.properties.size(); k++)
+        {
+            const spvPLYProperty &property = element.properties[k];
+            if(property.countType != VTK_VOID) return NULL;
+            int axis = (property.name.size() == 1) ? (int)std::string("xyz").find(property.name) : -1;
+            if(axis >= 0 && !(coordinates & (1 << axis)))
+            {
+                coordinates |= (1 << axis);
+                outputs.push_back(pointsOutputs[axis]);
+            }
+            else if(axis >= 0 || property.name == "nx" || property.name == "ny" || property.name == "nz" || element.count == 0)
+            {
+                outputs.push_back(spvCreateOutput(NULL, 0));
+            }
+            else
+            {
+                vtkSmartPointer<vtkFloatArray> attribute = vtkSmartPointer<vtkFloatArray>::New();
+                attribute->SetName(property.name.c_str());
+                attribute->SetNumberOfComponents(1);
+                attribute->SetNumberOfTuples(element.count);
+                attributes.push_back(attribute);
+                outputs.push_back(spvCreateOutput(attribute->GetPointer(0), 1));
+            }
+        }
+        if(coordinates != 7) return NULL;
+
+        if(format == 0)
+        {
+            std::vector<size_t> lines;
+            if(!spvFindLines(buffer, position, element.count, lines) || !spvParseLines(buffer, lines, outputs)) return NULL;
+        }
+        else
+        {
+            spvPLYVertices vertices;
+            vertices.stride = 0;
+            for(unsigned int k = 0; k < element.properties.size(); k++)
+            {
+                vertices.offsets.push_back(vertices.stride);
+                vertices.stride += element.properties[k].size;
+            }
+            if(vertices.stride*(size_t)element.count > buffer.size() - 1 - position) return NULL;
+            vertices.data = &buffer[position];
+            vertices.swap = swap;
+            vertices.properties = &element.properties;
+            vertices.outputs = &outputs;
+            ShapePopulationParallel::For(element.count, s_recordGrain, spvPLYVerticesBlock, &vertices);
+            position += vertices.stride*(size_t)element.count;
+        }
+    }
+
+    vtkSmartPointer<vtkPolyData> polyData = CreatePolyData(points, polys, numberOfPolys);
+    if(polyData == NULL) return NULL;
+    for(unsigned int i = 0; i < attributes.size(); i++) polyData->GetPointData()->AddArray(attributes[i]);
+    return polyData;
+}
+
+bool ShapePopulationSurfaceFormats::IsPLY(const char * a_bytes, size_t a_size)
+{
+    return (spvStartsWith(a_bytes, a_size, "ply\n") || spvStartsWith(a_bytes, a_size, "ply\r\n"));
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                              STL                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// By coordinates, then by index : the equal vertices follow each other, the first one leading
+struct spvVertexOrder
+{
+    const float * coordinates;
+    bool operator()(vtkIdType a_first, vtkIdType a_second) const
+    {
+        const float * first = coordinates + 3*a_first;
+        const float * second = coordinates + 3*a_second;
+        for(int k = 0; k < 3; k++)
+        {
+            if(first[k] != second[k]) return first[k] < second[k];
+        }
+        return a_first < a_second;
+    }
+};
+
+// STL triangles have their own copy of each vertex : the equal ones are merged into one point, in the
+// order of their first appearance
+static vtkSmartPointer<vtkFloatArray> spvMergeVertices(const std::vector<float> &a_coordinates, std::vector<vtkIdType> &a_polys)
+{
+    vtkIdType numberOfVertices = a_coordinates.size()/3;
+    if(numberOfVertices == 0) return NULL;
+    for(size_t i = 0; i < a_coordinates.size(); i++)
+    {
+        if(a_coordinates[i] != a_coordinates[i]) return NULL;           // NaN, no order
+    }
+
+    std::vector<vtkIdType> order(numberOfVertices);
+    for(vtkIdType i = 0; i < numberOfVertices; i++) order[i] = i;
+    spvVertexOrder vertexOrder;
+    vertexOrder.coordinates = &a_coordinates[0];
+    std::sort(order.begin(), order.end(), vertexOrder);
+
+    std::vector<vtkIdType> first(numberOfVertices);                     // first vertex equal to each one
+    vtkIdType numberOfPoints = 0;
+    for(vtkIdType j = 0; j < numberOfVertices; j++)
+    {
+        const float * vertex = &a_coordinates[3*order[j]];
+        bool same = (j > 0 && memcmp(vertex, &a_coordinates[3*order[j - 1]], 3*sizeof(float)) == 0);
+        first[order[j]] = same ? first[order[j - 1]] : order[j];
+        if(!same) numberOfPoints++;
+    }
+
+    vtkSmartPointer<vtkFloatArray> points = spvCreatePoints(numberOfPoints);
+    float * values = points->GetPointer(0);
+    std::vector<vtkIdType> ids(numberOfVertices, -1);
+    vtkIdType next = 0;
+    for(vtkIdType i = 0; i < numberOfVertices; i++)
+    {
+        vtkIdType &id = ids[first[i]];
+        if(id < 0)
+        {
+            id = next++;
+            memcpy(values + 3*id, &a_coordinates[3*i], 3*sizeof(float));
+        }
+        ids[i] = id;
+    }
+
+    a_polys.resize(4*(size_t)(numberOfVertices/3));
+    for(vtkIdType t = 0; t < numberOfVertices/3; t++)
+    {
+        a_polys[4*t] = 3;
+        for(int k = 0; k < 3; k++) a_polys[4*t + 1 + k] = ids[3*t + k];
+    }
+    return points;
+}
+
+struct spvSTLTriangles
+{
+    const char * data;                                                  // first triangle
+    float * coordinates;
+};
+
+static void spvSTLTrianglesBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    spvSTLTriangles * triangles = static_cast<spvSTLTriangles *>(a_data);
+    for(vtkIdType t = a_begin; t < a_end; t++)
+    {
+        // Normal, 3 vertices, 2 bytes of attributes
+        const char * vertices = triangles->data + 50*t + 12;
+        if(!s_bigEndian) memcpy(triangles->coordinates + 9*t, vertices, 9*sizeof(float));
+        else for(int k = 0; k < 9; k++) triangles->coordinates[9*t + k] = static_cast<float>(spvReadBinary(vertices + 4*k, VTK_FLOAT, 4, true));
+    }
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationSurfaceFormats::ReadSTL(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("ReadSTL");
+    std::vector<char> buffer;
+    if(!ReadFile(a_filePath, buffer)) return NULL;
+    size_t size = buffer.size() - 1;
+
+    // Binary files may start with "solid" too, their size tells them apart
+    std::vector<float> coordinates;
+    bool ascii = spvStartsWith(&buffer[0], size, "solid");
+    vtkTypeUInt32 numberOfTriangles = 0;
+    if(size >= 84)
+    {
+        numberOfTriangles = (vtkTypeUInt32)spvReadBinary(&buffer[80], VTK_UNSIGNED_INT, 4, s_bigEndian);     // little endian
+    }
+    size_t binarySize = 84 + 50*(size_t)numberOfTriangles;
+    if(size >= 84 && (size == binarySize || (!ascii && size > binarySize)))
+    {
+        coordinates.resize(9*(size_t)numberOfTriangles);
+        spvSTLTriangles triangles;
+        triangles.data = &buffer[84];
+        triangles.coordinates = coordinates.empty() ? NULL : &coordinates[0];
+        ShapePopulationParallel::For(numberOfTriangles, s_recordGrain, spvSTLTrianglesBlock, &triangles);
+    }
+    else if(ascii)
+    {
+        // The lines of the vertices, after their keyword
+        std::vector<size_t> lines;
+        for(size_t position = 0; position < size; position = spvNextLine(buffer, position))
+        {
+            const char * line = spvSkipSpaces(&buffer[position]);
+            if(strncmp(line, "vertex", 6) == 0) lines.push_back(line + 6 - &buffer[0]);
+        }
+        if(lines.size() % 3 != 0) return NULL;
+        coordinates.resize(3*lines.size());
+        std::vector<spvOutput> outputs;
+        for(int k = 0; k < 3; k++) outputs.push_back(spvCreateOutput(coordinates.empty() ? NULL : &coordinates[k], 3));
+        if(!spvParseLines(buffer, lines, outputs)) return NULL;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    std::vector<vtkIdType> polys;
+    vtkSmartPointer<vtkFloatArray> points = spvMergeVertices(coordinates, polys);
+    if(points == NULL) return NULL;
+    return CreatePolyData(points, polys, polys.size()/4);
+}
+
+bool ShapePopulationSurfaceFormats::IsSTL(const char * a_bytes, size_t a_size)
+{
+    return spvStartsWith(a_bytes, a_size, "solid");
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                              OFF                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+// OFF, and its variants with texture coordinates, colours or normals after the coordinates of the vertices
+static bool spvIsOFFKeyword(std::string a_keyword)
+{
+    if(a_keyword.size() < 3 || a_keyword.compare(a_keyword.size() - 3, 3, "OFF") != 0) return false;
+    return (a_keyword.find_first_not_of("STCN") == a_keyword.size() - 3);
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationSurfaceFormats::ReadOFF(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("ReadOFF");
+    std::vector<char> buffer;
+    if(!ReadFile(a_filePath, buffer)) return NULL;
+
+    // Keyword, then the numbers of vertices and faces, on the same line or the next one
+    size_t position = 0;
+    std::vector<size_t> lines;
+    if(!spvFindLines(buffer, position, 1, lines)) return NULL;
+    std::istringstream header(std::string(&buffer[lines[0]], position - lines[0]));
+    std::string keyword;
+    header >> keyword;
+    if(!spvIsOFFKeyword(keyword)) return NULL;
+    vtkIdType numberOfVertices = -1;
+    vtkIdType numberOfFaces = -1;
+    if(!(header >> numberOfVertices >> numberOfFaces))
+    {
+        header.clear();
+        std::string binary;
+        if(header >> binary && binary == "BINARY") return NULL;
+        if(!spvFindLines(buffer, position, 1, lines)) return NULL;
+        std::istringstream counts(std::string(&buffer[lines[0]], position - lines[0]));
+        counts >> numberOfVertices >> numberOfFaces;
+    }
+    if(numberOfVertices <= 0 || numberOfFaces < 0) return NULL;
+    if(!spvHasRecords(buffer, position, numberOfVertices, 1) || !spvHasRecords(buffer, position, numberOfFaces, 1)) return NULL;
+
+    vtkSmartPointer<vtkFloatArray> points = spvCreatePoints(numberOfVertices);
+    if(!spvFindLines(buffer, position, numberOfVertices, lines) || !spvParseLines(buffer, lines, spvPointsOutputs(points))) return NULL;
+
+    // Faces : the number of vertices, their ids, then maybe a colour
+    std::vector<vtkIdType> polys;
+    if(!spvFindLines(buffer, position, numberOfFaces, lines)) return NULL;
+    polys.reserve(4*lines.size());
+    for(vtkIdType f = 0; f < numberOfFaces; f++)
+    {
+        const char * line = &buffer[lines[f]];
+        vtkIdType size;
+        if(!spvReadInteger(line, size) || size < 1) return NULL;
+        polys.push_back(size);
+        for(vtkIdType j = 0; j < size; j++)
+        {
+            vtkIdType id;
+            if(!spvReadInteger(line, id)) return NULL;
+            polys.push_back(id);
+        }
+    }
+    return CreatePolyData(points, polys, numberOfFaces);
+}
+
+bool ShapePopulationSurfaceFormats::IsOFF(const char * a_bytes, size_t a_size)
+{
+    // The first line that is not a comment
+    std::istringstream stream(std::string(a_bytes, a_size));
+    std::string line;
+    while(std::getline(stream, line) && spvIsBlank(line.c_str())) {}
+    std::istringstream header(line);
+    std::string keyword;
+    header >> keyword;
+    return spvIsOFFKeyword(keyword);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                              OBJ                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+vtkSmartPointer<vtkPolyData> ShapePopulationSurfaceFormats::ReadOBJ(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("ReadOBJ");
+    std::vector<char> buffer;
+    if(!ReadFile(a_filePath, buffer)) return NULL;
+    size_t size = buffer.size() - 1;
+
+    // Vertices parsed later, faces now : their negative ids count back from the last vertex
+    std::vector<size_t> lines;
+    std::vector<vtkIdType> polys;
+    vtkIdType numberOfFaces = 0;
+    for(size_t position = 0; position < size; position = spvNextLine(buffer, position))
+    {
+        const char * line = spvSkipSpaces(&buffer[position]);
+        if(line[0] == 'v' && (line[1] == ' ' || line[1] == '\t'))
+        {
+            lines.push_back(line + 1 - &buffer[0]);
+        }
+        else if(line[0] == 'f' && (line[1] == ' ' || line[1] == '\t'))
+        {
+            size_t face = polys.size();
+            polys.push_back(0);
+            line++;
+            vtkIdType id;
+            while(spvReadInteger(line, id))
+            {
+                polys.push_back((id < 0) ? (vtkIdType)lines.size() + id : id - 1);
+                polys[face]++;
+                while(*line != ' ' && *line != '\t' && *line != '\r' && *line != '\n' && *line != '\0') line++;   // "/texture/normal"
+            }
+            if(polys[face] == 0) return NULL;
+            numberOfFaces++;
+        }
+    }
+
+    vtkSmartPointer<vtkFloatArray> points = spvCreatePoints(lines.size());
+    if(!spvParseLines(buffer, lines, spvPointsOutputs(points))) return NULL;
+    return CreatePolyData(points, polys, numberOfFaces);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             GIFTI                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+struct spvGIfTIArray
+{
+    std::map<std::string, std::string> attributes;
+    std::string name;                                                   // from the meta data
+    const char * data;                                                  // text of the Data element
+    const char * dataEnd;
+    vtkSmartPointer<vtkDataArray> array;                                // NULL if it couldn't be decoded
+};
+
+// Attributes of a start tag
+static std::map<std::string, std::string> spvXMLAttributes(const char * a_begin, const char * a_end)
+{
+    std::map<std::string, std::string> attributes;
+    const char * position = a_begin;
+    while(position < a_end)
+    {
+        const char * equal = std::find(position, a_end, '=');
+        const char * quote = equal + 1;
+        while(quote < a_end && (*quote == ' ' || *quote == '\t' || *quote == '\r' || *quote == '\n')) quote++;
+        if(equal == a_end || quote >= a_end || (*quote != '"' && *quote != '\'')) break;
+        const char * close = std::find(quote + 1, a_end, *quote);
+        if(close == a_end) break;
+
+        const char * nameEnd = equal;
+        while(nameEnd > position && isspace(nameEnd[-1])) nameEnd--;
+        const char * nameBegin = nameEnd;
+        while(nameBegin > position && !isspace(nameBegin[-1])) nameBegin--;
+        attributes[std::string(nameBegin, nameEnd)] = std::string(quote + 1, close);
+        position = close + 1;
+    }
+    return attributes;
+}
+
+// Text of an element, out of its CDATA section
+static std::string spvXMLText(const char * a_begin, const char * a_end)
+{
+    std::string text(a_begin, a_end);
+    size_t cdata = text.find("<![CDATA[");
+    if(cdata != std::string::npos)
+    {
+        size_t end = text.find("]]>", cdata);
+        text = text.substr(cdata + 9, (end == std::string::npos) ? std::string::npos : end - cdata - 9);
+    }
+    size_t first = text.find_first_not_of(" \t\r\n");
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return (first == std::string::npos) ? "" : text.substr(first, last - first + 1);
+}
+
+static std::string spvXMLElementText(const char * a_begin, const char * a_end, const char * a_name)
+{
+    std::string start = std::string("<") + a_name + ">";
+    std::string end = std::string("</") + a_name + ">";
+    const char * text = spvFind(a_begin, a_end, start.c_str());
+    if(text == a_end) return "";
+    text += start.size();
+    return spvXMLText(text, spvFind(text, a_end, end.c_str()));
+}
+
+static int spvBase64Value(char a_character)
+{
+    if(a_character >= 'A' && a_character <= 'Z') return a_character - 'A';
+    if(a_character >= 'a' && a_character <= 'z') return a_character - 'a' + 26;
+    if(a_character >= '0' && a_character <= '9') return a_character - '0' + 52;
+    if(a_character == '+') return 62;
+    if(a_character == '/') return 63;
+    return -1;
+}
+
+// Whitespace skipped. The number of decoded bytes, a_outputSize + 1 if there are more
+static size_t spvDecodeBase64(const char * a_begin, const char * a_end, unsigned char * a_output, size_t a_outputSize)
+{
+    unsigned int bits = 0;
+    int numberOfBits = 0;
+    size_t size = 0;
+    for(const char * position = a_begin; position < a_end && *position != '='; position++)
+    {
+        int value = spvBase64Value(*position);
+        if(value < 0)
+        {
+            if(isspace(*position)) continue;
+            break;
+        }
+        bits = (bits << 6) | (unsigned int)value;
+        numberOfBits += 6;
+        if(numberOfBits < 8) continue;
+        numberOfBits -= 8;
+        if(size == a_outputSize) return a_outputSize + 1;
+        a_output[size++] = (unsigned char)((bits >> numberOfBits) & 0xFF);
+    }
+    return size;
+}
+
+template <class T>
+static bool spvParseValues(const char * a_begin, const char * a_end, T * a_values, vtkIdType a_size)
+{
+    const char * position = a_begin;
+    for(vtkIdType i = 0; i < a_size; i++)
+    {
+        char * end;
+        double value = strtod(position, &end);
+        if(end == position || end > a_end) return false;
+        a_values[i] = static_cast<T>(value);
+        position = end;
+    }
+    return true;
+}
+
+static void spvDecodeGIfTIArray(spvGIfTIArray &a_array)
+{
+    std::map<std::string, std::string> &attributes = a_array.attributes;
+    const char * names[9] = {"NIFTI_TYPE_UINT8", "NIFTI_TYPE_INT8", "NIFTI_TYPE_INT16", "NIFTI_TYPE_UINT16", "NIFTI_TYPE_INT32",
+                             "NIFTI_TYPE_UINT32", "NIFTI_TYPE_INT64", "NIFTI_TYPE_FLOAT32", "NIFTI_TYPE_FLOAT64"};
+    const int types[9] = {VTK_UNSIGNED_CHAR, VTK_SIGNED_CHAR, VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_INT,
+                          VTK_UNSIGNED_INT, VTK_TYPE_INT64, VTK_FLOAT, VTK_DOUBLE};
+    int type = VTK_VOID;
+    for(int k = 0; k < 9; k++)
+    {
+        if(attributes["DataType"] == names[k]) type = types[k];
+    }
+    int dimensionality = atoi(attributes["Dimensionality"].c_str());
+    vtkIdType numberOfTuples = atol(attributes["Dim0"].c_str());
+    int numberOfComponents = (dimensionality == 2) ? atoi(attributes["Dim1"].c_str()) : 1;
+    if(type == VTK_VOID || dimensionality < 1 || dimensionality > 2 || numberOfTuples <= 0 || numberOfComponents <= 0) return;
+
+    // The dimensions are bounded by the data before the array is allocated : a value takes a character at least,
+    // and zlib does not compress more than 1032 times
+    std::string encoding = attributes["Encoding"];
+    size_t dataSize = a_array.dataEnd - a_array.data;
+    size_t maximumValues = (encoding == "GZipBase64Binary") ? 1032*dataSize : dataSize;
+    if((size_t)numberOfTuples > maximumValues/numberOfComponents) return;
+
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(type));
+    if(array == NULL) return;
+    array->SetNumberOfComponents(numberOfComponents);
+    array->SetNumberOfTuples(numberOfTuples);
+    vtkIdType numberOfValues = numberOfTuples*numberOfComponents;
+    int valueSize = array->GetDataTypeSize();
+    size_t numberOfBytes = (size_t)numberOfValues*valueSize;
+    unsigned char * values = static_cast<unsigned char *>(array->GetVoidPointer(0));
+
+    if(encoding == "ASCII")
+    {
+        bool valid = false;
+        switch(type)
+        {
+            vtkTemplateMacro(valid = spvParseValues(a_array.data, a_array.dataEnd, static_cast<VTK_TT *>(array->GetVoidPointer(0)), numberOfValues));
+        }
+        if(!valid) return;
+    }
+    else if(encoding == "Base64Binary")
+    {
+        if(spvDecodeBase64(a_array.data, a_array.dataEnd, values, numberOfBytes) != numberOfBytes) return;
+    }
+    else if(encoding == "GZipBase64Binary")
+    {
+        std::vector<unsigned char> compressed((a_array.dataEnd - a_array.data)*3/4 + 3);
+        compressed.resize(spvDecodeBase64(a_array.data, a_array.dataEnd, &compressed[0], compressed.size()));
+        vtkSmartPointer<vtkZLibDataCompressor> compressor = vtkSmartPointer<vtkZLibDataCompressor>::New();
+        if(compressed.empty() || compressor->Uncompress(&compressed[0], compressed.size(), values, numberOfBytes) != numberOfBytes) return;
+    }
+    else
+    {
+        return;                                                         // external files
+    }
+
+    // Byte order and order of the values of the binary encodings
+    bool swap = (encoding != "ASCII" && attributes["Endian"] == (s_bigEndian ? "LittleEndian" : "BigEndian"));
+    if(swap && valueSize > 1)
+    {
+        for(size_t i = 0; i < numberOfBytes; i += valueSize) std::reverse(values + i, values + i + valueSize);
+    }
+    if(attributes["ArrayIndexingOrder"] == "ColumnMajorOrder" && numberOfComponents > 1)
+    {
+        std::vector<unsigned char> columns(values, values + numberOfBytes);
+        for(vtkIdType i = 0; i < numberOfTuples; i++)
+        {
+            for(int k = 0; k < numberOfComponents; k++)
+            {
+                memcpy(values + (i*numberOfComponents + k)*valueSize, &columns[(k*numberOfTuples + i)*valueSize], valueSize);
+            }
+        }
+    }
+    a_array.array = array;
+}
+
+static void spvDecodeGIfTIBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    std::vector<spvGIfTIArray> &arrays = *static_cast<std::vector<spvGIfTIArray> *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++) spvDecodeGIfTIArray(arrays[i]);
+}
+
+template <class T>
+static void spvCopyTriangles(const T * a_values, vtkIdType a_numberOfTriangles, std::vector<vtkIdType> &a_polys)
+{
+    a_polys.resize(4*(size_t)a_numberOfTriangles);
+    for(vtkIdType t = 0; t < a_numberOfTriangles; t++)
+    {
+        a_polys[4*t] = 3;
+        for(int k = 0; k < 3; k++) a_polys[4*t + 1 + k] = static_cast<vtkIdType>(a_values[3*t + k]);
+    }
+}
+
+vtkSmartPointer<vtkPolyData> ShapePopulationSurfaceFormats::ReadGIfTI(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("ReadGIfTI");
+    std::vector<char> buffer;
+    if(!ReadFile(a_filePath, buffer)) return NULL;
+    const char * begin = &buffer[0];
+    const char * end = begin + buffer.size() - 1;
+    if(spvFind(begin, end, "<GIFTI") == end) return NULL;
+
+    // The data arrays, decoded each by a thread
+    std::vector<spvGIfTIArray> arrays;
+    for(const char * position = spvFind(begin, end, "<DataArray"); position != end; position = spvFind(position, end, "<DataArray"))
+    {
+        const char * tagEnd = std::find(position, end, '>');
+        const char * arrayEnd = spvFind(tagEnd, end, "</DataArray>");
+        if(tagEnd == end || arrayEnd == end) return NULL;
+        spvGIfTIArray array;
+        array.attributes = spvXMLAttributes(position + 10, tagEnd);
+        array.data = spvFind(tagEnd, arrayEnd, "<Data>");
+        array.data = (array.data == arrayEnd) ? arrayEnd : array.data + 6;
+        array.dataEnd = spvFind(array.data, arrayEnd, "</Data>");
+
+        // <MD><Name>Name</Name><Value>thickness</Value></MD>
+        for(const char * metaData = spvFind(tagEnd, array.data, "<MD>"); metaData != array.data; metaData = spvFind(metaData + 4, array.data, "<MD>"))
+        {
+            const char * metaDataEnd = spvFind(metaData, array.data, "</MD>");
+            if(spvXMLElementText(metaData, metaDataEnd, "Name") == "Name") array.name = spvXMLElementText(metaData, metaDataEnd, "Value");
+        }
+        arrays.push_back(array);
+        position = arrayEnd;
+    }
+    ShapePopulationParallel::For(arrays.size(), 1, spvDecodeGIfTIBlock, &arrays);
+
+    vtkSmartPointer<vtkDataArray> points;
+    std::vector<vtkIdType> polys;
+    vtkIdType numberOfPolys = 0;
+    for(unsigned int i = 0; i < arrays.size(); i++)
+    {
+        vtkDataArray * array = arrays[i].array;
+        if(array == NULL) return NULL;
+        std::string intent = arrays[i].attributes["Intent"];
+        if(intent == "NIFTI_INTENT_POINTSET" && points == NULL)
+        {
+            points = array;
+        }
+        else if(intent == "NIFTI_INTENT_TRIANGLE" && numberOfPolys == 0)
+        {
+            if(array->GetNumberOfComponents() != 3) return NULL;
+            numberOfPolys = array->GetNumberOfTuples();
+            switch(array->GetDataType())
+            {
+                vtkTemplateMacro(spvCopyTriangles(static_cast<VTK_TT *>(array->GetVoidPointer(0)), numberOfPolys, polys));
+            }
+        }
+    }
+
+    vtkSmartPointer<vtkPolyData> polyData = CreatePolyData(points, polys, numberOfPolys);
+    if(polyData == NULL) return NULL;
+
+    // The other arrays of the vertices, named by their meta data or their intent
+    for(unsigned int i = 0; i < arrays.size(); i++)
+    {
+        vtkDataArray * array = arrays[i].array;
+        std::string intent = arrays[i].attributes["Intent"];
+        if(intent == "NIFTI_INTENT_POINTSET" || intent == "NIFTI_INTENT_TRIANGLE") continue;
+        if(array->GetNumberOfTuples() != points->GetNumberOfTuples()) continue;
+        std::string name = arrays[i].name;
+        if(name.empty())
+        {
+            std::ostringstream intentName;
+            intentName << ((intent.find("NIFTI_INTENT_") == 0) ? intent.substr(13) : "Array") << "_" << i;
+            name = intentName.str();
+        }
+        array->SetName(name.c_str());
+        polyData->GetPointData()->AddArray(array);
+    }
+    return polyData;
+}
+
+bool ShapePopulationSurfaceFormats::IsGIfTI(const char * a_bytes, size_t a_size)
+{
+    return (std::string(a_bytes, a_size).find("<GIFTI") != std::string::npos);
+}
@@ -0,0 +1,49 @@
+#ifndef SHAPEPOPULATIONSURFACEFORMATS_H
+#define SHAPEPOPULATIONSURFACEFORMATS_H
+
+#include <vtkVersion.h>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkFloatArray.h>
+#include <vtkZLibDataCompressor.h>
+
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+
+// Native readers of the surface formats of other tools : PLY (ascii and binary), STL (ascii and binary),
+// OFF, OBJ and GIfTI (ascii, base64 and gzip base64). The whole file is read at once, then the vertices
+// are decoded in parallel : binary records of a fixed size, or ascii lines once their starts are known.
+// Faces are read in order, into the legacy layout of vtkCellArray. The vertex properties of PLY files and
+// the per-vertex arrays of GIfTI files are loaded as point attributes.
+// All the functions are thread safe and return NULL when the file can't be read.
+class ShapePopulationSurfaceFormats
+{
+    public :
+
+    static vtkSmartPointer<vtkPolyData> ReadPLY(std::string a_filePath);
+    static vtkSmartPointer<vtkPolyData> ReadSTL(std::string a_filePath);
+    static vtkSmartPointer<vtkPolyData> ReadOFF(std::string a_filePath);
+    static vtkSmartPointer<vtkPolyData> ReadOBJ(std::string a_filePath);
+    static vtkSmartPointer<vtkPolyData> ReadGIfTI(std::string a_filePath);
+
+    // First bytes of a file. OBJ files have no signature, binary STL files none either
+    static bool IsPLY(const char * a_bytes, size_t a_size);
+    static bool IsSTL(const char * a_bytes, size_t a_size);
+    static bool IsOFF(const char * a_bytes, size_t a_size);
+    static bool IsGIfTI(const char * a_bytes, size_t a_size);
+
+    protected :
+
+    static bool ReadFile(std::string a_filePath, std::vector<char> &a_buffer);   // ends with a '\0'
+    static vtkSmartPointer<vtkPolyData> CreatePolyData(vtkDataArray * a_points, const std::vector<vtkIdType> &a_polys, vtkIdType a_numberOfPolys);   // checks the faces
+};
+
+
+#endif
@@ -0,0 +1,286 @@
+#include "ShapePopulationTimeSeries.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/Directory.hxx>
+
+#include <algorithm>
+#include <cstdlib>
+
+// Default number of steps decoded ahead
+static const unsigned int s_bufferSize = 4;
+
+struct TimeSeriesReads
+{
+    std::vector<std::string> * filePaths;
+    std::vector<ShapePopulationData *> * frames;
+};
+
+
+ShapePopulationTimeSeries::ShapePopulationTimeSeries()
+{
+    m_NumberOfSteps = 0;
+    m_BufferSize = s_bufferSize;
+    m_Tick = 0;
+    m_CancelPrefetch = false;
+}
+
+ShapePopulationTimeSeries::~ShapePopulationTimeSeries()
+{
+    this->Clear();
+}
+
+std::vector<std::string> ShapePopulationTimeSeries::FindTimepoints(std::string a_filePath)
+{
+    std::vector<std::string> timepoints(1, a_filePath);
+    std::string directory = vtksys::SystemTools::GetFilenamePath(a_filePath);
+    std::string name = vtksys::SystemTools::GetFilenameName(a_filePath);
+
+    // Last number of the name : subject_t2_aligned.vtk -> subject_t, 2, _aligned.vtk
+    size_t end = name.find_last_of("0123456789");
+    if(end == std::string::npos) return timepoints;
+    size_t begin = name.find_last_not_of("0123456789", end);
+    begin = (begin == std::string::npos) ? 0 : begin + 1;
+    std::string prefix = name.substr(0, begin);
+    std::string suffix = name.substr(end + 1);
+
+    vtksys::Directory files;
+    if(!files.Load(directory.empty() ? "." : directory.c_str())) return timepoints;
+
+    std::vector< std::pair<unsigned long, std::string> > numberedFiles;
+    for(unsigned long i = 0; i < files.GetNumberOfFiles(); i++)
+    {
+        std::string fileName = files.GetFile(i);
+        if(fileName.size() <= prefix.size() + suffix.size()) continue;
+        if(fileName.compare(0, prefix.size(), prefix) != 0) continue;
+        if(fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) != 0) continue;
+
+        std::string number = fileName.substr(prefix.size(), fileName.size() - prefix.size() - suffix.size());
+        if(number.find_first_not_of("0123456789") != std::string::npos) continue;
+        numberedFiles.push_back(std::make_pair(strtoul(number.c_str(), NULL, 10), fileName));
+    }
+    if(numberedFiles.empty()) return timepoints;
+    std::sort(numberedFiles.begin(), numberedFiles.end());
+
+    timepoints.clear();
+    for(unsigned int i = 0; i < numberedFiles.size(); i++)
+    {
+        timepoints.push_back(directory.empty() ? numberedFiles[i].second : directory + "/" + numberedFiles[i].second);
+    }
+    return timepoints;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             TRACKS                                            * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationTimeSeries::SetTracks(std::vector< std::vector<std::string> > a_tracks)
+{
+    m_Lock.Lock();
+    this->ClearBuffer();
+    m_Tracks = a_tracks;
+    m_NumberOfSteps = 0;
+    for(unsigned int i = 0; i < m_Tracks.size(); i++)
+    {
+        if(m_Tracks[i].size() > m_NumberOfSteps) m_NumberOfSteps = m_Tracks[i].size();
+    }
+    Slot empty = {-1, NULL};
+    m_Buffer.assign(m_Tracks.size(), std::vector<Slot>(m_BufferSize, empty));
+    m_Tick = 0;
+    m_Lock.Unlock();
+}
+
+unsigned int ShapePopulationTimeSeries::GetNumberOfTimepoints(unsigned int a_track)
+{
+    if(a_track >= m_Tracks.size()) return 0;
+    return m_Tracks[a_track].size();
+}
+
+std::string ShapePopulationTimeSeries::GetTimepoint(unsigned int a_track, unsigned int a_step)
+{
+    return this->GetTickTimepoint(a_track, (long)a_step);
+}
+
+std::string ShapePopulationTimeSeries::GetTickTimepoint(unsigned int a_track, long a_tick)
+{
+    if(a_track >= m_Tracks.size() || m_Tracks[a_track].empty() || m_NumberOfSteps == 0) return "";
+    unsigned int step = a_tick % m_NumberOfSteps;
+    if(step >= m_Tracks[a_track].size()) step = m_Tracks[a_track].size() - 1;
+    return m_Tracks[a_track][step];
+}
+
+void ShapePopulationTimeSeries::SetBufferSize(unsigned int a_numberOfSteps)
+{
+    m_Lock.Lock();
+    this->ClearBuffer();
+    m_BufferSize = (a_numberOfSteps > 0) ? a_numberOfSteps : 1;
+    Slot empty = {-1, NULL};
+    m_Buffer.assign(m_Tracks.size(), std::vector<Slot>(m_BufferSize, empty));
+    m_Lock.Unlock();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            PLAYBACK                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+unsigned int ShapePopulationTimeSeries::GetCurrentStep()
+{
+    m_Lock.Lock();
+    unsigned int step = (m_NumberOfSteps == 0) ? 0 : m_Tick % m_NumberOfSteps;
+    m_Lock.Unlock();
+    return step;
+}
+
+ShapePopulationData * ShapePopulationTimeSeries::GetFrame(unsigned int a_track)
+{
+    m_Lock.Lock();
+    ShapePopulationData * frame = NULL;
+    if(a_track < m_Buffer.size())
+    {
+        Slot &slot = m_Buffer[a_track][m_Tick % m_BufferSize];
+        if(slot.tick == m_Tick) frame = slot.frame;
+    }
+    m_Lock.Unlock();
+    return frame;
+}
+
+bool ShapePopulationTimeSeries::IsStepReady()
+{
+    m_Lock.Lock();
+    bool ready = true;
+    for(unsigned int i = 0; i < m_Buffer.size() && ready; i++)
+    {
+        ready = (m_Buffer[i][m_Tick % m_BufferSize].tick == m_Tick);
+    }
+    m_Lock.Unlock();
+    return ready;
+}
+
+unsigned int ShapePopulationTimeSeries::GetNumberOfBufferedFrames()
+{
+    m_Lock.Lock();
+    unsigned int numberOfFrames = 0;
+    for(unsigned int i = 0; i < m_Buffer.size(); i++)
+    {
+        for(unsigned int j = 0; j < m_BufferSize; j++)
+        {
+            if(m_Buffer[i][j].tick >= m_Tick && m_Buffer[i][j].frame != NULL) numberOfFrames++;
+        }
+    }
+    m_Lock.Unlock();
+    return numberOfFrames;
+}
+
+void ShapePopulationTimeSeries::Advance()
+{
+    m_Lock.Lock();
+    for(unsigned int i = 0; i < m_Buffer.size(); i++)
+    {
+        // The arrays swapped into the displayed mesh are shared, they stay alive with it
+        Slot &slot = m_Buffer[i][m_Tick % m_BufferSize];
+        delete slot.frame;
+        slot.frame = NULL;
+        slot.tick = -1;
+    }
+    m_Tick++;
+    m_Lock.Unlock();
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            PREFETCH                                           * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+void ShapePopulationTimeSeries::ReadBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    TimeSeriesReads * reads = static_cast<TimeSeriesReads *>(a_data);
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        ShapePopulationData * frame = new ShapePopulationData;
+        frame->ReadMesh((*reads->filePaths)[i]);
+        if(frame->GetPolyData() == NULL)
+        {
+            delete frame;
+            frame = NULL;
+        }
+        (*reads->frames)[i] = frame;
+    }
+}
+
+void ShapePopulationTimeSeries::Prefetch()
+{
+    SPV_PROFILE_SCOPE("PrefetchTimepoints");
+    m_CancelPrefetch = false;
+    for(unsigned int k = 0; k < m_BufferSize && !m_CancelPrefetch; k++)
+    {
+        // Tracks missing the frame of the step, the tracks staying on the same file don't read it again
+        m_Lock.Lock();
+        long tick = m_Tick + k;
+        std::vector<unsigned int> tracks;
+        std::vector<std::string> filePaths;
+        for(unsigned int i = 0; i < m_Buffer.size(); i++)
+        {
+            Slot &slot = m_Buffer[i][tick % m_BufferSize];
+            if(slot.tick == tick) continue;
+
+            std::string filePath = this->GetTickTimepoint(i, tick);
+            if(filePath.empty() || (tick > 0 && filePath == this->GetTickTimepoint(i, tick - 1)))
+            {
+                slot.tick = tick;
+                slot.frame = NULL;
+                continue;
+            }
+            tracks.push_back(i);
+            filePaths.push_back(filePath);
+        }
+        m_Lock.Unlock();
+        if(tracks.empty()) continue;
+
+        // Files read outside of the lock
+        std::vector<ShapePopulationData *> frames(filePaths.size(), (ShapePopulationData *)NULL);
+        TimeSeriesReads reads;
+        reads.filePaths = &filePaths;
+        reads.frames = &frames;
+        ShapePopulationParallel::For(filePaths.size(), 1, ReadBlock, &reads);
+
+        m_Lock.Lock();
+        for(unsigned int j = 0; j < tracks.size(); j++)
+        {
+            Slot &slot = m_Buffer[tracks[j]][tick % m_BufferSize];
+            if(tick < m_Tick || slot.tick == tick)
+            {
+                delete frames[j];
+                continue;
+            }
+            slot.tick = tick;
+            slot.frame = frames[j];
+        }
+        m_Lock.Unlock();
+        ShapePopulationProfiler::AddCount("PrefetchedTimepoints", frames.size());
+    }
+}
+
+void ShapePopulationTimeSeries::ClearBuffer()
+{
+    for(unsigned int i = 0; i < m_Buffer.size(); i++)
+    {
+        for(unsigned int j = 0; j < m_Buffer[i].size(); j++)
+        {
+            delete m_Buffer[i][j].frame;
+            m_Buffer[i][j].frame = NULL;
+            m_Buffer[i][j].tick = -1;
+        }
+    }
+}
+
+void ShapePopulationTimeSeries::Clear()
+{
+    m_Lock.Lock();
+    this->ClearBuffer();
+    m_Buffer.clear();
+    m_Tracks.clear();
+    m_NumberOfSteps = 0;
+    m_Tick = 0;
+    m_Lock.Unlock();
+}
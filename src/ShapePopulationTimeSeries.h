@@ -0,0 +1,74 @@
+#ifndef SHAPEPOPULATIONTIMESERIES_H
+#define SHAPEPOPULATIONTIMESERIES_H
+
+#include <vtkVersion.h>
+#include <vtkMutexLock.h>
+
+#include "ShapePopulationData.h"
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+
+// Playback of longitudinal meshes : every tile has a track, the timepoints of its subject (files of the
+// same directory numbered differently). The frames decoded ahead of the one displayed are kept in a ring
+// buffer of a fixed number of steps per track. A prefetcher can fill the buffer in a worker thread, reading
+// the tracks in parallel, while the GUI thread takes the frames of the current step and moves to the next one.
+// Tracks shorter than the longest one stay on their last timepoint, the playback loops.
+class ShapePopulationTimeSeries
+{
+    public :
+
+    ShapePopulationTimeSeries();
+    ~ShapePopulationTimeSeries();
+
+    // Files of the directory of a_filePath differing only by the last number of its name, in the order of
+    // the numbers (a_filePath alone if its name has no number)
+    static std::vector<std::string> FindTimepoints(std::string a_filePath);
+
+    // TRACKS
+    void SetTracks(std::vector< std::vector<std::string> > a_tracks);      // restarts at the first step
+    unsigned int GetNumberOfTracks() {return m_Tracks.size();}
+    unsigned int GetNumberOfTimepoints(unsigned int a_track);
+    unsigned int GetNumberOfSteps() {return m_NumberOfSteps;}
+    std::string GetTimepoint(unsigned int a_track, unsigned int a_step);
+    void SetBufferSize(unsigned int a_numberOfSteps);
+    unsigned int GetBufferSize() {return m_BufferSize;}
+
+    // PLAYBACK
+    unsigned int GetCurrentStep();
+    // Frame of the current step, NULL if the track keeps the timepoint displayed (same file or unreadable one)
+    ShapePopulationData * GetFrame(unsigned int a_track);
+    bool IsStepReady();                                                 // frames of the current step all decoded, GetFrame is valid
+    unsigned int GetNumberOfBufferedFrames();
+    void Advance();                                                     // next step, the frames of the current one are deleted
+
+    // Worker : decodes the frames of the buffer, from the current step, until it is full or CancelPrefetch is called
+    void Prefetch();
+    void CancelPrefetch() {m_CancelPrefetch = true;}
+    void Clear();
+
+    protected :
+
+    struct Slot
+    {
+        long tick;                                                      // step of the playback which the slot holds, -1 : empty
+        ShapePopulationData * frame;                                    // NULL : the timepoint of the previous step is kept
+    };
+
+    vtkSimpleMutexLock m_Lock;
+    std::vector< std::vector<std::string> > m_Tracks;
+    std::vector< std::vector<Slot> > m_Buffer;                          // m_BufferSize slots per track, slot of a tick : tick % m_BufferSize
+    unsigned int m_NumberOfSteps;
+    unsigned int m_BufferSize;
+    long m_Tick;                                                        // steps played since SetTracks
+    volatile bool m_CancelPrefetch;
+
+    std::string GetTickTimepoint(unsigned int a_track, long a_tick);
+    void ClearBuffer();
+    static void ReadBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
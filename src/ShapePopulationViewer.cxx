@@ -65,7 +65,7 @@ int main( int argc, char** argv )
         {
             QString QFilePath(vtkFiles[i].c_str());
             QFileInfo vtkFileInfo(QFilePath);
-            if (!QFilePath.endsWith(".vtk") && !QFilePath.endsWith(".vtp")) wrongFileFormat(vtkFiles[i],"vtk/vtp", &window);         // Control the files format
+            if (!ShapePopulationReaders::IsSupported(vtkFiles[i])) wrongFileFormat(vtkFiles[i],ShapePopulationReaders::GetFormatList(), &window);   // Control the files format
             else if(!vtkFileInfo.exists()) fileDoesNotExist(vtkFiles[i], &window);                  // Control that the file exists
             else
             {
@@ -101,6 +101,14 @@ int main( int argc, char** argv )
             checkConfigurationFiles(cameraConfig, colormapConfig, &window);
         }
     }
+    if(!sessionFile.empty())
+    {
+        QString QFilePath(sessionFile.c_str());
+        QFileInfo sessionFileInfo(QFilePath);
+        if (!QFilePath.endsWith(".spvs")) wrongFileFormat(sessionFile,"spvs", &window);          // Control the files format
+        else if(!sessionFileInfo.exists()) fileDoesNotExist(sessionFile, &window);            // Control that the file exists
+        else window.loadSessionCLP(sessionFile);
+    }
     return app.exec();
 
     return 0;
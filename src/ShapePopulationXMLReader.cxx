@@ -0,0 +1,378 @@
+#include "ShapePopulationXMLReader.h"
+
+#include <fstream>
+#include <sstream>
+#include <string.h>
+
+static const vtkIdType s_blockGrain = 8;                                // zlib blocks of 32 KB by default
+static const vtkIdType s_cellGrain = 16384;
+
+static vtkIdType spvIdTypeAttribute(vtkXMLDataElement * a_element, const char * a_name)
+{
+    const char * value = (a_element != NULL) ? a_element->GetAttribute(a_name) : NULL;
+    if(value == NULL) return 0;
+    vtkIdType result = 0;
+    std::istringstream(value) >> result;
+    return result;
+}
+
+static bool spvHasAttribute(vtkXMLDataElement * a_element, const char * a_name, const char * a_value)
+{
+    const char * value = a_element->GetAttribute(a_name);
+    return (value != NULL && strcmp(value, a_value) == 0);
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             READ                                              * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+vtkSmartPointer<vtkPolyData> ShapePopulationXMLReader::Read(std::string a_filePath)
+{
+    SPV_PROFILE_SCOPE("ReadXMLAppended");
+    m_ErrorMessage.clear();
+    m_AppendedData.clear();
+    m_Blocks.clear();
+
+    std::ifstream file(a_filePath.c_str(), std::ios::in | std::ios::binary);
+    if(!file.is_open())
+    {
+        m_ErrorMessage = "Couldn't open " + a_filePath;
+        return NULL;
+    }
+
+    // XML header, the parser stops at the appended data
+    vtkSmartPointer<vtkXMLDataParser> parser = vtkSmartPointer<vtkXMLDataParser>::New();
+    parser->SetStream(&file);
+    if(!parser->Parse() || parser->GetRootElement() == NULL || parser->GetAppendedDataPosition() <= 0) return NULL;
+
+    vtkXMLDataElement * root = parser->GetRootElement();
+#ifdef VTK_WORDS_BIGENDIAN
+    const char * byteOrder = "BigEndian";
+#else
+    const char * byteOrder = "LittleEndian";
+#endif
+    if(!spvHasAttribute(root, "type", "PolyData") || !spvHasAttribute(root, "byte_order", byteOrder)) return NULL;
+    m_HeaderSize = 4;
+    if(root->GetAttribute("header_type") != NULL)
+    {
+        if(spvHasAttribute(root, "header_type", "UInt64")) m_HeaderSize = 8;
+        else if(!spvHasAttribute(root, "header_type", "UInt32")) return NULL;
+    }
+    m_Compressed = (root->GetAttribute("compressor") != NULL);
+    if(m_Compressed && !spvHasAttribute(root, "compressor", "vtkZLibDataCompressor")) return NULL;
+
+    vtkXMLDataElement * appended = root->FindNestedElementWithName("AppendedData");
+    vtkXMLDataElement * polyDataElement = root->FindNestedElementWithName("PolyData");
+    if(appended == NULL || !spvHasAttribute(appended, "encoding", "raw") || polyDataElement == NULL) return NULL;
+    if(polyDataElement->GetNumberOfNestedElements() != 1) return NULL;                 // one piece, no field data
+    vtkXMLDataElement * piece = polyDataElement->GetNestedElement(0);
+    if(strcmp(piece->GetName(), "Piece") != 0 || piece->FindNestedElementWithName("FieldData") != NULL) return NULL;
+
+    // The appended data in one read, its blocks are decoded in place
+    std::streamoff position = (std::streamoff)parser->GetAppendedDataPosition();
+    file.clear();
+    file.seekg(0, std::ios::end);
+    std::streamoff end = file.tellg();
+    if(end <= position) return NULL;
+    m_AppendedData.resize((size_t)(end - position));
+    file.seekg(position);
+    if(!file.read((char *)&m_AppendedData[0], m_AppendedData.size())) return NULL;
+
+    // Arrays, allocated to the sizes of their headers
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    vtkIdType numberOfPoints = spvIdTypeAttribute(piece, "NumberOfPoints");
+    const char * cellTypes[4] = {"Verts", "Lines", "Strips", "Polys"};
+    vtkIdType numberOfCells[4];
+    vtkIdType totalNumberOfCells = 0;
+    vtkSmartPointer<vtkDataArray> connectivity[4];
+    vtkSmartPointer<vtkDataArray> offsets[4];
+    for(int k = 0; k < 4; k++)
+    {
+        numberOfCells[k] = spvIdTypeAttribute(piece, (std::string("NumberOf") + cellTypes[k]).c_str());
+        totalNumberOfCells += numberOfCells[k];
+        if(numberOfCells[k] == 0) continue;
+        vtkXMLDataElement * cells = piece->FindNestedElementWithName(cellTypes[k]);
+        if(cells == NULL) return NULL;
+        for(int j = 0; j < cells->GetNumberOfNestedElements(); j++)
+        {
+            vtkXMLDataElement * element = cells->GetNestedElement(j);
+            if(spvHasAttribute(element, "Name", "connectivity")) connectivity[k] = this->ReadArray(element);
+            else if(spvHasAttribute(element, "Name", "offsets")) offsets[k] = this->ReadArray(element);
+        }
+        if(connectivity[k] == NULL || offsets[k] == NULL || offsets[k]->GetNumberOfTuples() != numberOfCells[k]) return NULL;
+    }
+
+    vtkXMLDataElement * pointsElement = piece->FindNestedElementWithName("Points");
+    if(numberOfPoints > 0)
+    {
+        if(pointsElement == NULL || pointsElement->GetNumberOfNestedElements() == 0) return NULL;
+        vtkSmartPointer<vtkDataArray> points = this->ReadArray(pointsElement->GetNestedElement(0));
+        if(points == NULL || points->GetNumberOfComponents() != 3 || points->GetNumberOfTuples() != numberOfPoints) return NULL;
+        polyData->SetPoints(vtkSmartPointer<vtkPoints>::New());
+        polyData->GetPoints()->SetData(points);
+    }
+    if(!this->ReadAttributes(piece->FindNestedElementWithName("PointData"), polyData->GetPointData(), numberOfPoints)) return NULL;
+    if(!this->ReadAttributes(piece->FindNestedElementWithName("CellData"), polyData->GetCellData(), totalNumberOfCells)) return NULL;
+
+    // Every block decoded by a thread, into the memory of its array
+    if(!m_Blocks.empty()) ShapePopulationParallel::For(m_Blocks.size(), s_blockGrain, DecompressBlock, this);
+    ShapePopulationProfiler::AddCount("XMLBlocks", m_Blocks.size());
+    for(unsigned int i = 0; i < m_Blocks.size(); i++)
+    {
+        if(m_Blocks[i].valid) continue;
+        m_ErrorMessage = "Couldn't decompress the data of " + a_filePath;
+        return NULL;
+    }
+    m_AppendedData.clear();
+
+    // Cells
+    for(int k = 0; k < 4; k++)
+    {
+        if(numberOfCells[k] == 0) continue;
+        vtkSmartPointer<vtkCellArray> cells = this->CreateCells(connectivity[k], offsets[k]);
+        if(cells == NULL)
+        {
+            m_ErrorMessage = std::string("Wrong ") + cellTypes[k] + " in " + a_filePath;
+            return NULL;
+        }
+        if(k == 0) polyData->SetVerts(cells);
+        else if(k == 1) polyData->SetLines(cells);
+        else if(k == 2) polyData->SetStrips(cells);
+        else polyData->SetPolys(cells);
+    }
+    return polyData;
+}
+
+bool ShapePopulationXMLReader::ReadAttributes(vtkXMLDataElement * a_element, vtkDataSetAttributes * a_attributes, vtkIdType a_numberOfTuples)
+{
+    if(a_element == NULL) return true;
+    for(int j = 0; j < a_element->GetNumberOfNestedElements(); j++)
+    {
+        vtkXMLDataElement * element = a_element->GetNestedElement(j);
+        if(strcmp(element->GetName(), "DataArray") != 0) return false;
+        vtkSmartPointer<vtkDataArray> array = this->ReadArray(element);
+        if(array == NULL || array->GetNumberOfTuples() != a_numberOfTuples) return false;
+        a_attributes->AddArray(array);
+    }
+
+    // Active attributes, as vtkXMLPolyDataReader sets them
+    const char * scalars = a_element->GetAttribute("Scalars");
+    const char * vectors = a_element->GetAttribute("Vectors");
+    const char * normals = a_element->GetAttribute("Normals");
+    const char * tensors = a_element->GetAttribute("Tensors");
+    const char * tcoords = a_element->GetAttribute("TCoords");
+    if(scalars != NULL) a_attributes->SetActiveScalars(scalars);
+    if(vectors != NULL) a_attributes->SetActiveVectors(vectors);
+    if(normals != NULL) a_attributes->SetActiveNormals(normals);
+    if(tensors != NULL) a_attributes->SetActiveTensors(tensors);
+    if(tcoords != NULL) a_attributes->SetActiveTCoords(tcoords);
+    return true;
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                            ARRAYS                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+int ShapePopulationXMLReader::GetDataType(const char * a_type)
+{
+    if(a_type == NULL) return VTK_VOID;
+    const char * names[10] = {"Float32", "Float64", "Int8", "UInt8", "Int16", "UInt16", "Int32", "UInt32", "Int64", "UInt64"};
+    const int types[10] = {VTK_FLOAT, VTK_DOUBLE, VTK_SIGNED_CHAR, VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_INT, VTK_UNSIGNED_INT, VTK_TYPE_INT64, VTK_TYPE_UINT64};
+    for(int k = 0; k < 10; k++)
+    {
+        if(strcmp(a_type, names[k]) == 0) return types[k];
+    }
+    return VTK_VOID;                                                    // strings, bits
+}
+
+bool ShapePopulationXMLReader::ReadHeader(size_t a_position, vtkTypeUInt64 &a_value)
+{
+    if(a_position + m_HeaderSize > m_AppendedData.size()) return false;
+    if(m_HeaderSize == 8)
+    {
+        vtkTypeUInt64 value;
+        memcpy(&value, &m_AppendedData[a_position], 8);
+        a_value = value;
+    }
+    else
+    {
+        vtkTypeUInt32 value;
+        memcpy(&value, &m_AppendedData[a_position], 4);
+        a_value = value;
+    }
+    return true;
+}
+
+vtkSmartPointer<vtkDataArray> ShapePopulationXMLReader::ReadArray(vtkXMLDataElement * a_element)
+{
+    if(!spvHasAttribute(a_element, "format", "appended") || a_element->GetAttribute("offset") == NULL) return NULL;
+    int type = GetDataType(a_element->GetAttribute("type"));
+    if(type == VTK_VOID) return NULL;
+    int numberOfComponents = 1;
+    a_element->GetScalarAttribute("NumberOfComponents", numberOfComponents);
+    if(numberOfComponents < 1) return NULL;
+    size_t position = 0;
+    std::istringstream(a_element->GetAttribute("offset")) >> position;
+
+    // Uncompressed : the number of bytes. Compressed : the number of blocks, the size of a block, the size
+    // of the last one (0 if it is full), then the compressed size of each block
+    std::vector<vtkTypeUInt64> sizes;
+    vtkTypeUInt64 numberOfBlocks = 1;
+    vtkTypeUInt64 blockSize = 0;
+    vtkTypeUInt64 lastBlockSize = 0;
+    vtkTypeUInt64 numberOfBytes = 0;
+    if(m_Compressed)
+    {
+        if(!this->ReadHeader(position, numberOfBlocks) || !this->ReadHeader(position + m_HeaderSize, blockSize)) return NULL;
+        if(!this->ReadHeader(position + 2*m_HeaderSize, lastBlockSize)) return NULL;
+        if(numberOfBlocks > m_AppendedData.size()/m_HeaderSize || lastBlockSize > blockSize) return NULL;
+        position += 3*m_HeaderSize;
+        sizes.resize((size_t)numberOfBlocks);
+        for(size_t b = 0; b < sizes.size(); b++, position += m_HeaderSize)
+        {
+            if(!this->ReadHeader(position, sizes[b])) return NULL;
+        }
+        numberOfBytes = numberOfBlocks*blockSize;
+        if(numberOfBlocks > 0 && lastBlockSize != 0) numberOfBytes -= blockSize - lastBlockSize;
+    }
+    else
+    {
+        if(!this->ReadHeader(position, numberOfBytes)) return NULL;
+        position += m_HeaderSize;
+        sizes.push_back(numberOfBytes);
+    }
+
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(type));
+    if(array == NULL) return NULL;
+    vtkTypeUInt64 tupleSize = (vtkTypeUInt64)array->GetDataTypeSize()*numberOfComponents;
+    if(numberOfBytes % tupleSize != 0) return NULL;
+    if(a_element->GetAttribute("Name") != NULL) array->SetName(a_element->GetAttribute("Name"));
+    array->SetNumberOfComponents(numberOfComponents);
+    array->SetNumberOfTuples((vtkIdType)(numberOfBytes/tupleSize));
+    if(numberOfBytes == 0) return array;
+
+    // Blocks decoded later, all the arrays at once
+    unsigned char * output = static_cast<unsigned char *>(array->GetVoidPointer(0));
+    for(size_t b = 0; b < sizes.size(); b++)
+    {
+        Block block;
+        block.data = &m_AppendedData[0] + position;
+        block.dataSize = (size_t)sizes[b];
+        block.output = output;
+        block.outputSize = m_Compressed ? (size_t)blockSize : (size_t)numberOfBytes;
+        if(m_Compressed && b + 1 == sizes.size() && lastBlockSize != 0) block.outputSize = (size_t)lastBlockSize;
+        block.compressed = m_Compressed;
+        block.valid = false;
+        if(position + block.dataSize > m_AppendedData.size()) return NULL;
+        m_Blocks.push_back(block);
+        position += block.dataSize;
+        output += block.outputSize;
+    }
+    return array;
+}
+
+void ShapePopulationXMLReader::DecompressBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    ShapePopulationXMLReader * reader = static_cast<ShapePopulationXMLReader *>(a_data);
+    vtkSmartPointer<vtkZLibDataCompressor> compressor = vtkSmartPointer<vtkZLibDataCompressor>::New();    // one per thread
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        Block &block = reader->m_Blocks[i];
+        if(block.compressed)
+        {
+            block.valid = (compressor->Uncompress(block.data, block.dataSize, block.output, block.outputSize) == block.outputSize);
+        }
+        else
+        {
+            memcpy(block.output, block.data, block.outputSize);
+            block.valid = true;
+        }
+    }
+}
+
+
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+// *                                             CELLS                                             * //
+// * ///////////////////////////////////////////////////////////////////////////////////////////// * //
+
+struct spvCells
+{
+    void * connectivity;
+    vtkIdType connectivitySize;
+    const std::vector<vtkIdType> * offsets;                            // end of each cell in the connectivity
+    vtkIdType * legacy;                                                 // number of points then point ids, for each cell
+    std::vector<char> * valid;                                          // by block of cells
+};
+
+template <class T>
+static void spvCopyIds(const T * a_values, vtkIdType a_size, std::vector<vtkIdType> &a_ids)
+{
+    a_ids.resize(a_size);
+    for(vtkIdType i = 0; i < a_size; i++) a_ids[i] = static_cast<vtkIdType>(a_values[i]);
+}
+
+// Cell i is at offsets[i - 1] + i in the legacy array : the blocks of cells are independent
+template <class T>
+static void spvCellsBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data)
+{
+    spvCells * cells = static_cast<spvCells *>(a_data);
+    const T * connectivity = static_cast<const T *>(cells->connectivity);
+    const std::vector<vtkIdType> &offsets = *cells->offsets;
+    bool valid = true;
+    for(vtkIdType i = a_begin; i < a_end; i++)
+    {
+        vtkIdType begin = (i == 0) ? 0 : offsets[i - 1];
+        vtkIdType end = offsets[i];
+        valid = (begin <= end && end <= cells->connectivitySize);
+        if(!valid) break;
+        vtkIdType * cell = cells->legacy + begin + i;
+        cell[0] = end - begin;
+        for(vtkIdType j = begin; j < end; j++) cell[1 + j - begin] = static_cast<vtkIdType>(connectivity[j]);
+    }
+    if(!valid) (*cells->valid)[a_begin/s_cellGrain] = 0;                // one call for the whole range on one thread
+}
+
+vtkSmartPointer<vtkCellArray> ShapePopulationXMLReader::CreateCells(vtkDataArray * a_connectivity, vtkDataArray * a_offsets)
+{
+    std::vector<vtkIdType> offsets;
+    vtkIdType numberOfCells = a_offsets->GetNumberOfTuples();
+    if(a_offsets->GetNumberOfComponents() != 1 || a_connectivity->GetNumberOfComponents() != 1) return NULL;
+    switch(a_offsets->GetDataType())
+    {
+        vtkTemplateMacro(spvCopyIds(static_cast<VTK_TT *>(a_offsets->GetVoidPointer(0)), numberOfCells, offsets));
+    }
+    if(numberOfCells == 0 || (int)offsets.size() != numberOfCells) return NULL;
+    vtkIdType numberOfIds = offsets.back();
+    if(numberOfIds < 0 || numberOfIds > a_connectivity->GetNumberOfTuples()) return NULL;
+    // The legacy array is sized from the last offset : every cell must end within it
+    for(vtkIdType i = 0; i < numberOfCells; i++)
+    {
+        if(offsets[i] < ((i == 0) ? 0 : offsets[i - 1]) || offsets[i] > numberOfIds) return NULL;
+    }
+
+    vtkSmartPointer<vtkIdTypeArray> legacy = vtkSmartPointer<vtkIdTypeArray>::New();
+    legacy->SetNumberOfValues(numberOfCells + numberOfIds);
+    std::vector<char> valid((numberOfCells + s_cellGrain - 1)/s_cellGrain, 1);
+    spvCells cells;
+    cells.connectivity = a_connectivity->GetVoidPointer(0);
+    cells.connectivitySize = numberOfIds;
+    cells.offsets = &offsets;
+    cells.legacy = legacy->GetPointer(0);
+    cells.valid = &valid;
+    switch(a_connectivity->GetDataType())
+    {
+        vtkTemplateMacro(ShapePopulationParallel::For(numberOfCells, s_cellGrain, spvCellsBlock<VTK_TT>, &cells));
+        default: return NULL;
+    }
+    for(unsigned int b = 0; b < valid.size(); b++)
+    {
+        if(!valid[b]) return NULL;
+    }
+
+    vtkSmartPointer<vtkCellArray> cellArray = vtkSmartPointer<vtkCellArray>::New();
+    cellArray->SetCells(numberOfCells, legacy);
+    return cellArray;
+}
@@ -0,0 +1,64 @@
+#ifndef SHAPEPOPULATIONXMLREADER_H
+#define SHAPEPOPULATIONXMLREADER_H
+
+#include <vtkVersion.h>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkXMLDataParser.h>
+#include <vtkXMLDataElement.h>
+#include <vtkZLibDataCompressor.h>
+
+#include "ShapePopulationParallel.h"
+#include "ShapePopulationProfiler.h"
+
+#include <vector>
+#include <string>
+
+// .vtp files whose arrays are appended raw, as written by vtkXMLPolyDataWriter in appended mode : the XML
+// header is parsed by a vtkXMLDataParser, then the whole appended data is read at once and its blocks,
+// compressed by zlib or not, are decoded in parallel straight into the memory of the arrays of the mesh.
+// The other .vtp files (inline or base64 data, several pieces, field data, another byte order or compressor)
+// are left to vtkXMLPolyDataReader : Read returns NULL for them.
+class ShapePopulationXMLReader
+{
+    public :
+
+    ShapePopulationXMLReader(){}
+    ~ShapePopulationXMLReader(){}
+
+    vtkSmartPointer<vtkPolyData> Read(std::string a_filePath);
+    std::string GetErrorMessage() {return m_ErrorMessage;}
+
+    protected :
+
+    struct Block
+    {
+        const unsigned char * data;                                     // in m_AppendedData
+        size_t dataSize;
+        unsigned char * output;                                         // in the array
+        size_t outputSize;
+        bool compressed;
+        bool valid;                                                     // decoded to the expected size
+    };
+
+    std::string m_ErrorMessage;
+    std::vector<unsigned char> m_AppendedData;
+    bool m_Compressed;
+    int m_HeaderSize;                                                   // 4 or 8 bytes
+    std::vector<Block> m_Blocks;
+
+    bool ReadHeader(size_t a_position, vtkTypeUInt64 &a_value);         // a header value of the appended data
+    vtkSmartPointer<vtkDataArray> ReadArray(vtkXMLDataElement * a_element);   // allocated, its blocks queued
+    bool ReadAttributes(vtkXMLDataElement * a_element, vtkDataSetAttributes * a_attributes, vtkIdType a_numberOfTuples);
+    vtkSmartPointer<vtkCellArray> CreateCells(vtkDataArray * a_connectivity, vtkDataArray * a_offsets);
+
+    static int GetDataType(const char * a_type);
+    static void DecompressBlock(vtkIdType a_begin, vtkIdType a_end, void * a_data);
+};
+
+
+#endif
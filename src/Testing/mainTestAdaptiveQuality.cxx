@@ -0,0 +1,20 @@
+//***************************************************************************//
+//          Test setQualityLevel in the class ShapePopulationBase            //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testAdaptiveQuality.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testAdaptiveQuality( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
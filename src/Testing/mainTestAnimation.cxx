@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                  Test the class ShapePopulationAnimation                  //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testAnimation.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testAnimation( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                  Test the class ShapePopulationComponents                 //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testComponents.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testComponents( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
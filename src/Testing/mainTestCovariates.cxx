@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                 Test the class ShapePopulationCovariates                  //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testCovariates.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testCovariates( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                   Test the class ShapePopulationExport                    //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testExport.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testExport( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
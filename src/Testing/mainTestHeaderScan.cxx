@@ -0,0 +1,20 @@
+//***************************************************************************//
+//           Test the class ShapePopulationHeader against ReadMesh           //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testHeaderScan.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testHeaderScan( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
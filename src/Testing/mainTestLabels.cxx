@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                    Test the class ShapePopulationLabels                   //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testLabels.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testLabels( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
@@ -0,0 +1,20 @@
+//***************************************************************************//
+//        Test enforceMemoryBudget in the class ShapePopulationBase          //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testMemoryBudget.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testMemoryBudget( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
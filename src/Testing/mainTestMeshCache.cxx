@@ -0,0 +1,20 @@
+//***************************************************************************//
+//       Test the LRU residency of the class ShapePopulationMeshCache        //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testMeshCache.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testMeshCache( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
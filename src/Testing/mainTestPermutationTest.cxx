@@ -0,0 +1,20 @@
+//***************************************************************************//
+//        Test computePermutationTest in the class ShapePopulationBase       //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testPermutationTest.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testPermutationTest( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
@@ -0,0 +1,20 @@
+//***************************************************************************//
+//          Test the instrumentation of the class ShapePopulationBase        //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testProfiler.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testProfiler( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                   Test the class ShapePopulationSession                   //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testSession.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testSession( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
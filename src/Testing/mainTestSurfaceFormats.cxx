@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                   Test the class ShapePopulationReaders                   //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testSurfaceFormats.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testSurfaceFormats( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
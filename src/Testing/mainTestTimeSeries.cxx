@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                 Test the class ShapePopulationTimeSeries                  //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testTimeSeries.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testTimeSeries( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
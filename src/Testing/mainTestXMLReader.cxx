@@ -0,0 +1,20 @@
+//***************************************************************************//
+//                  Test the class ShapePopulationXMLReader                  //
+//***************************************************************************//
+
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QFileInfo>
+
+#include "testXMLReader.h"
+
+int main(int, char *argv[])
+{
+    TestShapePopulationBase testShapePopulationBase;
+
+    bool test = testShapePopulationBase.testXMLReader( (std::string)argv[1] );
+
+    if(!test) return 0;
+    else return -1;
+}
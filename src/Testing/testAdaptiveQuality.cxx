@@ -0,0 +1,61 @@
+#include "testAdaptiveQuality.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testAdaptiveQuality(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+    shapePopulationBase->CreateNewWindow(filename);
+
+    vtkRenderer * renderer = shapePopulationBase->m_windowsList[0]->GetRenderers()->GetFirstRenderer();
+    vtkActor * glyphActor = renderer->GetActors()->GetLastActor();
+    vtkProp * fileName = (vtkProp*)renderer->GetViewProps()->GetItemAsObject(2);
+    vtkProp * scalarBar = (vtkProp*)renderer->GetViewProps()->GetItemAsObject(4);
+    glyphActor->SetVisibility(1);
+    fileName->SetVisibility(1);
+    scalarBar->SetVisibility(0);
+
+    // Call of the function that must be test
+    shapePopulationBase->setQualityLevel(3);
+
+    // Test if the glyphs and annotations are hidden
+    if(shapePopulationBase->m_qualityLevel != 3) return 1;
+    if(glyphActor->GetVisibility() || fileName->GetVisibility() || scalarBar->GetVisibility()) return 1;
+
+    // Back to full quality, the previous visibilities are restored
+    shapePopulationBase->setQualityLevel(0);
+    if(!glyphActor->GetVisibility() || !fileName->GetVisibility() || scalarBar->GetVisibility()) return 1;
+
+    // Large meshes are decimated with their attributes
+    vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetThetaResolution(200);
+    sphere->SetPhiResolution(200);
+    sphere->Update();
+    vtkIdType numPts = sphere->GetOutput()->GetNumberOfPoints();
+    vtkSmartPointer<vtkDoubleArray> values = vtkSmartPointer<vtkDoubleArray>::New();
+    values->SetName("TestLOD");
+    values->SetNumberOfTuples(numPts);
+    for(vtkIdType v = 0; v < numPts; v++) values->SetValue(v, v);
+    sphere->GetOutput()->GetPointData()->AddArray(values);
+
+    ShapePopulationData * mesh = new ShapePopulationData;
+    mesh->LoadPolyData(sphere->GetOutput(), "sphere.vtk");
+    shapePopulationBase->CreateNewWindow(mesh);
+    vtkSmartPointer<vtkPolyData> lodMesh = shapePopulationBase->getLODMesh(mesh);
+    if(lodMesh->GetNumberOfPoints() >= numPts/2) return 1;
+    if(lodMesh->GetPointData()->GetArray("TestLOD") == NULL) return 1;
+    if(shapePopulationBase->getLODMesh(mesh) != lodMesh) return 1;
+
+    // Small meshes are drawn as they are
+    ShapePopulationData * smallMesh = shapePopulationBase->m_meshList[0];
+    if(smallMesh->GetPolyData()->GetNumberOfPoints() < 10000 && shapePopulationBase->getLODMesh(smallMesh) != smallMesh->GetPolyData()) return 1;
+
+    return 0;
+}
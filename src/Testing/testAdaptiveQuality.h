@@ -0,0 +1,16 @@
+#ifndef TESTADAPTIVEQUALITY_H
+#define TESTADAPTIVEQUALITY_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testAdaptiveQuality(std::string filename);
+};
+
+#endif // TESTADAPTIVEQUALITY_H
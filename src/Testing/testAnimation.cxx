@@ -0,0 +1,97 @@
+#include "testAnimation.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+static bool sameCamera(const cameraConfigStruct &a, const cameraConfigStruct &b)
+{
+    const double * first = &a.pos_x;
+    const double * second = &b.pos_x;
+    for(int k = 0; k < 10; k++)
+    {
+        if(fabs(first[k] - second[k]) > 1e-9) return false;
+    }
+    return true;
+}
+
+static vtkSmartPointer<vtkImageData> createFrame(int width, int height, unsigned char value)
+{
+    vtkSmartPointer<vtkImageData> frame = vtkSmartPointer<vtkImageData>::New();
+    frame->SetDimensions(width, height, 1);
+#if (VTK_MAJOR_VERSION < 6)
+    frame->SetScalarTypeToUnsignedChar();
+    frame->SetNumberOfScalarComponents(3);
+    frame->AllocateScalars();
+#else
+    frame->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+#endif
+    unsigned char * pixels = static_cast<unsigned char *>(frame->GetScalarPointer());
+    for(int i = 0; i < 3*width*height; i++) pixels[i] = value;
+    pixels[3*width*(height - 1)] = 255;                     // first pixel of the top row
+    return frame;
+}
+
+bool TestShapePopulationBase::testAnimation(std::string filename)
+{
+    // Anterior view of the point (1, 2, 3)
+    cameraConfigStruct camera = {1.0, 12.0, 3.0, 1.0, 2.0, 3.0, 0.0, 0.0, 1.0, 5.0};
+
+    // Call of the function that must be test
+    cameraConfigStruct left = ShapePopulationAnimation::Orbit(camera, 90.0);
+    cameraConfigStruct expected = {-9.0, 2.0, 3.0, 1.0, 2.0, 3.0, 0.0, 0.0, 1.0, 5.0};
+    if(!sameCamera(left, expected)) return 1;
+
+    // The turntable follows the orbit between its keyframes and comes back to the first view
+    ShapePopulationAnimation animation;
+    animation.CreateOrbit(camera, 360.0, 4.0);
+    if(animation.GetNumberOfKeyframes() != 5 || animation.GetDuration() != 4.0) return 1;
+    if(!sameCamera(animation.GetCamera(0.5), ShapePopulationAnimation::Orbit(camera, 45.0))) return 1;
+    if(!sameCamera(animation.GetCamera(4.0), camera)) return 1;
+
+    // Distance to the focal point and zoom interpolated linearly
+    cameraConfigStruct far = {1.0, 22.0, 3.0, 1.0, 2.0, 3.0, 0.0, 0.0, 1.0, 15.0};
+    cameraConfigStruct middle = {1.0, 17.0, 3.0, 1.0, 2.0, 3.0, 0.0, 0.0, 1.0, 10.0};
+    if(!sameCamera(ShapePopulationAnimation::Interpolate(camera, far, 0.5), middle)) return 1;
+
+    // Tour A L P R A S I A
+    animation.CreateViewTour(camera, 7.0);
+    if(!sameCamera(animation.GetCamera(5.0), ShapePopulationAnimation::PresetView(camera, 0, 0, 1, 0, 1, 0))) return 1;
+    if(!sameCamera(animation.GetCamera(1.0), ShapePopulationAnimation::PresetView(camera, -1, 0, 0, 0, 0, 1))) return 1;
+
+    // Raw video : the queue holds two frames, written from the top row
+    std::string errorMessage;
+    if(!animation.Open("TestAnimation.rgb", ShapePopulationAnimation::RAW_VIDEO, 2, errorMessage)) return 1;
+    vtkSmartPointer<vtkImageData> first = createFrame(4, 3, 10);
+    vtkSmartPointer<vtkImageData> second = createFrame(4, 3, 20);
+    if(!animation.PushFrame(first) || !animation.PushFrame(second) || animation.GetNumberOfQueuedFrames() != 2) return 1;
+    animation.Close();
+    if(!animation.WriteFrames() || animation.GetNumberOfWrittenFrames() != 2) return 1;
+
+    FILE * video = fopen("TestAnimation.rgb", "rb");
+    if(video == NULL) return 1;
+    unsigned char pixels[2*4*3*3];
+    size_t size = fread(pixels, 1, sizeof(pixels) + 1, video);
+    fclose(video);
+    if(size != sizeof(pixels) || pixels[0] != 255 || pixels[3] != 10 || pixels[4*3*3] != 255 || pixels[4*3*3 + 3] != 20) return 1;
+
+    // Frames of different sizes can't make a raw video
+    animation.Open("TestAnimation.rgb", ShapePopulationAnimation::RAW_VIDEO, 2, errorMessage);
+    animation.PushFrame(first);
+    animation.PushFrame(createFrame(5, 3, 30));
+    animation.Close();
+    if(animation.WriteFrames() || animation.GetErrorMessage().empty()) return 1;
+
+    // Image sequence
+    if(!animation.Open("TestAnimation.png", ShapePopulationAnimation::PNG_SEQUENCE, 4, errorMessage)) return 1;
+    for(int i = 0; i < 3; i++) animation.PushFrame(createFrame(4, 3, 10*i));
+    animation.Close();
+    if(!animation.WriteFrames() || animation.GetNumberOfWrittenFrames() != 3) return 1;
+    if(animation.GetFramePath(2) != "TestAnimation_00002.png") return 1;
+    FILE * image = fopen("TestAnimation_00002.png", "rb");
+    if(image == NULL) return 1;
+    fclose(image);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef TESTANIMATION_H
+#define TESTANIMATION_H
+
+
+#include "../src/ShapePopulationAnimation.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testAnimation(std::string filename);
+};
+
+#endif // TESTANIMATION_H
@@ -0,0 +1,86 @@
+#include "testCellAttributes.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testCellAttributes(std::string filename)
+{
+    ShapePopulationData * mesh = new ShapePopulationData;
+    vtkSmartPointer<vtkPolyData> polyData = mesh->ReadPolyData(filename);
+    if(polyData == NULL) return 1;
+    vtkIdType numPts = polyData->GetNumberOfPoints();
+    vtkIdType numCells = polyData->GetNumberOfCells();
+    if(numCells < 2) return 1;
+
+    // Cell attributes : a label per face and a vector per face
+    vtkSmartPointer<vtkFloatArray> label = vtkSmartPointer<vtkFloatArray>::New();
+    label->SetName("Label");
+    label->SetNumberOfComponents(1);
+    label->SetNumberOfTuples(numCells);
+    vtkSmartPointer<vtkFloatArray> vector = vtkSmartPointer<vtkFloatArray>::New();
+    vector->SetName("FaceVector");
+    vector->SetNumberOfComponents(3);
+    vector->SetNumberOfTuples(numCells);
+    for(vtkIdType c = 0; c < numCells; c++)
+    {
+        label->SetValue(c, (float)(c % 4));
+        vector->SetTuple3(c, 1.0, 2.0, 2.0);
+    }
+    polyData->GetCellData()->AddArray(label);
+    polyData->GetCellData()->AddArray(vector);
+
+    // Call of the function that must be test
+    mesh->LoadPolyData(polyData, filename);
+    std::vector<std::string> attributes = mesh->GetAttributeList();
+    if(std::find(attributes.begin(), attributes.end(), "Label") == attributes.end()) return 1;
+    if(std::find(attributes.begin(), attributes.end(), "FaceVector") == attributes.end()) return 1;
+    if(!mesh->IsCellAttribute("Label") || mesh->GetAttribute("Label") == NULL) return 1;
+
+    // Displayed on the cells : no point scalars are active
+    mesh->SetActiveScalars("Label");
+    if(mesh->GetPolyData()->GetPointData()->GetScalars() != NULL) return 1;
+    if(std::string(mesh->GetActiveScalarsName()) != "Label") return 1;
+    if(mesh->GetPolyData()->GetPointData()->GetArray("Label") != NULL) return 1;
+
+    // Averaged to the points on demand, the mean of the cells of each point
+    vtkDataArray * pointLabel = mesh->GetPointAttribute("Label");
+    if(pointLabel == NULL || pointLabel->GetNumberOfTuples() != numPts) return 1;
+    std::vector<double> sums(numPts, 0.0);
+    std::vector<int> counts(numPts, 0);
+    vtkSmartPointer<vtkIdList> pointIds = vtkSmartPointer<vtkIdList>::New();
+    vtkDataArray * cellLabel = mesh->GetAttribute("Label");
+    for(vtkIdType c = 0; c < mesh->GetPolyData()->GetNumberOfCells(); c++)
+    {
+        mesh->GetPolyData()->GetCellPoints(c, pointIds);
+        for(vtkIdType p = 0; p < pointIds->GetNumberOfIds(); p++)
+        {
+            sums[pointIds->GetId(p)] += cellLabel->GetComponent(c, 0);
+            counts[pointIds->GetId(p)]++;
+        }
+    }
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        double expected = (counts[v] > 0) ? sums[v]/counts[v] : 0.0;
+        if(fabs(pointLabel->GetComponent(v, 0) - expected) > 1e-6) return 1;
+    }
+
+    // Cached until the cell values change
+    if(mesh->GetPointAttribute("Label") != pointLabel) return 1;
+    cellLabel->SetComponent(0, 0, 10.0);
+    cellLabel->Modified();
+    if(mesh->GetPointAttribute("Label") == pointLabel) return 1;
+
+    // Cell vectors become point vectors with their magnitude
+    mesh->ConvertCellVectors("FaceVector");
+    if(mesh->IsCellAttribute("FaceVector")) return 1;
+    vtkDataArray * pointVector = mesh->GetPolyData()->GetPointData()->GetArray("FaceVector");
+    if(pointVector == NULL || pointVector->GetNumberOfComponents() != 3) return 1;
+    if(mesh->GetPolyData()->GetPointData()->GetArray("FaceVector_mag\n") == NULL) return 1;
+    mesh->SetActiveScalars("FaceVector_mag\n");
+    if(mesh->GetPolyData()->GetCellData()->GetScalars() != NULL) return 1;
+
+    delete mesh;
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef TESTCELLATTRIBUTES_H
+#define TESTCELLATTRIBUTES_H
+
+
+#include "../src/ShapePopulationData.h"
+#include <vtkIdList.h>
+#include <vtkFloatArray.h>
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testCellAttributes(std::string filename);
+};
+
+#endif // TESTCELLATTRIBUTES_H
@@ -0,0 +1,94 @@
+#include "testComponents.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testComponents(std::string filename)
+{
+    // Eigenvalues sorted, a double one, and a multiple of the identity
+    double symmetric[12] = {2, 3, 4, 0, 0, 0,   2, 2, 3, 1, 0, 0};                // XX YY ZZ XY YZ XZ
+    double eigenvalues[6];
+    ShapePopulationComponents::ComputeEigenvalues(symmetric, 2, eigenvalues);
+    if(fabs(eigenvalues[0] - 4) > 1e-9 || fabs(eigenvalues[1] - 3) > 1e-9 || fabs(eigenvalues[2] - 2) > 1e-9) return 1;
+    if(fabs(eigenvalues[3] - 3) > 1e-6 || fabs(eigenvalues[4] - 3) > 1e-6 || fabs(eigenvalues[5] - 1) > 1e-6) return 1;
+    double identity[6] = {5, 5, 5, 0, 0, 0};
+    ShapePopulationComponents::ComputeEigenvalues(identity, 1, eigenvalues);
+    if(eigenvalues[0] != 5 || eigenvalues[1] != 5 || eigenvalues[2] != 5) return 1;
+
+    // A tensor at each point, a 4 components attribute on the cells
+    ShapePopulationData * mesh = new ShapePopulationData;
+    vtkSmartPointer<vtkPolyData> polyData = mesh->ReadPolyData(filename);
+    if(polyData == NULL) return 1;
+    vtkIdType numPts = polyData->GetNumberOfPoints();
+    vtkIdType numCells = polyData->GetNumberOfCells();
+
+    vtkSmartPointer<vtkFloatArray> tensor = vtkSmartPointer<vtkFloatArray>::New();
+    tensor->SetName("DTI");
+    tensor->SetNumberOfComponents(6);
+    tensor->SetNumberOfTuples(numPts);
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        float t[6] = {1.0f + (v % 5), 2.0f, 3.0f, 0.5f, 0.0f, 0.0f};
+        tensor->SetTupleValue(v, t);
+    }
+    polyData->GetPointData()->AddArray(tensor);
+
+    vtkSmartPointer<vtkFloatArray> feature = vtkSmartPointer<vtkFloatArray>::New();
+    feature->SetName("Feature");
+    feature->SetNumberOfComponents(4);
+    feature->SetNumberOfTuples(numCells);
+    for(vtkIdType c = 0; c < numCells; c++)
+    {
+        float f[4] = {1.0f, 2.0f, 2.0f, 4.0f*(c % 2)};
+        feature->SetTupleValue(c, f);
+    }
+    polyData->GetCellData()->AddArray(feature);
+
+    // Call of the function that must be test
+    mesh->LoadPolyData(polyData, filename);
+
+    // The derived attributes are listed, not the arrays themselves
+    std::vector<std::string> attributes = mesh->GetAttributeList();
+    const char * expected[] = {"DTI_XX", "DTI_XZ", "DTI_Magnitude", "DTI_Trace", "DTI_FA", "DTI_Eigenvalue3", "Feature_3", "Feature_Magnitude"};
+    for(unsigned int i = 0; i < 8; i++)
+    {
+        if(std::find(attributes.begin(), attributes.end(), expected[i]) == attributes.end()) return 1;
+    }
+    if(std::find(attributes.begin(), attributes.end(), "DTI") != attributes.end()) return 1;
+    if(!mesh->IsDerivedAttribute("Feature_0") || mesh->IsDerivedAttribute("Feature_Trace")) return 1;
+    if(mesh->IsCellAttribute("DTI_FA") || !mesh->IsCellAttribute("Feature_Magnitude")) return 1;
+
+    // Values, computed at the first access
+    vtkDataArray * trace = mesh->GetAttribute("DTI_Trace");
+    vtkDataArray * yy = mesh->GetAttribute("DTI_YY");
+    vtkDataArray * largest = mesh->GetAttribute("DTI_Eigenvalue1");
+    vtkDataArray * fa = mesh->GetAttribute("DTI_FA");
+    if(trace == NULL || yy == NULL || largest == NULL || fa == NULL) return 1;
+    if(trace->GetNumberOfTuples() != numPts || trace->GetNumberOfComponents() != 1) return 1;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        if(fabs(trace->GetComponent(v, 0) - (6.0 + (v % 5))) > 1e-6) return 1;
+        if(yy->GetComponent(v, 0) != 2.0) return 1;
+        if(largest->GetComponent(v, 0) < 3.0 - 1e-6) return 1;
+        if(fa->GetComponent(v, 0) < 0.0 || fa->GetComponent(v, 0) > 1.0) return 1;
+    }
+    vtkDataArray * magnitude = mesh->GetAttribute("Feature_Magnitude");
+    if(magnitude == NULL || magnitude->GetNumberOfTuples() != numCells) return 1;
+    if(fabs(magnitude->GetComponent(0, 0) - 3.0) > 1e-6 || fabs(magnitude->GetComponent(1, 0) - 5.0) > 1e-6) return 1;
+
+    // Ellipsoids : the symmetric tensor of the attribute
+    if(mesh->GetTensorSource("DTI_FA") != "DTI" || mesh->GetTensorSource("Feature_0") != "") return 1;
+    vtkDataArray * tensors = mesh->GetTensors("DTI_FA");
+    if(tensors == NULL || tensors->GetNumberOfComponents() != 9 || tensors->GetNumberOfTuples() != numPts) return 1;
+    if(tensors->GetComponent(0, 1) != 0.5 || tensors->GetComponent(0, 3) != 0.5) return 1;
+
+    // Computed again when the array changed
+    tensor->SetComponent(0, 1, 7.0);
+    tensor->Modified();
+    if(mesh->GetAttribute("DTI_YY")->GetComponent(0, 0) != 7.0) return 1;
+
+    delete mesh;
+    return 0;
+}
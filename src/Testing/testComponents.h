@@ -0,0 +1,18 @@
+#ifndef TESTCOMPONENTS_H
+#define TESTCOMPONENTS_H
+
+
+#include "../src/ShapePopulationData.h"
+#include <vtkFloatArray.h>
+#include <math.h>
+#include <algorithm>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testComponents(std::string filename);
+};
+
+#endif // TESTCOMPONENTS_H
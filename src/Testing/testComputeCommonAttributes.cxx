@@ -79,6 +79,29 @@ bool TestShapePopulationBase::testComputeCommonAttributes(std::string filename1,
         if(shapePopulationBase->m_commonAttributes[i] != commonAttributes[i]) return 1;
     }
 
+    // Paged population : the headers of the files remove the attributes of a single file, not the ones computed in memory
+    std::vector<std::string> filePaths;
+    filePaths.push_back(filename1);
+    filePaths.push_back(filename2);
+    std::vector<ShapePopulationHeader> headers = ShapePopulationHeader::ScanFiles(filePaths);
+    for(unsigned int i = 0; i < 2; i++)
+    {
+        vtkSmartPointer<vtkDoubleArray> distance = vtkSmartPointer<vtkDoubleArray>::New();
+        distance->SetName("Distance_Test");
+        distance->SetNumberOfTuples(shapePopulationBase->m_meshList.at(i)->GetPolyData()->GetNumberOfPoints());
+        distance->FillComponent(0, 1.0);
+        shapePopulationBase->m_meshList.at(i)->AddAttribute(distance);
+    }
+    shapePopulationBase->computeCommonAttributes(headers);
+    commonAttributes.insert(commonAttributes.begin() + 2, "Distance_Test");
+
+    if(shapePopulationBase->m_commonAttributes.size() != commonAttributes.size()) return 1;
+
+    for(unsigned int i = 0; i < shapePopulationBase->m_commonAttributes.size(); i++)
+    {
+        if(shapePopulationBase->m_commonAttributes[i] != commonAttributes[i]) return 1;
+    }
+
     return 0;
 }
 
@@ -0,0 +1,84 @@
+#include "testCovariates.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testCovariates(std::string filename)
+{
+    // Five meshes with an age and a diagnosis
+    const char * table[5][3] = {{"a.vtk", "30", "PD"}, {"b.vtk", "4", "HC"}, {"c.vtk", "", "PD"}, {"d.vtk", "100", "HC"}, {"e.vtk", "30", "PD"}};
+    std::vector<std::string> columns;
+    columns.push_back("age");
+    columns.push_back("diagnosis");
+    std::vector<std::string> filePaths;
+    std::vector< std::vector<std::string> > rows;
+    for(unsigned int i = 0; i < 5; i++)
+    {
+        filePaths.push_back(table[i][0]);
+        std::vector<std::string> values;
+        values.push_back(table[i][1]);
+        values.push_back(table[i][2]);
+        rows.push_back(values);
+    }
+    ShapePopulationCovariates covariates;
+    covariates.AddTable(columns, filePaths, rows);
+    if(covariates.GetValue("d.vtk", "diagnosis") != "HC" || covariates.GetValue("d.vtk", "site") != "") return 1;
+
+    // Call of the function that must be test
+    // Numerical sort, ties in the current order, empty values last
+    unsigned int sorted[5] = {1, 0, 4, 3, 2};
+    std::vector<unsigned int> order = covariates.ComputeOrder(filePaths, "", "age", false, "", "");
+    if(order != std::vector<unsigned int>(sorted, sorted + 5)) return 1;
+
+    // Grouped by diagnosis, sorted by decreasing age inside the groups
+    unsigned int grouped[5] = {3, 1, 0, 4, 2};
+    order = covariates.ComputeOrder(filePaths, "diagnosis", "age", true, "", "");
+    if(order != std::vector<unsigned int>(grouped, grouped + 5)) return 1;
+
+    // "nan" and "inf" are text, after the numbers
+    if(ShapePopulationCovariates::Compare("nan", "12") <= 0 || ShapePopulationCovariates::Compare("inf", "nan") >= 0) return 1;
+    std::vector<std::string> notNumbers;
+    notNumbers.push_back("nan");
+    notNumbers.push_back("12");
+    notNumbers.push_back("inf");
+    notNumbers.push_back("3");
+    std::vector<std::string> notNumberPaths;
+    std::vector< std::vector<std::string> > notNumberRows;
+    for(unsigned int i = 0; i < notNumbers.size(); i++)
+    {
+        notNumberPaths.push_back(std::string(1, (char)('f' + i)) + ".vtk");
+        notNumberRows.push_back(std::vector<std::string>(1, notNumbers[i]));
+    }
+    ShapePopulationCovariates notNumberCovariates;
+    notNumberCovariates.AddTable(std::vector<std::string>(1, "score"), notNumberPaths, notNumberRows);
+    unsigned int textLast[4] = {3, 1, 2, 0};
+    order = notNumberCovariates.ComputeOrder(notNumberPaths, "", "score", false, "", "");
+    if(order != std::vector<unsigned int>(textLast, textLast + 4)) return 1;
+
+    // Filtered
+    order = covariates.ComputeOrder(filePaths, "", "", false, "diagnosis", "HC");
+    if(order.size() != 2 || order[0] != 1 || order[1] != 3) return 1;
+
+    // Statistics of two groups of the same mesh
+    std::vector<ShapePopulationData *> meshes;
+    for(unsigned int i = 0; i < 3; i++)
+    {
+        meshes.push_back(new ShapePopulationData);
+        meshes[i]->ReadMesh(filename);
+    }
+    std::string attribute = meshes[0]->GetAttributeList().at(0);
+    std::vector<int> groups;
+    groups.push_back(0);
+    groups.push_back(1);
+    groups.push_back(1);
+    std::vector<ShapePopulationCovariates::GroupStatistics> statistics = ShapePopulationCovariates::ComputeGroupStatistics(meshes, groups, 2, attribute);
+    for(unsigned int i = 0; i < meshes.size(); i++) delete meshes[i];
+    if(statistics.size() != 2 || statistics[0].numberOfMeshes != 1 || statistics[1].numberOfMeshes != 2) return 1;
+    if(statistics[1].numberOfValues != 2*statistics[0].numberOfValues) return 1;
+    if(fabs(statistics[0].mean - statistics[1].mean) > 1e-6*(1.0 + fabs(statistics[0].mean))) return 1;
+    if(statistics[0].minimum > statistics[0].mean || statistics[0].mean > statistics[0].maximum) return 1;
+
+    return 0;
+}
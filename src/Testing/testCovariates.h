@@ -0,0 +1,16 @@
+#ifndef TESTCOVARIATES_H
+#define TESTCOVARIATES_H
+
+
+#include "../src/ShapePopulationCovariates.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testCovariates(std::string filename);
+};
+
+#endif // TESTCOVARIATES_H
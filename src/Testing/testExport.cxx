@@ -0,0 +1,83 @@
+#include "testExport.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+static unsigned char * pixel(vtkImageData * image, int x, int y)
+{
+    int dims[3];
+    image->GetDimensions(dims);
+    return static_cast<unsigned char *>(image->GetScalarPointer()) + 3*(y*dims[0] + x);
+}
+
+bool TestShapePopulationBase::testExport(std::string filename)
+{
+    // Three tiles of 4x3 pixels, of different colors
+    std::vector< vtkSmartPointer<vtkImageData> > tiles;
+    std::vector<vtkImageData *> images;
+    std::vector<std::string> filePaths;
+    std::vector<int> positions;
+    for(int i = 0; i < 3; i++)
+    {
+        vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+        image->SetDimensions(4, 3, 1);
+#if (VTK_MAJOR_VERSION < 6)
+        image->SetScalarTypeToUnsignedChar();
+        image->SetNumberOfScalarComponents(3);
+        image->AllocateScalars();
+#else
+        image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+#endif
+        for(int y = 0; y < 3; y++)
+        {
+            for(int x = 0; x < 4; x++)
+            {
+                unsigned char * p = pixel(image, x, y);
+                p[0] = 50*(i + 1);
+                p[1] = x;
+                p[2] = y;
+            }
+        }
+        tiles.push_back(image);
+        images.push_back(image);
+        std::ostringstream strs;
+        strs << "TestExport_" << i << ".png";
+        filePaths.push_back(strs.str());
+        positions.push_back(i);
+    }
+
+    ShapePopulationExport exporter;
+    if(ShapePopulationExport::GetExtension(ShapePopulationExport::TIFF) != ".tif") return 1;
+    int tileSize[2] = {4, 3};
+    double background[3] = {0.0, 0.0, 1.0};
+    exporter.InitializeMontage(3, 2, tileSize, background);
+
+    // Call of the function that must be test
+    if(!exporter.WriteBatch(images, filePaths, positions) || !exporter.GetFailedFiles().empty()) return 1;
+    if(!exporter.WriteMontage("TestExport_montage.png")) return 1;
+
+    // 2 columns and 2 rows separated by borders of 4 pixels, first tile at the top left
+    vtkImageData * montage = exporter.GetMontage();
+    int dims[3];
+    montage->GetDimensions(dims);
+    if(dims[0] != 20 || dims[1] != 18) return 1;
+    int origins[3][2] = {{4, 11}, {12, 11}, {4, 4}};
+    for(int i = 0; i < 3; i++)
+    {
+        unsigned char * p = pixel(montage, origins[i][0] + 3, origins[i][1] + 2);
+        if(p[0] != 50*(i + 1) || p[1] != 3 || p[2] != 2) return 1;
+    }
+    unsigned char * empty = pixel(montage, 12, 4);
+    unsigned char * border = pixel(montage, 0, 0);
+    if(empty[2] != 255 || empty[0] != 0 || border[2] != 255) return 1;
+
+    // Files which can't be written are reported
+    std::vector<vtkImageData *> missing(1, images[0]);
+    std::vector<std::string> missingPaths(1, "TestExport_missing_directory/image.png");
+    if(exporter.WriteBatch(missing, missingPaths, std::vector<int>())) return 1;
+    if(exporter.GetFailedFiles().size() != 1 || exporter.GetFailedFiles()[0] != missingPaths[0]) return 1;
+
+    return 0;
+}
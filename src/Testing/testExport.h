@@ -0,0 +1,17 @@
+#ifndef TESTEXPORT_H
+#define TESTEXPORT_H
+
+
+#include "../src/ShapePopulationExport.h"
+#include <math.h>
+#include <sstream>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testExport(std::string filename);
+};
+
+#endif // TESTEXPORT_H
@@ -0,0 +1,98 @@
+#include "testGroupComparison.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testGroupComparison(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+
+    // Group A : values 1 and 3, group B : values 0 and 2 on every vertex
+    double values[4] = {1.0, 3.0, 0.0, 2.0};
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        shapePopulationBase->CreateNewWindow(filename);
+
+        ShapePopulationData * mesh = shapePopulationBase->m_meshList[i];
+        vtkSmartPointer<vtkDoubleArray> scalars = vtkSmartPointer<vtkDoubleArray>::New();
+        scalars->SetName("TestScalars");
+        scalars->SetNumberOfTuples(mesh->GetPolyData()->GetNumberOfPoints());
+        scalars->FillComponent(0, values[i]);
+        mesh->AddAttribute(scalars);
+    }
+    shapePopulationBase->m_groupA.push_back(0);
+    shapePopulationBase->m_groupA.push_back(1);
+    shapePopulationBase->m_groupB.push_back(2);
+    shapePopulationBase->m_groupB.push_back(3);
+
+    // Call of the function that must be test
+    std::string errorMessage;
+    ShapePopulationData * result = shapePopulationBase->computeGroupComparison("TestScalars", errorMessage);
+
+    // Test if the result obtained is correct
+    if(result == NULL) return 1;
+    vtkIdType numPts = shapePopulationBase->m_meshList[0]->GetPolyData()->GetNumberOfPoints();
+    if(result->GetPolyData()->GetNumberOfPoints() != numPts) return 1;
+
+    vtkDataArray * difference = result->GetPolyData()->GetPointData()->GetArray("TestScalars_GroupDifference");
+    vtkDataArray * welchT = result->GetPolyData()->GetPointData()->GetArray("TestScalars_WelchT");
+    vtkDataArray * cohenD = result->GetPolyData()->GetPointData()->GetArray("TestScalars_CohenD");
+    if(difference == NULL || welchT == NULL || cohenD == NULL) return 1;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        if(fabs(difference->GetComponent(v,0) - 1.0) > 0.00001 ) return 1;
+        if(fabs(welchT->GetComponent(v,0) - 0.70711) > 0.00001 ) return 1;
+        if(fabs(cohenD->GetComponent(v,0) - 0.70711) > 0.00001 ) return 1;
+    }
+
+    // The maps are common attributes
+    shapePopulationBase->m_meshList.push_back(result);
+    shapePopulationBase->computeCommonAttributes();
+    std::vector<std::string> commonAttributes = shapePopulationBase->m_commonAttributes;
+    if(std::find(commonAttributes.begin(), commonAttributes.end(), "TestScalars_WelchT") == commonAttributes.end()) return 1;
+
+    // Derived attributes are compared on their values computed on demand : magnitude of 2 channels (0, value)
+    shapePopulationBase->m_groupA.clear();
+    shapePopulationBase->m_groupB.clear();
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        vtkSmartPointer<vtkPolyData> polyData = ShapePopulationData::ReadPolyData(filename);
+        if(polyData == NULL) return 1;
+        vtkSmartPointer<vtkDoubleArray> channels = vtkSmartPointer<vtkDoubleArray>::New();
+        channels->SetName("TestChannels");
+        channels->SetNumberOfComponents(2);
+        channels->SetNumberOfTuples(polyData->GetNumberOfPoints());
+        channels->FillComponent(0, 0.0);
+        channels->FillComponent(1, values[i]);
+        polyData->GetPointData()->AddArray(channels);
+
+        ShapePopulationData * mesh = new ShapePopulationData;
+        mesh->LoadPolyData(polyData, filename);
+        shapePopulationBase->CreateNewWindow(mesh);
+        unsigned int index = shapePopulationBase->m_meshList.size() - 1;
+        if(i < 2) shapePopulationBase->m_groupA.push_back(index);
+        else shapePopulationBase->m_groupB.push_back(index);
+    }
+    ShapePopulationData * derivedResult = shapePopulationBase->computeGroupComparison("TestChannels_Magnitude", errorMessage);
+    if(derivedResult == NULL) return 1;
+    vtkDataArray * derivedDifference = derivedResult->GetPolyData()->GetPointData()->GetArray("TestChannels_Magnitude_GroupDifference");
+    vtkDataArray * derivedWelchT = derivedResult->GetPolyData()->GetPointData()->GetArray("TestChannels_Magnitude_WelchT");
+    if(derivedDifference == NULL || derivedWelchT == NULL) return 1;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        if(fabs(derivedDifference->GetComponent(v,0) - 1.0) > 0.00001 ) return 1;
+        if(fabs(derivedWelchT->GetComponent(v,0) - 0.70711) > 0.00001 ) return 1;
+    }
+
+    // Not enough meshes in one group
+    shapePopulationBase->m_groupB.pop_back();
+    if(shapePopulationBase->computeGroupComparison("TestScalars", errorMessage) != NULL) return 1;
+
+    return 0;
+}
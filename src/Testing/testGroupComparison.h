@@ -0,0 +1,16 @@
+#ifndef TESTGROUPCOMPARISON_H
+#define TESTGROUPCOMPARISON_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testGroupComparison(std::string filename);
+};
+
+#endif // TESTGROUPCOMPARISON_H
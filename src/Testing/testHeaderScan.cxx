@@ -0,0 +1,150 @@
+#include "testHeaderScan.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testHeaderScan(std::string filename)
+{
+    ShapePopulationData mesh;
+    mesh.ReadMesh(filename);
+
+    // Call of the function that must be test
+    ShapePopulationHeader header;
+    if(!header.Scan(filename)) return 1;
+
+    // Test if the header describes the mesh ReadMesh loads
+    if(header.GetNumberOfPoints() != mesh.GetPolyData()->GetNumberOfPoints()) return 1;
+    if(header.GetNumberOfCells() != mesh.GetPolyData()->GetNumberOfCells()) return 1;
+    std::vector<std::string> attributes = header.GetAttributeList();
+    if(attributes != mesh.GetAttributeList()) return 1;
+    for(unsigned int i = 0; i < attributes.size(); i++)
+    {
+        int dim = mesh.GetAttribute(attributes[i])->GetNumberOfComponents();
+        if(header.GetNumberOfComponents(attributes[i]) != dim) return 1;
+    }
+
+    // Parallel scan of a population
+    std::vector<std::string> filePaths(8, filename);
+    filePaths.push_back(filename + ".missing.vtk");
+    std::vector<ShapePopulationHeader> headers = ShapePopulationHeader::ScanFiles(filePaths);
+    if(headers.size() != 9 || headers[8].IsValid()) return 1;
+    for(unsigned int i = 0; i < 8; i++)
+    {
+        if(!headers[i].IsValid() || headers[i].GetNumberOfPoints() != header.GetNumberOfPoints()) return 1;
+    }
+    if(ShapePopulationHeader::ComputeCommonAttributes(headers) != attributes) return 1;
+
+    // .vtp file with a scalar and a vector attribute : the writer stores their ranges in the header
+    vtkSmartPointer<vtkPolyData> polyData = ShapePopulationData::ReadPolyData(filename);
+    if(polyData == NULL) return 1;
+    vtkIdType numPts = polyData->GetNumberOfPoints();
+    vtkSmartPointer<vtkFloatArray> thickness = vtkSmartPointer<vtkFloatArray>::New();
+    thickness->SetName("Thickness");
+    thickness->SetNumberOfTuples(numPts);
+    vtkSmartPointer<vtkFloatArray> displacement = vtkSmartPointer<vtkFloatArray>::New();
+    displacement->SetName("Displacement");
+    displacement->SetNumberOfComponents(3);
+    displacement->SetNumberOfTuples(numPts);
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        thickness->SetValue(v, 0.25f*v - 1.0f);
+        displacement->SetTuple3(v, 0.5*v, -1.0*v, 2.0);
+    }
+    polyData->GetPointData()->AddArray(thickness);
+    polyData->GetPointData()->AddArray(displacement);
+
+    std::string xmlFile = "TestHeaderScan.vtp";
+    vtkSmartPointer<vtkXMLPolyDataWriter> writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    writer->SetInput(polyData);
+#else
+    writer->SetInputData(polyData);
+#endif
+    writer->SetFileName(xmlFile.c_str());
+    if(!writer->Write()) return 1;
+
+    ShapePopulationData xmlMesh;
+    xmlMesh.ReadMesh(xmlFile);
+    ShapePopulationHeader xmlHeader;
+    bool scanned = xmlHeader.Scan(xmlFile);
+    remove(xmlFile.c_str());
+    if(!scanned || xmlHeader.GetNumberOfPoints() != numPts) return 1;
+    std::vector<std::string> xmlAttributes = xmlHeader.GetAttributeList();
+    if(xmlAttributes != xmlMesh.GetAttributeList()) return 1;
+    for(unsigned int i = 0; i < xmlAttributes.size(); i++)
+    {
+        if(xmlHeader.GetNumberOfComponents(xmlAttributes[i]) != xmlMesh.GetAttribute(xmlAttributes[i])->GetNumberOfComponents()) return 1;
+    }
+
+    // RangeMin and RangeMax : the values of the scalars, the magnitudes of the vectors
+    const char * ranged[2] = {"Thickness", "Displacement"};
+    for(int k = 0; k < 2; k++)
+    {
+        vtkDataArray * array = xmlMesh.GetAttribute(ranged[k]);
+        double range[2];
+        double expected[2];
+        if(array == NULL || !xmlHeader.GetRange(ranged[k], range)) return 1;
+        array->GetRange(expected, (array->GetNumberOfComponents() == 1) ? 0 : -1);
+        for(int j = 0; j < 2; j++)
+        {
+            if(fabs(range[j] - expected[j]) > 1e-6*(1.0 + fabs(expected[j]))) return 1;
+        }
+    }
+
+    // Formats recognized as the readers do : upper case extension
+    std::string extension = filename.substr(filename.rfind('.'));
+    for(unsigned int i = 0; i < extension.size(); i++) extension[i] = toupper(extension[i]);
+    std::string upperFile = "TestHeaderScanUpper" + extension;
+    std::ifstream source(filename.c_str(), std::ios::in | std::ios::binary);
+    std::ofstream copy(upperFile.c_str(), std::ios::out | std::ios::binary);
+    copy << source.rdbuf();
+    copy.close();
+    ShapePopulationHeader upperHeader;
+    scanned = upperHeader.Scan(upperFile);
+    remove(upperFile.c_str());
+    if(!scanned || upperHeader.GetNumberOfPoints() != header.GetNumberOfPoints() || upperHeader.GetAttributeList() != attributes) return 1;
+
+    // Surface formats without arrays
+    std::string offFile = "TestHeaderScan.off";
+    std::ofstream off(offFile.c_str());
+    off << "OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n";
+    off.close();
+    ShapePopulationHeader offHeader;
+    scanned = offHeader.Scan(offFile);
+    remove(offFile.c_str());
+    if(!scanned || !offHeader.GetAttributeList().empty()) return 1;
+
+    // GIfTI data arrays : named by their meta data, or by their intent and index
+    std::string giftiFile = "TestHeaderScan.gii";
+    std::ofstream gifti(giftiFile.c_str());
+    gifti << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<GIFTI Version=\"1.0\" NumberOfDataArrays=\"4\">\n"
+          << "<DataArray Intent=\"NIFTI_INTENT_POINTSET\" DataType=\"NIFTI_TYPE_FLOAT32\" ArrayIndexingOrder=\"RowMajorOrder\""
+          << " Dimensionality=\"2\" Dim0=\"4\" Dim1=\"3\" Encoding=\"ASCII\" Endian=\"LittleEndian\" ExternalFileName=\"\" ExternalFileOffset=\"\">\n"
+          << "<Data>0 0 0 1 0 0 0 1 0 1 1 0</Data>\n</DataArray>\n"
+          << "<DataArray Intent=\"NIFTI_INTENT_TRIANGLE\" DataType=\"NIFTI_TYPE_INT32\" ArrayIndexingOrder=\"RowMajorOrder\""
+          << " Dimensionality=\"2\" Dim0=\"2\" Dim1=\"3\" Encoding=\"ASCII\" Endian=\"LittleEndian\" ExternalFileName=\"\" ExternalFileOffset=\"\">\n"
+          << "<Data>0 1 2 1 3 2</Data>\n</DataArray>\n"
+          << "<DataArray Intent=\"NIFTI_INTENT_SHAPE\" DataType=\"NIFTI_TYPE_FLOAT32\" ArrayIndexingOrder=\"RowMajorOrder\""
+          << " Dimensionality=\"1\" Dim0=\"4\" Encoding=\"ASCII\" Endian=\"LittleEndian\" ExternalFileName=\"\" ExternalFileOffset=\"\">\n"
+          << "<MetaData><MD><Name><![CDATA[Name]]></Name><Value><![CDATA[thickness]]></Value></MD></MetaData>\n"
+          << "<Data>0.5 1.5 2.5 3.5</Data>\n</DataArray>\n"
+          << "<DataArray Intent=\"NIFTI_INTENT_SHAPE\" DataType=\"NIFTI_TYPE_FLOAT32\" ArrayIndexingOrder=\"RowMajorOrder\""
+          << " Dimensionality=\"2\" Dim0=\"4\" Dim1=\"2\" Encoding=\"ASCII\" Endian=\"LittleEndian\" ExternalFileName=\"\" ExternalFileOffset=\"\">\n"
+          << "<Data>0 1 0 2 0 3 0 4</Data>\n</DataArray>\n</GIFTI>\n";
+    gifti.close();
+
+    ShapePopulationData giftiMesh;
+    giftiMesh.ReadMesh(giftiFile);
+    ShapePopulationHeader giftiHeader;
+    scanned = giftiHeader.Scan(giftiFile);
+    remove(giftiFile.c_str());
+    if(!scanned || giftiHeader.GetNumberOfPoints() != 4 || giftiHeader.GetNumberOfCells() != 2) return 1;
+    std::vector<std::string> giftiAttributes = giftiHeader.GetAttributeList();
+    if(giftiAttributes != giftiMesh.GetAttributeList()) return 1;
+    if(std::find(giftiAttributes.begin(), giftiAttributes.end(), "thickness") == giftiAttributes.end()) return 1;
+    if(giftiHeader.GetNumberOfComponents("SHAPE_3_Magnitude") != 1) return 1;
+
+    return 0;
+}
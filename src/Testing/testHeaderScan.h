@@ -0,0 +1,23 @@
+#ifndef TESTHEADERSCAN_H
+#define TESTHEADERSCAN_H
+
+
+#include "../src/ShapePopulationHeader.h"
+#include "../src/ShapePopulationData.h"
+#include <vtkXMLPolyDataWriter.h>
+#include <vtkFloatArray.h>
+#include <fstream>
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testHeaderScan(std::string filename);
+};
+
+#endif // TESTHEADERSCAN_H
@@ -0,0 +1,68 @@
+#include "testHistograms.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testHistograms(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+
+    // Values 0, 1, ..., n-1 on the first mesh and 2n, ..., 3n-1 on the second one
+    for(unsigned int i = 0; i < 2; i++)
+    {
+        shapePopulationBase->CreateNewWindow(filename);
+
+        vtkIdType numPts = shapePopulationBase->m_meshList[i]->GetPolyData()->GetNumberOfPoints();
+        vtkSmartPointer<vtkDoubleArray> values = vtkSmartPointer<vtkDoubleArray>::New();
+        values->SetName("TestHistogram");
+        values->SetNumberOfTuples(numPts);
+        for(vtkIdType v = 0; v < numPts; v++)
+        {
+            values->SetValue(v, 2.0*i*numPts + v);
+        }
+        shapePopulationBase->m_meshList[i]->AddAttribute(values);
+    }
+    shapePopulationBase->computeCommonAttributes();
+    double numPts = shapePopulationBase->m_meshList[0]->GetPolyData()->GetNumberOfPoints();
+
+    // Call of the function that must be test
+    double range[2];
+    shapePopulationBase->m_selectedIndex.push_back(0);
+    if(!shapePopulationBase->computePercentileRange("TestHistogram", 0.0, 100.0, range)) return 1;
+
+    // Test if the result obtained is correct
+    double binWidth = 3.0*numPts/shapePopulationBase->m_histograms.GetNumberOfBins();
+    if(fabs(range[0]) > binWidth || fabs(range[1] - numPts) > binWidth) return 1;
+
+    // Merged histogram of both meshes
+    shapePopulationBase->m_selectedIndex.push_back(1);
+    std::vector<double> histogram = shapePopulationBase->m_histograms.GetMergedHistogram("TestHistogram", shapePopulationBase->m_selectedIndex);
+    double total = 0.0;
+    for(unsigned int b = 0; b < histogram.size(); b++) total += histogram[b];
+    if(total != 2.0*numPts) return 1;
+
+    if(!shapePopulationBase->computePercentileRange("TestHistogram", 25.0, 75.0, range)) return 1;
+    if(fabs(range[0] - 0.5*numPts) > binWidth || fabs(range[1] - 2.5*numPts) > binWidth) return 1;
+
+    // A modified array is binned again
+    vtkDoubleArray * values = vtkDoubleArray::SafeDownCast(shapePopulationBase->m_meshList[1]->GetPolyData()->GetPointData()->GetArray("TestHistogram"));
+    for(vtkIdType v = 0; v < values->GetNumberOfTuples(); v++)
+    {
+        values->SetValue(v, v);
+    }
+    values->Modified();
+    if(!shapePopulationBase->computePercentileRange("TestHistogram", 0.0, 100.0, range)) return 1;
+    binWidth = numPts/shapePopulationBase->m_histograms.GetNumberOfBins();
+    if(fabs(range[1] - numPts) > binWidth) return 1;
+
+    // Unknown attribute
+    if(shapePopulationBase->computePercentileRange("NotAnAttribute", 0.0, 100.0, range)) return 1;
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef TESTHISTOGRAMS_H
+#define TESTHISTOGRAMS_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testHistograms(std::string filename);
+};
+
+#endif // TESTHISTOGRAMS_H
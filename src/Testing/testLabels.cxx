@@ -0,0 +1,100 @@
+#include "testLabels.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testLabels(std::string filename)
+{
+    // Two meshes : a label per face, a label per point and an attribute which is not a label
+    std::vector<ShapePopulationData *> meshes;
+    for(int m = 0; m < 2; m++)
+    {
+        ShapePopulationData * mesh = new ShapePopulationData;
+        vtkSmartPointer<vtkPolyData> polyData = mesh->ReadPolyData(filename);
+        if(polyData == NULL) return 1;
+        vtkIdType numPts = polyData->GetNumberOfPoints();
+        vtkIdType numCells = polyData->GetNumberOfCells();
+        if(numCells < 4) return 1;
+
+        vtkSmartPointer<vtkIntArray> cellLabel = vtkSmartPointer<vtkIntArray>::New();
+        cellLabel->SetName("Parcellation");
+        cellLabel->SetNumberOfComponents(1);
+        cellLabel->SetNumberOfTuples(numCells);
+        for(vtkIdType c = 0; c < numCells; c++) cellLabel->SetValue(c, (c % 4) + 4*m);   // 0-3, then 4-7
+        polyData->GetCellData()->AddArray(cellLabel);
+
+        vtkSmartPointer<vtkFloatArray> pointLabel = vtkSmartPointer<vtkFloatArray>::New();
+        pointLabel->SetName("PointLabel");
+        pointLabel->SetNumberOfComponents(1);
+        pointLabel->SetNumberOfTuples(numPts);
+        vtkSmartPointer<vtkFloatArray> distance = vtkSmartPointer<vtkFloatArray>::New();
+        distance->SetName("Distance");
+        distance->SetNumberOfComponents(1);
+        distance->SetNumberOfTuples(numPts);
+        for(vtkIdType v = 0; v < numPts; v++)
+        {
+            pointLabel->SetValue(v, (float)(v % 3));
+            distance->SetValue(v, 0.5f + v);
+        }
+        polyData->GetPointData()->AddArray(pointLabel);
+        polyData->GetPointData()->AddArray(distance);
+
+        mesh->LoadPolyData(polyData, filename);
+        meshes.push_back(mesh);
+    }
+
+    // Call of the function that must be test
+    ShapePopulationLabels labels;
+    if(!labels.Compute(meshes, "Parcellation") || !labels.IsCategorical()) return 1;
+    if(!labels.IsComputed(meshes, "Parcellation") || labels.IsComputed(meshes, "PointLabel")) return 1;
+
+    // Labels sorted, in one mesh each, all the cells counted once
+    std::vector<ShapePopulationLabels::LabelStatistics> statistics = labels.GetStatistics();
+    if(statistics.size() != 8) return 1;
+    vtkIdType numberOfCells = 0;
+    double cellArea = 0.0;
+    for(unsigned int i = 0; i < statistics.size(); i++)
+    {
+        if(statistics[i].label != (double)i || statistics[i].numberOfMeshes != 1) return 1;
+        numberOfCells += statistics[i].count;
+        cellArea += statistics[i].area;
+    }
+    if(numberOfCells != 2*meshes[0]->GetPolyData()->GetNumberOfCells() || cellArea <= 0.0) return 1;
+
+    // One color per label, in an indexed lookup table
+    vtkLookupTable * lookupTable = labels.GetLookupTable();
+    if(!lookupTable->GetIndexedLookup() || lookupTable->GetNumberOfTableValues() != 8) return 1;
+    if(lookupTable->GetNumberOfAnnotatedValues() != 8) return 1;
+    double first[3], second[3];
+    labels.GetColor(0, first);
+    labels.GetColor(1, second);
+    if(first[0] == second[0] && first[1] == second[1] && first[2] == second[2]) return 1;
+
+    // Hiding a label only changes the opacity of its color
+    labels.SetLabelVisibility(3, false);
+    if(labels.GetLabelVisibility(3) || lookupTable->GetTableValue(3)[3] != 0.0) return 1;
+    if(lookupTable->GetTableValue(2)[3] != 1.0) return 1;
+    labels.SetLabelVisibility(3, true);
+    if(lookupTable->GetTableValue(3)[3] != 1.0) return 1;
+
+    // Point labels : in both meshes, the same area as the cells
+    if(!labels.Compute(meshes, "PointLabel")) return 1;
+    statistics = labels.GetStatistics();
+    if(statistics.size() != 3) return 1;
+    double pointArea = 0.0;
+    for(unsigned int i = 0; i < statistics.size(); i++)
+    {
+        if(statistics[i].numberOfMeshes != 2) return 1;
+        pointArea += statistics[i].area;
+    }
+    if(fabs(pointArea - cellArea) > 1e-6*cellArea) return 1;
+
+    // Not a label attribute
+    if(labels.Compute(meshes, "Distance") || labels.IsCategorical() || labels.GetErrorMessage().empty()) return 1;
+    if(labels.Compute(meshes, "Missing")) return 1;
+
+    for(unsigned int m = 0; m < meshes.size(); m++) delete meshes[m];
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef TESTLABELS_H
+#define TESTLABELS_H
+
+
+#include "../src/ShapePopulationLabels.h"
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testLabels(std::string filename);
+};
+
+#endif // TESTLABELS_H
@@ -0,0 +1,98 @@
+#include "testMemoryBudget.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+// Population whose windows are all scrolled out of the view
+class OffScreenShapePopulation : public ShapePopulationBase
+{
+    protected :
+    bool isWindowVisible(unsigned int) {return false;}
+};
+
+bool TestShapePopulationBase::testMemoryBudget(std::string filename)
+{
+    QSharedPointer<OffScreenShapePopulation> shapePopulationBase = QSharedPointer<OffScreenShapePopulation>( new OffScreenShapePopulation );
+
+    shapePopulationBase->m_windowsList.clear();
+
+    // Two meshes with a vector attribute, only the first one is selected
+    for(unsigned int i = 0; i < 2; i++)
+    {
+        shapePopulationBase->CreateNewWindow(filename);
+
+        vtkIdType numPts = shapePopulationBase->m_meshList[i]->GetPolyData()->GetNumberOfPoints();
+        vtkSmartPointer<vtkDoubleArray> vectors = vtkSmartPointer<vtkDoubleArray>::New();
+        vectors->SetName("TestMemory");
+        vectors->SetNumberOfComponents(3);
+        vectors->SetNumberOfTuples(numPts);
+        for(vtkIdType v = 0; v < numPts; v++)
+        {
+            vectors->SetTuple3(v, 1.0, 2.0, 2.0);
+        }
+        shapePopulationBase->m_meshList[i]->AddAttribute(vectors);
+    }
+    shapePopulationBase->m_selectedIndex.push_back(0);
+
+    memoryUsageStruct usage = shapePopulationBase->computeMemoryUsage(1);
+    if(usage.geometry == 0 || usage.attributes == 0 || usage.derived == 0) return 1;
+
+    // No budget : nothing is released
+    if(shapePopulationBase->enforceMemoryBudget() != 0) return 1;
+
+    // Call of the function that must be test
+    shapePopulationBase->m_memoryBudget = 1;
+    if(shapePopulationBase->enforceMemoryBudget() == 0) return 1;
+
+    // Test if the data of the unselected mesh only is released
+    vtkPointData * pointData = shapePopulationBase->m_meshList[1]->GetPolyData()->GetPointData();
+    if(pointData->GetArray("TestMemory_mag\n") != NULL) return 1;
+    if(pointData->GetArray("TestMemory") == NULL) return 1;
+    if(!shapePopulationBase->m_glyphList[1]->GetOutput()->GetDataReleased()) return 1;
+    if(shapePopulationBase->m_meshList[0]->GetPolyData()->GetPointData()->GetArray("TestMemory_mag\n") == NULL) return 1;
+    if(shapePopulationBase->m_glyphList[0]->GetOutput()->GetDataReleased()) return 1;
+    if(shapePopulationBase->computeMemoryUsage(1).derived >= usage.derived) return 1;
+
+    // Rebuilt on demand
+    shapePopulationBase->restoreMeshData(1);
+    vtkDataArray * magnitude = pointData->GetArray("TestMemory_mag\n");
+    if(magnitude == NULL) return 1;
+    if(fabs(magnitude->GetTuple1(0) - 3.0) > 1e-6) return 1;
+    if(shapePopulationBase->m_glyphList[1]->GetOutput()->GetDataReleased()) return 1;
+
+    // Group comparison of the vectors of meshes whose magnitudes were released : 3 and 3 against 1 and 2
+    double tuples[2][3] = {{0.0, 0.0, 1.0}, {0.0, 0.0, 2.0}};
+    for(unsigned int i = 2; i < 4; i++)
+    {
+        shapePopulationBase->CreateNewWindow(filename);
+
+        vtkIdType numPts = shapePopulationBase->m_meshList[i]->GetPolyData()->GetNumberOfPoints();
+        vtkSmartPointer<vtkDoubleArray> vectors = vtkSmartPointer<vtkDoubleArray>::New();
+        vectors->SetName("TestMemory");
+        vectors->SetNumberOfComponents(3);
+        vectors->SetNumberOfTuples(numPts);
+        for(vtkIdType v = 0; v < numPts; v++)
+        {
+            vectors->SetTuple(v, tuples[i - 2]);
+        }
+        shapePopulationBase->m_meshList[i]->AddAttribute(vectors);
+    }
+    if(shapePopulationBase->enforceMemoryBudget() == 0) return 1;
+    if(shapePopulationBase->m_meshList[3]->GetPolyData()->GetPointData()->GetArray("TestMemory_mag\n") != NULL) return 1;
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        if(i < 2) shapePopulationBase->m_groupA.push_back(i);
+        else shapePopulationBase->m_groupB.push_back(i);
+    }
+    std::string errorMessage;
+    ShapePopulationData * result = shapePopulationBase->computeGroupComparison("TestMemory", errorMessage);
+    if(result == NULL) return 1;
+    vtkDataArray * difference = result->GetPolyData()->GetPointData()->GetArray("TestMemory_GroupDifference");
+    if(difference == NULL || fabs(difference->GetComponent(0, 0) - 1.5) > 1e-6) return 1;
+
+    return 0;
+}
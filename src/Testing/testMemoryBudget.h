@@ -0,0 +1,16 @@
+#ifndef TESTMEMORYBUDGET_H
+#define TESTMEMORYBUDGET_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testMemoryBudget(std::string filename);
+};
+
+#endif // TESTMEMORYBUDGET_H
@@ -0,0 +1,53 @@
+#include "testMeshCache.h"
+#include <QFileInfo>
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testMeshCache(std::string filename)
+{
+    ShapePopulationMeshCache meshCache;
+    meshCache.SetCapacity(2);
+
+    // Three paths of the same file, cached as three meshes
+    QFileInfo file(QString(filename.c_str()));
+    std::vector<std::string> filePaths;
+    filePaths.push_back(filename);
+    filePaths.push_back(std::string(file.absolutePath().toLatin1().data()) + "/./" + std::string(file.fileName().toLatin1().data()));
+    filePaths.push_back(std::string(file.absolutePath().toLatin1().data()) + "/././" + std::string(file.fileName().toLatin1().data()));
+
+    // Call of the function that must be test
+    ShapePopulationData * first = meshCache.Load(filePaths[0]);
+    if(first == NULL || first->GetPolyData()->GetNumberOfPoints() == 0) return 1;
+    if(meshCache.Load(filePaths[0]) != first) return 1;
+    if(meshCache.Get(filePaths[1]) != NULL) return 1;
+
+    // The least recently used mesh is evicted beyond the capacity
+    ShapePopulationData * second = meshCache.Load(filePaths[1]);
+    meshCache.Get(filePaths[0]);
+    meshCache.Load(filePaths[2]);
+    if(meshCache.GetNumberOfMeshes() != 2) return 1;
+    if(meshCache.Contains(second)) return 1;
+    if(meshCache.Get(filePaths[0]) != first) return 1;
+
+    // Pinned meshes stay resident
+    std::vector<ShapePopulationData *> pinned;
+    pinned.push_back(meshCache.Get(filePaths[2]));
+    meshCache.Pin(pinned);
+    meshCache.SetCapacity(0);
+    if(meshCache.GetNumberOfMeshes() != 1 || !meshCache.Contains(pinned[0])) return 1;
+
+    // Prefetch stops at the capacity, the displayed mesh is removed and deleted by the cache
+    meshCache.SetCapacity(2);
+    meshCache.Prefetch(filePaths);
+    if(meshCache.GetNumberOfMeshes() != 2) return 1;
+    if(!meshCache.Remove(pinned[0]) || meshCache.Contains(pinned[0])) return 1;
+    if(meshCache.GetNumberOfMeshes() != 1) return 1;
+
+    meshCache.Clear();
+    if(meshCache.GetNumberOfMeshes() != 0) return 1;
+
+    return 0;
+}
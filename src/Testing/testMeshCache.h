@@ -0,0 +1,15 @@
+#ifndef TESTMESHCACHE_H
+#define TESTMESHCACHE_H
+
+
+#include "../src/ShapePopulationMeshCache.h"
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testMeshCache(std::string filename);
+};
+
+#endif // TESTMESHCACHE_H
@@ -0,0 +1,77 @@
+#include "testMorph.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testMorph(std::string filename)
+{
+    ShapePopulationData * first = new ShapePopulationData;
+    first->ReadMesh(filename);
+    vtkPolyData * firstPolyData = first->GetPolyData();
+    if(firstPolyData->GetNumberOfPoints() == 0) return 1;
+
+    // Second shape : the first one moved by 2 along x
+    vtkSmartPointer<vtkPolyData> moved = vtkSmartPointer<vtkPolyData>::New();
+    moved->DeepCopy(firstPolyData);
+    for(vtkIdType v = 0; v < moved->GetNumberOfPoints(); v++)
+    {
+        double point[3];
+        moved->GetPoint(v, point);
+        point[0] += 2.0;
+        moved->GetPoints()->SetPoint(v, point);
+    }
+    ShapePopulationData * second = new ShapePopulationData;
+    second->LoadProcessedPolyData(moved, "Moved.vtk");
+
+    // Call of the function that must be test
+    ShapePopulationMorph morph;
+    std::vector<ShapePopulationData *> shapes(1, first);
+    if(morph.SetShapes(shapes) || morph.GetErrorMessage().empty()) return 1;
+    shapes.push_back(second);
+    if(!morph.SetShapes(shapes) || morph.GetNumberOfShapes() != 2) return 1;
+
+    vtkPolyData * morphPolyData = morph.GetMorph();
+    if(morphPolyData->GetNumberOfPoints() != firstPolyData->GetNumberOfPoints()) return 1;
+    if(morphPolyData->GetNumberOfPolys() != firstPolyData->GetNumberOfPolys()) return 1;
+
+    // The blend is written in the same arrays
+    vtkDataArray * points = morphPolyData->GetPoints()->GetData();
+    double origin[3];
+    double point[3];
+    firstPolyData->GetPoint(0, origin);
+    morph.Blend(0.5, ShapePopulationMorph::LINEAR);
+    morphPolyData->GetPoint(0, point);
+    if(morphPolyData->GetPoints()->GetData() != points) return 1;
+    if(fabs(point[0] - (origin[0] + 1.0)) > 1e-4 || fabs(point[1] - origin[1]) > 1e-4) return 1;
+    morph.Blend(1.0, ShapePopulationMorph::SPLINE);
+    morphPolyData->GetPoint(0, point);
+    if(fabs(point[0] - (origin[0] + 2.0)) > 1e-4) return 1;
+
+    // Normals stay unit vectors, the attributes shared by the shapes are kept
+    double normal[3];
+    morphPolyData->GetPointData()->GetNormals()->GetTuple(0, normal);
+    if(fabs(vtkMath::Norm(normal) - 1.0) > 1e-4) return 1;
+    std::vector<std::string> attributes = morph.GetAttributes();
+    for(unsigned int j = 0; j < attributes.size(); j++)
+    {
+        vtkDataArray * expected = firstPolyData->GetPointData()->GetArray(attributes[j].c_str());
+        vtkDataArray * blended = morphPolyData->GetPointData()->GetArray(attributes[j].c_str());
+        if(expected == NULL || blended == NULL) return 1;
+        if(fabs(expected->GetComponent(0, 0) - blended->GetComponent(0, 0)) > 1e-4) return 1;
+    }
+
+    // Weights of the spline through three shapes
+    int indices[4];
+    float weights[4];
+    if(ShapePopulationMorph::ComputeWeights(1.0, ShapePopulationMorph::SPLINE, 3, indices, weights) != 1 || indices[0] != 1) return 1;
+    if(ShapePopulationMorph::ComputeWeights(0.5, ShapePopulationMorph::SPLINE, 3, indices, weights) != 4) return 1;
+    if(fabs(weights[0] + weights[1] + weights[2] + weights[3] - 1.0) > 1e-6 || indices[0] != 0 || indices[3] != 2) return 1;
+    if(ShapePopulationMorph::ComputeWeights(1.75, ShapePopulationMorph::LINEAR, 3, indices, weights) != 2) return 1;
+    if(indices[0] != 1 || fabs(weights[1] - 0.75) > 1e-6) return 1;
+
+    delete first;
+    delete second;
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef TESTMORPH_H
+#define TESTMORPH_H
+
+
+#include "../src/ShapePopulationMorph.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testMorph(std::string filename);
+};
+
+#endif // TESTMORPH_H
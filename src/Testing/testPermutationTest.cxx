@@ -0,0 +1,70 @@
+#include "testPermutationTest.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testPermutationTest(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+
+    // Group A : values 1 and 3, group B : values 0 and 2 on every vertex
+    double values[4] = {1.0, 3.0, 0.0, 2.0};
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        shapePopulationBase->CreateNewWindow(filename);
+
+        ShapePopulationData * mesh = shapePopulationBase->m_meshList[i];
+        vtkSmartPointer<vtkDoubleArray> scalars = vtkSmartPointer<vtkDoubleArray>::New();
+        scalars->SetName("TestScalars");
+        scalars->SetNumberOfTuples(mesh->GetPolyData()->GetNumberOfPoints());
+        scalars->FillComponent(0, values[i]);
+        mesh->AddAttribute(scalars);
+    }
+    shapePopulationBase->m_groupA.push_back(0);
+    shapePopulationBase->m_groupA.push_back(1);
+    shapePopulationBase->m_groupB.push_back(2);
+    shapePopulationBase->m_groupB.push_back(3);
+
+    // Call of the function that must be test, twice with the same seed
+    std::string errorMessage;
+    ShapePopulationData * result = shapePopulationBase->computePermutationTest("TestScalars", 1000, 42, errorMessage);
+    if(result == NULL) return 1;
+    vtkIdType numPts = result->GetPolyData()->GetNumberOfPoints();
+    std::vector<double> firstRun(numPts);
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        firstRun[v] = result->GetPolyData()->GetPointData()->GetArray("TestScalars_pUncorrected")->GetComponent(v,0);
+    }
+
+    result = shapePopulationBase->computePermutationTest("TestScalars", 1000, 42, errorMessage);
+    if(result == NULL) return 1;
+
+    // Test if the result obtained is correct
+    vtkDataArray * welchT = result->GetPolyData()->GetPointData()->GetArray("TestScalars_WelchT");
+    vtkDataArray * uncorrectedP = result->GetPolyData()->GetPointData()->GetArray("TestScalars_pUncorrected");
+    vtkDataArray * maxTP = result->GetPolyData()->GetPointData()->GetArray("TestScalars_pMaxT");
+    vtkDataArray * FDRq = result->GetPolyData()->GetPointData()->GetArray("TestScalars_qFDR");
+    if(welchT == NULL || uncorrectedP == NULL || maxTP == NULL || FDRq == NULL) return 1;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        double p = uncorrectedP->GetComponent(v,0);
+        if(p != firstRun[v]) return 1;                                  // reproducible
+        if(p <= 0.0 || p > 1.0) return 1;
+        if(fabs(welchT->GetComponent(v,0) - 0.70711) > 0.00001 ) return 1;
+        if(fabs(p - 2.0/3.0) > 0.1) return 1;                           // 4 of the 6 labelings reach |t| >= 0.70711
+        if(maxTP->GetComponent(v,0) < p - 0.00001) return 1;
+        if(FDRq->GetComponent(v,0) < p - 0.00001) return 1;
+    }
+
+    // Not enough meshes in one group
+    shapePopulationBase->m_groupB.pop_back();
+    if(shapePopulationBase->computePermutationTest("TestScalars", 1000, 42, errorMessage) != NULL) return 1;
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef TESTPERMUTATIONTEST_H
+#define TESTPERMUTATIONTEST_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testPermutationTest(std::string filename);
+};
+
+#endif // TESTPERMUTATIONTEST_H
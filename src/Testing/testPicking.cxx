@@ -0,0 +1,80 @@
+#include "testPicking.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testPicking(std::string filename)
+{
+    ShapePopulationData * first = new ShapePopulationData;
+    first->ReadMesh(filename);
+    vtkPolyData * firstPolyData = first->GetPolyData();
+    if(firstPolyData->GetNumberOfPoints() < 20) return 1;
+
+    // Second mesh : the first one moved by 2 along x, corresponded vertex by vertex
+    vtkSmartPointer<vtkPolyData> moved = vtkSmartPointer<vtkPolyData>::New();
+    moved->DeepCopy(firstPolyData);
+    for(vtkIdType v = 0; v < moved->GetNumberOfPoints(); v++)
+    {
+        double point[3];
+        moved->GetPoint(v, point);
+        point[0] += 2.0;
+        moved->GetPoints()->SetPoint(v, point);
+    }
+    ShapePopulationData * second = new ShapePopulationData;
+    second->LoadProcessedPolyData(moved, "Moved.vtk");
+
+    // Call of the function that must be test
+    ShapePopulationPicking picking;
+    std::vector<ShapePopulationData *> meshes;
+    meshes.push_back(first);
+    meshes.push_back(second);
+    picking.SetMeshes(meshes);
+    if(picking.GetNumberOfLocators() != 0) return 1;
+    picking.BuildLocators();
+    if(picking.GetNumberOfLocators() != 2 || !picking.HasLocator(second)) return 1;
+
+    // The closest vertex is at the point picked
+    double point[3];
+    double closest[3];
+    firstPolyData->GetPoint(10, point);
+    vtkIdType vertex = picking.FindClosestPoint(first, point);
+    if(vertex < 0) return 1;
+    firstPolyData->GetPoint(vertex, closest);
+    if(vtkMath::Distance2BetweenPoints(point, closest) > 1e-8) return 1;
+    point[0] += 2.0;
+    vertex = picking.FindClosestPoint(second, point);
+    if(vertex < 0) return 1;
+    moved->GetPoint(vertex, closest);
+    if(vtkMath::Distance2BetweenPoints(point, closest) > 1e-8) return 1;
+
+    // Values at the vertex, magnitudes for the vectors
+    std::vector<std::string> attributes = first->GetAttributeList();
+    for(unsigned int j = 0; j < attributes.size(); j++)
+    {
+        vtkDataArray * array = firstPolyData->GetPointData()->GetArray(attributes[j].c_str());
+        double value;
+        if(!ShapePopulationPicking::GetValue(first, attributes[j], 10, value)) return 1;
+        if(array->GetNumberOfComponents() == 1 && fabs(value - array->GetComponent(10, 0)) > 1e-6) return 1;
+        if(value < 0.0 && array->GetNumberOfComponents() > 1) return 1;
+        if(ShapePopulationPicking::GetValue(first, attributes[j], firstPolyData->GetNumberOfPoints(), value)) return 1;
+    }
+
+    // Points swapped : the locator is outdated, the pick builds it again
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->DeepCopy(firstPolyData->GetPoints());
+    firstPolyData->SetPoints(points);
+    if(picking.HasLocator(first)) return 1;
+    firstPolyData->GetPoint(15, point);
+    if(picking.FindClosestPoint(first, point) < 0 || !picking.HasLocator(first)) return 1;
+
+    // The locators of the meshes removed are forgotten
+    meshes.erase(meshes.begin());
+    picking.SetMeshes(meshes);
+    if(picking.GetNumberOfLocators() != 1 || picking.HasLocator(first)) return 1;
+
+    delete first;
+    delete second;
+    return 0;
+}
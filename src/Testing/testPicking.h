@@ -0,0 +1,16 @@
+#ifndef TESTPICKING_H
+#define TESTPICKING_H
+
+
+#include "../src/ShapePopulationPicking.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testPicking(std::string filename);
+};
+
+#endif // TESTPICKING_H
@@ -0,0 +1,50 @@
+#include "testProfiler.h"
+#include <QSharedPointer>
+#include <QDir>
+#include <fstream>
+#include <cstdio>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testProfiler(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+
+    // Nothing is recorded while the profiler is disabled
+    ShapePopulationProfiler::SetEnabled(false);
+    ShapePopulationProfiler::Reset();
+    shapePopulationBase->CreateNewWindow(filename);
+    if(ShapePopulationProfiler::GetSummary(100).find("CreateNewWindow") != std::string::npos) return 1;
+
+    // Call of the functions that must be test
+    ShapePopulationProfiler::SetEnabled(true);
+    shapePopulationBase->CreateNewWindow(filename);
+
+    // Test if the events and counters are recorded
+    std::string summary = ShapePopulationProfiler::GetSummary(100);
+    if(summary.find("ReadMesh : 1 x") == std::string::npos) return 1;
+    if(summary.find("CreateNewWindow : 1 x") == std::string::npos) return 1;
+    if(summary.find("vtkGlyph3D") == std::string::npos) return 1;
+    if(summary.find("GlyphExecutions") == std::string::npos) return 1;
+    if(summary.find("MemoryAllocatedKB") == std::string::npos) return 1;
+
+    // Chrome trace
+    std::string tracePath = QDir::temp().filePath("TestProfiler.json").toStdString();
+    if(!ShapePopulationProfiler::WriteChromeTrace(tracePath)) return 1;
+    std::ifstream trace(tracePath.c_str());
+    std::string content((std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>());
+    trace.close();
+    remove(tracePath.c_str());
+    if(content.find("{\"traceEvents\":[") != 0) return 1;
+    if(content.find("\"name\":\"CreateNewWindow\"") == std::string::npos) return 1;
+    if(content.find("\"ph\":\"C\"") == std::string::npos) return 1;
+
+    ShapePopulationProfiler::SetEnabled(false);
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef TESTPROFILER_H
+#define TESTPROFILER_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testProfiler(std::string filename);
+};
+
+#endif // TESTPROFILER_H
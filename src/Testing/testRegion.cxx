@@ -0,0 +1,100 @@
+#include "testRegion.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testRegion(std::string filename)
+{
+    ShapePopulationData * first = new ShapePopulationData;
+    first->ReadMesh(filename);
+    vtkPolyData * firstPolyData = first->GetPolyData();
+    vtkIdType numPts = firstPolyData->GetNumberOfPoints();
+    if(numPts < 20) return 1;
+
+    // Second mesh : the first one with an attribute equal to 1, the integral is the area
+    vtkSmartPointer<vtkPolyData> copy = vtkSmartPointer<vtkPolyData>::New();
+    copy->DeepCopy(firstPolyData);
+    vtkSmartPointer<vtkFloatArray> one = vtkSmartPointer<vtkFloatArray>::New();
+    one->SetName("One");
+    one->SetNumberOfComponents(1);
+    one->SetNumberOfTuples(numPts);
+    for(vtkIdType v = 0; v < numPts; v++) one->SetValue(v, 1.0f);
+    copy->GetPointData()->AddArray(one);
+    ShapePopulationData * second = new ShapePopulationData;
+    second->LoadProcessedPolyData(copy, "One.vtk");
+
+    // Call of the function that must be test
+    // Identity projection : a lasso around every x, y selects the whole mesh
+    ShapePopulationRegion region;
+    double identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    double bounds[6];
+    firstPolyData->GetBounds(bounds);
+    std::vector<double> lasso;
+    lasso.push_back(bounds[0] - 1.0); lasso.push_back(bounds[2] - 1.0);
+    lasso.push_back(bounds[1] + 1.0); lasso.push_back(bounds[2] - 1.0);
+    lasso.push_back(bounds[1] + 1.0); lasso.push_back(bounds[3] + 1.0);
+    lasso.push_back(bounds[0] - 1.0); lasso.push_back(bounds[3] + 1.0);
+    region.SelectInPolygon(firstPolyData, identity, lasso, true);
+    if(region.GetNumberOfVertices() != numPts || !region.Contains(numPts - 1)) return 1;
+    if(region.GetVertexCells(numPts)->GetNumberOfCells() != numPts) return 1;
+
+    // Z-buffer : the projection puts every point at the depth 0.5, behind a surface at 0.25 and in front of one at 0.75
+    ShapePopulationRegion hidden;
+    double flat[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+    std::vector<float> depth(16*16, 0.25f);
+    hidden.SelectInPolygon(firstPolyData, flat, lasso, true, &depth[0], 16, 16);
+    if(hidden.GetNumberOfVertices() != 0) return 1;
+    std::fill(depth.begin(), depth.end(), 0.75f);
+    hidden.SelectInPolygon(firstPolyData, flat, lasso, true, &depth[0], 16, 16);
+    if(hidden.GetNumberOfVertices() != numPts) return 1;
+
+    // Statistics over both meshes
+    std::vector<ShapePopulationData *> meshes;
+    meshes.push_back(first);
+    meshes.push_back(second);
+    std::vector<ShapePopulationRegion::Statistics> statistics = region.ComputeStatistics(meshes, "One");
+    if(statistics.size() != 2 || statistics[0].defined || !statistics[1].defined) return 1;
+    if(statistics[1].numberOfVertices != numPts || statistics[1].area <= 0.0) return 1;
+    if(fabs(statistics[1].mean - 1.0) > 1e-6 || fabs(statistics[1].maximum - 1.0) > 1e-6) return 1;
+    if(fabs(statistics[1].integral - statistics[1].area) > 1e-6*statistics[1].area) return 1;
+    double area = statistics[1].area;
+
+    // Ctrl lasso : the half x < middle is removed, the area of the rest is smaller
+    double middle = 0.5*(bounds[0] + bounds[1]);
+    lasso[2] = middle;
+    lasso[4] = middle;
+    region.SelectInPolygon(firstPolyData, identity, lasso, false);
+    vtkIdType numberOfVertices = region.GetNumberOfVertices();
+    if(numberOfVertices == 0 || numberOfVertices == numPts) return 1;
+    for(vtkIdType v = 0; v < numPts; v++)
+    {
+        double point[3];
+        firstPolyData->GetPoint(v, point);
+        if(point[0] < middle - 1e-6 && region.Contains(v)) return 1;
+        if(point[0] > middle + 1e-6 && !region.Contains(v)) return 1;
+    }
+    statistics = region.ComputeStatistics(meshes, "One");
+    if(statistics[1].numberOfVertices != numberOfVertices || statistics[1].area >= area) return 1;
+
+    // CSV : a header, a row per mesh
+    std::string csv = filename + ".region.csv";
+    std::vector<std::string> names;
+    names.push_back(first->GetFileName());
+    names.push_back(second->GetFileName());
+    if(!ShapePopulationRegion::WriteCSV(csv, "One", names, statistics)) return 1;
+    std::ifstream file(csv.c_str());
+    std::string line;
+    std::getline(file, line);
+    if(line != "Mesh,Vertices,Area,Mean One,Maximum One,Integral One") return 1;
+    int numberOfRows = 0;
+    while(std::getline(file, line)) numberOfRows++;
+    file.close();
+    remove(csv.c_str());
+    if(numberOfRows != 2) return 1;
+
+    delete first;
+    delete second;
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef TESTREGION_H
+#define TESTREGION_H
+
+
+#include "../src/ShapePopulationRegion.h"
+#include <math.h>
+#include <fstream>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testRegion(std::string filename);
+};
+
+#endif // TESTREGION_H
@@ -0,0 +1,80 @@
+#include "testSession.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testSession(std::string filename)
+{
+    ShapePopulationData * mesh = new ShapePopulationData;
+    mesh->ReadMesh(filename);
+    std::vector<ShapePopulationData *> meshes;
+    meshes.push_back(mesh);
+
+    // State of the workspace
+    ShapePopulationSession session;
+    ShapePopulationSession::MeshState meshState = ShapePopulationSession::DefaultMeshState(filename);
+    meshState.opacity = 40;
+    meshState.vectorScale = 250;
+    meshState.colorMapByDirection = true;
+    meshState.axisColor.XAxiscolor[1] = 128;
+    meshState.axisColor.sameColor = false;
+    session.GetMeshes().push_back(meshState);
+
+    ShapePopulationSession::AttributeState attribute;
+    attribute.name = mesh->GetAttributeList().at(0);
+    attribute.colorBar.range[0] = -1.5;
+    attribute.colorBar.range[1] = 2.25;
+    colorPointStruct colorPoint = {0.5, 0.2, 0.4, 0.6};
+    attribute.colorBar.colorPointList.push_back(colorPoint);
+    attribute.magnitude.min = -1.5;
+    attribute.magnitude.max = 2.25;
+    session.GetAttributes().push_back(attribute);
+
+    ShapePopulationSession::ViewState &view = session.GetView();
+    view.attribute = attribute.name;
+    view.displaySphere = false;
+    view.labelColor[0] = 0.25;
+    view.camera.pos_x = 1.0/3.0;
+    view.camera.scale = 12.5;
+    view.columns = 3;
+
+    // Call of the function that must be test
+    std::string errorMessage;
+    bool written = session.Write("TestSession.spvs", meshes, errorMessage);
+    ShapePopulationSession restored;
+    if(!written || !restored.Read("TestSession.spvs", errorMessage))
+    {
+        delete mesh;
+        return 1;
+    }
+
+    ShapePopulationSession::ViewState &restoredView = restored.GetView();
+    if(restoredView.attribute != view.attribute || restoredView.displaySphere || !restoredView.displayMeshName) return 1;
+    if(restoredView.labelColor[0] != 0.25 || restoredView.columns != 3) return 1;
+    if(restoredView.camera.pos_x != view.camera.pos_x || restoredView.camera.scale != 12.5) return 1;
+
+    if(restored.GetAttributes().size() != 1) return 1;
+    ShapePopulationSession::AttributeState &restoredAttribute = restored.GetAttributes()[0];
+    if(restoredAttribute.name != attribute.name || restoredAttribute.colorBar.range[1] != 2.25 || restoredAttribute.magnitude.min != -1.5) return 1;
+    if(restoredAttribute.colorBar.colorPointList.size() != 1 || restoredAttribute.colorBar.colorPointList[0].g != 0.4) return 1;
+
+    if(restored.GetMeshes().size() != 1) return 1;
+    ShapePopulationSession::MeshState &restoredMesh = restored.GetMeshes()[0];
+    if(restoredMesh.filePath != filename || restoredMesh.embeddedFile.empty()) return 1;
+    if(restoredMesh.opacity != 40 || restoredMesh.vectorScale != 250 || !restoredMesh.colorMapByDirection || restoredMesh.displayVectors) return 1;
+    if(restoredMesh.axisColor.XAxiscolor[1] != 128 || restoredMesh.axisColor.sameColor) return 1;
+
+    // Embedded mesh : same geometry and attributes as the original one
+    std::vector<ShapePopulationData *> embedded = restored.ReadEmbeddedMeshes();
+    bool same = embedded.size() == 1 && embedded[0] != NULL
+            && embedded[0]->GetPolyData()->GetNumberOfPoints() == mesh->GetPolyData()->GetNumberOfPoints()
+            && embedded[0]->GetAttributeList() == mesh->GetAttributeList()
+            && embedded[0]->GetFilePath() == filename;
+    for(unsigned int i = 0; i < embedded.size(); i++) delete embedded[i];
+    delete mesh;
+    if(!same) return 1;
+
+    return 0;
+}
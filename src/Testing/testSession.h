@@ -0,0 +1,16 @@
+#ifndef TESTSESSION_H
+#define TESTSESSION_H
+
+
+#include "../src/ShapePopulationSession.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testSession(std::string filename);
+};
+
+#endif // TESTSESSION_H
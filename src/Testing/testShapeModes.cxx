@@ -0,0 +1,79 @@
+#include "testShapeModes.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testShapeModes(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+
+    // The same mesh translated along x : a single mode of variation
+    double translations[4] = {-1.5, -0.5, 0.5, 1.5};
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        shapePopulationBase->CreateNewWindow(filename);
+
+        vtkPoints * points = shapePopulationBase->m_meshList[i]->GetPolyData()->GetPoints();
+        for(vtkIdType v = 0; v < points->GetNumberOfPoints(); v++)
+        {
+            double point[3];
+            points->GetPoint(v, point);
+            point[0] += translations[i];
+            points->SetPoint(v, point);
+        }
+        shapePopulationBase->m_selectedIndex.push_back(i);
+    }
+
+    // Call of the function that must be test
+    std::string errorMessage;
+    ShapePopulationData * result = shapePopulationBase->computeShapeModes(2, errorMessage);
+    if(result == NULL) return 1;
+    shapePopulationBase->m_meshList.push_back(result);
+
+    // Test if the result obtained is correct
+    if(shapePopulationBase->m_shapeModes.GetNumberOfModes() < 1) return 1;
+    if(shapePopulationBase->m_shapeModes.GetExplainedVariance(0) < 0.999) return 1;
+
+    // One standard deviation along the mode : every vertex moves by sqrt(5/3)
+    shapePopulationBase->setShapeMode(0, 1.0);
+    vtkDataArray * displacement = result->GetPolyData()->GetPointData()->GetArray("ShapeMode_Displacement");
+    if(displacement == NULL) return 1;
+    for(vtkIdType v = 0; v < displacement->GetNumberOfTuples(); v++)
+    {
+        if(fabs(displacement->GetComponent(v,0) - 1.29099) > 0.001 ) return 1;
+    }
+
+    // The vertex picked on the deformed shape : the locator built before setShapeMode is outdated
+    ShapePopulationPicking picking;
+    picking.SetMeshes(std::vector<ShapePopulationData *>(1, result));
+    picking.BuildLocators();
+    if(!picking.HasLocator(result)) return 1;
+    shapePopulationBase->setShapeMode(0, -1.0);
+    if(picking.HasLocator(result)) return 1;
+    double point[3];
+    double closest[3];
+    result->GetPolyData()->GetPoint(0, point);
+    vtkIdType vertex = picking.FindClosestPoint(result, point);
+    if(vertex < 0) return 1;
+    result->GetPolyData()->GetPoint(vertex, closest);
+    if(vtkMath::Distance2BetweenPoints(point, closest) > 1e-8) return 1;
+
+    // Back to the mean shape
+    shapePopulationBase->setShapeMode(0, 0.0);
+    for(vtkIdType v = 0; v < displacement->GetNumberOfTuples(); v++)
+    {
+        if(fabs(displacement->GetComponent(v,0)) > 0.00001 ) return 1;
+    }
+
+    // Not enough meshes
+    shapePopulationBase->m_selectedIndex.resize(2);
+    if(shapePopulationBase->computeShapeModes(2, errorMessage) != NULL) return 1;
+
+    return 0;
+}
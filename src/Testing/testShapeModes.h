@@ -0,0 +1,17 @@
+#ifndef TESTSHAPEMODES_H
+#define TESTSHAPEMODES_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <vtkMath.h>
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testShapeModes(std::string filename);
+};
+
+#endif // TESTSHAPEMODES_H
@@ -0,0 +1,79 @@
+#include "testSurfaceDistance.h"
+#include <QSharedPointer>
+#include "ShapePopulationQT.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::testSurfaceDistance(std::string filename)
+{
+    QSharedPointer<ShapePopulationBase> shapePopulationBase = QSharedPointer<ShapePopulationBase>( new ShapePopulationBase );
+
+    shapePopulationBase->m_windowsList.clear();
+    shapePopulationBase->CreateNewWindow(filename);
+    shapePopulationBase->CreateNewWindow(filename);
+
+    // The second mesh is moved outside the first one along its normals
+    vtkPolyData * reference = shapePopulationBase->m_meshList[0]->GetPolyData();
+    vtkSmartPointer<vtkPolyDataNormals> normalGenerator = vtkSmartPointer<vtkPolyDataNormals>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    normalGenerator->SetInput(reference);
+#else
+    normalGenerator->SetInputData(reference);
+#endif
+    normalGenerator->SplittingOff();
+    normalGenerator->ConsistencyOff();
+    normalGenerator->ComputePointNormalsOn();
+    normalGenerator->ComputeCellNormalsOff();
+    normalGenerator->Update();
+    vtkDataArray * normals = normalGenerator->GetOutput()->GetPointData()->GetNormals();
+
+    double offset = 0.001 * reference->GetLength();
+    vtkPoints * points = shapePopulationBase->m_meshList[1]->GetPolyData()->GetPoints();
+    for(vtkIdType v = 0; v < points->GetNumberOfPoints(); v++)
+    {
+        double point[3];
+        double normal[3];
+        points->GetPoint(v, point);
+        normals->GetTuple(v, normal);
+        for(int k = 0; k < 3; k++) point[k] += offset * normal[k];
+        points->SetPoint(v, point);
+    }
+    shapePopulationBase->m_selectedIndex.push_back(0);
+    shapePopulationBase->m_selectedIndex.push_back(1);
+
+    // Call of the function that must be test
+    std::string attribute;
+    std::string errorMessage;
+    if(!shapePopulationBase->computeSurfaceDistance(0, attribute, errorMessage)) return 1;
+
+    // Test if the result obtained is correct
+    shapePopulationBase->computeCommonAttributes();
+    if(std::find(shapePopulationBase->m_commonAttributes.begin(), shapePopulationBase->m_commonAttributes.end(), attribute) == shapePopulationBase->m_commonAttributes.end()) return 1;
+
+    // Distance of the reference to itself
+    vtkDataArray * selfDistance = reference->GetPointData()->GetArray(attribute.c_str());
+    for(vtkIdType v = 0; v < selfDistance->GetNumberOfTuples(); v++)
+    {
+        if(fabs(selfDistance->GetComponent(v,0)) > 0.00001 ) return 1;
+    }
+
+    // Moved mesh : outside, and never further than the offset
+    vtkDataArray * distance = shapePopulationBase->m_meshList[1]->GetPolyData()->GetPointData()->GetArray(attribute.c_str());
+    double mean = 0.0;
+    for(vtkIdType v = 0; v < distance->GetNumberOfTuples(); v++)
+    {
+        double value = distance->GetComponent(v,0);
+        if(value <= 0.0 || value > offset * 1.0001 ) return 1;
+        mean += value;
+    }
+    mean /= distance->GetNumberOfTuples();
+    if(mean < 0.75 * offset) return 1;
+
+    // Reference out of the list
+    if(shapePopulationBase->computeSurfaceDistance(2, attribute, errorMessage)) return 1;
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef TESTSURFACEDISTANCE_H
+#define TESTSURFACEDISTANCE_H
+
+
+#include "../src/ShapePopulationBase.h"
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testSurfaceDistance(std::string filename);
+};
+
+#endif // TESTSURFACEDISTANCE_H
@@ -0,0 +1,200 @@
+#include "testSurfaceFormats.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+// Same triangles at the same coordinates. STL files have no shared points : they are merged again, in another order
+bool TestShapePopulationBase::isSameSurface(vtkPolyData * a_first, vtkPolyData * a_second, bool a_mergedPoints)
+{
+    if(a_first == NULL || a_second == NULL) return false;
+    if(a_first->GetNumberOfPoints() != a_second->GetNumberOfPoints()) return false;
+    if(a_first->GetPolys()->GetNumberOfCells() != a_second->GetPolys()->GetNumberOfCells()) return false;
+
+    vtkCellArray * firstPolys = a_first->GetPolys();
+    vtkCellArray * secondPolys = a_second->GetPolys();
+    firstPolys->InitTraversal();
+    secondPolys->InitTraversal();
+    vtkIdType firstSize, secondSize;
+    vtkIdType * firstIds;
+    vtkIdType * secondIds;
+    while(firstPolys->GetNextCell(firstSize, firstIds))
+    {
+        if(!secondPolys->GetNextCell(secondSize, secondIds) || firstSize != secondSize) return false;
+        for(vtkIdType j = 0; j < firstSize; j++)
+        {
+            if(!a_mergedPoints && firstIds[j] != secondIds[j]) return false;
+            double first[3], second[3];
+            a_first->GetPoints()->GetPoint(firstIds[j], first);
+            a_second->GetPoints()->GetPoint(secondIds[j], second);
+            for(int k = 0; k < 3; k++)
+            {
+                if(fabs(first[k] - second[k]) > 1e-4*(1.0 + fabs(first[k]))) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool TestShapePopulationBase::testSurfaceFormats(std::string filename)
+{
+    // Registry : by extension whatever its case, the file filters list every format
+    if(!ShapePopulationReaders::IsSupported("mesh.PLY") || !ShapePopulationReaders::IsSupported("/data.dir/mesh.gii")) return 1;
+    if(ShapePopulationReaders::IsSupported("mesh.csv") || ShapePopulationReaders::IsSupported("/data.ply/mesh")) return 1;
+    if(ShapePopulationReaders::GetFormat("mesh.stl") != "STL") return 1;
+    if(ShapePopulationReaders::GetFileFilter() != "*.vtk *.vtp *.ply *.stl *.off *.obj *.gii") return 1;
+
+    vtkSmartPointer<vtkPolyData> polyData = ShapePopulationReaders::Read(filename);
+    if(polyData == NULL || polyData->GetNumberOfPoints() == 0) return 1;
+    vtkIdType numberOfPoints = polyData->GetNumberOfPoints();
+    vtkIdType numberOfPolys = polyData->GetPolys()->GetNumberOfCells();
+    std::vector<vtkIdType> polys;
+    vtkIdType size;
+    vtkIdType * ids;
+    polyData->GetPolys()->InitTraversal();
+    while(polyData->GetPolys()->GetNextCell(size, ids))
+    {
+        if(size != 3) return 1;                                         // triangles, for the STL and GIfTI files
+        polys.insert(polys.end(), ids, ids + 3);
+    }
+    std::vector<float> points(3*numberOfPoints);
+    for(vtkIdType v = 0; v < numberOfPoints; v++)
+    {
+        double point[3];
+        polyData->GetPoints()->GetPoint(v, point);
+        for(int k = 0; k < 3; k++) points[3*v + k] = (float)point[k];
+    }
+
+    // The mesh written in each format
+    std::ofstream plyAscii("TestSurfaceFormatsAscii.ply");
+    plyAscii << "ply\nformat ascii 1.0\ncomment test\nelement vertex " << numberOfPoints << "\n"
+             << "property float x\nproperty float y\nproperty float z\nproperty float quality\n"
+             << "element face " << numberOfPolys << "\nproperty list uchar int vertex_indices\nend_header\n";
+    plyAscii.precision(9);
+    for(vtkIdType v = 0; v < numberOfPoints; v++) plyAscii << points[3*v] << " " << points[3*v + 1] << " " << points[3*v + 2] << " " << 0.5*v << "\n";
+    for(vtkIdType c = 0; c < numberOfPolys; c++) plyAscii << "3 " << polys[3*c] << " " << polys[3*c + 1] << " " << polys[3*c + 2] << "\n";
+    plyAscii.close();
+
+    // Big endian, whatever the machine
+    std::ofstream plyBinary("TestSurfaceFormatsBinary.ply", std::ios::out | std::ios::binary);
+    plyBinary << "ply\nformat binary_big_endian 1.0\nelement vertex " << numberOfPoints << "\n"
+              << "property float x\nproperty float y\nproperty float z\nproperty uchar red\n"
+              << "element face " << numberOfPolys << "\nproperty list uchar int vertex_indices\nend_header\n";
+    for(vtkIdType v = 0; v < numberOfPoints; v++)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            vtkTypeUInt32 bits;
+            memcpy(&bits, &points[3*v + k], 4);
+            for(int b = 3; b >= 0; b--) plyBinary.put((char)((bits >> (8*b)) & 0xFF));
+        }
+        plyBinary.put((char)(v % 256));
+    }
+    for(vtkIdType c = 0; c < numberOfPolys; c++)
+    {
+        plyBinary.put(3);
+        for(int j = 0; j < 3; j++)
+        {
+            vtkTypeUInt32 id = (vtkTypeUInt32)polys[3*c + j];
+            for(int b = 3; b >= 0; b--) plyBinary.put((char)((id >> (8*b)) & 0xFF));
+        }
+    }
+    plyBinary.close();
+
+    // Little endian : 80 bytes, the number of triangles, then a normal, 3 vertices and 2 bytes for each
+    std::ofstream stl("TestSurfaceFormats.stl", std::ios::out | std::ios::binary);
+    stl << "solid header of a binary file";
+    for(int i = 29; i < 80; i++) stl.put(' ');
+    for(int b = 0; b < 4; b++) stl.put((char)((numberOfPolys >> (8*b)) & 0xFF));
+    for(vtkIdType c = 0; c < numberOfPolys; c++)
+    {
+        for(int k = 0; k < 12; k++) stl.put(0);
+        for(int j = 0; j < 3; j++)
+        {
+            for(int k = 0; k < 3; k++)
+            {
+                vtkTypeUInt32 bits;
+                memcpy(&bits, &points[3*polys[3*c + j] + k], 4);
+                for(int b = 0; b < 4; b++) stl.put((char)((bits >> (8*b)) & 0xFF));
+            }
+        }
+        stl.put(0);
+        stl.put(0);
+    }
+    stl.close();
+
+    std::ofstream off("TestSurfaceFormats.off");
+    std::ofstream obj("TestSurfaceFormats.obj");
+    std::ofstream gifti("TestSurfaceFormats.gii");
+    off.precision(9);
+    obj.precision(9);
+    gifti.precision(9);
+    off << "# comment\nOFF\n" << numberOfPoints << " " << numberOfPolys << " 0\n";
+    obj << "# comment\n";
+    gifti << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<GIFTI Version=\"1.0\" NumberOfDataArrays=\"2\">\n"
+          << "<DataArray Intent=\"NIFTI_INTENT_POINTSET\" DataType=\"NIFTI_TYPE_FLOAT32\" ArrayIndexingOrder=\"RowMajorOrder\""
+          << " Dimensionality=\"2\" Dim0=\"" << numberOfPoints << "\" Dim1=\"3\" Encoding=\"ASCII\" Endian=\"LittleEndian\""
+          << " ExternalFileName=\"\" ExternalFileOffset=\"\">\n<Data>";
+    for(vtkIdType v = 0; v < numberOfPoints; v++)
+    {
+        off << points[3*v] << " " << points[3*v + 1] << " " << points[3*v + 2] << "\n";
+        obj << "v " << points[3*v] << " " << points[3*v + 1] << " " << points[3*v + 2] << "\n";
+        gifti << points[3*v] << " " << points[3*v + 1] << " " << points[3*v + 2] << "\n";
+    }
+    gifti << "</Data>\n</DataArray>\n"
+          << "<DataArray Intent=\"NIFTI_INTENT_TRIANGLE\" DataType=\"NIFTI_TYPE_INT32\" ArrayIndexingOrder=\"ColumnMajorOrder\""
+          << " Dimensionality=\"2\" Dim0=\"" << numberOfPolys << "\" Dim1=\"3\" Encoding=\"ASCII\" Endian=\"LittleEndian\""
+          << " ExternalFileName=\"\" ExternalFileOffset=\"\">\n<Data>";
+    for(int j = 0; j < 3; j++)
+    {
+        for(vtkIdType c = 0; c < numberOfPolys; c++) gifti << polys[3*c + j] << " ";
+    }
+    gifti << "</Data>\n</DataArray>\n</GIFTI>\n";
+    for(vtkIdType c = 0; c < numberOfPolys; c++)
+    {
+        off << "3 " << polys[3*c] << " " << polys[3*c + 1] << " " << polys[3*c + 2] << " 255 0 0\n";
+        obj << "f " << polys[3*c] + 1 << "/1 " << polys[3*c + 1] + 1 << "//1 " << polys[3*c + 2] - numberOfPoints << "\n";   // relative index
+    }
+    off.close();
+    obj.close();
+    gifti.close();
+
+    // Call of the function that must be test
+    const char * files[6] = {"TestSurfaceFormatsAscii.ply", "TestSurfaceFormatsBinary.ply", "TestSurfaceFormats.stl",
+                             "TestSurfaceFormats.off", "TestSurfaceFormats.obj", "TestSurfaceFormats.gii"};
+    for(int f = 0; f < 6; f++)
+    {
+        vtkSmartPointer<vtkPolyData> surface = ShapePopulationReaders::Read(files[f]);
+        if(!isSameSurface(polyData, surface, f == 2)) return 1;
+    }
+
+    // Vertex properties of the PLY files as attributes
+    vtkSmartPointer<vtkPolyData> ply = ShapePopulationReaders::Read("TestSurfaceFormatsAscii.ply");
+    vtkDataArray * quality = ply->GetPointData()->GetArray("quality");
+    if(quality == NULL || quality->GetNumberOfTuples() != numberOfPoints || quality->GetComponent(numberOfPoints - 1, 0) != 0.5*(numberOfPoints - 1)) return 1;
+    ply = ShapePopulationReaders::Read("TestSurfaceFormatsBinary.ply");
+    vtkDataArray * red = ply->GetPointData()->GetArray("red");
+    if(red == NULL || red->GetComponent(numberOfPoints - 1, 0) != (numberOfPoints - 1) % 256) return 1;
+
+    // No extension : recognized by its first bytes
+    std::ifstream source("TestSurfaceFormats.off");
+    std::ofstream copy("TestSurfaceFormatsNoExtension");
+    copy << source.rdbuf();
+    copy.close();
+    if(!ShapePopulationReaders::IsSupported("TestSurfaceFormatsNoExtension")) return 1;
+    if(!isSameSurface(polyData, ShapePopulationReaders::Read("TestSurfaceFormatsNoExtension"), false)) return 1;
+
+    // Faces out of the points, truncated files
+    std::ofstream wrong("TestSurfaceFormatsWrong.off");
+    wrong << "OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 3\n";
+    wrong.close();
+    if(ShapePopulationReaders::Read("TestSurfaceFormatsWrong.off") != NULL) return 1;
+    std::ofstream truncated("TestSurfaceFormatsTruncated.ply");
+    truncated << "ply\nformat binary_little_endian 1.0\nelement vertex 10\nproperty float x\nproperty float y\nproperty float z\nend_header\n";
+    truncated.close();
+    if(ShapePopulationReaders::Read("TestSurfaceFormatsTruncated.ply") != NULL) return 1;
+    if(ShapePopulationReaders::Read("TestSurfaceFormatsMissing.stl") != NULL) return 1;
+
+    return 0;
+}
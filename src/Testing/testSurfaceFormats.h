@@ -0,0 +1,22 @@
+#ifndef TESTSURFACEFORMATS_H
+#define TESTSURFACEFORMATS_H
+
+
+#include "../src/ShapePopulationReaders.h"
+#include <vtkFloatArray.h>
+#include <fstream>
+#include <math.h>
+#include <string.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testSurfaceFormats(std::string filename);
+
+protected:
+    bool isSameSurface(vtkPolyData * a_first, vtkPolyData * a_second, bool a_mergedPoints);
+};
+
+#endif // TESTSURFACEFORMATS_H
@@ -0,0 +1,87 @@
+#include "testTimeSeries.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+static bool writeTimepoint(vtkPolyData * polyData, double shift, std::string filePath)
+{
+    vtkSmartPointer<vtkPolyData> timepoint = vtkSmartPointer<vtkPolyData>::New();
+    timepoint->DeepCopy(polyData);
+    for(vtkIdType v = 0; v < timepoint->GetNumberOfPoints(); v++)
+    {
+        double point[3];
+        timepoint->GetPoint(v, point);
+        point[0] += shift;
+        timepoint->GetPoints()->SetPoint(v, point);
+    }
+
+    vtkSmartPointer<vtkPolyDataWriter> writer = vtkSmartPointer<vtkPolyDataWriter>::New();
+#if (VTK_MAJOR_VERSION < 6)
+    writer->SetInput(timepoint);
+#else
+    writer->SetInputData(timepoint);
+#endif
+    writer->SetFileName(filePath.c_str());
+    return writer->Write() == 1;
+}
+
+static double firstCoordinate(ShapePopulationData * frame)
+{
+    double point[3];
+    frame->GetPolyData()->GetPoint(0, point);
+    return point[0];
+}
+
+bool TestShapePopulationBase::testTimeSeries(std::string filename)
+{
+    ShapePopulationData mesh;
+    mesh.ReadMesh(filename);
+    if(mesh.GetPolyData() == NULL) return 1;
+    double origin = firstCoordinate(&mesh);
+
+    // Timepoints 1, 2 and 10 of a subject
+    if(!writeTimepoint(mesh.GetPolyData(), 1.0, "TestTimeSeries_t1.vtk")) return 1;
+    if(!writeTimepoint(mesh.GetPolyData(), 2.0, "TestTimeSeries_t10.vtk")) return 1;
+    if(!writeTimepoint(mesh.GetPolyData(), 3.0, "TestTimeSeries_t2.vtk")) return 1;
+
+    // Call of the function that must be test
+    std::vector<std::string> timepoints = ShapePopulationTimeSeries::FindTimepoints("TestTimeSeries_t2.vtk");
+    if(timepoints.size() != 3) return 1;
+    if(timepoints[0] != "TestTimeSeries_t1.vtk" || timepoints[1] != "TestTimeSeries_t2.vtk" || timepoints[2] != "TestTimeSeries_t10.vtk") return 1;
+
+    // The second subject has one timepoint, it is read once
+    std::vector< std::vector<std::string> > tracks;
+    tracks.push_back(timepoints);
+    tracks.push_back(std::vector<std::string>(1, "TestTimeSeries_t1.vtk"));
+    ShapePopulationTimeSeries timeSeries;
+    timeSeries.SetBufferSize(2);
+    timeSeries.SetTracks(tracks);
+    if(timeSeries.GetNumberOfSteps() != 3 || timeSeries.IsStepReady()) return 1;
+
+    timeSeries.Prefetch();
+    if(!timeSeries.IsStepReady() || timeSeries.GetNumberOfBufferedFrames() != 3) return 1;
+    if(timeSeries.GetFrame(0) == NULL || timeSeries.GetFrame(1) == NULL) return 1;
+    if(fabs(firstCoordinate(timeSeries.GetFrame(0)) - (origin + 1.0)) > 1e-4) return 1;
+
+    timeSeries.Advance();
+    if(timeSeries.GetCurrentStep() != 1 || !timeSeries.IsStepReady() || timeSeries.GetFrame(1) != NULL) return 1;
+    if(fabs(firstCoordinate(timeSeries.GetFrame(0)) - (origin + 3.0)) > 1e-4) return 1;
+
+    // Beyond the ring buffer
+    timeSeries.Advance();
+    if(timeSeries.IsStepReady()) return 1;
+    timeSeries.Prefetch();
+    if(!timeSeries.IsStepReady() || fabs(firstCoordinate(timeSeries.GetFrame(0)) - (origin + 2.0)) > 1e-4) return 1;
+
+    // The playback loops
+    timeSeries.Advance();
+    timeSeries.Prefetch();
+    if(timeSeries.GetCurrentStep() != 0 || timeSeries.GetFrame(0) == NULL || timeSeries.GetFrame(1) != NULL) return 1;
+
+    // A name without number has no other timepoint
+    if(ShapePopulationTimeSeries::FindTimepoints("TestTimeSeries.vtk").size() != 1) return 1;
+
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef TESTTIMESERIES_H
+#define TESTTIMESERIES_H
+
+
+#include "../src/ShapePopulationTimeSeries.h"
+#include <vtkPolyDataWriter.h>
+#include <math.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testTimeSeries(std::string filename);
+};
+
+#endif // TESTTIMESERIES_H
@@ -0,0 +1,91 @@
+#include "testXMLReader.h"
+
+TestShapePopulationBase::TestShapePopulationBase()
+{
+
+}
+
+bool TestShapePopulationBase::isEqual(vtkDataArray * a_first, vtkDataArray * a_second)
+{
+    if(a_first == NULL || a_second == NULL) return false;
+    if(a_first->GetDataType() != a_second->GetDataType()) return false;
+    if(a_first->GetNumberOfComponents() != a_second->GetNumberOfComponents()) return false;
+    if(a_first->GetNumberOfTuples() != a_second->GetNumberOfTuples()) return false;
+    for(vtkIdType i = 0; i < a_first->GetNumberOfTuples(); i++)
+    {
+        for(int k = 0; k < a_first->GetNumberOfComponents(); k++)
+        {
+            if(a_first->GetComponent(i, k) != a_second->GetComponent(i, k)) return false;
+        }
+    }
+    return true;
+}
+
+bool TestShapePopulationBase::testXMLReader(std::string filename)
+{
+    // A mesh with a point attribute and a cell attribute
+    vtkSmartPointer<vtkPolyData> polyData = ShapePopulationData::ReadPolyData(filename);
+    if(polyData == NULL || polyData->GetNumberOfPoints() == 0) return 1;
+    vtkSmartPointer<vtkFloatArray> distance = vtkSmartPointer<vtkFloatArray>::New();
+    distance->SetName("Distance");
+    distance->SetNumberOfTuples(polyData->GetNumberOfPoints());
+    for(vtkIdType v = 0; v < polyData->GetNumberOfPoints(); v++) distance->SetValue(v, 0.5f*v);
+    polyData->GetPointData()->SetScalars(distance);
+    vtkSmartPointer<vtkFloatArray> area = vtkSmartPointer<vtkFloatArray>::New();
+    area->SetName("Area");
+    area->SetNumberOfTuples(polyData->GetNumberOfCells());
+    for(vtkIdType c = 0; c < polyData->GetNumberOfCells(); c++) area->SetValue(c, (float)(c % 17));
+    polyData->GetCellData()->AddArray(area);
+
+    // Appended raw : zlib in small blocks, then uncompressed. Inline ascii is left to the VTK reader
+    const char * files[3] = {"TestXMLReaderCompressed.vtp", "TestXMLReaderRaw.vtp", "TestXMLReaderAscii.vtp"};
+    for(int f = 0; f < 3; f++)
+    {
+        vtkSmartPointer<vtkXMLPolyDataWriter> writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+#if (VTK_MAJOR_VERSION < 6)
+        writer->SetInput(polyData);
+#else
+        writer->SetInputData(polyData);
+#endif
+        writer->SetFileName(files[f]);
+        if(f < 2)
+        {
+            writer->SetDataModeToAppended();
+            writer->EncodeAppendedDataOff();
+        }
+        else writer->SetDataModeToAscii();
+        if(f == 0) writer->SetBlockSize(1024);
+        if(f == 1) writer->SetCompressor(NULL);
+        if(!writer->Write()) return 1;
+    }
+
+    for(int f = 0; f < 3; f++)
+    {
+        // Call of the function that must be test
+        ShapePopulationXMLReader reader;
+        vtkSmartPointer<vtkPolyData> read = reader.Read(files[f]);
+        if(f == 2)
+        {
+            if(read != NULL || ShapePopulationData::ReadPolyData(files[f]) == NULL) return 1;
+            continue;
+        }
+        if(read == NULL) return 1;
+
+        // The same mesh as vtkXMLPolyDataReader reads
+        vtkSmartPointer<vtkXMLPolyDataReader> vtkReader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+        vtkReader->SetFileName(files[f]);
+        vtkReader->Update();
+        vtkPolyData * expected = vtkReader->GetOutput();
+        if(read->GetNumberOfPoints() != expected->GetNumberOfPoints()) return 1;
+        if(read->GetNumberOfPolys() != expected->GetNumberOfPolys()) return 1;
+        if(!isEqual(read->GetPoints()->GetData(), expected->GetPoints()->GetData())) return 1;
+        if(!isEqual(read->GetPolys()->GetData(), expected->GetPolys()->GetData())) return 1;
+        if(!isEqual(read->GetPointData()->GetArray("Distance"), expected->GetPointData()->GetArray("Distance"))) return 1;
+        if(!isEqual(read->GetCellData()->GetArray("Area"), expected->GetCellData()->GetArray("Area"))) return 1;
+        if(read->GetPointData()->GetScalars() == NULL || std::string(read->GetPointData()->GetScalars()->GetName()) != "Distance") return 1;
+    }
+
+    ShapePopulationXMLReader reader;
+    if(reader.Read("TestXMLReaderMissing.vtp") != NULL || reader.GetErrorMessage().empty()) return 1;
+    return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef TESTXMLREADER_H
+#define TESTXMLREADER_H
+
+
+#include "../src/ShapePopulationData.h"
+#include "../src/ShapePopulationXMLReader.h"
+#include <vtkXMLPolyDataWriter.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkFloatArray.h>
+
+class TestShapePopulationBase
+{
+public:
+    TestShapePopulationBase();
+
+    bool testXMLReader(std::string filename);
+
+protected:
+    bool isEqual(vtkDataArray * a_first, vtkDataArray * a_second);
+};
+
+#endif // TESTXMLREADER_H
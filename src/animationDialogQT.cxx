@@ -0,0 +1,57 @@
+#include "animationDialogQT.h"
+#include "ui_animationDialogQT.h"
+
+animationDialogQT::animationDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::animationDialogQT)
+{
+    ui->setupUi(this);
+}
+
+animationDialogQT::~animationDialogQT()
+{
+    delete ui;
+}
+
+void animationDialogQT::setNumberOfKeyframes(unsigned int a_numberOfKeyframes)
+{
+    // A path needs two keyframes at least
+    ui->comboBox_path->setItemText(KEYFRAMES, QString("Camera keyframes (%1)").arg(a_numberOfKeyframes));
+    if(a_numberOfKeyframes < 2 && ui->comboBox_path->currentIndex() == KEYFRAMES) ui->comboBox_path->setCurrentIndex(TURNTABLE);
+    ui->label_keyframes->setVisible(a_numberOfKeyframes < 2);
+}
+
+void animationDialogQT::on_comboBox_path_currentIndexChanged(int index)
+{
+    ui->doubleSpinBox_degrees->setEnabled(index == TURNTABLE);
+}
+
+int animationDialogQT::getPath()
+{
+    return ui->comboBox_path->currentIndex();
+}
+
+double animationDialogQT::getDegrees()
+{
+    return ui->doubleSpinBox_degrees->value();
+}
+
+double animationDialogQT::getDuration()
+{
+    return ui->doubleSpinBox_duration->value();
+}
+
+int animationDialogQT::getFrameRate()
+{
+    return ui->spinBox_frameRate->value();
+}
+
+int animationDialogQT::getMagnification()
+{
+    return ui->spinBox_magnification->value();
+}
+
+int animationDialogQT::getOutput()
+{
+    return ui->comboBox_output->currentIndex();
+}
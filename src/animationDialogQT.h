@@ -0,0 +1,35 @@
+#ifndef ANIMATIONDIALOGQT_H
+#define ANIMATIONDIALOGQT_H
+
+#include <QDialog>
+
+namespace Ui {
+class animationDialogQT;
+}
+
+class animationDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit animationDialogQT(QWidget *Qparent = 0);
+    ~animationDialogQT();
+
+    enum Path {TURNTABLE = 0, VIEW_TOUR = 1, KEYFRAMES = 2};
+
+    void setNumberOfKeyframes(unsigned int a_numberOfKeyframes);
+    int getPath();
+    double getDegrees();
+    double getDuration();
+    int getFrameRate();
+    int getMagnification();
+    int getOutput();
+
+private slots:
+    void on_comboBox_path_currentIndexChanged(int index);
+
+private:
+    Ui::animationDialogQT *ui;
+};
+
+#endif // ANIMATIONDIALOGQT_H
@@ -0,0 +1,112 @@
+#include "covariatesDialogQT.h"
+#include "ui_covariatesDialogQT.h"
+
+covariatesDialogQT::covariatesDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::covariatesDialogQT)
+{
+    ui->setupUi(this);
+    this->setColumns(QStringList());
+}
+
+covariatesDialogQT::~covariatesDialogQT()
+{
+    delete ui;
+}
+
+void covariatesDialogQT::setColumns(QStringList a_columns)
+{
+    // The chosen columns are kept if the new CSV has them
+    QComboBox * comboBoxes[3] = {ui->comboBox_sort, ui->comboBox_group, ui->comboBox_filter};
+    for(int k = 0; k < 3; k++)
+    {
+        QString current = comboBoxes[k]->currentIndex() > 0 ? comboBoxes[k]->currentText() : QString();
+        comboBoxes[k]->blockSignals(true);
+        comboBoxes[k]->clear();
+        comboBoxes[k]->addItem("(none)");
+        comboBoxes[k]->addItems(a_columns);
+        int index = comboBoxes[k]->findText(current);
+        comboBoxes[k]->setCurrentIndex(index > 0 ? index : 0);
+        comboBoxes[k]->blockSignals(false);
+    }
+    ui->lineEdit_filter->setEnabled(ui->comboBox_filter->currentIndex() > 0);
+}
+
+void covariatesDialogQT::setGroupStatistics(QString a_attribute, QStringList a_groups, std::vector<ShapePopulationCovariates::GroupStatistics> a_statistics)
+{
+    ui->label_attribute_value->setText(a_attribute);
+    ui->tableWidget_statistics->setRowCount(a_groups.size());
+    for(int g = 0; g < a_groups.size() && g < (int)a_statistics.size(); g++)
+    {
+        QStringList values;
+        values << (a_groups[g].isEmpty() ? QString("(no value)") : a_groups[g])
+               << QString::number(a_statistics[g].numberOfMeshes);
+        if(a_statistics[g].numberOfValues > 0)
+        {
+            values << QString::number(a_statistics[g].mean) << QString::number(a_statistics[g].minimum) << QString::number(a_statistics[g].maximum);
+        }
+        else values << "" << "" << "";
+
+        for(int c = 0; c < values.size(); c++)
+        {
+            QTableWidgetItem * item = new QTableWidgetItem(values[c]);
+            item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+            ui->tableWidget_statistics->setItem(g, c, item);
+        }
+    }
+    ui->tableWidget_statistics->resizeColumnsToContents();
+}
+
+std::string covariatesDialogQT::getSortColumn()
+{
+    if(ui->comboBox_sort->currentIndex() <= 0) return "";
+    return ui->comboBox_sort->currentText().toStdString();
+}
+
+bool covariatesDialogQT::getDescending()
+{
+    return ui->checkBox_descending->isChecked();
+}
+
+std::string covariatesDialogQT::getGroupColumn()
+{
+    if(ui->comboBox_group->currentIndex() <= 0) return "";
+    return ui->comboBox_group->currentText().toStdString();
+}
+
+std::string covariatesDialogQT::getFilterColumn()
+{
+    if(ui->comboBox_filter->currentIndex() <= 0) return "";
+    return ui->comboBox_filter->currentText().toStdString();
+}
+
+std::string covariatesDialogQT::getFilterText()
+{
+    return ui->lineEdit_filter->text().toStdString();
+}
+
+void covariatesDialogQT::on_comboBox_sort_currentIndexChanged(int)
+{
+    emit sig_displayChanged();
+}
+
+void covariatesDialogQT::on_checkBox_descending_toggled(bool)
+{
+    emit sig_displayChanged();
+}
+
+void covariatesDialogQT::on_comboBox_group_currentIndexChanged(int)
+{
+    emit sig_displayChanged();
+}
+
+void covariatesDialogQT::on_comboBox_filter_currentIndexChanged(int index)
+{
+    ui->lineEdit_filter->setEnabled(index > 0);
+    emit sig_displayChanged();
+}
+
+void covariatesDialogQT::on_lineEdit_filter_textChanged(QString)
+{
+    emit sig_displayChanged();
+}
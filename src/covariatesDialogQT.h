@@ -0,0 +1,47 @@
+#ifndef COVARIATESDIALOGQT_H
+#define COVARIATESDIALOGQT_H
+
+#include <QDialog>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+#include "ShapePopulationCovariates.h"
+
+namespace Ui {
+class covariatesDialogQT;
+}
+
+class covariatesDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit covariatesDialogQT(QWidget *Qparent = 0);
+    ~covariatesDialogQT();
+
+    void setColumns(QStringList a_columns);
+    void setGroupStatistics(QString a_attribute, QStringList a_groups, std::vector<ShapePopulationCovariates::GroupStatistics> a_statistics);
+
+    // "" when the grid is not sorted, grouped or filtered
+    std::string getSortColumn();
+    bool getDescending();
+    std::string getGroupColumn();
+    std::string getFilterColumn();
+    std::string getFilterText();
+
+private slots:
+    void on_comboBox_sort_currentIndexChanged(int index);
+    void on_checkBox_descending_toggled(bool checked);
+    void on_comboBox_group_currentIndexChanged(int index);
+    void on_comboBox_filter_currentIndexChanged(int index);
+    void on_lineEdit_filter_textChanged(QString text);
+
+signals:
+    void sig_displayChanged();
+
+private:
+    Ui::covariatesDialogQT *ui;
+};
+
+#endif // COVARIATESDIALOGQT_H
@@ -0,0 +1,35 @@
+#include "histogramDialogQT.h"
+#include "ui_histogramDialogQT.h"
+
+histogramDialogQT::histogramDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::histogramDialogQT)
+{
+    ui->setupUi(this);
+}
+
+histogramDialogQT::~histogramDialogQT()
+{
+    delete ui;
+}
+
+void histogramDialogQT::setHistograms(QString a_attribute, const double a_range[2], std::vector<double> a_merged, std::vector< std::vector<double> > a_meshes)
+{
+    ui->label_attribute_value->setText(a_attribute);
+    ui->widget_histogram->setHistograms(a_range, a_merged, a_meshes);
+}
+
+void histogramDialogQT::setColorbarRange(double a_min, double a_max)
+{
+    ui->widget_histogram->setColorbarRange(a_min, a_max);
+}
+
+void histogramDialogQT::on_checkBox_meshes_toggled(bool checked)
+{
+    ui->widget_histogram->setMeshesVisible(checked);
+}
+
+void histogramDialogQT::on_pushButton_autoRange_clicked()
+{
+    emit sig_autoRange(ui->spinBox_lowPercentile->value(), ui->spinBox_highPercentile->value());
+}
@@ -0,0 +1,34 @@
+#ifndef HISTOGRAMDIALOGQT_H
+#define HISTOGRAMDIALOGQT_H
+
+#include <QDialog>
+#include <QString>
+#include <vector>
+
+namespace Ui {
+class histogramDialogQT;
+}
+
+class histogramDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit histogramDialogQT(QWidget *Qparent = 0);
+    ~histogramDialogQT();
+
+    void setHistograms(QString a_attribute, const double a_range[2], std::vector<double> a_merged, std::vector< std::vector<double> > a_meshes);
+    void setColorbarRange(double a_min, double a_max);
+
+private slots:
+    void on_checkBox_meshes_toggled(bool checked);
+    void on_pushButton_autoRange_clicked();
+
+signals:
+    void sig_autoRange(double lowPercentile, double highPercentile);
+
+private:
+    Ui::histogramDialogQT *ui;
+};
+
+#endif // HISTOGRAMDIALOGQT_H
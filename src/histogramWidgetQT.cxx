@@ -0,0 +1,113 @@
+#include "histogramWidgetQT.h"
+
+#include <QPainter>
+#include <QPolygonF>
+
+histogramWidgetQT::histogramWidgetQT(QWidget *Qparent) :
+    QWidget(Qparent)
+{
+    m_range[0] = 0.0;
+    m_range[1] = 1.0;
+    m_colorbarRange[0] = 0.0;
+    m_colorbarRange[1] = 1.0;
+    m_meshesVisible = true;
+}
+
+void histogramWidgetQT::setHistograms(const double a_range[2], std::vector<double> a_merged, std::vector< std::vector<double> > a_meshes)
+{
+    m_range[0] = a_range[0];
+    m_range[1] = a_range[1];
+    m_merged = a_merged;
+    m_meshes = a_meshes;
+    this->update();
+}
+
+void histogramWidgetQT::setColorbarRange(double a_min, double a_max)
+{
+    m_colorbarRange[0] = a_min;
+    m_colorbarRange[1] = a_max;
+    this->update();
+}
+
+void histogramWidgetQT::setMeshesVisible(bool a_visible)
+{
+    m_meshesVisible = a_visible;
+    this->update();
+}
+
+// Fraction of the values of a histogram in each bin
+static std::vector<double> normalizeHistogram(const std::vector<double> &a_histogram, double &a_maximum)
+{
+    std::vector<double> fractions(a_histogram.size(), 0.0);
+    double total = 0.0;
+    for(unsigned int b = 0; b < a_histogram.size(); b++) total += a_histogram[b];
+    if(total == 0.0) return fractions;
+    for(unsigned int b = 0; b < a_histogram.size(); b++)
+    {
+        fractions[b] = a_histogram[b]/total;
+        if(fractions[b] > a_maximum) a_maximum = fractions[b];
+    }
+    return fractions;
+}
+
+void histogramWidgetQT::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(this->rect(), Qt::white);
+
+    int textHeight = painter.fontMetrics().height();
+    QRectF area(5, 5, this->width() - 10, this->height() - 10 - textHeight);
+    painter.setPen(Qt::gray);
+    painter.drawRect(area);
+    if(m_merged.empty()) return;
+
+    // Both the selection and the meshes are drawn as densities, on the same scale
+    double maximum = 0.0;
+    std::vector<double> merged = normalizeHistogram(m_merged, maximum);
+    std::vector< std::vector<double> > meshes;
+    if(m_meshesVisible)
+    {
+        for(unsigned int i = 0; i < m_meshes.size(); i++) meshes.push_back(normalizeHistogram(m_meshes[i], maximum));
+    }
+    if(maximum == 0.0) return;
+
+    double binWidth = area.width()/merged.size();
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(150, 170, 200));
+    for(unsigned int b = 0; b < merged.size(); b++)
+    {
+        double height = merged[b]/maximum*area.height();
+        painter.drawRect(QRectF(area.left() + b*binWidth, area.bottom() - height, binWidth, height));
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setBrush(Qt::NoBrush);
+    for(unsigned int i = 0; i < meshes.size(); i++)
+    {
+        QPolygonF line;
+        for(unsigned int b = 0; b < meshes[i].size(); b++)
+        {
+            line << QPointF(area.left() + (b + 0.5)*binWidth, area.bottom() - meshes[i][b]/maximum*area.height());
+        }
+        painter.setPen(QPen(QColor::fromHsv((int)(360.0*i/meshes.size()), 200, 200), 1));
+        painter.drawPolyline(line);
+    }
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    // Range of the colorbar
+    double width = m_range[1] - m_range[0];
+    if(width > 0.0)
+    {
+        painter.setPen(QPen(Qt::red, 1, Qt::DashLine));
+        for(int k = 0; k < 2; k++)
+        {
+            double x = area.left() + (m_colorbarRange[k] - m_range[0])/width*area.width();
+            if(x >= area.left() && x <= area.right()) painter.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+        }
+    }
+
+    painter.setPen(Qt::black);
+    QRectF labels(area.left(), area.bottom() + 2, area.width(), textHeight);
+    painter.drawText(labels, Qt::AlignLeft, QString::number(m_range[0], 'g', 4));
+    painter.drawText(labels, Qt::AlignRight, QString::number(m_range[1], 'g', 4));
+}
@@ -0,0 +1,31 @@
+#ifndef HISTOGRAMWIDGETQT_H
+#define HISTOGRAMWIDGETQT_H
+
+#include <QWidget>
+#include <vector>
+
+// Merged histogram of the selection drawn as bars, histograms of the meshes as lines,
+// and the range of the colorbar as two vertical markers
+class histogramWidgetQT : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit histogramWidgetQT(QWidget *Qparent = 0);
+
+    void setHistograms(const double a_range[2], std::vector<double> a_merged, std::vector< std::vector<double> > a_meshes);
+    void setColorbarRange(double a_min, double a_max);
+    void setMeshesVisible(bool a_visible);
+
+protected:
+    void paintEvent(QPaintEvent *);
+
+private:
+    double m_range[2];
+    double m_colorbarRange[2];
+    bool m_meshesVisible;
+    std::vector<double> m_merged;
+    std::vector< std::vector<double> > m_meshes;
+};
+
+#endif // HISTOGRAMWIDGETQT_H
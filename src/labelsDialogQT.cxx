@@ -0,0 +1,62 @@
+#include "labelsDialogQT.h"
+#include "ui_labelsDialogQT.h"
+
+labelsDialogQT::labelsDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::labelsDialogQT)
+{
+    ui->setupUi(this);
+}
+
+labelsDialogQT::~labelsDialogQT()
+{
+    delete ui;
+}
+
+void labelsDialogQT::setLabels(ShapePopulationLabels * a_labels)
+{
+    std::vector<ShapePopulationLabels::LabelStatistics> statistics = a_labels->GetStatistics();
+    ui->label_attribute_value->setText(QString(a_labels->GetAttribute().c_str()));
+    ui->label_labels_value->setText(QString::number(statistics.size()));
+
+    // No signal while the rows are filled, and the rows would move : the order chosen is applied again after
+    ui->tableWidget_labels->blockSignals(true);
+    ui->tableWidget_labels->setSortingEnabled(false);
+    ui->tableWidget_labels->setRowCount(statistics.size());
+    for(unsigned int i = 0; i < statistics.size(); i++)
+    {
+        // The label on its color
+        double color[3];
+        a_labels->GetColor(i, color);
+        QTableWidgetItem * label = new QTableWidgetItem;
+        label->setData(Qt::DisplayRole, statistics[i].label);
+        label->setBackground(QColor::fromRgbF(color[0], color[1], color[2]));
+        label->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+        ui->tableWidget_labels->setItem(i, 0, label);
+
+        QTableWidgetItem * visible = new QTableWidgetItem;
+        visible->setCheckState(a_labels->GetLabelVisibility(statistics[i].label) ? Qt::Checked : Qt::Unchecked);
+        visible->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+        ui->tableWidget_labels->setItem(i, 1, visible);
+
+        double values[3] = {(double)statistics[i].numberOfMeshes, (double)statistics[i].count, statistics[i].area};
+        for(int c = 0; c < 3; c++)
+        {
+            QTableWidgetItem * item = new QTableWidgetItem;
+            item->setData(Qt::DisplayRole, values[c]);
+            item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+            ui->tableWidget_labels->setItem(i, c + 2, item);
+        }
+    }
+    ui->tableWidget_labels->setSortingEnabled(true);
+    ui->tableWidget_labels->resizeColumnsToContents();
+    ui->tableWidget_labels->blockSignals(false);
+}
+
+void labelsDialogQT::on_tableWidget_labels_itemChanged(QTableWidgetItem * a_item)
+{
+    if(a_item->column() != 1) return;
+    QTableWidgetItem * label = ui->tableWidget_labels->item(a_item->row(), 0);
+    if(label == NULL) return;
+    emit sig_labelVisibilityChanged(label->data(Qt::DisplayRole).toDouble(), a_item->checkState() == Qt::Checked);
+}
@@ -0,0 +1,35 @@
+#ifndef LABELSDIALOGQT_H
+#define LABELSDIALOGQT_H
+
+#include <QDialog>
+#include <QString>
+#include <QColor>
+#include <QTableWidgetItem>
+
+#include "ShapePopulationLabels.h"
+
+namespace Ui {
+class labelsDialogQT;
+}
+
+class labelsDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit labelsDialogQT(QWidget *Qparent = 0);
+    ~labelsDialogQT();
+
+    void setLabels(ShapePopulationLabels * a_labels);
+
+private slots:
+    void on_tableWidget_labels_itemChanged(QTableWidgetItem * a_item);
+
+signals:
+    void sig_labelVisibilityChanged(double a_label, bool a_visible);
+
+private:
+    Ui::labelsDialogQT *ui;
+};
+
+#endif // LABELSDIALOGQT_H
@@ -0,0 +1,14 @@
+#ifndef MEMORYUSAGESTRUCT_H
+#define MEMORYUSAGESTRUCT_H
+
+// Memory of a mesh in KB
+struct memoryUsageStruct
+{
+    unsigned long geometry;         // points, cells and normals
+    unsigned long attributes;
+    unsigned long derived;          // "_mag" and "_ColorByDirection" arrays
+    unsigned long glyphs;
+    unsigned long graphics;         // estimate of the GPU buffers of the visible actors
+};
+
+#endif // MEMORYUSAGESTRUCT_H
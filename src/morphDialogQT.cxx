@@ -0,0 +1,51 @@
+#include "morphDialogQT.h"
+#include "ui_morphDialogQT.h"
+
+// Slider steps between two shapes
+static const int s_stepsPerShape = 100;
+
+morphDialogQT::morphDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::morphDialogQT)
+{
+    ui->setupUi(this);
+}
+
+morphDialogQT::~morphDialogQT()
+{
+    delete ui;
+}
+
+void morphDialogQT::setShapes(QStringList a_shapes)
+{
+    m_shapes = a_shapes;
+
+    // The spline goes through every shape, with two shapes it eases in and out
+    ui->horizontalSlider_position->blockSignals(true);
+    ui->horizontalSlider_position->setMaximum(s_stepsPerShape*(m_shapes.size() > 1 ? m_shapes.size() - 1 : 1));
+    ui->horizontalSlider_position->setTickInterval(s_stepsPerShape);
+    ui->horizontalSlider_position->setValue(0);
+    ui->horizontalSlider_position->blockSignals(false);
+    this->updateShapeName();
+}
+
+void morphDialogQT::on_comboBox_interpolation_currentIndexChanged(int index)
+{
+    if(index < 0) return;
+    emit sig_morph_valueChanged(ui->horizontalSlider_position->value()/(double)s_stepsPerShape, index);
+}
+
+void morphDialogQT::on_horizontalSlider_position_valueChanged(int value)
+{
+    this->updateShapeName();
+    emit sig_morph_valueChanged(value/(double)s_stepsPerShape, ui->comboBox_interpolation->currentIndex());
+}
+
+void morphDialogQT::updateShapeName()
+{
+    // Nearest shape of the selection
+    int value = ui->horizontalSlider_position->value();
+    int shape = (value + s_stepsPerShape/2)/s_stepsPerShape;
+    QString name = (shape < m_shapes.size()) ? m_shapes[shape] : QString("");
+    ui->label_position_value->setText(QString::number(value/(double)s_stepsPerShape, 'f', 2) + "  " + name);
+}
@@ -0,0 +1,35 @@
+#ifndef MORPHDIALOGQT_H
+#define MORPHDIALOGQT_H
+
+#include <QDialog>
+#include <QStringList>
+
+namespace Ui {
+class morphDialogQT;
+}
+
+class morphDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit morphDialogQT(QWidget *Qparent = 0);
+    ~morphDialogQT();
+
+    void setShapes(QStringList a_shapes);
+
+private slots:
+    void on_comboBox_interpolation_currentIndexChanged(int index);
+    void on_horizontalSlider_position_valueChanged(int value);
+
+signals:
+    void sig_morph_valueChanged(double position, int interpolation);
+
+private:
+    Ui::morphDialogQT *ui;
+    QStringList m_shapes;
+
+    void updateShapeName();
+};
+
+#endif // MORPHDIALOGQT_H
@@ -0,0 +1,35 @@
+#include "permutationTestDialogQT.h"
+#include "ui_permutationTestDialogQT.h"
+
+permutationTestDialogQT::permutationTestDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::permutationTestDialogQT)
+{
+    ui->setupUi(this);
+}
+
+permutationTestDialogQT::~permutationTestDialogQT()
+{
+    delete ui;
+}
+
+void permutationTestDialogQT::setAttributes(QStringList a_attributes)
+{
+    ui->comboBox_attribute->clear();
+    ui->comboBox_attribute->addItems(a_attributes);
+}
+
+int permutationTestDialogQT::getAttributeIndex()
+{
+    return ui->comboBox_attribute->currentIndex();
+}
+
+int permutationTestDialogQT::getNumberOfPermutations()
+{
+    return ui->spinBox_permutations->value();
+}
+
+unsigned int permutationTestDialogQT::getSeed()
+{
+    return (unsigned int)ui->spinBox_seed->value();
+}
@@ -0,0 +1,28 @@
+#ifndef PERMUTATIONTESTDIALOGQT_H
+#define PERMUTATIONTESTDIALOGQT_H
+
+#include <QDialog>
+#include <QStringList>
+
+namespace Ui {
+class permutationTestDialogQT;
+}
+
+class permutationTestDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit permutationTestDialogQT(QWidget *Qparent = 0);
+    ~permutationTestDialogQT();
+
+    void setAttributes(QStringList a_attributes);
+    int getAttributeIndex();
+    int getNumberOfPermutations();
+    unsigned int getSeed();
+
+private:
+    Ui::permutationTestDialogQT *ui;
+};
+
+#endif // PERMUTATIONTESTDIALOGQT_H
@@ -0,0 +1,48 @@
+#include "regionStatisticsDialogQT.h"
+#include "ui_regionStatisticsDialogQT.h"
+
+regionStatisticsDialogQT::regionStatisticsDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::regionStatisticsDialogQT)
+{
+    ui->setupUi(this);
+}
+
+regionStatisticsDialogQT::~regionStatisticsDialogQT()
+{
+    delete ui;
+}
+
+void regionStatisticsDialogQT::setStatistics(int a_numberOfVertices, QString a_attribute, QStringList a_meshes, std::vector<ShapePopulationRegion::Statistics> a_statistics)
+{
+    ui->label_vertices_value->setText(QString::number(a_numberOfVertices));
+    ui->label_attribute_value->setText(a_attribute);
+
+    // The rows would move while they are filled, the order chosen is applied again after
+    ui->tableWidget_statistics->setSortingEnabled(false);
+    ui->tableWidget_statistics->setRowCount(a_meshes.size());
+    for(int i = 0; i < a_meshes.size() && i < (int)a_statistics.size(); i++)
+    {
+        const ShapePopulationRegion::Statistics &statistics = a_statistics[i];
+        QTableWidgetItem * mesh = new QTableWidgetItem(a_meshes[i]);
+        mesh->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+        ui->tableWidget_statistics->setItem(i, 0, mesh);
+
+        // Numbers sorted as numbers, empty cells for the meshes without the region or the attribute
+        double values[5] = {(double)statistics.numberOfVertices, statistics.area, statistics.mean, statistics.maximum, statistics.integral};
+        for(int c = 0; c < 5; c++)
+        {
+            QTableWidgetItem * item = new QTableWidgetItem;
+            if(statistics.defined) item->setData(Qt::DisplayRole, values[c]);
+            item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+            ui->tableWidget_statistics->setItem(i, c + 1, item);
+        }
+    }
+    ui->tableWidget_statistics->setSortingEnabled(true);
+    ui->tableWidget_statistics->resizeColumnsToContents();
+}
+
+void regionStatisticsDialogQT::on_pushButton_export_clicked()
+{
+    emit sig_exportCSV();
+}
@@ -0,0 +1,35 @@
+#ifndef REGIONSTATISTICSDIALOGQT_H
+#define REGIONSTATISTICSDIALOGQT_H
+
+#include <QDialog>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+#include "ShapePopulationRegion.h"
+
+namespace Ui {
+class regionStatisticsDialogQT;
+}
+
+class regionStatisticsDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit regionStatisticsDialogQT(QWidget *Qparent = 0);
+    ~regionStatisticsDialogQT();
+
+    void setStatistics(int a_numberOfVertices, QString a_attribute, QStringList a_meshes, std::vector<ShapePopulationRegion::Statistics> a_statistics);
+
+private slots:
+    void on_pushButton_export_clicked();
+
+signals:
+    void sig_exportCSV();
+
+private:
+    Ui::regionStatisticsDialogQT *ui;
+};
+
+#endif // REGIONSTATISTICSDIALOGQT_H
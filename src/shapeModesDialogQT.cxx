@@ -0,0 +1,44 @@
+#include "shapeModesDialogQT.h"
+#include "ui_shapeModesDialogQT.h"
+
+shapeModesDialogQT::shapeModesDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::shapeModesDialogQT)
+{
+    ui->setupUi(this);
+}
+
+shapeModesDialogQT::~shapeModesDialogQT()
+{
+    delete ui;
+}
+
+void shapeModesDialogQT::setModes(QStringList a_modes)
+{
+    ui->comboBox_mode->blockSignals(true);
+    ui->comboBox_mode->clear();
+    ui->comboBox_mode->addItems(a_modes);
+    ui->comboBox_mode->blockSignals(false);
+
+    ui->horizontalSlider_sigma->blockSignals(true);
+    ui->horizontalSlider_sigma->setValue(0);
+    ui->horizontalSlider_sigma->blockSignals(false);
+    ui->label_sigma_value->setText(QString("0.0"));
+}
+
+void shapeModesDialogQT::on_comboBox_mode_currentIndexChanged(int index)
+{
+    if(index < 0) return;
+    emit sig_shapeMode_valueChanged(index, ui->horizontalSlider_sigma->value()/10.0);
+}
+
+void shapeModesDialogQT::on_horizontalSlider_sigma_valueChanged(int value)
+{
+    ui->label_sigma_value->setText(QString::number(value/10.0, 'f', 1));
+    emit sig_shapeMode_valueChanged(ui->comboBox_mode->currentIndex(), value/10.0);
+}
+
+void shapeModesDialogQT::on_pushButton_reset_clicked()
+{
+    ui->horizontalSlider_sigma->setValue(0);
+}
@@ -0,0 +1,33 @@
+#ifndef SHAPEMODESDIALOGQT_H
+#define SHAPEMODESDIALOGQT_H
+
+#include <QDialog>
+#include <QStringList>
+
+namespace Ui {
+class shapeModesDialogQT;
+}
+
+class shapeModesDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit shapeModesDialogQT(QWidget *Qparent = 0);
+    ~shapeModesDialogQT();
+
+    void setModes(QStringList a_modes);
+
+private slots:
+    void on_comboBox_mode_currentIndexChanged(int index);
+    void on_horizontalSlider_sigma_valueChanged(int value);
+    void on_pushButton_reset_clicked();
+
+signals:
+    void sig_shapeMode_valueChanged(int mode, double standardDeviations);
+
+private:
+    Ui::shapeModesDialogQT *ui;
+};
+
+#endif // SHAPEMODESDIALOGQT_H
@@ -0,0 +1,38 @@
+#include "vertexPickingDialogQT.h"
+#include "ui_vertexPickingDialogQT.h"
+
+vertexPickingDialogQT::vertexPickingDialogQT(QWidget *Qparent) :
+    QDialog(Qparent),
+    ui(new Ui::vertexPickingDialogQT)
+{
+    ui->setupUi(this);
+}
+
+vertexPickingDialogQT::~vertexPickingDialogQT()
+{
+    delete ui;
+}
+
+void vertexPickingDialogQT::setValues(int a_vertex, QString a_attribute, QStringList a_meshes, std::vector<double> a_values, std::vector<bool> a_defined)
+{
+    ui->label_vertex_value->setText(QString::number(a_vertex));
+    ui->label_attribute_value->setText(a_attribute);
+
+    // The rows would move while they are filled, the order chosen is applied again after
+    ui->tableWidget_values->setSortingEnabled(false);
+    ui->tableWidget_values->setRowCount(a_meshes.size());
+    for(int i = 0; i < a_meshes.size() && i < (int)a_values.size() && i < (int)a_defined.size(); i++)
+    {
+        QTableWidgetItem * mesh = new QTableWidgetItem(a_meshes[i]);
+        mesh->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+        ui->tableWidget_values->setItem(i, 0, mesh);
+
+        // Numbers sorted as numbers
+        QTableWidgetItem * value = new QTableWidgetItem;
+        if(a_defined[i]) value->setData(Qt::DisplayRole, a_values[i]);
+        value->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+        ui->tableWidget_values->setItem(i, 1, value);
+    }
+    ui->tableWidget_values->setSortingEnabled(true);
+    ui->tableWidget_values->resizeColumnsToContents();
+}
@@ -0,0 +1,28 @@
+#ifndef VERTEXPICKINGDIALOGQT_H
+#define VERTEXPICKINGDIALOGQT_H
+
+#include <QDialog>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+namespace Ui {
+class vertexPickingDialogQT;
+}
+
+class vertexPickingDialogQT : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit vertexPickingDialogQT(QWidget *Qparent = 0);
+    ~vertexPickingDialogQT();
+
+    // a_defined[i] false : the mesh a_meshes[i] has no such vertex or attribute
+    void setValues(int a_vertex, QString a_attribute, QStringList a_meshes, std::vector<double> a_values, std::vector<bool> a_defined);
+
+private:
+    Ui::vertexPickingDialogQT *ui;
+};
+
+#endif // VERTEXPICKINGDIALOGQT_H